@@ -3,6 +3,7 @@
 
 #include <array>
 #include "Config.hpp"
+#include "db/DatabaseWorker.hpp"
 #include "db/SyncDatabase.hpp"
 #include <future>
 #include <stack>
@@ -45,6 +46,8 @@ namespace Main {
 
             // Database object (all calls are wrapped with a mutex)
             SyncDatabase database_;
+            // Runs queries in the background for frames
+            DatabaseWorker * databaseWorker_;
 
             // Sysmodule object which allows communication
             Sysmodule * sysmodule_;
@@ -56,6 +59,9 @@ namespace Main {
             std::atomic<bool> hasUpdate_;
             std::future<void> updateThread;
 
+            // Set when the next library scan should read every file (see Splash::scanLibrary())
+            std::atomic<bool> fullScan_;
+
             // Thread which handles sysmodule communication
             std::future<void> sysThread;
 
@@ -78,18 +84,27 @@ namespace Main {
             void updateScreenTheme();
 
             // Helper functions for database
+            // The path index is exported when unlocking unless false is passed (i.e. when the database
+            // will be locked again shortly, in which case the last unlock exports it instead)
             void lockDatabase();
-            void unlockDatabase();
+            void unlockDatabase(const bool = true);
 
             // Returns whether an update is available
             bool hasUpdate();
             // Set whether the application has an update
             void setHasUpdate(const bool);
 
+            // Returns whether the next library scan should ignore the stored directories and read every file
+            bool fullScan();
+            // Set whether the next library scan should read every file
+            void setFullScan(const bool);
+
             // Returns config pointer
             Config * config();
             // Returns database object
             const SyncDatabase & database();
+            // Returns database worker pointer
+            DatabaseWorker * databaseWorker();
             // Returns sysmodule pointer
             Sysmodule * sysmodule();
             // Returns theme pointer
@@ -43,8 +43,8 @@ class Config {
 
         bool autoLaunchService_;
         int setQueueMax_;
-        int searchMaxPhrases_;
-        int searchMaxScore_;
+        int searchMinMatch_;
+        int databaseCache_;
 
         // Read all values from app .ini
         void readConfig();
@@ -120,13 +120,13 @@ class Config {
         int setQueueMax();
         bool setSetQueueMax(const int);
 
-        // Minimum search score
-        int searchMaxScore();
-        bool setSearchMaxScore(const int);
+        // Minimum percentage of the search query a result must match
+        int searchMinMatch();
+        bool setSearchMinMatch(const int);
 
-        // Maximum search phrases
-        int searchMaxPhrases();
-        bool setSearchMaxPhrases(const int);
+        // Size of the database read cache (in KB)
+        int databaseCache();
+        bool setDatabaseCache(const int);
 
         // === Sysmodule Config === //
         // All methods start with sys*
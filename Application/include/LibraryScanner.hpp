@@ -5,6 +5,7 @@
 #include <mutex>
 #include <string>
 #include "Types.hpp"
+#include "utils/Timer.hpp"
 #include <vector>
 
 // The LibraryScanner class searches for audio files in the given path and updates
@@ -16,7 +17,7 @@ class LibraryScanner {
             Ok,                 // No error occurred
             ErrDatabase,        // The database object had an error
             ErrUnknown,         // Something unexpected went wrong
-            DoneRemove,         // Returned when there are only songs to remove
+            DoneRemove,         // Returned when there are only songs to remove (or move)
             Done                // Returned when no action needs to be taken
         };
 
@@ -26,8 +27,10 @@ class LibraryScanner {
             std::string path;           // File path
             unsigned int modifiedTime;  // Last modified timestamp
             AudioFormat format;         // Audio format of file
+            std::string fingerprint;    // Fingerprint of contents (blank if not calculated yet)
         };
         static bool FileTupleComparator(const FileTuple &, const FileTuple &);
+        static std::string fingerprintFile(const std::string &);
 
         // Reference to Database object
         const SyncDatabase & database;
@@ -47,6 +50,30 @@ class LibraryScanner {
         // Vector of files to remove
         std::vector<FileTuple> removeFiles;
 
+        // Vector of files which have been moved (old file, new file)
+        std::vector< std::pair<FileTuple, FileTuple> > moveFiles;
+
+        // Vector of fingerprints calculated for songs which were stored without one (path, fingerprint)
+        std::vector< std::pair<std::string, std::string> > fingerprints;
+
+        // Index of the next file to be parsed (counting the files to add, then those to update)
+        size_t nextFile;
+        // Number of songs stored by a previous scan which was interrupted (and are still in the journal)
+        size_t resumedSongs;
+        // Timer started when the first batch is parsed, used to estimate remaining time
+        Utils::Timer metadataTimer;
+
+        // Vector of album images that have been written but not yet stored in the database
+        std::vector< std::pair<AlbumID, std::string> > albumImages;
+
+        // Vector of palettes picked from album images that haven't been stored in the database yet
+        std::vector< std::pair<std::string, Metadata::Palette> > imagePalettes;
+
+        // State of each directory found while scanning (sorted by path), and whether
+        // it differs from what was stored in the database after the last scan
+        std::vector<Metadata::Directory> directories;
+        bool directoriesChanged_;
+
         // Functions to actually process files on another thread
         std::string parseAlbumArt(const Metadata::Song &);
         Status parseFileAdd(const FileTuple &);
@@ -57,21 +84,56 @@ class LibraryScanner {
         // Doesn't actually do anything yet
         LibraryScanner(const SyncDatabase &, const std::string &);
 
-        // Prepare lists of files to add/edit/remove from database
+        // Prepare lists of files to add/edit/remove/move within the database
+        // Directories which haven't changed since the last scan have their files' details
+        // taken from the database instead of the SD card
+        // Removed files whose fingerprint matches an added file are treated as moved
+        // A few songs stored without a fingerprint also have theirs calculated
         Status processFiles();
 
-        // Process metadata for each required file
-        // Accepts references to variables to update status
+        // Returns whether the directories have changed since the last scan (even if no songs have)
+        bool directoriesChanged();
+
+        // Store the state of each directory for the next scan (also done by updateDatabase())
+        // !! Assumes that the database is locked for writing before calling !!
+        Status updateDirectories();
+
+        // Returns whether fingerprints were calculated for songs stored without one (see FINGERPRINTS_PER_SCAN),
+        // which need to be stored even if no songs have changed
+        bool hasFingerprints();
+
+        // Store the fingerprints calculated by processFiles() (also done by updateDatabase())
+        // !! Assumes that the database is locked for writing before calling !!
+        Status updateFingerprints();
+
+        // Add the files to add/update to the scan journal, so that if the scan is interrupted the next
+        // one can still extract art for the songs which were stored
+        // !! Assumes that the database is locked for writing before calling !!
+        Status startJournal();
+
+        // Returns the number of files which haven't had their metadata processed yet
+        size_t filesRemaining();
+
+        // Process metadata for the next batch of files (see SCAN_BATCH_SIZE)
+        // Accepts references to variables to update status, which count every file in the scan
         // (current file, total files, estimated remaining time (secs))
         Status processMetadata(std::atomic<size_t> &, std::atomic<size_t> &, std::atomic<size_t> &);
 
-        // Update the database with new data
+        // Update the database with the batch processed by processMetadata(), marking it as stored in the journal
+        // Songs are moved with the first batch, and removed (along with updating the directories, etc.) once
+        // no files remain, as the next scan would otherwise skip the files in the unstored batches
         // !! Assumes that the database is locked for writing before calling !!
         Status updateDatabase();
 
-        // Extract album art and write path to database
-        // !! Assumes that the database is locked for writing before calling !!
+        // Extract album art for the songs in the scan journal whose album doesn't have an image, on multiple
+        // threads, writing each at every size
+        // The player's colours are then picked from each new image (and any album images without them)
+        // Accepts reference to variable to update with the number of images found
         Status processArt(std::atomic<size_t> &);
+
+        // Write the paths and colours of the album art found by processArt() to the database, then clear the journal
+        // !! Assumes that the database is locked for writing before calling !!
+        Status updateArt();
 };
 
 #endif
\ No newline at end of file
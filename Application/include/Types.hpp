@@ -1,7 +1,9 @@
 #ifndef TYPES_HPP
 #define TYPES_HPP
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 // All IDs are integers
 typedef int ArtistID, AlbumID, PlaylistID, PlaylistSongID, SongID;
@@ -13,7 +15,7 @@ enum class AudioFormat {
     MP3,        // Audio stored as MP3
     WAV,        // Audio stored as WAV
 };
-AudioFormat audioFormatFromString(const std::string &);
+AudioFormat audioFormatFromString(const std::string_view);
 std::string audioFormatToString(const AudioFormat);
 
 // Status of sysmodule playback
@@ -63,6 +65,7 @@ namespace Metadata {
         std::string description;    // Playlist description (optional)
         std::string imagePath;      // Path to playlist's image (can be blank)
         unsigned int songCount;     // Number of songs in the playlist
+        bool smart;                 // Whether the songs are chosen by rules instead of by hand (see SmartPlaylist.hpp)
     };
 
     struct Song {
@@ -78,12 +81,27 @@ namespace Metadata {
         std::string path;           // Path of associated file
         AudioFormat format;         // Audio format song is stored in
         unsigned int modified;      // Timestamp file was last modified
+        std::string fingerprint;    // Fingerprint of file's contents (only set by the scanner, blank otherwise)
     };
 
     struct PlaylistSong {
         PlaylistSongID ID;          // Unique ID for this song entry
         Song song;                  // Song struct seen above
     };
+
+    struct Palette {
+        bool valid;                 // Set false if no colours have been stored for the image
+        bool bgLight;               // Is the background colour light?
+        uint32_t background;        // Colour to use for background (as 0xRRGGBBAA)
+        uint32_t primary;           // Colour to use for primary text
+        uint32_t secondary;         // Colour to use for secondary text
+    };
+
+    struct Directory {
+        std::string path;           // Path of directory
+        unsigned int modified;      // Timestamp directory was last modified
+        unsigned int entries;       // Number of files/directories within it (not recursive)
+    };
 };
 
 #endif
\ No newline at end of file
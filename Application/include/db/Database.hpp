@@ -1,8 +1,10 @@
 #ifndef DATABASE_HPP
 #define DATABASE_HPP
 
+#include "db/SmartPlaylist.hpp"
 #include "SQLite.hpp"
 #include "Types.hpp"
+#include <atomic>
 #include <vector>
 
 // The Database class interacts with the database stored on the sd card
@@ -33,14 +35,17 @@ class Database {
         SQLite * db;
         // String describing last error
         std::string error_;
-        // Number of phrases to generate when searching
-        unsigned int searchPhrases;
-        // Maximum 'spellfix score' to permit for searches
-        unsigned int searchScore;
+        // Minimum percentage of a query's trigrams a result must contain
+        unsigned int searchMatch;
+        // Incremented each time the running search is interrupted
+        std::atomic<unsigned int> searchInterrupts;
+        // Token of the running search (see searchToken())
+        unsigned int searchStart;
+        // Set when a song/artist/album is changed, meaning the path index needs to be exported again
+        bool pathIndexOutdated;
 
-        // Indicates whether search_update has been set to 1
-        // Used to avoid repeated UPDATE queries
-        bool updateMarked;
+        // Progress handler which aborts the running search if it has been interrupted
+        static int searchProgress(void *);
 
         // Update the stored error message
         void setErrorMsg(const std::string &);
@@ -49,8 +54,9 @@ class Database {
         bool addArtist(std::string &);
         bool addAlbum(std::string &);
         bool getVersion(int &);
-        bool setSearchUpdate(int);
-        std::vector<std::string> getSearchPhrases(const std::string &, std::string &);
+        std::string getSearchQuery(const std::string &);
+        bool copySongsToPlaylist(const std::string &, PlaylistID, const std::string &, int);
+        bool canEditPlaylistSongs(const std::string &, const std::string &, int);
 
     public:
         // ===== Housekeeping ===== //
@@ -58,12 +64,22 @@ class Database {
         Database();
         // Migrates the database to bring it to the latest version
         bool migrate();
+        // Updates the statistics used to plan queries (call after large changes, i.e. a scan)
+        // Requires a read-write connection
+        bool analyze();
         // Returns the last error that occurred (blank if no error has occurred)
         std::string error();
-        // Set the maximum number of phrases to search with (higher means a 'broader' search)
-        void setSearchPhraseCount(const unsigned int);
-        // Set the maximum 'spellfix score' to use for searches (higher means less accurate)
-        void setSpellfixScore(const unsigned int);
+        // Set the minimum percentage of the search query a result must match (lower means a 'broader' search)
+        void setSearchMatchPercent(const unsigned int);
+        // Set the size of the read cache (in KB), which takes effect when the database is next opened
+        void setReadCache(const unsigned int);
+        // Returns a token for a search starting now, to pass to the search queries
+        // Any call to interruptSearch() after this aborts searches given the token, even if they haven't started running yet
+        // This doesn't touch the connection, so it's safe to call without holding the lock
+        unsigned int searchToken();
+        // Interrupts a search running on another thread, which will return whatever it has found so far
+        // This doesn't touch the connection, so it's safe to call without holding the lock
+        void interruptSearch();
 
         // ===== Connection Management ===== //
         // Open the database read-write (will block until available)
@@ -72,10 +88,19 @@ class Database {
         bool openReadWrite();
         // Close a open connection (if there is one)
         void close();
+        // Begin, commit or rollback a transaction wrapping several of the calls below, so they're all stored
+        // at once (calls which use a transaction of their own can't be made while one is active)
+        // Returns true if successful, false otherwise
+        bool beginTransaction();
+        bool commitTransaction();
+        bool rollbackTransaction();
 
         // ===== Album Metadata ===== //
         // Update an album's metadata (grabs ID from struct)
         bool updateAlbum(Metadata::Album);
+        // Set the image of many albums at once (in one transaction)
+        // Return true if successful, false otherwise (in which case none are updated)
+        bool setAlbumImages(const std::vector< std::pair<AlbumID, std::string> > &);
         // Returns metadata for all stored albums
         // Empty if no albums or an error occurred
         std::vector<Metadata::Album> getAllAlbumMetadata(SortBy);
@@ -117,12 +142,27 @@ class Database {
         // Returns a playlist's songs
         // Empty if there are none or an error occurred
         std::vector<Metadata::PlaylistSong> getSongMetadataForPlaylist(PlaylistID, SortBy);
+        // Note that the songs in a smart playlist can't be added or removed by the following
         // Add a song to a playlist
         // Return true if successful, false otherwise
         bool addSongToPlaylist(PlaylistID, SongID);
+        // Add many songs to a playlist (in one transaction)
+        // Return true if successful, false otherwise (in which case none are added)
+        bool addSongsToPlaylist(PlaylistID, const std::vector<SongID> &);
+        // Add every song in an album/by an artist/in another playlist to a playlist (in one statement)
+        // Return true if successful, false otherwise (in which case none are added)
+        bool addAlbumToPlaylist(PlaylistID, AlbumID);
+        bool addArtistToPlaylist(PlaylistID, ArtistID);
+        bool addPlaylistToPlaylist(PlaylistID, PlaylistID);
         // Remove a song from a playlist
         // Return true if successful, false otherwise
         bool removeSongFromPlaylist(PlaylistSongID);
+        // Add a playlist containing the songs matching the given rules (see SmartPlaylist.hpp)
+        // Returns true if successful, false otherwise
+        bool addSmartPlaylist(Metadata::Playlist, const std::vector<SmartPlaylist::Rule> &);
+        // Updates the songs in every smart playlist (only songs changed since the last refresh are tested)
+        // Call after songs are changed or played. Returns true if successful, false otherwise
+        bool refreshSmartPlaylists();
 
         // ===== Song Metadata ===== //
         // Add a song (and associated artists, etc) into database
@@ -131,6 +171,10 @@ class Database {
         // Updates the matching song in the database
         // Returns true if successful, false otherwise
         bool updateSong(Metadata::Song);
+        // Changes the path (plus format and modified time) of a song whose file has been moved,
+        // leaving everything else (plays, playlists, etc.) untouched
+        // Returns true if successful, false otherwise
+        bool moveSong(SongID, const std::string &, AudioFormat, unsigned int);
         // Remove song from database with ID
         // Returns true if successful, false otherwise
         bool removeSong(SongID);
@@ -147,22 +191,31 @@ class Database {
         Metadata::Song getSongMetadataForID(SongID);
 
         // ===== Search Queries ===== //
-        // Returns if the database needs to be updated before searching
-        bool needsSearchUpdate();
-        // Indexes terms and prepares database for searching
-        bool prepareSearch();
-        // Search for records matching given text
+        // Note that the search tables are kept up to date by triggers, so no preparation is required
+        // Search for records matching given text, as part of the search identified by the token (see searchToken())
         // The number of returned records can also be optionally limited
-        // Empty if no matching songs or an error occurred
-        std::vector<Metadata::Album> searchAlbums(const std::string, int = -1);
-        std::vector<Metadata::Artist> searchArtists(const std::string, int = -1);
-        std::vector<Metadata::Playlist> searchPlaylists(const std::string, int = -1);
-        std::vector<Metadata::Song> searchSongs(const std::string, int = -1);
+        // Empty if no matching songs or an error occurred (bool set false on error, true on success or if interrupted)
+        std::vector<Metadata::Album> searchAlbums(const std::string, const unsigned int, bool &, int = -1);
+        std::vector<Metadata::Artist> searchArtists(const std::string, const unsigned int, bool &, int = -1);
+        std::vector<Metadata::Playlist> searchPlaylists(const std::string, const unsigned int, bool &, int = -1);
+        std::vector<Metadata::Song> searchSongs(const std::string, const unsigned int, bool &, int = -1);
 
         // ===== Misc. Queries ===== //
-        // Returns a vector of strings containing all referenced images
+        // Returns a vector of strings containing all images counted in the Images table (sorted by path)
         // Empty if no image paths stored or an error occurred (bool set false on error, true on success)
         std::vector<std::string> getAllImagePaths(bool &);
+        // Deletes images which are no longer used by any album, artist or playlist (including other sizes of
+        // album art), optionally only removing up to the given number of images
+        // Returns true if successful, false otherwise
+        bool removeUnusedImages(int = -1);
+        // Returns the images used by albums which don't have a palette stored yet
+        // Empty if there are none or an error occurred
+        std::vector<std::string> getAlbumImagesWithoutPalette();
+        // Returns the palette stored for the given image (valid will be false if there isn't one)
+        Metadata::Palette getPaletteForImage(const std::string &);
+        // Store the palette of many images at once (in one transaction)
+        // Return true if successful, false otherwise (in which case none are updated)
+        bool setImagePalettes(const std::vector< std::pair<std::string, Metadata::Palette> > &);
         // Returns a vector of pairs (file path, modified time) for all songs
         // Empty if no songs or error occurred (bool set false on error, true on success)
         std::vector< std::pair<std::string, unsigned int> > getAllSongFileInfo(bool &);
@@ -176,6 +229,54 @@ class Database {
         ArtistID getArtistIDForSong(SongID);
         // Return ID of song with given path (-1 if not found)
         SongID getSongIDForPath(std::string &);
+        // Return the fingerprint of the file at the given path (blank if not known or not found)
+        std::string getSongFingerprintForPath(const std::string &);
+        // Returns the paths of songs stored without a fingerprint (i.e. before they were calculated),
+        // optionally only returning up to the given number of paths
+        // Empty if there are none or an error occurred
+        std::vector<std::string> getSongPathsWithoutFingerprint(int = -1);
+        // Store the fingerprints of many songs at once (pairs of path, fingerprint) in one transaction
+        // Returns true if successful, false otherwise (in which case none are updated)
+        bool setSongFingerprints(const std::vector< std::pair<std::string, std::string> > &);
+
+        // ===== Play History ===== //
+        // Adds the plays recorded by the sysmodule (see PlayJournal.hpp) to the History table and
+        // each song's play count, then removes the journal. Requires a read-write connection
+        // Returns true if successful (or there was nothing to add), false on an error
+        bool importPlayJournal();
+
+        // ===== Directory Manifest ===== //
+        // Returns the state of each directory as of the last library scan (sorted by path)
+        // Empty if there are none or an error occurred (bool set false on error, true on success)
+        std::vector<Metadata::Directory> getAllDirectoryInfo(bool &);
+        // Replaces the stored directories with the given ones. Requires a read-write connection
+        // Returns true if successful, false on an error
+        bool setAllDirectoryInfo(const std::vector<Metadata::Directory> &);
+        // Forgets the stored directories, so that the next library scan reads every file instead of trusting
+        // unchanged directories (i.e. picks up files whose tags were edited in place). Requires a read-write connection
+        // Returns true if successful, false on an error
+        bool removeAllDirectoryInfo();
+
+        // ===== Scan Journal ===== //
+        // Adds the given files (which a library scan is about to store) to the journal, leaving any
+        // already in it untouched. Requires a read-write connection
+        // Returns true if successful, false on an error
+        bool addToScanJournal(const std::vector<std::string> &);
+        // Marks the given files as stored in the journal. Requires a read-write connection
+        // This should be called in the transaction which stores the files' songs
+        // Returns true if successful, false on an error
+        bool setScanJournalStored(const std::vector<std::string> &);
+        // Returns the songs in the journal which have been stored (i.e. by a scan which hasn't finished yet)
+        // Empty if there are none or an error occurred (bool set false on error, true on success)
+        std::vector<Metadata::Song> getStoredScanJournalSongs(bool &);
+        // Removes every file from the journal once the scan has finished. Requires a read-write connection
+        // Returns true if successful, false on an error
+        bool clearScanJournal();
+
+        // ===== Path Index ===== //
+        // Writes the path index read by the sysmodule (see PathIndex.hpp) if songs have changed since it was last written
+        // Returns true if successful (or already up to date), false on an error
+        bool exportPathIndex();
 
         // Destructor closes handle
         ~Database();
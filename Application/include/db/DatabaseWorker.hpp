@@ -0,0 +1,83 @@
+#ifndef DATABASEWORKER_HPP
+#define DATABASEWORKER_HPP
+
+#include <condition_variable>
+#include "db/SyncDatabase.hpp"
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+
+// The DatabaseWorker runs queries on a background thread so that the UI thread
+// never has to wait on SQLite. Each job is tagged with an 'owner' (usually a frame)
+// and has a callback which is invoked on the UI thread by dispatch() once finished.
+// Only one thread is used as there is a single connection and SQLite is compiled
+// without thread safety, so every call is serialized by SyncDatabase anyways.
+class DatabaseWorker {
+    private:
+        // A queued job and the callback to invoke once it's done
+        struct Job {
+            const void * owner;
+            std::function<void(const SyncDatabase &)> job;
+            std::function<void()> done;
+        };
+
+        // Database to pass to jobs
+        const SyncDatabase & database;
+
+        // Jobs waiting to be run and callbacks waiting to be dispatched
+        std::deque<Job> queued;
+        std::deque<Job> finished;
+
+        // Owner of the job currently running, and whether its result should be dropped
+        const void * runningOwner;
+        bool runningCancelled;
+
+        // Protects the above variables
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        // Held while a job is running (see pause())
+        std::mutex jobMutex;
+
+        // Thread which runs the jobs
+        bool exit_;
+        std::future<void> thread;
+        void process();
+
+    public:
+        // Starts the worker thread
+        DatabaseWorker(const SyncDatabase &);
+
+        // Queue a job to run on the worker thread, with a callback to invoke on the UI thread
+        void queueJob(const void *, const std::function<void(const SyncDatabase &)> &, const std::function<void()> &);
+
+        // Typed variant of the above: the callback is passed the value returned by the query
+        template <typename Query, typename Callback>
+        void queue(const void * owner, Query query, Callback callback) {
+            using Result = decltype(query(this->database));
+            std::shared_ptr<Result> result = std::make_shared<Result>();
+            this->queueJob(owner, [query, result](const SyncDatabase & db) {
+                *result = query(db);
+            }, [callback, result]() {
+                callback(*result);
+            });
+        }
+
+        // Drop all jobs and pending callbacks for the given owner
+        // Must be called before the owner is deleted
+        void cancel(const void *);
+
+        // Invoke the callbacks of all finished jobs (call on the UI thread)
+        void dispatch();
+
+        // Returns a lock which prevents any jobs from running while held
+        // Used while the database is being closed/reopened
+        std::unique_lock<std::mutex> pause();
+
+        // Stops the thread (waiting for the running job to finish)
+        ~DatabaseWorker();
+};
+
+#endif
\ No newline at end of file
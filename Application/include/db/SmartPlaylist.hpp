@@ -0,0 +1,46 @@
+#ifndef SMARTPLAYLIST_HPP
+#define SMARTPLAYLIST_HPP
+
+#include <string>
+#include <vector>
+
+// A smart playlist is a playlist whose songs are chosen by a set of rules instead of
+// by hand. The rules are compiled into an SQL expression (evaluated against a row in
+// the Songs table) which is stored alongside the playlist. The matching songs are kept in
+// PlaylistSongs like any other playlist, and are refreshed by Database::refreshSmartPlaylists().
+namespace SmartPlaylist {
+    // Property of a song to test
+    enum class Field {
+        Title,              // Song's title
+        Artist,             // Artist's name
+        Album,              // Album's name
+        Duration,           // Length in seconds
+        Plays,              // Number of times played (not including skips)
+        Favourite,          // 1 if favourited, 0 otherwise
+        DaysSincePlayed,    // Number of days since last played (or since 1970 if never)
+        DaysSinceModified   // Number of days since the file was last modified
+    };
+
+    // How to compare the field with the rule's value
+    enum class Comparison {
+        Is,                 // Equal (case insensitive for text)
+        IsNot,              // Not equal (case insensitive for text)
+        Contains,           // Text contains value (treated as Is for numbers)
+        LessThan,           // Less than value
+        GreaterThan         // Greater than value
+    };
+
+    // A single rule (a song must match every rule to be included)
+    struct Rule {
+        Field field;
+        Comparison comparison;
+        std::string value;
+    };
+
+    // Compiles the rules into an SQL expression, values are escaped so this is safe to store
+    // The boolean is set true if the result depends on the current time (and thus can change
+    // without the song changing)
+    std::string compile(const std::vector<Rule> &, bool &);
+};
+
+#endif
\ No newline at end of file
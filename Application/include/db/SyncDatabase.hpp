@@ -48,6 +48,12 @@ class SyncDatabase {
 
         // Override -> operator to invoke the before/after methods
         SyncDatabaseProxy operator->() const;
+
+        // Returns a token for a search starting now without waiting for the mutex (see Database::searchToken())
+        unsigned int searchToken() const;
+
+        // Interrupts a running search without waiting for the mutex (see Database::interruptSearch())
+        void interruptSearch() const;
 };
 
 #endif
\ No newline at end of file
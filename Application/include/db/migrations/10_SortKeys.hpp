@@ -0,0 +1,13 @@
+#ifndef MIGRATION_10_HPP
+#define MIGRATION_10_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 10
+// Add normalised sort keys and indexes to support each sort/lookup
+namespace Migration {
+    std::string migrateTo10(SQLite *);
+};
+
+#endif
\ No newline at end of file
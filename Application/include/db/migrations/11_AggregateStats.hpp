@@ -0,0 +1,13 @@
+#ifndef MIGRATION_11_HPP
+#define MIGRATION_11_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 11
+// Store album/artist counts in tables maintained by triggers
+namespace Migration {
+    std::string migrateTo11(SQLite *);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef MIGRATION_12_HPP
+#define MIGRATION_12_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 12
+// Add a table recording each time a song is played (from the sysmodule's play journal)
+namespace Migration {
+    std::string migrateTo12(SQLite *);
+};
+
+#endif
\ No newline at end of file
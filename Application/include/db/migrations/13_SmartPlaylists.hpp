@@ -0,0 +1,13 @@
+#ifndef MIGRATION_13_HPP
+#define MIGRATION_13_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 13
+// Add smart playlists, and track which songs have changed since they were last refreshed
+namespace Migration {
+    std::string migrateTo13(SQLite *);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef MIGRATION_14_HPP
+#define MIGRATION_14_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 14
+// Remember the state of each directory in the library so unchanged ones can be skipped when scanning
+namespace Migration {
+    std::string migrateTo14(SQLite *);
+};
+
+#endif
\ No newline at end of file
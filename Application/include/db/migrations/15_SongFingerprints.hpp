@@ -0,0 +1,13 @@
+#ifndef MIGRATION_15_HPP
+#define MIGRATION_15_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 15
+// Store a fingerprint of each song's file so moved files can be recognised
+namespace Migration {
+    std::string migrateTo15(SQLite *);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef MIGRATION_16_HPP
+#define MIGRATION_16_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 16
+// Count the references to each image so images shared between rows are only deleted once unused
+namespace Migration {
+    std::string migrateTo16(SQLite *);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef MIGRATION_17_HPP
+#define MIGRATION_17_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 17
+// Store the colours picked from each image for the player
+namespace Migration {
+    std::string migrateTo17(SQLite *);
+};
+
+#endif
\ No newline at end of file
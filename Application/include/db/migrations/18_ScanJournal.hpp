@@ -0,0 +1,13 @@
+#ifndef MIGRATION_18_HPP
+#define MIGRATION_18_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 18
+// Record the files being stored by a library scan so it can be resumed if interrupted
+namespace Migration {
+    std::string migrateTo18(SQLite *);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef MIGRATION_8_HPP
+#define MIGRATION_8_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 8
+// Maintain search tables with triggers instead of rebuilding them
+namespace Migration {
+    std::string migrateTo8(SQLite *);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef MIGRATION_9_HPP
+#define MIGRATION_9_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 9
+// Index trigrams instead of words and remove the spellfix tables
+namespace Migration {
+    std::string migrateTo9(SQLite *);
+};
+
+#endif
\ No newline at end of file
@@ -9,5 +9,16 @@
 #include "db/migrations/5_UpdateSearch.hpp"
 #include "db/migrations/6_RemoveImages.hpp"
 #include "db/migrations/7_AddAudioFormat.hpp"
+#include "db/migrations/8_IncrementalSearch.hpp"
+#include "db/migrations/9_TrigramSearch.hpp"
+#include "db/migrations/10_SortKeys.hpp"
+#include "db/migrations/11_AggregateStats.hpp"
+#include "db/migrations/12_PlayHistory.hpp"
+#include "db/migrations/13_SmartPlaylists.hpp"
+#include "db/migrations/14_DirectoryManifest.hpp"
+#include "db/migrations/15_SongFingerprints.hpp"
+#include "db/migrations/16_ImageReferences.hpp"
+#include "db/migrations/17_ImagePalettes.hpp"
+#include "db/migrations/18_ScanJournal.hpp"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,18 @@
+#ifndef METADATA_TAGREADER_HPP
+#define METADATA_TAGREADER_HPP
+
+#include <string>
+#include "Types.hpp"
+
+// Reads tags and durations by only reading the parts of a file which store them, which is much
+// quicker than TagLib as the rest of the file is never touched. Only the common layouts are
+// handled (ID3v2.3/2.4, ID3v1, FLAC STREAMINFO/VORBIS_COMMENT and PCM WAV with LIST/id3 chunks),
+// anything else should be read with TagLib instead.
+namespace Metadata::TagReader {
+    // Fills the given Song with the tags and duration of the specified file, only replacing
+    // empty values and checking tags in the same order as when TagLib is used
+    // Returns false (leaving the Song untouched) if the file couldn't be handled
+    bool readFromFile(const std::string &, const AudioFormat, Song &);
+};
+
+#endif
\ No newline at end of file
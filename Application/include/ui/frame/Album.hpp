@@ -25,9 +25,13 @@ namespace Frame {
             bool oneArtist;
             std::vector<Metadata::Song> songs;
 
+            // Creates the frame's contents once the album's metadata and songs have been fetched
+            void populate(const Metadata::Album &, const std::vector<Metadata::Song> &);
+
             // Functions to create menus
             void createAlbumMenu();
             void createArtistsList();
+            void showArtistsList(const std::vector<Metadata::Artist> &);
             void createSongMenu(size_t);
 
             // Helper function to play album from position
@@ -38,6 +38,9 @@ namespace Frame {
             bool threadRunning;
             std::string newImagePath;
 
+            // Creates the frame's elements once the album's metadata has been fetched
+            void populate(const Metadata::Album &);
+
             // Functions which create/update popups
             void createAudioDBOverlay();
             void updateAudioDBOverlay();
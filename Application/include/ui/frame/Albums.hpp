@@ -28,7 +28,11 @@ namespace Frame {
             // Helper functions to prepare menus
             void createArtistsList(AlbumID);
             void createList(Database::SortBy);
-            void createMenu(AlbumID);
+            void createMenu(const Metadata::Album &);
+            void showArtistsList(const std::vector<Metadata::Artist> &);
+
+            // Fill the grid once the albums have been fetched
+            void populateList(const std::vector<Metadata::Album> &);
 
         public:
             // Constructor sets strings and forms list using database
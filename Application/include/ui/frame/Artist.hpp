@@ -29,10 +29,14 @@ namespace Frame {
             Aether::FilledButton * playButton;
             CustomElm::ScrollableGrid * grid;
 
+            // Creates the frame's contents once the artist's metadata has been fetched
+            void populate(const Metadata::Artist &);
+
             // Functions to create menus
-            void createArtistMenu(ArtistID);
-            void createAlbumMenu(AlbumID);
+            void createArtistMenu();
+            void createAlbumMenu(const Metadata::Album &);
             void createList(Database::SortBy);
+            void populateList(const std::vector<Metadata::Album> &);
 
         public:
             // The constructor takes the ID of the artist to show
@@ -31,6 +31,9 @@ namespace Frame {
             bool threadRunning;
             std::string newImagePath;
 
+            // Creates the frame's elements once the artist's metadata has been fetched
+            void populate(const Metadata::Artist &);
+
             // Functions which create/update popups
             void createAudioDBOverlay();
             void updateAudioDBOverlay();
@@ -26,10 +26,12 @@ namespace Frame {
             CustomOvl::SortBy * sortMenu;
 
             // Helper function to prepare menu
-            void createMenu(ArtistID);
+            void createMenu(const Metadata::Artist &);
 
             // (Re)create main list
             void createList(Database::SortBy);
+            // Fill the grid once the artists have been fetched
+            void populateList(const std::vector<Metadata::Artist> &);
 
         public:
             // Constructor sets strings and forms list using database
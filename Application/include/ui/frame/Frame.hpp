@@ -8,6 +8,10 @@ namespace Main {
     class Application;
 };
 
+namespace CustomOvl {
+    class ItemMenu;
+};
+
 namespace Frame {
     // Action to take on setting frame
     enum class Action {
@@ -57,6 +61,23 @@ namespace Frame {
             std::function<void(const std::string &, const std::vector<SongID> &, const size_t, const bool)> playNewQueue;
             std::function<void(std::function<void(PlaylistID)>)> showAddToPlaylist;
 
+            // Fetch the IDs of the songs in an album/by an artist/in a playlist on the database worker, then
+            // pass them to the given function on the UI thread (i.e. to play or queue them without waiting)
+            void withAlbumSongs(AlbumID, const std::function<void(const std::vector<SongID> &)> &);
+            void withArtistSongs(ArtistID, const std::function<void(const std::vector<SongID> &)> &);
+            void withPlaylistSongs(PlaylistID, const std::function<void(const std::vector<SongID> &)> &);
+            // Fetch the path to the thumbnail of the given song's album on the database worker, then pass it
+            // to the given function on the UI thread (the default art is passed if there is no image)
+            void withSongArt(SongID, const std::function<void(const std::string &)> &);
+            // Look up the artist of a song/the artist with the given name/the album of a song on the database
+            // worker, then push its frame once found
+            void goToArtistForSong(SongID);
+            void goToArtistNamed(const std::string &);
+            void goToAlbumForSong(SongID);
+            // Show placeholders in the given menu, then fill in the song's title, artist and album art once
+            // fetched on the database worker (skipped if the menu pointer has changed by then)
+            void fillSongMenu(CustomOvl::ItemMenu * const &, SongID);
+
         public:
             // Passed app pointer for sysmodule + theme
             Frame(Main::Application *);
@@ -80,6 +101,9 @@ namespace Frame {
             void setPlayNewQueueFunc(std::function<void(const std::string &, const std::vector<SongID> &, const size_t, const bool)>);
             // Passed a function to call when wanting to add to playlist
             void setShowAddToPlaylistFunc(std::function<void(std::function<void(PlaylistID)>)>);
+
+            // Cancels any queries still queued for the frame
+            virtual ~Frame();
     };
 };
 
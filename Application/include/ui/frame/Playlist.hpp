@@ -41,6 +41,9 @@ namespace Frame {
             Metadata::Playlist metadata;
             std::vector<Metadata::PlaylistSong> songs;
 
+            // Creates the frame's contents once the playlist's metadata has been fetched
+            void populate(const Metadata::Playlist &);
+
             // Functions to create menus
             void createDeleteMenu();
             void createPlaylistMenu();
@@ -55,6 +58,10 @@ namespace Frame {
             // Repopulates list
             void calculateStats();
             void refreshList(Database::SortBy);
+            void populateList(const Metadata::Playlist &, const std::vector<Metadata::PlaylistSong> &);
+
+            // Updates the heading and image with metadata changed in PlaylistInfo
+            void updateMetadata(const Metadata::Playlist &);
 
         public:
             // The constructor takes the ID of the playlist to show
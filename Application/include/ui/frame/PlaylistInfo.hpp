@@ -42,6 +42,9 @@ namespace Frame {
             bool updateImage;
             std::string newImagePath;
 
+            // Creates the frame's elements once the playlist's metadata has been fetched
+            void populate(const Metadata::Playlist &);
+
             // Functions which create/update popups
             void createFileBrowser(const FBType);
             void createInfoOverlay(const std::string &);
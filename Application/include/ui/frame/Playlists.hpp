@@ -12,6 +12,7 @@ namespace CustomElm::ListItem {
 namespace CustomOvl {
     class FileBrowser;
     class ItemMenu;
+    class Menu;
     class NewPlaylist;
     class SortBy;
 };
@@ -30,6 +31,7 @@ namespace Frame {
             CustomOvl::ItemMenu * menu;
             Aether::MessageBox * msgbox;
             CustomOvl::NewPlaylist * newMenu;
+            CustomOvl::Menu * smartMenu;
 
             // Various things
             bool checkFB;
@@ -52,6 +54,7 @@ namespace Frame {
             void createFileBrowser(const std::string &, const std::vector<std::string> &, const std::string &);
             void createMenu(size_t);
             void createNewPlaylistMenu();
+            void createSmartPlaylistMenu();
             void createInfoOverlay(const std::string &);
 
             // Creates a ListItem::Playlist from the given metadata
@@ -69,6 +72,9 @@ namespace Frame {
             // Save new playlist to DB
             void savePlaylist();
 
+            // Save a new smart playlist with the given name and rules to DB
+            void saveSmartPlaylist(const std::string &, const std::vector<SmartPlaylist::Rule> &);
+
         public:
             // Constructor sets strings and forms list using database
             Playlists(Main::Application *);
@@ -5,16 +5,50 @@
 #include "ui/overlay/ArtistList.hpp"
 #include "ui/overlay/Overlay.hpp"
 #include "ui/overlay/ItemMenu.hpp"
+#include <atomic>
+#include <unordered_map>
 
 namespace Frame {
     class Search : public Frame {
         private:
+            // Results for a single query
+            struct Results {
+                std::vector<Metadata::Playlist> playlists;
+                std::vector<Metadata::Artist> artists;
+                std::vector<Metadata::Album> albums;
+                std::vector<Metadata::Song> songs;
+            };
+
             // Cached songIDs (used to set play queue)
             std::vector<SongID> songIDs;
 
             // Is the list empty?
             bool listEmpty;
 
+            // Button to edit the query, and elements which are replaced when new results are shown
+            Aether::BorderButton * edit;
+            Aether::Container * errorContainer;
+            Aether::Text * ellipsis;
+            Aether::Text * noResults;
+
+            // Current query (as entered) and the results shown for each query this session
+            // Cached results are shown immediately, and are refined locally when a query extends a cached one
+            std::string query;
+            std::unordered_map<std::string, Results> cache;
+
+            // Invokes the keyboard to get a new query
+            void openKeyboard();
+            // Shows results for the given query (searching the database if needed), superseding any running search
+            void setQuery(const std::string &);
+            // Returns the results for a query, refined from those of the longest cached prefix (false if none exists)
+            bool refineCached(const std::string &, Results &);
+            // Removes the current results/messages
+            void clearResults();
+            // Replaces the current results/messages with the given results
+            void showResults(const Results &);
+            // Starts searching for the current query
+            void startSearch();
+
             // Functions that setup/add relevant entries to the list
             void addEntries();
             void addPlaylists();
@@ -29,19 +63,21 @@ namespace Frame {
             Aether::Container * searchContainer;
             void showSearching();
 
-            // Function run by other thread to actually search the database
-            bool searchDatabase(const std::string &);
+            // Function run by other thread to actually search the database (query, generation, search token)
+            // Returns false if a search failed (but not if it was interrupted)
+            bool searchDatabase(const std::string &, const unsigned int, const unsigned int);
 
             // Functions to create appropriate menus
             CustomOvl::ItemMenu * menu;
             void createNewMenu();
-            void createPlaylistMenu(PlaylistID);
-            void createArtistMenu(ArtistID);
-            void createAlbumMenu(AlbumID);
+            void createPlaylistMenu(const Metadata::Playlist &);
+            void createArtistMenu(const Metadata::Artist &);
+            void createAlbumMenu(const Metadata::Album &);
             void createSongMenu(SongID);
 
             CustomOvl::ArtistList * artistsList;
             void createArtistsList(AlbumID);
+            void showArtistsList(const std::vector<Metadata::Artist> &);
 
             // === Variables used to operate the search thread ===
             // These vectors are filled with the results and emptied after use
@@ -50,20 +86,30 @@ namespace Frame {
             std::vector<Metadata::Album> albums;
             std::vector<Metadata::Song> songs;
 
+            // Results filled by the thread
+            Results threadResults;
+
             // Future returning true if search appeared to succeed
             std::future<bool> searchThread;
 
             // Set true after the thread is done to avoid accessing an invalid future
             bool threadDone;
 
+            // Incremented each time the query changes, so stale searches can be abandoned and their results ignored
+            std::atomic<unsigned int> generation;
+            // Generation of the query being searched for by the thread
+            unsigned int threadGeneration;
+            // Set true if the current query still needs to be searched for
+            bool searchPending;
+
         public:
             // Constructor sets up elements and invokes keyboard
             Search(Main::Application *);
 
-            // Checks if the thread is finished
+            // Checks if the thread is finished and starts the next search
             void update(uint32_t);
 
-            // Delete created menu
+            // Stops any running search and deletes created menu
             ~Search();
     };
 };
@@ -21,6 +21,9 @@ namespace Frame {
             CustomElm::NumberBox * trackNumber;
             CustomElm::TextBox * filePath;
 
+            // Creates the frame's elements once the song's metadata has been fetched
+            void populate(const Metadata::Song &);
+
             // Functions which create/update popups
             Aether::MessageBox * msgbox;
             void createInfoOverlay(const std::string &);
@@ -24,6 +24,8 @@ namespace Frame {
 
             // (Re)create list with given sorting order
             void createList(Database::SortBy);
+            // Fill the list once the songs have been fetched
+            void populateList(const std::vector<Metadata::Song> &);
 
             // Create the above menu
             void createMenu(SongID);
@@ -1,6 +1,7 @@
 #ifndef SCREEN_FULLSCREEN_HPP
 #define SCREEN_FULLSCREEN_HPP
 
+#include "Types.hpp"
 #include "ui/element/Image.hpp"
 #include "ui/element/RoundButton.hpp"
 #include "ui/element/Slider.hpp"
@@ -60,6 +61,16 @@ namespace Screen {
             SongID playingID;
             unsigned int durationVal;
 
+            // Metadata of the playing song, fetched in the background along with its album art and stored colours
+            struct PlayingSong {
+                Metadata::Song song;
+                std::string imagePath;
+                Metadata::Palette palette;
+            };
+
+            // Show the given song's metadata and album art
+            void showPlayingSong(const PlayingSong &);
+
             // Colours matching the album art
             double interpolatePos;
             Aether::Colour oldBackground;
@@ -78,8 +89,8 @@ namespace Screen {
             // Set all element colours based on primary/secondary colours
             void setColours();
 
-            // Updates the image and extracts/sets colours based on image
-            void updateImage(const std::string &);
+            // Updates the image and sets colours based on those stored for it (extracting them if there are none)
+            void updateImage(const std::string &, const Metadata::Palette &);
 
         public:
             Fullscreen(Main::Application *);
@@ -66,6 +66,10 @@ namespace Screen {
             // Cached vars to avoid updating every frame
             SongID playingID;
 
+            // Show the given song (and path to its album art) in the player, or placeholders if nothing is playing
+            void showPlayingSong(const Metadata::Song &, const std::string &);
+            void showNotPlaying();
+
             // Function called to go 'back'
             void backCallback();
 
@@ -1,14 +1,52 @@
 #ifndef UTILS_IMAGE_HPP
 #define UTILS_IMAGE_HPP
 
+#include <string>
 #include <vector>
 
 namespace Utils::Image {
+    // Sizes (in pixels) that album art is stored at, so the UI never has to downscale
+    // the full size image to draw a small one
+    enum class ArtSize {
+        Thumbnail = 110,    // Lists, menus and the player
+        Tile = 160,         // Grids and headings
+        Full = 400          // Fullscreen player
+    };
+
     // Resizes the given image to the provided dimensions
     // The buffer will be replaced with the resized image as a PNG
     // Accepts raw PNG/JPEG file, resized width, resized height
     // Returns true on success, false on an error
     bool resize(std::vector<unsigned char> &, size_t, size_t);
+
+    // Resizes the given image to each of the provided (square) sizes, only decoding it once
+    // Accepts raw PNG/JPEG file, sizes, vector to fill with a PNG for each size
+    // Returns true on success, false on an error
+    bool resize(std::vector<unsigned char> &, const std::vector<size_t> &, std::vector< std::vector<unsigned char> > &);
+
+    // Decodes the given image into RGBA pixels, shrinking it (keeping its aspect ratio) to fit within the given size
+    // Accepts raw PNG/JPEG file, size, vector to fill with pixels, width and height of the returned pixels
+    // Returns true on success, false on an error
+    bool getPixels(std::vector<unsigned char> &, size_t, std::vector<unsigned char> &, size_t &, size_t &);
+
+    // Writes the given image as album art at every ArtSize
+    // Images are named by a hash of the given file, so identical art is only written (and stored) once
+    // Accepts raw PNG/JPEG file, folder to write to
+    // Returns the path to the full size image, or a blank string on an error
+    std::string writeArt(std::vector<unsigned char> &, const std::string &);
+
+    // Writes the given image resized to the given (square) size, or at its original size if it can't be resized
+    // Images are named by a hash of the given file, so identical images are only written (and stored) once
+    // Accepts raw PNG/JPEG file, folder to write to, size
+    // Returns the path to the image, or a blank string on an error
+    std::string writeImage(std::vector<unsigned char> &, const std::string &, size_t);
+
+    // Returns the path to the given size of the album art at the given path
+    // (images which weren't written by writeArt() are only stored at one size, so their path is returned)
+    std::string artPath(const std::string &, const ArtSize);
+
+    // Deletes the album art at the given path, including any other sizes
+    void deleteArt(const std::string &);
 };
 
 #endif
\ No newline at end of file
@@ -5,16 +5,14 @@
 #include <vector>
 
 namespace Utils::Search {
-    // Stores a string and it's score
-    struct ScoredString {
-        std::string string;     // String (can be word or phrase)
-        int score;              // Score of the string (lower is better)
-    };
+    // Splits the given string into words (in the same manner as SQLite's 'simple' tokenizer)
+    // and returns every trigram (three consecutive characters) of each word, lowercased
+    // Words shorter than three characters are returned whole
+    std::vector<std::string> getTrigrams(const std::string &);
 
-    // Returns best ranking phrases given a vector of ordered (ascending) ScoredStrings
-    // forming phrases where each 'string' is a word
-    // Ordered best (lowest score) first
-    std::vector<std::string> getPhrases(std::vector< std::vector<ScoredString> > &, size_t);
+    // Returns the percentage of the given trigrams (from the above) which are found in the string
+    // Trigrams shorter than three characters only need to match the start of a word, as when searching the database
+    unsigned int matchPercent(const std::vector<std::string> &, const std::string &);
 };
 
 #endif
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define UTILS_SPLASH_HPP
 
 #include "Aether/Aether.hpp"
+#include "Types.hpp"
 
 // These helper functions use the 'splash' library to return prominent colours
 // in the given image
@@ -21,6 +22,14 @@ namespace Utils::Splash {
     // Returns the above struct filled with colours for the given image
     Palette getPaletteForDrawable(Aether::Drawable *);
 
+    // Returns the above struct filled with colours for the image at the given path
+    // The image is shrunk before picking colours, so this is safe to call for large images (and on any thread)
+    Palette getPaletteForFile(const std::string &);
+
+    // Convert between the above struct and the one stored in the database
+    Palette fromMetadata(const Metadata::Palette &);
+    Metadata::Palette toMetadata(const Palette &);
+
     // Return a colour interpolated between the two provided colours at the given position (0 - 1)
     Aether::Colour interpolateColours(const Aether::Colour &, const Aether::Colour &, double);
 };
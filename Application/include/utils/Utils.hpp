@@ -1,6 +1,7 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
+#include <cstdint>
 #include <regex>
 #include <set>
 #include <string>
@@ -9,6 +10,13 @@
 
 // General helper functions
 namespace Utils {
+    // Starting hash for fnv1a()
+    constexpr uint64_t FNV1A_OFFSET_BASIS = 0xcbf29ce484222325;
+
+    // Hash the given bytes with 64-bit FNV-1a
+    // Data can be hashed in parts by passing the previous result back in as the starting hash
+    uint64_t fnv1a(const unsigned char *, size_t, uint64_t = FNV1A_OFFSET_BASIS);
+
     // Return the given number as a formatted byte string
     // eg. 2 KB or 102.3 MB
     std::string formatBytes(long long);
@@ -32,6 +40,10 @@ namespace Utils {
     // Format seconds in x hours, y minutes
     std::string secondsToHoursMins(unsigned int);
 
+    // Returns a key for sorting the given string by: lowercased, with accents removed from
+    // Latin characters and without a leading 'The ' (eg. "The Beatles" -> "beatles")
+    std::string sortKey(const std::string &);
+
     // Splits the given string into words (splits on provided delimiter)
     std::vector<std::string> splitIntoWords(const std::string &, const char);
 
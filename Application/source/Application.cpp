@@ -18,8 +18,9 @@ namespace Main {
     Application::Application() : database_(SyncDatabase(new Database())) {
         // Load config
         this->config_ = new Config(Path::App::ConfigFile);
-        this->database_->setSpellfixScore(this->config_->searchMaxScore());
-        this->database_->setSearchPhraseCount(this->config_->searchMaxPhrases());
+        this->database_->setSearchMatchPercent(this->config_->searchMinMatch());
+        this->database_->setReadCache(this->config_->databaseCache());
+        this->databaseWorker_ = new DatabaseWorker(this->database_);
 
         // Start logging
         Log::openFile(Path::App::LogFile, this->config_->logLevel());
@@ -70,6 +71,7 @@ namespace Main {
         Utils::NX::setPlayingMedia(true);
 
         // Start checking for an update
+        this->fullScan_ = false;
         this->hasUpdate_ = false;
         this->updateThread = std::async(std::launch::async, [this]() {
             Updater updater = Updater();
@@ -142,15 +144,22 @@ namespace Main {
     }
 
     void Application::lockDatabase() {
+        // Don't let any queued queries run while the database is closed
+        std::unique_lock<std::mutex> lock = this->databaseWorker_->pause();
         this->database_->close();
         this->sysmodule_->waitRequestDBLock();
         this->database_->openReadWrite();
     }
 
-    void Application::unlockDatabase() {
+    void Application::unlockDatabase(const bool exportIndex) {
+        // Update the path index before the sysmodule is allowed to read it again
+        std::unique_lock<std::mutex> lock = this->databaseWorker_->pause();
         this->database_->close();
-        this->sysmodule_->sendReleaseDBLock();
         this->database_->openReadOnly();
+        if (exportIndex && !this->database_->exportPathIndex()) {
+            Log::writeError("[APP] Unable to export the path index, the sysmodule may be unable to play new songs");
+        }
+        this->sysmodule_->sendReleaseDBLock();
     }
 
     bool Application::hasUpdate() {
@@ -161,6 +170,14 @@ namespace Main {
         this->hasUpdate_ = b;
     }
 
+    bool Application::fullScan() {
+        return this->fullScan_;
+    }
+
+    void Application::setFullScan(const bool b) {
+        this->fullScan_ = b;
+    }
+
     Config * Application::config() {
         return this->config_;
     }
@@ -169,6 +186,10 @@ namespace Main {
         return this->database_;
     }
 
+    DatabaseWorker * Application::databaseWorker() {
+        return this->databaseWorker_;
+    }
+
     Sysmodule * Application::sysmodule() {
         return this->sysmodule_;
     }
@@ -180,6 +201,8 @@ namespace Main {
     void Application::run() {
         // Do main loop
         while (this->window->loop()) {
+            // Pass any finished queries back to their frames
+            this->databaseWorker_->dispatch();
         }
     }
 
@@ -225,6 +248,9 @@ namespace Main {
         // Cleanup Aether after screens are deleted
         delete this->window;
 
+        // Stop running queries now that nothing is waiting on them
+        delete this->databaseWorker_;
+
         // Disconnect from sysmodule
         this->sysmodule_->exit();
         this->sysThread.get();
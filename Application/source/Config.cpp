@@ -158,18 +158,18 @@ void Config::readConfig() {
         this->setQueueMax_ = -1;
     }
 
-    // Advanced::search_max_score
-    this->searchMaxScore_ = this->ini->geti("Advanced", "search_max_score", -42069);
-    if (this->searchMaxScore_ < 0) {
-        Log::writeError("[CONFIG] Failed to get (Advanced) search_max_score");
-        this->searchMaxScore_ = 130;
+    // Advanced::search_min_match
+    this->searchMinMatch_ = this->ini->geti("Advanced", "search_min_match", -42069);
+    if (this->searchMinMatch_ < 1 || this->searchMinMatch_ > 100) {
+        Log::writeError("[CONFIG] Failed to get (Advanced) search_min_match");
+        this->searchMinMatch_ = 50;
     }
 
-    // Advanced::search_max_phrases
-    this->searchMaxPhrases_ = this->ini->geti("Advanced", "search_max_phrases", -42069);
-    if (this->searchMaxPhrases_ < 0) {
-        Log::writeError("[CONFIG] Failed to get (Advanced) search_max_phrases");
-        this->searchMaxPhrases_ = 8;
+    // Advanced::database_cache
+    this->databaseCache_ = this->ini->geti("Advanced", "database_cache", -42069);
+    if (this->databaseCache_ < 0) {
+        Log::writeError("[CONFIG] Failed to get (Advanced) database_cache");
+        this->databaseCache_ = 8192;
     }
 }
 
@@ -500,30 +500,30 @@ bool Config::setSetQueueMax(const int v) {
     return ok;
 }
 
-int Config::searchMaxScore() {
-    return this->searchMaxScore_;
+int Config::searchMinMatch() {
+    return this->searchMinMatch_;
 }
 
-bool Config::setSearchMaxScore(const int i) {
-    bool ok = this->ini->put("Advanced", "search_max_score", i);
+bool Config::setSearchMinMatch(const int i) {
+    bool ok = this->ini->put("Advanced", "search_min_match", i);
     if (!ok) {
-        Log::writeError("[CONFIG] Failed to set (Advanced) search_max_score");
+        Log::writeError("[CONFIG] Failed to set (Advanced) search_min_match");
     } else {
-        this->searchMaxScore_ = i;
+        this->searchMinMatch_ = i;
     }
     return ok;
 }
 
-int Config::searchMaxPhrases() {
-    return this->searchMaxPhrases_;
+int Config::databaseCache() {
+    return this->databaseCache_;
 }
 
-bool Config::setSearchMaxPhrases(const int i) {
-    bool ok = this->ini->put("Advanced", "search_max_phrases", i);
+bool Config::setDatabaseCache(const int i) {
+    bool ok = this->ini->put("Advanced", "database_cache", i);
     if (!ok) {
-        Log::writeError("[CONFIG] Failed to set (Advanced) search_max_phrases");
+        Log::writeError("[CONFIG] Failed to set (Advanced) database_cache");
     } else {
-        this->searchMaxPhrases_ = i;
+        this->databaseCache_ = i;
     }
     return ok;
 }
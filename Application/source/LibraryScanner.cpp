@@ -1,16 +1,41 @@
 #include <algorithm>
+#include <condition_variable>
+#include <cstdio>
 #include <filesystem>
 #include <future>
 #include "LibraryScanner.hpp"
 #include "Log.hpp"
 #include "meta/Metadata.hpp"
 #include "Paths.hpp"
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include "utils/FS.hpp"
 #include "utils/Image.hpp"
 #include "utils/NX.hpp"
+#include "utils/Splash.hpp"
 #include "utils/Timer.hpp"
 #include "utils/Utils.hpp"
 
+// Maximum number of threads used to parse metadata (applications are given three cores)
+// (can be overridden when building, which the scanner benchmark in Tools/benchmark does)
+#ifndef MAX_METADATA_THREADS
+#define MAX_METADATA_THREADS 3
+#endif
+// Number of threads used to list directories (more would only make the SD card thrash)
+// (can also be overridden when building)
+#ifndef MAX_WALK_THREADS
+#define MAX_WALK_THREADS 4
+#endif
+// Maximum number of threads used to extract and resize album art
+#define MAX_ART_THREADS 3
+// Number of bytes hashed at the start and end of a file to create its fingerprint
+#define FINGERPRINT_CHUNK_SIZE 65536
+// Maximum number of songs stored without a fingerprint to fingerprint on each scan (any others are done by the following scans)
+#define FINGERPRINTS_PER_SCAN 100
+// Number of files parsed before their metadata is stored (only the current batch is lost if the scan is interrupted)
+#define SCAN_BATCH_SIZE 500
+
 // List of accepted extensions (case insensitive, but these must be lowercase)
 static const std::vector< std::pair<std::string, AudioFormat> > allowedTypes = {
     {".flac", AudioFormat::FLAC},
@@ -25,8 +50,56 @@ bool LibraryScanner::FileTupleComparator(const FileTuple & lhs, const FileTuple
     return lhs.path < rhs.path;
 }
 
-LibraryScanner::LibraryScanner(const SyncDatabase & db, const std::string & path) : database(db), searchPath(path) {
+// Returns a fingerprint identifying the contents of the given file, made up of its size and
+// a hash of the start and end of the file (as reading it all would take far too long)
+// Returns a blank string if the file couldn't be read
+std::string LibraryScanner::fingerprintFile(const std::string & path) {
+    std::FILE * fp = std::fopen(path.c_str(), "rb");
+    if (fp == nullptr) {
+        return "";
+    }
+
+    // Get the size first
+    bool ok = (std::fseek(fp, 0, SEEK_END) == 0);
+    long size = std::ftell(fp);
+    ok = (ok && size >= 0);
+
+    // Hash both chunks with 64-bit FNV-1a (the chunks overlap for small files, which is fine)
+    std::vector<unsigned char> buffer(FINGERPRINT_CHUNK_SIZE);
+    uint64_t hash = Utils::FNV1A_OFFSET_BASIS;
+    long offsets[2] = {0, std::max(0L, size - FINGERPRINT_CHUNK_SIZE)};
+    for (size_t i = 0; ok && i < 2; i++) {
+        ok = (std::fseek(fp, offsets[i], SEEK_SET) == 0);
+        size_t read = (ok ? std::fread(buffer.data(), 1, buffer.size(), fp) : 0);
+        hash = Utils::fnv1a(buffer.data(), read, hash);
+        ok = (ok && !std::ferror(fp));
+    }
+    std::fclose(fp);
 
+    if (!ok) {
+        return "";
+    }
+    char str[17];
+    std::snprintf(str, sizeof(str), "%016llx", (unsigned long long)hash);
+    return std::to_string(size) + ":" + str;
+}
+
+// Comparator for Directories returning true if the lhs is before the rhs (by path)
+static bool DirectoryComparator(const Metadata::Directory & lhs, const Metadata::Directory & rhs) {
+    return lhs.path < rhs.path;
+}
+
+// Converts a file's modified time into a timestamp
+// Why is this conversion so hard?
+static unsigned int toTimestamp(const std::filesystem::file_time_type & time) {
+    auto clock = std::chrono::file_clock::to_sys(time);
+    return (unsigned int)std::chrono::system_clock::to_time_t(clock);
+}
+
+LibraryScanner::LibraryScanner(const SyncDatabase & db, const std::string & path) : database(db), searchPath(path) {
+    this->directoriesChanged_ = false;
+    this->nextFile = 0;
+    this->resumedSongs = 0;
 }
 
 std::string LibraryScanner::parseAlbumArt(const Metadata::Song & meta) {
@@ -36,27 +109,12 @@ std::string LibraryScanner::parseAlbumArt(const Metadata::Song & meta) {
         return "";
     }
 
-    // If we extracted an image resize it
-    bool resized = Utils::Image::resize(image, 400, 400);
-    if (!resized) {
-        Log::writeError("[SCAN] [ART] Unable to resize image found in: " + meta.path);
-        return "";
-    }
-
-    // Write the image to disk
-    std::string filename;
-    do {
-        filename = Utils::randomString(10);
-    } while (Utils::Fs::fileExists(Path::App::AlbumImageFolder + filename + ".png"));
-
-    filename = Path::App::AlbumImageFolder + filename + ".png";
-    bool ok = Utils::Fs::writeFile(filename, image);
-    if (!ok) {
-        Log::writeError("[SCAN] [ART] Unable to write image to file: " + filename);
-        return "";
+    // If we extracted an image write it at each size (unless another album has the same art)
+    std::string path = Utils::Image::writeArt(image, Path::App::AlbumImageFolder);
+    if (path.empty()) {
+        Log::writeError("[SCAN] [ART] Unable to write image found in: " + meta.path);
     }
-
-    return filename;
+    return path;
 }
 
 LibraryScanner::Status LibraryScanner::parseFileAdd(const FileTuple & file) {
@@ -68,6 +126,7 @@ LibraryScanner::Status LibraryScanner::parseFileAdd(const FileTuple & file) {
     }
     meta.path = file.path;
     meta.modified = file.modifiedTime;
+    meta.fingerprint = (file.fingerprint.empty() ? fingerprintFile(file.path) : file.fingerprint);
 
     // Append to metadata vector
     std::scoped_lock<std::mutex> mtx(this->addMutex);
@@ -98,6 +157,7 @@ LibraryScanner::Status LibraryScanner::parseFileUpdate(const FileTuple & file) {
     meta.trackNumber = newMeta.trackNumber;
     meta.discNumber = newMeta.discNumber;
     meta.modified = file.modifiedTime;
+    meta.fingerprint = fingerprintFile(file.path);
 
     // Append to metadata vector
     std::scoped_lock<std::mutex> mtx(this->updateMutex);
@@ -106,165 +166,406 @@ LibraryScanner::Status LibraryScanner::parseFileUpdate(const FileTuple & file) {
 }
 
 LibraryScanner::Status LibraryScanner::processFiles() {
-    // First get all paths within folder along with modified timestamp
+    // First get the state of each directory after the last scan, and all paths and modified
+    // times from the database (the database returns both in sorted order)
     Utils::NX::setLowFsPriority(true);
+    bool dbOK;
+    std::vector<Metadata::Directory> lastDirectories = this->database->getAllDirectoryInfo(dbOK);
+    std::vector< std::pair<std::string, unsigned int> > tmp;
+    if (dbOK) {
+        tmp = this->database->getAllSongFileInfo(dbOK);
+    }
+    if (!dbOK) {
+        Log::writeError("[SCAN] Couldn't read filesystem info from database");
+        Utils::NX::setLowFsPriority(false);
+        return Status::ErrDatabase;
+    }
+
+    std::vector<FileTuple> dbFiles;
+    for (size_t i = 0; i < tmp.size(); i++) {
+        dbFiles.push_back(FileTuple{tmp[i].first, tmp[i].second, AudioFormat::None});
+    }
+
+    // Next walk each directory within the folder, getting the modified time of each audio file.
+    // Directories with the same modified time and number of entries as the last scan are assumed
+    // to be unchanged, so their files are skipped and the database's entries are trusted instead.
+    // Note that they still need to be listed to find any subdirectories.
     std::vector<FileTuple> files;
+    std::vector<std::string> unchangedDirectories;
+    std::atomic<bool> walkError{false};
+    auto walkDirectory = [this, &lastDirectories, &walkError](Metadata::Directory & dir, std::vector<Metadata::Directory> & subdirs, std::vector<FileTuple> & audioFiles) -> bool {
+        std::error_code err;
+        std::vector< std::pair<std::filesystem::directory_entry, AudioFormat> > entries;
+        for (std::filesystem::directory_iterator it(dir.path, err); !err && it != std::filesystem::directory_iterator(); it.increment(err)) {
+            const std::filesystem::directory_entry & entry = *it;
+            dir.entries++;
+            if (entry.is_directory(err)) {
+                std::filesystem::file_time_type time = entry.last_write_time(err);
+                subdirs.push_back(Metadata::Directory{entry.path().string(), toTimestamp(time), 0});
+                continue;
+            }
 
-    if (Utils::Fs::fileExists(this->searchPath)) {
-        for (auto & entry: std::filesystem::recursive_directory_iterator(this->searchPath)) {
-            // Check if file's extension is whitelisted
-            AudioFormat audioType = AudioFormat::None;
+            // Keep the file if its extension is whitelisted
+            std::string extension = Utils::toLowercase(entry.path().extension());
             for (const std::pair<std::string, AudioFormat> & type : allowedTypes) {
-                if (Utils::toLowercase(entry.path().extension()) == type.first) {
-                    audioType = type.second;
+                if (extension == type.first) {
+                    entries.push_back(std::make_pair(entry, type.second));
                     break;
                 }
             }
+        }
 
-            // Continue if not whitelisted
-            if (audioType == AudioFormat::None) {
-                continue;
+        // Only create FileTuples (which requires the modified time) if the directory has changed
+        std::vector<Metadata::Directory>::iterator it = std::lower_bound(lastDirectories.begin(), lastDirectories.end(), dir, DirectoryComparator);
+        bool unchanged = (it != lastDirectories.end() && (*it).path == dir.path && (*it).modified == dir.modified && (*it).entries == dir.entries);
+        for (size_t i = 0; !unchanged && !err && i < entries.size(); i++) {
+            std::filesystem::file_time_type time = entries[i].first.last_write_time(err);
+            audioFiles.push_back(FileTuple{entries[i].first.path().string(), toTimestamp(time), entries[i].second});
+        }
+
+        // Stop if something couldn't be read, as otherwise its songs would be removed
+        if (err) {
+            Log::writeError("[SCAN] Couldn't read directory: " + dir.path + " (" + err.message() + ")");
+            walkError = true;
+        }
+        return unchanged;
+    };
+
+    // Directories are walked by a few threads at once (as each read has a high latency), with each
+    // taking the next directory from a shared stack and pushing any subdirectories it finds
+    std::vector<Metadata::Directory> toWalk;
+    size_t walking = 0;
+    std::mutex walkMutex;
+    std::condition_variable walkCondition;
+    auto walk = [this, &files, &unchangedDirectories, &walkError, &walkDirectory, &toWalk, &walking, &walkMutex, &walkCondition]() {
+        // The priority only applies to the calling thread
+        Utils::NX::setLowFsPriority(true);
+
+        std::unique_lock<std::mutex> lock(walkMutex);
+        while (true) {
+            // Finished once there's nothing left and no other thread can push more
+            walkCondition.wait(lock, [&toWalk, &walking]() {
+                return !toWalk.empty() || walking == 0;
+            });
+            if (toWalk.empty() || walkError) {
+                break;
+            }
+            Metadata::Directory dir = toWalk.back();
+            toWalk.pop_back();
+            walking++;
+            lock.unlock();
+
+            std::vector<Metadata::Directory> subdirs;
+            std::vector<FileTuple> audioFiles;
+            bool unchanged = walkDirectory(dir, subdirs, audioFiles);
+
+            lock.lock();
+            walking--;
+            toWalk.insert(toWalk.end(), subdirs.begin(), subdirs.end());
+            files.insert(files.end(), audioFiles.begin(), audioFiles.end());
+            if (unchanged) {
+                unchangedDirectories.push_back(dir.path);
             }
+            this->directories.push_back(dir);
+            walkCondition.notify_all();
+        }
+    };
 
-            // Otherwise get modified time and create FileTuple
-            // Why is this conversion so hard?
-            auto time = entry.last_write_time();
-            auto clock = std::chrono::file_clock::to_sys(time);
-            unsigned int timestamp = (unsigned int)std::chrono::system_clock::to_time_t(clock);
+    if (Utils::Fs::fileExists(this->searchPath)) {
+        std::error_code err;
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(this->searchPath, err);
+        toWalk.push_back(Metadata::Directory{this->searchPath, toTimestamp(time), 0});
 
-            files.push_back(FileTuple{entry.path().string(), timestamp, audioType});
+        std::vector< std::future<void> > threads;
+        for (unsigned int i = 1; i < MAX_WALK_THREADS; i++) {
+            threads.push_back(std::async(std::launch::async, walk));
+        }
+        walk();
+        for (std::future<void> & thread : threads) {
+            thread.get();
         }
     }
 
-    // Sort returned paths
-    Log::writeInfo("[SCAN] Found " + std::to_string(files.size()) + " files");
-    std::sort(files.begin(), files.end(), FileTupleComparator);
-
-    // Next get all paths and modified times from database
-    // (the database returns paths in sorted order)
-    bool dbOK;
-    std::vector<FileTuple> dbFiles;
-    std::vector< std::pair<std::string, unsigned int> > tmp = this->database->getAllSongFileInfo(dbOK);
-    if (!dbOK) {
-        Log::writeError("[SCAN] Couldn't read filesystem info from database");
+    if (walkError) {
         Utils::NX::setLowFsPriority(false);
-        return Status::ErrDatabase;
+        return Status::ErrUnknown;
     }
 
-    for (size_t i = 0; i < tmp.size(); i++) {
-        dbFiles.push_back(FileTuple{tmp[i].first, tmp[i].second, AudioFormat::None});
+    // Sort everything found
+    Log::writeInfo("[SCAN] Found " + std::to_string(this->directories.size()) + " directories (" + std::to_string(unchangedDirectories.size()) + " unchanged)");
+    Log::writeInfo("[SCAN] Found " + std::to_string(files.size()) + " files in changed directories");
+    std::sort(files.begin(), files.end(), FileTupleComparator);
+    std::sort(unchangedDirectories.begin(), unchangedDirectories.end());
+    std::sort(this->directories.begin(), this->directories.end(), DirectoryComparator);
+    this->directoriesChanged_ = !std::equal(this->directories.begin(), this->directories.end(), lastDirectories.begin(), lastDirectories.end(), [](const Metadata::Directory & lhs, const Metadata::Directory & rhs) {
+        return lhs.path == rhs.path && lhs.modified == rhs.modified && lhs.entries == rhs.entries;
+    });
+
+    // Finally step through both sorted lists at once to work out what has changed:
+    // - Files only on the SD card need to be added
+    // - Files in both need to be updated if the database's modified time is smaller
+    // - Files only in the database need to be removed, unless their directory was unchanged
+    size_t f = 0;
+    size_t d = 0;
+    while (f < files.size() || d < dbFiles.size()) {
+        if (d == dbFiles.size() || (f < files.size() && files[f].path < dbFiles[d].path)) {
+            this->addFiles.push_back(files[f]);
+            f++;
+
+        } else if (f == files.size() || dbFiles[d].path < files[f].path) {
+            const std::string & path = dbFiles[d].path;
+            if (!std::binary_search(unchangedDirectories.begin(), unchangedDirectories.end(), path.substr(0, path.rfind('/')))) {
+                this->removeFiles.push_back(dbFiles[d]);
+            }
+            d++;
+
+        } else {
+            if (dbFiles[d].modifiedTime < files[f].modifiedTime) {
+                this->updateFiles.push_back(files[f]);
+            }
+            f++;
+            d++;
+        }
     }
 
-    // Use a thread to work out what files to add
-    std::future<void> addThread = std::async(std::launch::async, [this, &files, &dbFiles]() {
-        // Check if each file has an entry in the database
-        // If not, it needs to be added
-        for (size_t i = 0; i < files.size(); i++) {
-            bool inDB = std::binary_search(dbFiles.begin(), dbFiles.end(), files[i], FileTupleComparator);
-            if (!inDB) {
-                this->addFiles.push_back(files[i]);
+    // A file which has been moved (or renamed) shows up as both a removed and an added file, so
+    // match these up by fingerprint in order to keep the song's plays, playlists, etc.
+    // Only added files with the same size as a removed one need to be read
+    if (!this->addFiles.empty() && !this->removeFiles.empty()) {
+        std::unordered_multimap<std::string, size_t> removedPrints;
+        std::unordered_set<std::string> removedSizes;
+        for (size_t i = 0; i < this->removeFiles.size(); i++) {
+            std::string fingerprint = this->database->getSongFingerprintForPath(this->removeFiles[i].path);
+            if (!fingerprint.empty()) {
+                removedPrints.insert(std::make_pair(fingerprint, i));
+                removedSizes.insert(fingerprint.substr(0, fingerprint.find(':')));
             }
         }
-    });
 
-    // Use another thread to work out what files need updating
-    std::future<void> updateThread = std::async(std::launch::async, [this, &files, &dbFiles]() {
-        // Check if each file is in the database
-        // If it is and the DB's modified time is smaller, it needs to be updated
-        for (size_t i = 0; i < files.size(); i++) {
-            std::vector<FileTuple>::iterator it = std::lower_bound(dbFiles.begin(), dbFiles.end(), files[i], FileTupleComparator);
-            if (it != dbFiles.end() && (*it).path == files[i].path) {
-                if ((*it).modifiedTime < files[i].modifiedTime) {
-                    this->updateFiles.push_back(files[i]);
+        std::vector<bool> moved(this->removeFiles.size(), false);
+        std::vector<FileTuple> stillAdded;
+        for (FileTuple & file : this->addFiles) {
+            std::error_code err;
+            uintmax_t size = std::filesystem::file_size(file.path, err);
+            if (!err && removedSizes.count(std::to_string(size)) > 0) {
+                file.fingerprint = fingerprintFile(file.path);
+                auto it = removedPrints.find(file.fingerprint);
+                if (it != removedPrints.end()) {
+                    this->moveFiles.push_back(std::make_pair(this->removeFiles[it->second], file));
+                    moved[it->second] = true;
+                    removedPrints.erase(it);
+                    continue;
                 }
             }
+            stillAdded.push_back(file);
         }
-    });
 
-    // This thread is responsible for determining which files to remove
-    for (size_t i = 0; i < dbFiles.size(); i++) {
-        bool onSD = std::binary_search(files.begin(), files.end(), dbFiles[i], FileTupleComparator);
-        if (!onSD) {
-            this->removeFiles.push_back(dbFiles[i]);
+        std::vector<FileTuple> stillRemoved;
+        for (size_t i = 0; i < this->removeFiles.size(); i++) {
+            if (!moved[i]) {
+                stillRemoved.push_back(this->removeFiles[i]);
+            }
         }
+        this->addFiles = stillAdded;
+        this->removeFiles = stillRemoved;
     }
 
-    // Wait for threads to finish
-    addThread.get();
-    updateThread.get();
+    // Songs stored before fingerprints were calculated can't be matched if they're moved, so fingerprint a
+    // few of them on each scan (skipping those being updated, as they're fingerprinted when parsed)
+    std::vector<std::string> unprinted = this->database->getSongPathsWithoutFingerprint(FINGERPRINTS_PER_SCAN);
+    for (const std::string & path : unprinted) {
+        if (std::binary_search(this->updateFiles.begin(), this->updateFiles.end(), FileTuple{path, 0, AudioFormat::None}, FileTupleComparator)) {
+            continue;
+        }
+
+        std::string fingerprint = fingerprintFile(path);
+        if (!fingerprint.empty()) {
+            this->fingerprints.push_back(std::make_pair(path, fingerprint));
+        }
+    }
     Utils::NX::setLowFsPriority(false);
 
+    // Songs stored before the last scan was interrupted are now up to date so won't be found above,
+    // but their art still needs to be extracted
+    this->resumedSongs = this->database->getStoredScanJournalSongs(dbOK).size();
+    if (!dbOK) {
+        Log::writeError("[SCAN] Couldn't read the scan journal from database");
+        return Status::ErrDatabase;
+    }
+    if (this->resumedSongs > 0) {
+        Log::writeInfo("[SCAN] Resuming an interrupted scan (" + std::to_string(this->resumedSongs) + " songs were already stored)");
+    }
+
     // Log status
     Log::writeInfo("[SCAN] Adding " + std::to_string(this->addFiles.size()) + " files");
     Log::writeInfo("[SCAN] Updating " + std::to_string(this->updateFiles.size()) + " files");
+    Log::writeInfo("[SCAN] Moving " + std::to_string(this->moveFiles.size()) + " files");
     Log::writeInfo("[SCAN] Removing " + std::to_string(this->removeFiles.size()) + " files");
+    Log::writeInfo("[SCAN] Fingerprinted " + std::to_string(this->fingerprints.size()) + " of " + std::to_string(unprinted.size()) + " songs stored without one");
     Log::writeSuccess("[SCAN] Initial processing completed");
 
     // Return appropriate status
-    if (this->addFiles.empty() && this->updateFiles.empty()) {
-        return (this->removeFiles.empty() ? Status::Done : Status::DoneRemove);
+    if (this->addFiles.empty() && this->updateFiles.empty() && this->resumedSongs == 0) {
+        return (this->removeFiles.empty() && this->moveFiles.empty() ? Status::Done : Status::DoneRemove);
     }
     return Status::Ok;
 }
 
-LibraryScanner::Status LibraryScanner::processMetadata(std::atomic<size_t> & currentFile, std::atomic<size_t> & totalFiles, std::atomic<size_t> & estRemaining) {
-    // Set initial status values
-    estRemaining = 0;
-    currentFile = 1;
-    totalFiles = this->addFiles.size() + this->updateFiles.size();
-    Status status = Status::Ok;
-
-    // Timer used to estimate remaining time
-    Utils::Timer timer = Utils::Timer();
-    timer.start();
+bool LibraryScanner::directoriesChanged() {
+    return this->directoriesChanged_;
+}
 
-    // Parse files that need to be added first, then updated
-    std::vector<FileTuple> dummy;
-    std::vector<FileTuple> & vec = dummy;
-    for (size_t v = 0; v < 2; v++) {
-        // Get reference to appropriate vector
-        switch (v) {
-            case 0:
-                vec = this->addFiles;
-                break;
+LibraryScanner::Status LibraryScanner::updateDirectories() {
+    if (!this->directoriesChanged_) {
+        return Status::Done;
+    }
 
-            case 1:
-                vec = this->updateFiles;
-                break;
+    if (!this->database->setAllDirectoryInfo(this->directories)) {
+        Log::writeError("[SCAN] Couldn't store directory info in database");
+        return Status::ErrDatabase;
+    }
+    this->directoriesChanged_ = false;
+    return Status::Ok;
+}
 
-            default:
-                return Status::ErrUnknown;
-                break;
+LibraryScanner::Status LibraryScanner::startJournal() {
+    std::vector<std::string> paths;
+    for (const std::vector<FileTuple> * vec : {&this->addFiles, &this->updateFiles}) {
+        for (const FileTuple & file : *vec) {
+            paths.push_back(file.path);
         }
+    }
 
-        // Iterate over each vector
-        for (size_t i = 0; i < vec.size(); i++) {
-            status = (v == 0 ? this->parseFileAdd(vec[i]) : this->parseFileUpdate(vec[i]));
+    if (!paths.empty() && !this->database->addToScanJournal(paths)) {
+        Log::writeError("[SCAN] Couldn't add files to the scan journal");
+        return Status::ErrDatabase;
+    }
+    return Status::Ok;
+}
 
-            // Increment counter and adjust remaining time
-            estRemaining = (timer.elapsedSeconds() / (double)currentFile) * (totalFiles - currentFile);
-            currentFile++;
+bool LibraryScanner::hasFingerprints() {
+    return !this->fingerprints.empty();
+}
+
+LibraryScanner::Status LibraryScanner::updateFingerprints() {
+    if (this->fingerprints.empty()) {
+        return Status::Done;
+    }
+
+    if (!this->database->setSongFingerprints(this->fingerprints)) {
+        Log::writeError("[SCAN] Couldn't store fingerprints in database");
+        return Status::ErrDatabase;
+    }
+    this->fingerprints.clear();
+    return Status::Ok;
+}
+
+size_t LibraryScanner::filesRemaining() {
+    return this->addFiles.size() + this->updateFiles.size() - this->nextFile;
+}
+
+LibraryScanner::Status LibraryScanner::processMetadata(std::atomic<size_t> & currentFile, std::atomic<size_t> & totalFiles, std::atomic<size_t> & estRemaining) {
+    // Set initial status values (continuing on from the last batch)
+    size_t total = this->addFiles.size() + this->updateFiles.size();
+    size_t end = std::min(this->nextFile + SCAN_BATCH_SIZE, total);
+    currentFile = this->nextFile + 1;
+    totalFiles = total;
+    std::atomic<Status> status{Status::Ok};
+    if (this->nextFile == 0) {
+        estRemaining = 0;
+    }
+
+    // Timer used to estimate remaining time (does nothing if already started by an earlier batch)
+    Utils::Timer & timer = this->metadataTimer;
+    timer.start();
+
+    // Each thread takes the next file to parse until none are left in the batch (or one fails), with
+    // files that need to be added handed out first, then those to be updated
+    std::atomic<size_t> nextIndex{this->nextFile};
+    auto parseFiles = [this, &currentFile, &totalFiles, &estRemaining, &status, &nextIndex, &timer, end]() {
+        size_t i;
+        while (status == Status::Ok && (i = nextIndex++) < end) {
+            Status result;
+            if (i < this->addFiles.size()) {
+                result = this->parseFileAdd(this->addFiles[i]);
+            } else {
+                result = this->parseFileUpdate(this->updateFiles[i - this->addFiles.size()]);
+            }
 
-            // Return if an error occurred
-            if (status != Status::Ok) {
-                Log::writeError("[SCAN] Error occurred during metadata scan");
-                return status;
+            // Stop all threads if an error occurred (keeping the first error)
+            if (result != Status::Ok) {
+                Status expected = Status::Ok;
+                status.compare_exchange_strong(expected, result);
+                return;
             }
+
+            // Increment counter and adjust remaining time
+            size_t done = currentFile++;
+            estRemaining = (timer.elapsedSeconds() / (double)done) * (totalFiles - done);
         }
+    };
+
+    // Parse on as many threads as there are cores (this thread being one of them)
+    unsigned int threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, (unsigned int)MAX_METADATA_THREADS);
+    std::vector< std::future<void> > threads;
+    for (unsigned int i = 1; i < threadCount; i++) {
+        threads.push_back(std::async(std::launch::async, parseFiles));
+    }
+    parseFiles();
+    for (std::future<void> & thread : threads) {
+        thread.get();
+    }
+
+    // Return if an error occurred
+    if (status != Status::Ok) {
+        Log::writeError("[SCAN] Error occurred during metadata scan");
+        return status;
     }
+    this->nextFile = end;
+
+    // Threads finish files in any order, so sort the results by path to keep the order
+    // they're inserted into the database the same as if they were parsed one at a time
+    auto comparator = [](const Metadata::Song & lhs, const Metadata::Song & rhs) {
+        return lhs.path < rhs.path;
+    };
+    std::sort(this->addMeta.begin(), this->addMeta.end(), comparator);
+    std::sort(this->updateMeta.begin(), this->updateMeta.end(), comparator);
 
     // We get here once all are completed and no error occurred
-    Log::writeSuccess("[SCAN] Song metadata processed successfully");
+    Log::writeSuccess("[SCAN] Song metadata processed successfully (" + std::to_string(end) + " of " + std::to_string(total) + " files)");
     return Status::Ok;
 }
 
 LibraryScanner::Status LibraryScanner::updateDatabase() {
-    // Add songs first
+    // The batch is stored in one transaction along with the journal's cursor, so if the scan is
+    // interrupted either all of it is stored (and marked as such) or none of it is
+    if (!this->database->beginTransaction()) {
+        Log::writeError("[SCAN] Couldn't begin a transaction to store the batch");
+        return Status::ErrDatabase;
+    }
+    auto fail = [this](const std::string & msg) {
+        this->database->rollbackTransaction();
+        Log::writeError("[SCAN] " + msg);
+        return Status::ErrDatabase;
+    };
+
+    // Move songs first (with the first batch), so their old paths are free before anything is added
+    for (size_t i = 0; i < this->moveFiles.size(); i++) {
+        const FileTuple & from = this->moveFiles[i].first;
+        const FileTuple & to = this->moveFiles[i].second;
+        std::string tmp = from.path;
+        SongID id = this->database->getSongIDForPath(tmp);
+        bool ok = (id >= 0 && this->database->moveSong(id, to.path, to.format, to.modifiedTime));
+        if (!ok) {
+            return fail("Error moving song: " + from.path + " -> " + to.path);
+        }
+    }
+
+    // Then add songs
     for (size_t i = 0; i < this->addMeta.size(); i++) {
         bool ok = this->database->addSong(this->addMeta[i]);
         if (!ok) {
-            Log::writeError("[SCAN] Error adding song: " + this->addMeta[i].path);
-            return Status::ErrDatabase;
+            return fail("Error adding song: " + this->addMeta[i].path);
         }
     }
 
@@ -272,11 +573,33 @@ LibraryScanner::Status LibraryScanner::updateDatabase() {
     for (size_t i = 0; i < this->updateMeta.size(); i++) {
         bool ok = this->database->updateSong(this->updateMeta[i]);
         if (!ok) {
-            Log::writeError("[SCAN] Error updating song: " + this->updateMeta[i].path);
-            return Status::ErrDatabase;
+            return fail("Error updating song: " + this->updateMeta[i].path);
         }
     }
 
+    // Advance the journal's cursor past this batch
+    std::vector<std::string> paths;
+    for (const std::vector<Metadata::Song> * vec : {&this->addMeta, &this->updateMeta}) {
+        for (const Metadata::Song & meta : *vec) {
+            paths.push_back(meta.path);
+        }
+    }
+    if (!paths.empty() && !this->database->setScanJournalStored(paths)) {
+        return fail("Couldn't mark batch as stored in the scan journal");
+    }
+
+    if (!this->database->commitTransaction()) {
+        return fail("Couldn't commit the batch to the database");
+    }
+    this->moveFiles.clear();
+    this->addMeta.clear();
+    this->updateMeta.clear();
+
+    // Everything else waits until the last batch has been stored
+    if (this->filesRemaining() > 0) {
+        return Status::Ok;
+    }
+
     // And finally remove songs
     bool ok = true;
     for (size_t i = 0; i < this->removeFiles.size(); i++) {
@@ -289,6 +612,23 @@ LibraryScanner::Status LibraryScanner::updateDatabase() {
         }
     }
 
+    // Refresh the planner's statistics now that the library has changed
+    if (!this->database->analyze()) {
+        Log::writeWarning("[SCAN] Unable to analyze the database, queries may be slower");
+    }
+
+    // Update smart playlists to include/exclude changed songs
+    if (!this->database->refreshSmartPlaylists()) {
+        Log::writeWarning("[SCAN] Unable to refresh smart playlists");
+    }
+
+    // Remember the state of each directory so unchanged ones can be skipped next time
+    // (not fatal as the next scan will just check every directory again)
+    this->updateDirectories();
+
+    // Same goes for the fingerprints, as they'll be calculated again
+    this->updateFingerprints();
+
     Log::writeSuccess("[SCAN] Database successfully updated");
     return Status::Ok;
 }
@@ -296,71 +636,129 @@ LibraryScanner::Status LibraryScanner::updateDatabase() {
 LibraryScanner::Status LibraryScanner::processArt(std::atomic<size_t> & currentFile) {
     // Initialize variables
     currentFile = 0;
+    this->albumImages.clear();
+    this->imagePalettes.clear();
 
-    // Map used to mark when an album has an image
-    // Album name -> bool
-    std::unordered_map<std::string, bool> hasImage;
+    // Get the songs stored by this scan (and any earlier scan which was interrupted)
+    bool dbOK;
+    std::vector<Metadata::Song> songs = this->database->getStoredScanJournalSongs(dbOK);
+    if (!dbOK) {
+        Log::writeError("[SCAN] Couldn't read the scan journal from database");
+        return Status::ErrDatabase;
+    }
 
-    // First get all the albums in the database and mark
+    // Find the albums which don't have an image yet
     std::vector<Metadata::Album> albums = this->database->getAllAlbumMetadata(Database::SortBy::AlbumAsc);
-    for (size_t i = 0; i < albums.size(); i++) {
-        hasImage[albums[i].name] = (!albums[i].imagePath.empty());
-    }
-
-    // Iterate over each song added/updated and search for an image if the album doesn't have one
-    std::vector<Metadata::Song> dummy;
-    for (size_t v = 0; v < 2; v++) {
-        // Pick vector based on 'v' (used to avoid repeating code)
-        std::vector<Metadata::Song> & vec = dummy;
-        switch (v) {
-            case 0:
-                vec = this->addMeta;
-                break;
-
-            case 1:
-                vec = this->updateMeta;
-                break;
-
-            default:
-                return Status::ErrUnknown;
+    std::unordered_map<std::string, AlbumID> needsImage;
+    for (const Metadata::Album & album : albums) {
+        if (album.imagePath.empty()) {
+            needsImage[album.name] = album.ID;
         }
+    }
 
-        for (size_t i = 0; i < vec.size(); i++) {
-            Metadata::Song meta = vec[i];
+    // Group the songs added/updated by album, as only one image is needed per album
+    // (each song is checked in turn until one contains an image)
+    std::vector< std::pair<AlbumID, std::vector<const Metadata::Song *> > > jobs;
+    std::unordered_map<AlbumID, size_t> jobIndex;
+    for (const Metadata::Song & meta : songs) {
+        std::unordered_map<std::string, AlbumID>::iterator it = needsImage.find(meta.album);
+        if (it == needsImage.end()) {
+            continue;
+        }
 
-            // Check this song for album art if the album does not yet have any
-            if (hasImage[meta.album]) {
-                continue;
-            }
-            std::string path = this->parseAlbumArt(meta);
+        if (jobIndex.count(it->second) == 0) {
+            jobIndex[it->second] = jobs.size();
+            jobs.push_back(std::make_pair(it->second, std::vector<const Metadata::Song *>()));
+        }
+        jobs[jobIndex[it->second]].second.push_back(&meta);
+    }
 
-            // If the image was written to the SD Card update database
-            if (path.empty()) {
-                continue;
-            }
-            SongID songID = this->database->getSongIDForPath(meta.path);
-            AlbumID albumID = this->database->getAlbumIDForSong(songID);
-            Status status = (songID >= 0 && albumID >= 0 ? Status::Ok : Status::ErrDatabase);
-            if (status == Status::Ok) {
-                Metadata::Album album = this->database->getAlbumMetadataForID(albumID);
-                status = (album.ID >= 0 ? Status::Ok : Status::ErrDatabase);
-                if (status == Status::Ok) {
-                    album.imagePath = path;
-                    status = (this->database->updateAlbum(album) ? Status::Ok : Status::ErrDatabase);
+    // Each thread takes the next album and writes its image (decoding and resizing
+    // are slow enough that the SD card isn't the bottleneck)
+    std::vector<std::string> paths(jobs.size());
+    std::atomic<size_t> nextJob{0};
+    auto extractArt = [this, &currentFile, &jobs, &paths, &nextJob]() {
+        size_t i;
+        while ((i = nextJob++) < jobs.size()) {
+            for (const Metadata::Song * meta : jobs[i].second) {
+                paths[i] = this->parseAlbumArt(*meta);
+                if (!paths[i].empty()) {
+                    currentFile++;
+                    break;
                 }
             }
+        }
+    };
+
+    // Runs the given function on each thread (including this one) until they've all returned
+    unsigned int threadCount = std::clamp(std::thread::hardware_concurrency(), 1u, (unsigned int)MAX_ART_THREADS);
+    auto runOnThreads = [threadCount](const auto & func) {
+        std::vector< std::future<void> > threads;
+        for (unsigned int i = 1; i < threadCount; i++) {
+            threads.push_back(std::async(std::launch::async, func));
+        }
+        func();
+        for (std::future<void> & thread : threads) {
+            thread.get();
+        }
+    };
+    runOnThreads(extractArt);
 
-            // Remove the image file if an error occurred and return
-            if (status != Status::Ok) {
-                Utils::Fs::deleteFile(path);
-                return status;
-            }
+    // Keep the paths so they can all be written to the database at once
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (!paths[i].empty()) {
+            this->albumImages.push_back(std::make_pair(jobs[i].first, paths[i]));
+        }
+    }
+    Log::writeSuccess("[SCAN] Found images for " + std::to_string(this->albumImages.size()) + " of " + std::to_string(jobs.size()) + " albums");
+
+    // Pick the player's colours from the new images (and any older ones without colours) now, so the player
+    // doesn't have to when the song changes. The smallest size of each image has more than enough pixels.
+    std::vector<std::string> palettePaths = this->database->getAlbumImagesWithoutPalette();
+    for (const std::pair<AlbumID, std::string> & image : this->albumImages) {
+        palettePaths.push_back(image.second);
+    }
+    std::sort(palettePaths.begin(), palettePaths.end());
+    palettePaths.erase(std::unique(palettePaths.begin(), palettePaths.end()), palettePaths.end());
+
+    std::vector<Metadata::Palette> palettes(palettePaths.size());
+    nextJob = 0;
+    runOnThreads([&palettePaths, &palettes, &nextJob]() {
+        size_t i;
+        while ((i = nextJob++) < palettePaths.size()) {
+            std::string path = Utils::Image::artPath(palettePaths[i], Utils::Image::ArtSize::Thumbnail);
+            palettes[i] = Utils::Splash::toMetadata(Utils::Splash::getPaletteForFile(path));
+        }
+    });
 
-            // Otherwise mark that the album has an image
-            currentFile++;
-            hasImage[meta.album] = true;
+    for (size_t i = 0; i < palettePaths.size(); i++) {
+        if (palettes[i].valid) {
+            this->imagePalettes.push_back(std::make_pair(palettePaths[i], palettes[i]));
         }
     }
+    Log::writeSuccess("[SCAN] Picked colours for " + std::to_string(this->imagePalettes.size()) + " of " + std::to_string(palettePaths.size()) + " images");
+    return Status::Ok;
+}
 
+LibraryScanner::Status LibraryScanner::updateArt() {
+    // The images aren't removed if they couldn't be stored, as other albums may be using them
+    if (!this->albumImages.empty() && !this->database->setAlbumImages(this->albumImages)) {
+        Log::writeError("[SCAN] Error storing album images in database");
+        this->albumImages.clear();
+        this->imagePalettes.clear();
+        return Status::ErrDatabase;
+    }
+    this->albumImages.clear();
+
+    // The player picks the colours itself if they're missing, so this isn't treated as an error
+    if (!this->imagePalettes.empty() && !this->database->setImagePalettes(this->imagePalettes)) {
+        Log::writeWarning("[SCAN] Unable to store album image colours in database");
+    }
+    this->imagePalettes.clear();
+
+    // The scan has finished (if the journal isn't cleared the next scan only rechecks these albums)
+    if (!this->database->clearScanJournal()) {
+        Log::writeWarning("[SCAN] Unable to clear the scan journal");
+    }
     return Status::Ok;
 }
\ No newline at end of file
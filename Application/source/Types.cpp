@@ -1,6 +1,6 @@
 #include "Types.hpp"
 
-AudioFormat audioFormatFromString(const std::string & str) {
+AudioFormat audioFormatFromString(const std::string_view str) {
     if (str == "FLAC") {
         return AudioFormat::FLAC;
 
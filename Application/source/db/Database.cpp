@@ -3,24 +3,67 @@
 #include "db/extensions/okapi_bm25.h"
 #include "db/extensions/Spellfix.h"
 #include "db/migrations/Migration.hpp"
+#include "db/SmartPlaylist.hpp"
 #include "Log.hpp"
+#include "PathIndex.hpp"
 #include "Paths.hpp"
+#include "PlayJournal.hpp"
 #include "utils/FS.hpp"
+#include "utils/Image.hpp"
 #include "utils/Search.hpp"
 #include "utils/Utils.hpp"
 
 // Version of the database (database begins with zero from 'template', so this started at 1)
-#define DB_VERSION 7
-// Maximum number of spellfixed words to allow per word (i.e. pick the top x words)
-#define SPELLFIX_LIMIT 6
+#define DB_VERSION 18
 // Location of template file
 #define TEMPLATE_DB_PATH "romfs:/db/template.sqlite3"
+// Number of songs to insert per statement when adding many to a playlist (one parameter each,
+// SQLite allows at most 999)
+#define PLAYLIST_BATCH_SIZE 500
 
 // Custom boolean 'operator' which instead of 'keeping' true, will 'keep' false
 bool keepFalse(const bool & a, const bool & b) {
     return !(!a || !b);
 }
 
+// Columns to select for a Metadata::Song (in the order read by readSong())
+#define SONG_COLUMNS "Songs.id, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified"
+
+// Reads a Metadata::Song from the current row of a query selecting SONG_COLUMNS
+bool readSong(SQLite * db, Metadata::Song & m) {
+    std::string_view format;
+    bool ok = db->getColumns(0, m.ID, m.title, m.artist, m.album, m.trackNumber, m.discNumber, m.duration, m.plays, m.favourite, m.path, format, m.modified);
+    m.format = audioFormatFromString(format);
+    return ok;
+}
+
+// Columns to select for a Metadata::Album (in the order read by readAlbum())
+// Needs artist_count and song_count columns, i.e. from AlbumStats
+#define ALBUM_COLUMNS "Albums.id, Albums.name, CASE WHEN artist_count > 1 THEN 'Various Artists' ELSE Artists.name END, Albums.tadb_id, Albums.image_path, song_count"
+
+// Reads a Metadata::Album from the current row of a query selecting ALBUM_COLUMNS
+bool readAlbum(SQLite * db, Metadata::Album & m) {
+    return db->getColumns(0, m.ID, m.name, m.artist, m.tadbID, m.imagePath, m.songCount);
+}
+
+// Columns to select for a Metadata::Artist (in the order read by readArtist())
+// Needs album_count and song_count columns, i.e. from ArtistStats
+#define ARTIST_COLUMNS "Artists.id, Artists.name, Artists.tadb_id, Artists.image_path, album_count, song_count"
+
+// Reads a Metadata::Artist from the current row of a query selecting ARTIST_COLUMNS
+bool readArtist(SQLite * db, Metadata::Artist & m) {
+    return db->getColumns(0, m.ID, m.name, m.tadbID, m.imagePath, m.albumCount, m.songCount);
+}
+
+// Columns to select for a Metadata::Playlist (in the order read by readPlaylist())
+// Needs PlaylistSongs to be left joined and the results grouped by playlist
+#define PLAYLIST_COLUMNS "Playlists.id, Playlists.name, Playlists.description, Playlists.image_path, COUNT(PlaylistSongs.song_id) AS song_count, EXISTS (SELECT 1 FROM SmartPlaylists WHERE SmartPlaylists.playlist_id = Playlists.id)"
+
+// Reads a Metadata::Playlist from the current row of a query selecting PLAYLIST_COLUMNS
+bool readPlaylist(SQLite * db, Metadata::Playlist & m) {
+    return db->getColumns(0, m.ID, m.name, m.description, m.imagePath, m.songCount, m.smart);
+}
+
 // Helper function called by sqlite3 to remove an entry's image
 void removeImage(sqlite3_context * pCtx, int argc, sqlite3_value ** argv) {
     // Get image_path string
@@ -39,6 +82,60 @@ void removeImage(sqlite3_context * pCtx, int argc, sqlite3_value ** argv) {
     Utils::Fs::deleteFile(string);
 }
 
+// Helper function called by sqlite3 to convert text into a string of trigrams (which is then indexed)
+void trigrams(sqlite3_context * pCtx, int argc, sqlite3_value ** argv) {
+    if (argc < 1) {
+        return;
+    }
+    const unsigned char * tmp = sqlite3_value_text(argv[0]);
+    std::string string = (tmp == nullptr ? "" : (char *)tmp);
+
+    // Join trigrams with a space so each is tokenized separately
+    std::vector<std::string> trigrams = Utils::Search::getTrigrams(string);
+    std::string result = "";
+    for (size_t i = 0; i < trigrams.size(); i++) {
+        result += (i == 0 ? "" : " ") + trigrams[i];
+    }
+    sqlite3_result_text(pCtx, result.c_str(), result.length(), SQLITE_TRANSIENT);
+}
+
+// Helper function called by sqlite3 to convert text into a key which is sorted on
+void sortKey(sqlite3_context * pCtx, int argc, sqlite3_value ** argv) {
+    if (argc < 1) {
+        return;
+    }
+    const unsigned char * tmp = sqlite3_value_text(argv[0]);
+    std::string key = Utils::sortKey(tmp == nullptr ? "" : (char *)tmp);
+    sqlite3_result_text(pCtx, key.c_str(), key.length(), SQLITE_TRANSIENT);
+}
+
+// Helper function called by sqlite3 which returns the percentage of phrases matched by a row
+// Expects the output of matchinfo() with at least 'pcx'
+void matchPercent(sqlite3_context * pCtx, int argc, sqlite3_value ** argv) {
+    if (argc < 1) {
+        return;
+    }
+    const unsigned int * info = (const unsigned int *)sqlite3_value_blob(argv[0]);
+    if (info == nullptr || info[0] == 0) {
+        sqlite3_result_int(pCtx, 0);
+        return;
+    }
+
+    // A phrase is matched if it has a hit in any column of this row
+    unsigned int phrases = info[0];
+    unsigned int cols = info[1];
+    unsigned int matched = 0;
+    for (unsigned int p = 0; p < phrases; p++) {
+        for (unsigned int c = 0; c < cols; c++) {
+            if (info[2 + 3*(p*cols + c)] > 0) {
+                matched++;
+                break;
+            }
+        }
+    }
+    sqlite3_result_int(pCtx, (100 * matched)/phrases);
+}
+
 // ===== Housekeeping ===== //
 Database::Database() {
     // Copy the template if the database doesn't exist
@@ -55,16 +152,31 @@ Database::Database() {
     this->db = new SQLite(Path::Common::DatabaseFile);
     this->db->ignoreConstraints(true);
 
-    // Load the spellfix1 extension
+    // Load the spellfix1 extension (no longer used but required to drop the old tables when migrating)
     sqlite3_auto_extension((void (*)(void))sqlite3_spellfix_init);
     // Load the okapi_bm25 extension
     sqlite3_auto_extension((void (*)(void))sqlite3_okapi_bm25_init);
 
     // Set variables
     this->error_ = "";
-    this->searchPhrases = 8;
-    this->searchScore = 130;
-    this->updateMarked = false;
+    this->searchMatch = 50;
+    this->searchInterrupts = 0;
+    this->searchStart = 0;
+    this->pathIndexOutdated = true;
+}
+
+bool Database::analyze() {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[analyze] Can't analyze as the database is unwritable");
+        return false;
+    }
+
+    bool ok = this->db->prepareAndExecuteQuery("ANALYZE;");
+    if (!ok) {
+        this->setErrorMsg("[analyze] Unable to analyze the database");
+    }
+    return ok;
 }
 
 std::string Database::error() {
@@ -167,6 +279,94 @@ bool Database::migrate() {
                     break;
                 }
                 Log::writeSuccess("[DB] Migrated to version 7");
+
+            case 7:
+                err = Migration::migrateTo8(this->db);
+                if (!err.empty()) {
+                    err = "Migration 8: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 8");
+
+            case 8:
+                err = Migration::migrateTo9(this->db);
+                if (!err.empty()) {
+                    err = "Migration 9: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 9");
+
+            case 9:
+                err = Migration::migrateTo10(this->db);
+                if (!err.empty()) {
+                    err = "Migration 10: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 10");
+
+            case 10:
+                err = Migration::migrateTo11(this->db);
+                if (!err.empty()) {
+                    err = "Migration 11: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 11");
+
+            case 11:
+                err = Migration::migrateTo12(this->db);
+                if (!err.empty()) {
+                    err = "Migration 12: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 12");
+
+            case 12:
+                err = Migration::migrateTo13(this->db);
+                if (!err.empty()) {
+                    err = "Migration 13: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 13");
+
+            case 13:
+                err = Migration::migrateTo14(this->db);
+                if (!err.empty()) {
+                    err = "Migration 14: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 14");
+
+            case 14:
+                err = Migration::migrateTo15(this->db);
+                if (!err.empty()) {
+                    err = "Migration 15: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 15");
+
+            case 15:
+                err = Migration::migrateTo16(this->db);
+                if (!err.empty()) {
+                    err = "Migration 16: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 16");
+
+            case 16:
+                err = Migration::migrateTo17(this->db);
+                if (!err.empty()) {
+                    err = "Migration 17: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 17");
+
+            case 17:
+                err = Migration::migrateTo18(this->db);
+                if (!err.empty()) {
+                    err = "Migration 18: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 18");
         }
     }
 
@@ -194,12 +394,25 @@ bool Database::migrate() {
     return ok;
 }
 
-void Database::setSearchPhraseCount(const unsigned int p) {
-    this->searchPhrases = p;
+void Database::setSearchMatchPercent(const unsigned int p) {
+    this->searchMatch = p;
+}
+
+void Database::setReadCache(const unsigned int kb) {
+    this->db->setReadCache(kb);
+}
+
+int Database::searchProgress(void * data) {
+    Database * db = static_cast<Database *>(data);
+    return (db->searchInterrupts != db->searchStart ? 1 : 0);
 }
 
-void Database::setSpellfixScore(const unsigned int s) {
-    this->searchScore = s;
+unsigned int Database::searchToken() {
+    return this->searchInterrupts;
+}
+
+void Database::interruptSearch() {
+    this->searchInterrupts++;
 }
 
 void Database::setErrorMsg(const std::string & msg = "") {
@@ -265,68 +478,26 @@ bool Database::getVersion(int & version) {
     return ok;
 }
 
-bool Database::setSearchUpdate(int val) {
-    // Skip if already set
-    if (this->updateMarked && val != 0) {
-        return true;
-    }
-
-    bool ok = this->db->prepareQuery("UPDATE Variables SET value = ? WHERE name = 'search_update';");
-    ok = keepFalse(ok, this->db->bindInt(0, val));
-    ok = keepFalse(ok, this->db->executeQuery());
-    if (!ok) {
-        this->setErrorMsg("[setSearchUpdate] Updating the search_update variable failed");
-    }
-
-    // Set as marked if not 0
-    if (ok) {
-        this->updateMarked = (val != 0);
-    }
-
-    return ok;
-}
-
-std::vector<std::string> Database::getSearchPhrases(const std::string & table, std::string & str) {
-    // Split string into words
-    std::vector<std::string> words = Utils::splitIntoWords(str, ' ');
-    str = "";
-
-    // Get word suggestions for each word and store associated score
-    std::vector< std::vector<Utils::Search::ScoredString> > suggestions;
-    for (size_t i = 0; i < words.size(); i++) {
-        // Use string concatenation here as you can't bind a table name (I know it's not ideal but the names are hard coded at least)
-        bool ok = this->db->prepareQuery("SELECT word, score FROM " + table + " WHERE word MATCH ? AND SCORE < ? LIMIT ?;");
-        ok = keepFalse(ok, this->db->bindString(0, words[i]));
-        ok = keepFalse(ok, this->db->bindInt(1, this->searchScore));
-        ok = keepFalse(ok, this->db->bindInt(2, SPELLFIX_LIMIT));
-        ok = keepFalse(ok, this->db->executeQuery());
-        if (!ok) {
-            this->setErrorMsg("Error performing spell check");
-        }
-
-        // Push returned words onto vector
-        std::vector<Utils::Search::ScoredString> fixed;
-        while (ok && this->db->hasRow()) {
-            Utils::Search::ScoredString word;
-            ok = keepFalse(ok, this->db->getString(0, word.string));
-            ok = keepFalse(ok, this->db->getInt(1, word.score));
-
-            if (ok) {
-                fixed.push_back(word);
-            }
-            ok = keepFalse(ok, this->db->nextRow());
+std::string Database::getSearchQuery(const std::string & str) {
+    // Search for any of the input's unique trigrams
+    std::vector<std::string> trigrams = Utils::removeDuplicates(Utils::Search::getTrigrams(str));
+    std::string query = "";
+    for (size_t i = 0; i < trigrams.size(); i++) {
+        if (i > 0) {
+            query += " OR ";
         }
-
-        // Return empty vector if no appropriate words are found
-        if (fixed.empty()) {
-            return std::vector<std::string>();
+        query += trigrams[i];
+
+        // Words shorter than a trigram are matched as a prefix, so that partially typed words still find results
+        size_t chars = std::count_if(trigrams[i].begin(), trigrams[i].end(), [](const char c) {
+            return ((c & 0xC0) != 0x80);
+        });
+        if (chars < 3) {
+            query += "*";
         }
-
-        suggestions.push_back(fixed);
     }
 
-    // Get top number of phrases (sorted best first)
-    return Utils::Search::getPhrases(suggestions, this->searchPhrases);
+    return query;
 }
 
 // ===== Connection Management ===== //
@@ -334,6 +505,9 @@ bool Database::openReadWrite() {
     bool ok = this->db->openConnection(SQLite::Connection::ReadWrite);
     if (ok) {
         ok = keepFalse(ok, this->db->createFunction("removeImage", removeImage, nullptr));
+        ok = keepFalse(ok, this->db->createFunction("trigrams", trigrams, nullptr));
+        ok = keepFalse(ok, this->db->createFunction("sortKey", sortKey, nullptr));
+        ok = keepFalse(ok, this->db->createFunction("matchPercent", matchPercent, nullptr));
     }
     return ok;
 }
@@ -342,6 +516,9 @@ bool Database::openReadOnly() {
     bool ok = this->db->openConnection(SQLite::Connection::ReadOnly);
     if (ok) {
         ok = keepFalse(ok, this->db->createFunction("removeImage", removeImage, nullptr));
+        ok = keepFalse(ok, this->db->createFunction("trigrams", trigrams, nullptr));
+        ok = keepFalse(ok, this->db->createFunction("sortKey", sortKey, nullptr));
+        ok = keepFalse(ok, this->db->createFunction("matchPercent", matchPercent, nullptr));
     }
     return ok;
 }
@@ -350,6 +527,36 @@ void Database::close() {
     this->db->closeConnection();
 }
 
+bool Database::beginTransaction() {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[beginTransaction] Can't begin a transaction as the database is unwritable");
+        return false;
+    }
+
+    bool ok = this->db->beginTransaction();
+    if (!ok) {
+        this->setErrorMsg("[beginTransaction] Unable to begin a transaction");
+    }
+    return ok;
+}
+
+bool Database::commitTransaction() {
+    bool ok = this->db->commitTransaction();
+    if (!ok) {
+        this->setErrorMsg("[commitTransaction] Unable to commit the transaction");
+    }
+    return ok;
+}
+
+bool Database::rollbackTransaction() {
+    bool ok = this->db->rollbackTransaction();
+    if (!ok) {
+        this->setErrorMsg("[rollbackTransaction] Unable to rollback the transaction");
+    }
+    return ok;
+}
+
 // ===== Album Metadata ===== //
 bool Database::updateAlbum(Metadata::Album m) {
     // First check we have write permission
@@ -360,10 +567,7 @@ bool Database::updateAlbum(Metadata::Album m) {
 
     // Now update relevant fields
     bool ok = this->db->prepareQuery("UPDATE Albums SET name = ?, tadb_id = ?, image_path = ? WHERE id = ?;");
-    ok = keepFalse(ok, this->db->bindString(0, m.name));
-    ok = keepFalse(ok, this->db->bindInt(1, m.tadbID));
-    ok = keepFalse(ok, this->db->bindString(2, m.imagePath));
-    ok = keepFalse(ok, this->db->bindInt(3, m.ID));
+    ok = keepFalse(ok, this->db->bindValues(0, m.name, m.tadbID, m.imagePath, m.ID));
     if (!ok) {
         this->setErrorMsg("[updateAlbum] An error occurred while preparing the statement");
         return false;
@@ -378,14 +582,38 @@ bool Database::updateAlbum(Metadata::Album m) {
         if (Log::loggingLevel() == Log::Level::Info) {
             Log::writeInfo("[DB] [updateAlbum] '" + m.name + "' was updated");
         }
+        this->pathIndexOutdated = true;
     }
     this->db->ignoreConstraints(true);
 
-    // Mark search tables as out of date
-    if (ok) {
-        ok = this->setSearchUpdate(1);
+    return ok;
+}
+
+bool Database::setAlbumImages(const std::vector< std::pair<AlbumID, std::string> > & images) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[setAlbumImages] Can't update albums as the database is unwritable");
+        return false;
+    }
+
+    // Update each album within one transaction so there's only one commit
+    bool ok = this->db->beginTransaction();
+    for (size_t i = 0; ok && i < images.size(); i++) {
+        ok = this->db->prepareQuery("UPDATE Albums SET image_path = ? WHERE id = ?;");
+        ok = keepFalse(ok, this->db->bindValues(0, images[i].second, images[i].first));
+        ok = keepFalse(ok, this->db->executeQuery());
     }
 
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[setAlbumImages] An error occurred updating the albums");
+    } else {
+        this->pathIndexOutdated = true;
+    }
     return ok;
 }
 
@@ -402,49 +630,42 @@ std::vector<Metadata::Album> Database::getAllAlbumMetadata(Database::SortBy sort
     switch (sort) {
         case Database::SortBy::AlbumAsc:
         default:
-            orderBy = "Albums.name ASC";
+            orderBy = "Albums.sort_name ASC";
             break;
 
         case Database::SortBy::AlbumDsc:
-            orderBy = "Albums.name DESC";
+            orderBy = "Albums.sort_name DESC";
             break;
 
         case Database::SortBy::ArtistAsc:
-            orderBy = "artist_name ASC, Albums.name ASC";
+            orderBy = "artist_sort ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::ArtistDsc:
-            orderBy = "artist_name DESC, Albums.name ASC";
+            orderBy = "artist_sort DESC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::SongsAsc:
-            orderBy = "song_count ASC, Albums.name ASC";
+            orderBy = "song_count ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::SongsDsc:
-            orderBy = "song_count DESC, Albums.name ASC";
+            orderBy = "song_count DESC, Albums.sort_name ASC";
             break;
     }
 
     // Create a Metadata::Album for each entry
-    bool ok = this->db->prepareAndExecuteQuery("SELECT album_id, Albums.name, CASE WHEN COUNT(DISTINCT artist_id) > 1 THEN 'Various Artists' ELSE Artists.name END AS artist_name, Albums.tadb_id, Albums.image_path, COUNT(*) AS song_count FROM Songs JOIN Albums ON Songs.album_id = Albums.id JOIN Artists ON Songs.artist_id = Artists.id GROUP BY album_id ORDER BY " + orderBy + ";");
+    bool ok = this->db->prepareAndExecuteQuery("SELECT " ALBUM_COLUMNS ", CASE WHEN artist_count > 1 THEN 'various artists' ELSE Artists.sort_name END AS artist_sort FROM AlbumStats JOIN Albums ON AlbumStats.album_id = Albums.id JOIN Artists ON AlbumStats.artist_id = Artists.id ORDER BY " + orderBy + ";");
     if (!ok) {
         this->setErrorMsg("[getAllAlbumMetadata] Unable to query for all albums");
         return v;
     }
     while (ok && this->db->hasRow()) {
         Metadata::Album m;
-        ok = this->db->getInt(0, m.ID);
-        ok = keepFalse(ok, this->db->getString(1, m.name));
-        ok = keepFalse(ok, this->db->getString(2, m.artist));
-        ok = keepFalse(ok, this->db->getInt(3, m.tadbID));
-        ok = keepFalse(ok, this->db->getString(4, m.imagePath));
-        int tmp;
-        ok = keepFalse(ok, this->db->getInt(5, tmp));
-        m.songCount = tmp;
+        ok = readAlbum(this->db, m);
 
         if (ok) {
-            v.push_back(m);
+            v.push_back(std::move(m));
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -463,22 +684,14 @@ Metadata::Album Database::getAlbumMetadataForID(AlbumID id) {
     }
 
     // Create a Metadata::Album
-    bool ok = this->db->prepareQuery("SELECT album_id, Albums.name, CASE WHEN COUNT(DISTINCT artist_id) > 1 THEN 'Various Artists' ELSE Artists.name END, Albums.tadb_id, Albums.image_path, COUNT(*) FROM Songs JOIN Albums ON Songs.album_id = Albums.id JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.album_id = ? GROUP BY Songs.album_id;");
+    bool ok = this->db->prepareQuery("SELECT " ALBUM_COLUMNS " FROM AlbumStats JOIN Albums ON AlbumStats.album_id = Albums.id JOIN Artists ON AlbumStats.artist_id = Artists.id WHERE album_id = ?;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
         this->setErrorMsg("[getAlbumMetadataForID] An error occurred querying for info");
         return m;
     }
-    int tmp;
-    ok = this->db->getInt(0, m.ID);
-    ok = keepFalse(ok, this->db->getString(1, m.name));
-    ok = keepFalse(ok, this->db->getString(2, m.artist));
-    ok = keepFalse(ok, this->db->getInt(3, m.tadbID));
-    ok = keepFalse(ok, this->db->getString(4, m.imagePath));
-    ok = keepFalse(ok, this->db->getInt(5, tmp));
-    m.songCount = tmp;
-
+    ok = readAlbum(this->db, m);
     if (!ok) {
         this->setErrorMsg("[getAlbumMetadataForID] An error occurred reading from the query results");
         m.ID = -1;
@@ -501,24 +714,25 @@ std::vector<Metadata::Album> Database::getAlbumMetadataForArtist(ArtistID id, Da
     switch (sort) {
         case Database::SortBy::AlbumAsc:
         default:
-            orderBy = "Albums.name ASC";
+            orderBy = "Albums.sort_name ASC";
             break;
 
         case Database::SortBy::AlbumDsc:
-            orderBy = "Albums.name DESC";
+            orderBy = "Albums.sort_name DESC";
             break;
 
         case Database::SortBy::SongsAsc:
-            orderBy = "song_count ASC, Albums.name ASC";
+            orderBy = "song_count ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::SongsDsc:
-            orderBy = "song_count DESC, Albums.name ASC";
+            orderBy = "song_count DESC, Albums.sort_name ASC";
             break;
     }
 
-    // Create a Metadata::Album (note this query won't ever return 'Various Artists' as the artist but that's alright seeing how we're querying for an artist)
-    bool ok = this->db->prepareQuery("SELECT album_id, Albums.name, Artists.name, Albums.tadb_id, Albums.image_path, COUNT(*) AS song_count FROM Songs JOIN Albums ON Songs.album_id = Albums.id JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.artist_id = ? GROUP BY Songs.album_id ORDER BY " + orderBy + ";");
+    // Create a Metadata::Album, counting only the artist's songs on each album (so the artist is never 'Various Artists',
+    // but that's alright seeing how we're querying for an artist)
+    bool ok = this->db->prepareQuery("SELECT " ALBUM_COLUMNS " FROM (SELECT album_id, artist_id, 1 AS artist_count, COUNT(*) AS song_count FROM Songs WHERE artist_id = ? GROUP BY album_id) JOIN Albums ON album_id = Albums.id JOIN Artists ON artist_id = Artists.id ORDER BY " + orderBy + ";");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -527,17 +741,10 @@ std::vector<Metadata::Album> Database::getAlbumMetadataForArtist(ArtistID id, Da
     }
     while (ok && this->db->hasRow()) {
         Metadata::Album m;
-        int tmp;
-        ok = this->db->getInt(0, m.ID);
-        ok = keepFalse(ok, this->db->getString(1, m.name));
-        ok = keepFalse(ok, this->db->getString(2, m.artist));
-        ok = keepFalse(ok, this->db->getInt(3, m.tadbID));
-        ok = keepFalse(ok, this->db->getString(4, m.imagePath));
-        ok = keepFalse(ok, this->db->getInt(5, tmp));
-        m.songCount = tmp;
+        ok = readAlbum(this->db, m);
 
         if (ok) {
-            v.push_back(m);
+            v.push_back(std::move(m));
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -555,10 +762,7 @@ bool Database::updateArtist(Metadata::Artist m) {
 
     // Now update relevant fields
     bool ok = this->db->prepareQuery("UPDATE Artists SET name = ?, tadb_id = ?, image_path = ? WHERE id = ?;");
-    ok = keepFalse(ok, this->db->bindString(0, m.name));
-    ok = keepFalse(ok, this->db->bindInt(1, m.tadbID));
-    ok = keepFalse(ok, this->db->bindString(2, m.imagePath));
-    ok = keepFalse(ok, this->db->bindInt(3, m.ID));
+    ok = keepFalse(ok, this->db->bindValues(0, m.name, m.tadbID, m.imagePath, m.ID));
     if (!ok) {
         this->setErrorMsg("[updateArtist] An error occurred while preparing the statement");
         return false;
@@ -573,14 +777,10 @@ bool Database::updateArtist(Metadata::Artist m) {
         if (Log::loggingLevel() == Log::Level::Info) {
             Log::writeInfo("[DB] [updateArtist] '" + m.name + "' was updated");
         }
+        this->pathIndexOutdated = true;
     }
     this->db->ignoreConstraints(true);
 
-    // Mark search tables as out of date
-    if (ok) {
-        ok = this->setSearchUpdate(1);
-    }
-
     return ok;
 }
 
@@ -597,50 +797,42 @@ std::vector<Metadata::Artist> Database::getAllArtistMetadata(Database::SortBy so
     switch (sort) {
         case Database::SortBy::ArtistAsc:
         default:
-            orderBy = "Artists.name ASC";
+            orderBy = "Artists.sort_name ASC";
             break;
 
         case Database::SortBy::ArtistDsc:
-            orderBy = "Artists.name DESC";
+            orderBy = "Artists.sort_name DESC";
             break;
 
         case Database::SortBy::AlbumsAsc:
-            orderBy = "album_count ASC, Artists.name ASC";
+            orderBy = "album_count ASC, Artists.sort_name ASC";
             break;
 
         case Database::SortBy::AlbumsDsc:
-            orderBy = "album_count DESC, Artists.name ASC";
+            orderBy = "album_count DESC, Artists.sort_name ASC";
             break;
 
         case Database::SortBy::SongsAsc:
-            orderBy = "song_count ASC, Artists.name ASC";
+            orderBy = "song_count ASC, Artists.sort_name ASC";
             break;
 
         case Database::SortBy::SongsDsc:
-            orderBy = "song_count DESC, Artists.name ASC";
+            orderBy = "song_count DESC, Artists.sort_name ASC";
             break;
     }
 
     // Create a Metadata::Artist for each entry
-    bool ok = this->db->prepareAndExecuteQuery("SELECT artist_id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id) AS album_count, COUNT(*) AS song_count FROM Songs JOIN Artists ON Songs.artist_id = Artists.id GROUP BY artist_id ORDER BY " + orderBy + ";");
+    bool ok = this->db->prepareAndExecuteQuery("SELECT " ARTIST_COLUMNS " FROM ArtistStats JOIN Artists ON ArtistStats.artist_id = Artists.id ORDER BY " + orderBy + ";");
     if (!ok) {
         this->setErrorMsg("[getAllArtists] Unable to query for all artists");
         return v;
     }
     while (ok && this->db->hasRow()) {
         Metadata::Artist m;
-        ok = this->db->getInt(0, m.ID);
-        ok = keepFalse(ok, this->db->getString(1, m.name));
-        ok = keepFalse(ok, this->db->getInt(2, m.tadbID));
-        ok = keepFalse(ok, this->db->getString(3, m.imagePath));
-        int tmp;
-        ok = keepFalse(ok, this->db->getInt(4, tmp));
-        m.albumCount = tmp;
-        ok = keepFalse(ok, this->db->getInt(5, tmp));
-        m.songCount = tmp;
+        ok = readArtist(this->db, m);
 
         if (ok) {
-            v.push_back(m);
+            v.push_back(std::move(m));
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -656,8 +848,8 @@ std::vector<Metadata::Artist> Database::getArtistMetadataForAlbum(AlbumID id) {
         return v;
     }
 
-    // Create a Metadata::Artist for each entry (note this query won't ever return more than '1' as the number of albums as we're querying for a single album)
-    bool ok = this->db->prepareQuery("SELECT artist_id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id), COUNT(*) FROM Songs JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.album_id = ? GROUP BY artist_id ORDER BY Artists.name;");
+    // Create a Metadata::Artist for each entry, counting only their songs on the album (so the number of albums is always '1')
+    bool ok = this->db->prepareQuery("SELECT " ARTIST_COLUMNS " FROM (SELECT artist_id, 1 AS album_count, COUNT(*) AS song_count FROM Songs WHERE album_id = ? GROUP BY artist_id) JOIN Artists ON artist_id = Artists.id ORDER BY Artists.sort_name;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -666,18 +858,10 @@ std::vector<Metadata::Artist> Database::getArtistMetadataForAlbum(AlbumID id) {
     }
     while (ok && this->db->hasRow()) {
         Metadata::Artist m;
-        ok = this->db->getInt(0, m.ID);
-        ok = keepFalse(ok, this->db->getString(1, m.name));
-        ok = keepFalse(ok, this->db->getInt(2, m.tadbID));
-        ok = keepFalse(ok, this->db->getString(3, m.imagePath));
-        int tmp;
-        ok = keepFalse(ok, this->db->getInt(4, tmp));
-        m.albumCount = tmp;
-        ok = keepFalse(ok, this->db->getInt(5, tmp));
-        m.songCount = tmp;
+        ok = readArtist(this->db, m);
 
         if (ok) {
-            v.push_back(m);
+            v.push_back(std::move(m));
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -696,22 +880,14 @@ Metadata::Artist Database::getArtistMetadataForID(ArtistID id) {
     }
 
     // Create a Metadata::Artist for each entry
-    bool ok = this->db->prepareQuery("SELECT artist_id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id), COUNT(*) FROM Songs JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.artist_id = ?;");
+    bool ok = this->db->prepareQuery("SELECT " ARTIST_COLUMNS " FROM ArtistStats JOIN Artists ON ArtistStats.artist_id = Artists.id WHERE artist_id = ?;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
         this->setErrorMsg("[getArtistMetadataForID] An error occurred querying for info");
         return m;
     }
-    int tmp;
-    ok = this->db->getInt(0, m.ID);
-    ok = keepFalse(ok, this->db->getString(1, m.name));
-    ok = keepFalse(ok, this->db->getInt(2, m.tadbID));
-    ok = keepFalse(ok, this->db->getString(3, m.imagePath));
-    ok = keepFalse(ok, this->db->getInt(4, tmp));
-    m.albumCount = tmp;
-    ok = keepFalse(ok, this->db->getInt(5, tmp));
-    m.songCount = tmp;
+    ok = readArtist(this->db, m);
     if (!ok) {
         this->setErrorMsg("[getArtistMetadataForID] An error occurred reading from the query results");
         m.ID = -1;
@@ -730,9 +906,7 @@ bool Database::addPlaylist(Metadata::Playlist m) {
 
     // Prepare query
     bool ok = this->db->prepareQuery("INSERT INTO Playlists (name, description, image_path) VALUES (?, ?, ?);");
-    ok = keepFalse(ok, this->db->bindString(0, m.name));
-    ok = keepFalse(ok, this->db->bindString(1, m.description));
-    ok = keepFalse(ok, this->db->bindString(2, m.imagePath));
+    ok = keepFalse(ok, this->db->bindValues(0, m.name, m.description, m.imagePath));
     if (!ok) {
         this->setErrorMsg("[addPlaylist] An error occurred while preparing the statement");
         return false;
@@ -748,11 +922,6 @@ bool Database::addPlaylist(Metadata::Playlist m) {
         }
     }
 
-    // Mark search tables as out of date
-    if (ok) {
-        ok = this->setSearchUpdate(1);
-    }
-
     return ok;
 }
 
@@ -765,10 +934,7 @@ bool Database::updatePlaylist(Metadata::Playlist m) {
 
     // Prepare query
     bool ok = this->db->prepareQuery("UPDATE Playlists SET name = ?, description = ?, image_path = ? WHERE id = ?;");
-    ok = keepFalse(ok, this->db->bindString(0, m.name));
-    ok = keepFalse(ok, this->db->bindString(1, m.description));
-    ok = keepFalse(ok, this->db->bindString(2, m.imagePath));
-    ok = keepFalse(ok, this->db->bindInt(3, m.ID));
+    ok = keepFalse(ok, this->db->bindValues(0, m.name, m.description, m.imagePath, m.ID));
     if (!ok) {
         this->setErrorMsg("[updatePlaylist] An error occurred while preparing the statement");
     }
@@ -783,11 +949,6 @@ bool Database::updatePlaylist(Metadata::Playlist m) {
         }
     }
 
-    // Mark search tables as out of date
-    if (ok) {
-        ok = this->setSearchUpdate(1);
-    }
-
     return ok;
 }
 
@@ -810,11 +971,6 @@ bool Database::removePlaylist(PlaylistID id) {
         this->setErrorMsg("[removePlaylist] An error occurred removing the playlist");
     }
 
-    // Mark search tables as out of date
-    if (ok) {
-        ok = this->setSearchUpdate(1);
-    }
-
     return ok;
 }
 
@@ -831,40 +987,34 @@ std::vector<Metadata::Playlist> Database::getAllPlaylistMetadata(Database::SortB
     switch (sort) {
         case Database::SortBy::TitleAsc:
         default:
-            orderBy = "name ASC, song_count ASC";
+            orderBy = "sort_name ASC, song_count ASC";
             break;
 
         case Database::SortBy::TitleDsc:
-            orderBy = "name DESC, song_count ASC";
+            orderBy = "sort_name DESC, song_count ASC";
             break;
 
         case Database::SortBy::SongsAsc:
-            orderBy = "song_count ASC, name ASC";
+            orderBy = "song_count ASC, sort_name ASC";
             break;
 
         case Database::SortBy::SongsDsc:
-            orderBy = "song_count DESC, name ASC";
+            orderBy = "song_count DESC, sort_name ASC";
             break;
     }
 
     // Create a Metadata::Playlist for each entry
-    bool ok = this->db->prepareAndExecuteQuery("SELECT id, name, description, image_path, COUNT(PlaylistSongs.song_id) AS song_count FROM Playlists LEFT JOIN PlaylistSongs ON playlist_id = Playlists.id GROUP BY Playlists.id ORDER BY " + orderBy + ";");
+    bool ok = this->db->prepareAndExecuteQuery("SELECT " PLAYLIST_COLUMNS " FROM Playlists LEFT JOIN PlaylistSongs ON playlist_id = Playlists.id GROUP BY Playlists.id ORDER BY " + orderBy + ";");
     if (!ok) {
         this->setErrorMsg("[getAllPlaylistMetadata] Unable to query for all playlists");
         return v;
     }
     while (ok && this->db->hasRow()) {
         Metadata::Playlist m;
-        int tmp;
-        ok = this->db->getInt(0, m.ID);
-        ok = keepFalse(ok, this->db->getString(1, m.name));
-        ok = keepFalse(ok, this->db->getString(2, m.description));
-        ok = keepFalse(ok, this->db->getString(3, m.imagePath));
-        ok = keepFalse(ok, this->db->getInt(4, tmp));
-        m.songCount = tmp;
+        ok = readPlaylist(this->db, m);
 
         if (ok) {
-            v.push_back(m);
+            v.push_back(std::move(m));
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -883,21 +1033,14 @@ Metadata::Playlist Database::getPlaylistMetadataForID(PlaylistID id) {
     }
 
     // Query for playlist info
-    bool ok = this->db->prepareQuery("SELECT id, name, description, image_path, COUNT(PlaylistSongs.song_id) FROM Playlists LEFT JOIN PlaylistSongs ON playlist_id = Playlists.id WHERE id = ?;");
+    bool ok = this->db->prepareQuery("SELECT " PLAYLIST_COLUMNS " FROM Playlists LEFT JOIN PlaylistSongs ON playlist_id = Playlists.id WHERE id = ?;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
         this->setErrorMsg("[getPlaylistMetadataForID] An error occurred querying for info");
         return m;
     }
-    int tmp;
-    ok = this->db->getInt(0, m.ID);
-    ok = keepFalse(ok, this->db->getString(1, m.name));
-    ok = keepFalse(ok, this->db->getString(2, m.description));
-    ok = keepFalse(ok, this->db->getString(3, m.imagePath));
-    ok = keepFalse(ok, this->db->getInt(4, tmp));
-    m.songCount = tmp;
-
+    ok = readPlaylist(this->db, m);
     if (!ok) {
         this->setErrorMsg("[getPlaylistMetadataForID] An error occurred reading from the query results");
         m.ID = -1;
@@ -920,40 +1063,40 @@ std::vector<Metadata::PlaylistSong> Database::getSongMetadataForPlaylist(Playlis
     switch (sort) {
         case Database::SortBy::TitleAsc:
         default:
-            orderBy = "Songs.title ASC, Artists.name ASC, Albums.name ASC";
+            orderBy = "Songs.sort_title ASC, Artists.sort_name ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::TitleDsc:
-            orderBy = "Songs.title DESC, Artists.name ASC, Albums.name ASC";
+            orderBy = "Songs.sort_title DESC, Artists.sort_name ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::ArtistAsc:
-            orderBy = "Artists.name ASC, Songs.title ASC";
+            orderBy = "Artists.sort_name ASC, Songs.sort_title ASC";
             break;
 
         case Database::SortBy::ArtistDsc:
-            orderBy = "Artists.name DESC, Songs.title ASC";
+            orderBy = "Artists.sort_name DESC, Songs.sort_title ASC";
             break;
 
         case Database::SortBy::AlbumAsc:
-            orderBy = "Albums.name ASC, Songs.title ASC";
+            orderBy = "Albums.sort_name ASC, Songs.sort_title ASC";
             break;
 
         case Database::SortBy::AlbumDsc:
-            orderBy = "Albums.name DESC, Songs.title ASC";
+            orderBy = "Albums.sort_name DESC, Songs.sort_title ASC";
             break;
 
         case Database::SortBy::LengthAsc:
-            orderBy = "Songs.duration ASC, Songs.title ASC, Artists.name ASC, Albums.name ASC";
+            orderBy = "Songs.duration ASC, Songs.sort_title ASC, Artists.sort_name ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::LengthDsc:
-            orderBy = "Songs.duration DESC, Songs.title ASC, Artists.name ASC, Albums.name ASC";
+            orderBy = "Songs.duration DESC, Songs.sort_title ASC, Artists.sort_name ASC, Albums.sort_name ASC";
             break;
     }
 
     // Create a Metadata::Song for each entry given the playlist
-    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified, PlaylistSongs.rowid FROM PlaylistSongs JOIN Songs ON Songs.id = PlaylistSongs.song_id JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE PlaylistSongs.playlist_id = ? ORDER BY " + orderBy + ";");
+    bool ok = this->db->prepareQuery("SELECT " SONG_COLUMNS ", PlaylistSongs.rowid FROM PlaylistSongs JOIN Songs ON Songs.id = PlaylistSongs.song_id JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE PlaylistSongs.playlist_id = ? ORDER BY " + orderBy + ";");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -962,31 +1105,13 @@ std::vector<Metadata::PlaylistSong> Database::getSongMetadataForPlaylist(Playlis
     }
     while (ok && this->db->hasRow()) {
         Metadata::Song m;
-        int tmp;
-        std::string tmpStr;
-        ok = this->db->getInt(0, m.ID);
-        ok = keepFalse(ok, this->db->getString(1, m.title));
-        ok = keepFalse(ok, this->db->getString(2, m.artist));
-        ok = keepFalse(ok, this->db->getString(3, m.album));
-        ok = keepFalse(ok, this->db->getInt(4, tmp));
-        m.trackNumber = tmp;
-        ok = keepFalse(ok, this->db->getInt(5, tmp));
-        m.discNumber = tmp;
-        ok = keepFalse(ok, this->db->getInt(6, tmp));
-        m.duration = tmp;
-        ok = keepFalse(ok, this->db->getInt(7, tmp));
-        m.plays = tmp;
-        ok = keepFalse(ok, this->db->getBool(8, m.favourite));
-        ok = keepFalse(ok, this->db->getString(9, m.path));
-        ok = keepFalse(ok, this->db->getString(10, tmpStr));
-        m.format = audioFormatFromString(tmpStr);
-        ok = keepFalse(ok, this->db->getInt(11, tmp));
-        m.modified = tmp;
-        ok = keepFalse(ok, this->db->getInt(12, tmp));
+        PlaylistSongID id;
+        ok = readSong(this->db, m);
+        ok = keepFalse(ok, this->db->getColumns(12, id));
 
         // Push back PlaylistSong struct if all successful
         if (ok) {
-            v.push_back(Metadata::PlaylistSong{tmp, m});
+            v.push_back(Metadata::PlaylistSong{id, std::move(m)});
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -995,17 +1120,36 @@ std::vector<Metadata::PlaylistSong> Database::getSongMetadataForPlaylist(Playlis
     return v;
 }
 
+bool Database::canEditPlaylistSongs(const std::string & method, const std::string & playlist, int id) {
+    // Look for a smart playlist matching the given expression (the parameter is the ID), as its songs
+    // are chosen by its rules and any changes would be undone by the next refresh
+    bool ok = this->db->prepareQuery("SELECT 1 FROM SmartPlaylists WHERE playlist_id = " + playlist + ";");
+    ok = keepFalse(ok, this->db->bindInt(0, id));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[" + method + "] Unable to check if the playlist is a smart playlist");
+        return false;
+    }
+    if (this->db->hasRow()) {
+        this->setErrorMsg("[" + method + "] Can't change the songs in a smart playlist");
+        return false;
+    }
+    return true;
+}
+
 bool Database::addSongToPlaylist(PlaylistID pl, SongID s) {
     // First check we have write permission
     if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
         this->setErrorMsg("[addSongToPlaylist] Can't add song as the database is unwritable");
         return false;
     }
+    if (!this->canEditPlaylistSongs("addSongToPlaylist", "?", pl)) {
+        return false;
+    }
 
     // Prepare query
     bool ok = this->db->prepareQuery("INSERT INTO PlaylistSongs (playlist_id, song_id) VALUES (?, ?);");
-    ok = keepFalse(ok, this->db->bindInt(0, pl));
-    ok = keepFalse(ok, this->db->bindInt(1, s));
+    ok = keepFalse(ok, this->db->bindValues(0, pl, s));
     if (!ok) {
         this->setErrorMsg("[addSongToPlaylist] An error occurred preparing the query");
         return false;
@@ -1020,138 +1164,316 @@ bool Database::addSongToPlaylist(PlaylistID pl, SongID s) {
     return ok;
 }
 
-bool Database::removeSongFromPlaylist(PlaylistSongID rowid) {
+bool Database::addSongsToPlaylist(PlaylistID pl, const std::vector<SongID> & ids) {
     // First check we have write permission
     if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
-        this->setErrorMsg("[removeSongFromPlaylist] Can't add song as the database is unwritable");
+        this->setErrorMsg("[addSongsToPlaylist] Can't add songs as the database is unwritable");
         return false;
     }
-
-    // Prepare query
-    bool ok = this->db->prepareQuery("DELETE FROM PlaylistSongs WHERE rowid = ?;");
-    ok = keepFalse(ok, this->db->bindInt(0, rowid));
-    if (!ok) {
-        this->setErrorMsg("[removeSongFromPlaylist] An error occurred preparing the query");
+    if (!this->canEditPlaylistSongs("addSongsToPlaylist", "?", pl)) {
         return false;
     }
 
-    // Perform query
-    ok = this->db->executeQuery();
-    if (!ok) {
-        this->setErrorMsg("[removeSongFromPlaylist] An error occurred removing the song");
+    // Insert a batch of rows per statement, all within one transaction so there's only one commit
+    // IDs which no longer exist are skipped (otherwise the whole batch would be rejected)
+    bool ok = this->db->beginTransaction();
+    for (size_t i = 0; ok && i < ids.size(); i += PLAYLIST_BATCH_SIZE) {
+        size_t count = std::min<size_t>(ids.size() - i, PLAYLIST_BATCH_SIZE);
+        std::string values = "(?)";
+        for (size_t j = 1; j < count; j++) {
+            values += ", (?)";
+        }
+        ok = this->db->prepareQuery("INSERT INTO PlaylistSongs (playlist_id, song_id) SELECT ?, column1 FROM (VALUES " + values + ") WHERE column1 IN (SELECT id FROM Songs);");
+        ok = keepFalse(ok, this->db->bindInt(0, pl));
+        for (size_t j = 0; j < count; j++) {
+            ok = keepFalse(ok, this->db->bindInt(j + 1, ids[i + j]));
+        }
+        ok = keepFalse(ok, this->db->executeQuery());
     }
 
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[addSongsToPlaylist] An error occurred adding the songs");
+    }
     return ok;
 }
 
-// ===== Song Metadata ===== //
-bool Database::addSong(Metadata::Song m) {
+bool Database::copySongsToPlaylist(const std::string & method, PlaylistID pl, const std::string & select, int id) {
     // First check we have write permission
     if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
-        this->setErrorMsg("[addSong] Can't add a song as the database is unwritable");
+        this->setErrorMsg("[" + method + "] Can't add songs as the database is unwritable");
         return false;
     }
-
-    // Add artist and album (will do nothing if they already exist)
-    bool ok = this->addArtist(m.artist);
-    ok = keepFalse(ok, this->addAlbum(m.album));
-    if (!ok) {
+    if (!this->canEditPlaylistSongs(method, "?", pl)) {
         return false;
     }
 
-    // Finally add song
-    ok = this->db->prepareQuery("INSERT INTO Songs (path, format, modified, artist_id, album_id, title, duration, track, disc) VALUES (?, ?, ?, (SELECT id FROM Artists WHERE name = ?), (SELECT id FROM Albums WHERE name = ?), ?, ?, ?, ?);");
-    ok = keepFalse(ok, this->db->bindString(0, m.path));
-    ok = keepFalse(ok, this->db->bindString(1, audioFormatToString(m.format)));
-    ok = keepFalse(ok, this->db->bindInt(2, m.modified));
-    ok = keepFalse(ok, this->db->bindString(3, m.artist));
-    ok = keepFalse(ok, this->db->bindString(4, m.album));
-    ok = keepFalse(ok, this->db->bindString(5, m.title));
-    ok = keepFalse(ok, this->db->bindInt(6, m.duration));
-    ok = keepFalse(ok, this->db->bindInt(7, m.trackNumber));
-    ok = keepFalse(ok, this->db->bindInt(8, m.discNumber));
+    // Copy the IDs straight from the query (the first parameter is the playlist)
+    bool ok = this->db->prepareQuery("INSERT INTO PlaylistSongs (playlist_id, song_id) " + select + ";");
+    ok = keepFalse(ok, this->db->bindValues(0, pl, id));
     if (!ok) {
-        this->setErrorMsg("[addSong] An error occurred while preparing the statement");
+        this->setErrorMsg("[" + method + "] An error occurred preparing the query");
         return false;
     }
 
     ok = this->db->executeQuery();
     if (!ok) {
-        this->setErrorMsg("[addSong] An error occurred while adding the entry");
-    } else {
-        if (Log::loggingLevel() == Log::Level::Info) {
-            Log::writeInfo("[DB] [addSong] '" + m.path + "' added to the database");
-        }
+        this->setErrorMsg("[" + method + "] An error occurred adding the songs");
     }
+    return ok;
+}
 
-    // Mark search tables as out of date
-    if (ok) {
-        ok = this->setSearchUpdate(1);
-    }
+bool Database::addAlbumToPlaylist(PlaylistID pl, AlbumID id) {
+    // Same order as getSongMetadataForAlbum()
+    return this->copySongsToPlaylist("addAlbumToPlaylist", pl, "SELECT ?, id FROM Songs WHERE album_id = ? ORDER BY CASE disc WHEN 0 THEN 9999 ELSE disc END, CASE track WHEN 0 THEN 9999 ELSE track END, sort_title", id);
+}
 
-    return ok;
+bool Database::addArtistToPlaylist(PlaylistID pl, ArtistID id) {
+    // Same order as getSongMetadataForArtist()
+    return this->copySongsToPlaylist("addArtistToPlaylist", pl, "SELECT ?, id FROM Songs WHERE artist_id = ? ORDER BY sort_title", id);
 }
 
-bool Database::updateSong(Metadata::Song m) {
+bool Database::addPlaylistToPlaylist(PlaylistID pl, PlaylistID id) {
+    // Keeps the order the songs were added to the other playlist
+    return this->copySongsToPlaylist("addPlaylistToPlaylist", pl, "SELECT ?, song_id FROM PlaylistSongs WHERE playlist_id = ? ORDER BY rowid", id);
+}
+
+bool Database::removeSongFromPlaylist(PlaylistSongID rowid) {
     // First check we have write permission
     if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
-        this->setErrorMsg("[updateSong] Can't update song as the database is unwritable");
+        this->setErrorMsg("[removeSongFromPlaylist] Can't add song as the database is unwritable");
         return false;
     }
-
-    // Add artist and album (will do nothing if they already exist)
-    bool ok = this->addArtist(m.artist);
-    ok = keepFalse(ok, this->addAlbum(m.album));
-    if (!ok) {
+    if (!this->canEditPlaylistSongs("removeSongFromPlaylist", "(SELECT playlist_id FROM PlaylistSongs WHERE rowid = ?)", rowid)) {
         return false;
     }
 
-    // Now update relevant fields
-    ok = this->db->prepareQuery("UPDATE Songs SET modified = ?, artist_id = (SELECT id FROM Artists WHERE name = ?), album_id = (SELECT id FROM Albums WHERE name = ?), title = ?, track = ?, disc = ?, duration = ?, plays = ?, favourite = ?, path = ?, format = ? WHERE id = ?;");
-    ok = keepFalse(ok, this->db->bindInt(0, m.modified));
-    ok = keepFalse(ok, this->db->bindString(1, m.artist));
-    ok = keepFalse(ok, this->db->bindString(2, m.album));
-    ok = keepFalse(ok, this->db->bindString(3, m.title));
-    ok = keepFalse(ok, this->db->bindInt(4, m.trackNumber));
-    ok = keepFalse(ok, this->db->bindInt(5, m.discNumber));
-    ok = keepFalse(ok, this->db->bindInt(6, m.duration));
-    ok = keepFalse(ok, this->db->bindInt(7, m.plays));
-    ok = keepFalse(ok, this->db->bindBool(8, m.favourite));
-    ok = keepFalse(ok, this->db->bindString(9, m.path));
-    ok = keepFalse(ok, this->db->bindString(10, audioFormatToString(m.format)));
-    ok = keepFalse(ok, this->db->bindInt(11, m.ID));
+    // Prepare query
+    bool ok = this->db->prepareQuery("DELETE FROM PlaylistSongs WHERE rowid = ?;");
+    ok = keepFalse(ok, this->db->bindInt(0, rowid));
     if (!ok) {
-        this->setErrorMsg("[updateSong] An error occurred while preparing the statement");
+        this->setErrorMsg("[removeSongFromPlaylist] An error occurred preparing the query");
         return false;
     }
 
+    // Perform query
     ok = this->db->executeQuery();
     if (!ok) {
-        this->setErrorMsg("[updateSong] An error occurred while adding the entry");
-    } else {
-        if (Log::loggingLevel() == Log::Level::Info) {
-            Log::writeInfo("[DB] [updateSong] '" + m.title + "' was updated");
-        }
-    }
-
-    // Mark search tables as out of date
-    if (ok) {
-        ok = this->setSearchUpdate(1);
+        this->setErrorMsg("[removeSongFromPlaylist] An error occurred removing the song");
     }
 
     return ok;
 }
 
-bool Database::removeSong(SongID id) {
+bool Database::addSmartPlaylist(Metadata::Playlist m, const std::vector<SmartPlaylist::Rule> & rules) {
     // First check we have write permission
     if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
-        this->setErrorMsg("[removeSong] Can't remove song as the database is unwritable");
+        this->setErrorMsg("[addSmartPlaylist] Can't add a playlist as the database is unwritable");
         return false;
     }
 
-    bool ok = this->db->prepareQuery("DELETE FROM Songs WHERE id = ?;");
-    ok = keepFalse(ok, this->db->bindInt(0, id));
-    if (!ok) {
+    // Add the playlist and its rules together
+    bool relative;
+    std::string predicate = SmartPlaylist::compile(rules, relative);
+    bool ok = this->db->beginTransaction();
+    ok = keepFalse(ok, this->addPlaylist(m));
+    if (ok) {
+        ok = this->db->prepareQuery("INSERT INTO SmartPlaylists (playlist_id, predicate, relative) VALUES (last_insert_rowid(), ?, ?);");
+        ok = keepFalse(ok, this->db->bindValues(0, predicate, relative));
+        ok = keepFalse(ok, this->db->executeQuery());
+    }
+
+    // Fill it with every matching song
+    PlaylistID id = -1;
+    if (ok) {
+        ok = this->db->prepareAndExecuteQuery("SELECT last_insert_rowid();");
+        ok = keepFalse(ok, this->db->getInt(0, id));
+    }
+    if (ok) {
+        ok = this->db->prepareQuery("INSERT INTO PlaylistSongs (playlist_id, song_id) SELECT ?, id FROM Songs WHERE " + predicate + ";");
+        ok = keepFalse(ok, this->db->bindInt(0, id));
+        ok = keepFalse(ok, this->db->executeQuery());
+    }
+
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[addSmartPlaylist] An error occurred while adding the smart playlist");
+    }
+    return ok;
+}
+
+bool Database::refreshSmartPlaylists() {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[refreshSmartPlaylists] Can't refresh playlists as the database is unwritable");
+        return false;
+    }
+
+    // Get each playlist's rules
+    struct Smart {
+        PlaylistID id;
+        std::string predicate;
+        bool relative;
+    };
+    std::vector<Smart> playlists;
+    bool ok = this->db->prepareAndExecuteQuery("SELECT playlist_id, predicate, relative FROM SmartPlaylists;");
+    if (!ok) {
+        this->setErrorMsg("[refreshSmartPlaylists] Unable to read smart playlists");
+        return false;
+    }
+    while (ok && this->db->hasRow()) {
+        Smart smart;
+        ok = this->db->getColumns(0, smart.id, smart.predicate, smart.relative);
+        if (ok) {
+            playlists.push_back(smart);
+        }
+        ok = keepFalse(ok, this->db->nextRow());
+    }
+
+    // Only retest the songs which have changed, unless the rules depend on the time
+    ok = this->db->beginTransaction();
+    for (size_t i = 0; ok && i < playlists.size(); i++) {
+        const Smart & smart = playlists[i];
+        std::string songs = (smart.relative ? "" : " AND song_id IN (SELECT song_id FROM DirtySongs)");
+        ok = this->db->prepareQuery("DELETE FROM PlaylistSongs WHERE playlist_id = ?" + songs + ";");
+        ok = keepFalse(ok, this->db->bindInt(0, smart.id));
+        ok = keepFalse(ok, this->db->executeQuery());
+
+        songs = (smart.relative ? "" : "id IN (SELECT song_id FROM DirtySongs) AND ");
+        ok = keepFalse(ok, this->db->prepareQuery("INSERT INTO PlaylistSongs (playlist_id, song_id) SELECT ?, id FROM Songs WHERE " + songs + smart.predicate + ";"));
+        ok = keepFalse(ok, this->db->bindInt(0, smart.id));
+        ok = keepFalse(ok, this->db->executeQuery());
+    }
+    ok = keepFalse(ok, this->db->prepareAndExecuteQuery("DELETE FROM DirtySongs;"));
+
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[refreshSmartPlaylists] An error occurred refreshing the smart playlists");
+    }
+    return ok;
+}
+
+// ===== Song Metadata ===== //
+bool Database::addSong(Metadata::Song m) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[addSong] Can't add a song as the database is unwritable");
+        return false;
+    }
+
+    // Add artist and album (will do nothing if they already exist)
+    bool ok = this->addArtist(m.artist);
+    ok = keepFalse(ok, this->addAlbum(m.album));
+    if (!ok) {
+        return false;
+    }
+
+    // Finally add song
+    ok = this->db->prepareQuery("INSERT INTO Songs (path, format, modified, artist_id, album_id, title, duration, track, disc, fingerprint) VALUES (?, ?, ?, (SELECT id FROM Artists WHERE name = ?), (SELECT id FROM Albums WHERE name = ?), ?, ?, ?, ?, NULLIF(?, ''));");
+    ok = keepFalse(ok, this->db->bindValues(0, m.path, audioFormatToString(m.format), m.modified, m.artist, m.album, m.title, m.duration, m.trackNumber, m.discNumber, m.fingerprint));
+    if (!ok) {
+        this->setErrorMsg("[addSong] An error occurred while preparing the statement");
+        return false;
+    }
+
+    ok = this->db->executeQuery();
+    if (!ok) {
+        this->setErrorMsg("[addSong] An error occurred while adding the entry");
+    } else {
+        if (Log::loggingLevel() == Log::Level::Info) {
+            Log::writeInfo("[DB] [addSong] '" + m.path + "' added to the database");
+        }
+        this->pathIndexOutdated = true;
+    }
+
+    return ok;
+}
+
+bool Database::updateSong(Metadata::Song m) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[updateSong] Can't update song as the database is unwritable");
+        return false;
+    }
+
+    // Add artist and album (will do nothing if they already exist)
+    bool ok = this->addArtist(m.artist);
+    ok = keepFalse(ok, this->addAlbum(m.album));
+    if (!ok) {
+        return false;
+    }
+
+    // Now update relevant fields
+    // The fingerprint is only replaced if one is given, as it isn't read into Metadata::Song
+    ok = this->db->prepareQuery("UPDATE Songs SET modified = ?, artist_id = (SELECT id FROM Artists WHERE name = ?), album_id = (SELECT id FROM Albums WHERE name = ?), title = ?, track = ?, disc = ?, duration = ?, plays = ?, favourite = ?, path = ?, format = ?, fingerprint = COALESCE(NULLIF(?, ''), fingerprint) WHERE id = ?;");
+    ok = keepFalse(ok, this->db->bindValues(0, m.modified, m.artist, m.album, m.title, m.trackNumber, m.discNumber, m.duration, m.plays, m.favourite, m.path, audioFormatToString(m.format), m.fingerprint, m.ID));
+    if (!ok) {
+        this->setErrorMsg("[updateSong] An error occurred while preparing the statement");
+        return false;
+    }
+
+    ok = this->db->executeQuery();
+    if (!ok) {
+        this->setErrorMsg("[updateSong] An error occurred while adding the entry");
+    } else {
+        if (Log::loggingLevel() == Log::Level::Info) {
+            Log::writeInfo("[DB] [updateSong] '" + m.title + "' was updated");
+        }
+        this->pathIndexOutdated = true;
+    }
+
+    return ok;
+}
+
+bool Database::moveSong(SongID id, const std::string & path, AudioFormat format, unsigned int modified) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[moveSong] Can't move song as the database is unwritable");
+        return false;
+    }
+
+    bool ok = this->db->prepareQuery("UPDATE Songs SET path = ?, format = ?, modified = ? WHERE id = ?;");
+    ok = keepFalse(ok, this->db->bindValues(0, path, audioFormatToString(format), modified, id));
+    if (!ok) {
+        this->setErrorMsg("[moveSong] An error occurred while preparing the statement");
+        return false;
+    }
+
+    ok = this->db->executeQuery();
+    if (!ok) {
+        this->setErrorMsg("[moveSong] An error occurred while moving the entry");
+    } else {
+        if (Log::loggingLevel() == Log::Level::Info) {
+            Log::writeInfo("[DB] [moveSong] '" + std::to_string(id) + "' was moved to '" + path + "'");
+        }
+        this->pathIndexOutdated = true;
+    }
+
+    return ok;
+}
+
+bool Database::removeSong(SongID id) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[removeSong] Can't remove song as the database is unwritable");
+        return false;
+    }
+
+    bool ok = this->db->prepareQuery("DELETE FROM Songs WHERE id = ?;");
+    ok = keepFalse(ok, this->db->bindInt(0, id));
+    if (!ok) {
         this->setErrorMsg("[removeSong] An error occurred while preparing the statement");
         return false;
     }
@@ -1163,11 +1485,7 @@ bool Database::removeSong(SongID id) {
         if (Log::loggingLevel() == Log::Level::Info) {
             Log::writeInfo("[DB] [removeSong] '" + std::to_string(id) + "' was deleted");
         }
-    }
-
-    // Mark search tables as out of date
-    if (ok) {
-        ok = this->setSearchUpdate(1);
+        this->pathIndexOutdated = true;
     }
 
     return ok;
@@ -1186,40 +1504,40 @@ std::vector<Metadata::Song> Database::getAllSongMetadata(Database::SortBy sort)
     switch (sort) {
         case Database::SortBy::TitleAsc:
         default:
-            orderBy = "Songs.title ASC, Artists.name ASC, Albums.name ASC";
+            orderBy = "Songs.sort_title ASC, Artists.sort_name ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::TitleDsc:
-            orderBy = "Songs.title DESC, Artists.name ASC, Albums.name ASC";
+            orderBy = "Songs.sort_title DESC, Artists.sort_name ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::ArtistAsc:
-            orderBy = "Artists.name ASC, Songs.title ASC";
+            orderBy = "Artists.sort_name ASC, Songs.sort_title ASC";
             break;
 
         case Database::SortBy::ArtistDsc:
-            orderBy = "Artists.name DESC, Songs.title ASC";
+            orderBy = "Artists.sort_name DESC, Songs.sort_title ASC";
             break;
 
         case Database::SortBy::AlbumAsc:
-            orderBy = "Albums.name ASC, Songs.title ASC";
+            orderBy = "Albums.sort_name ASC, Songs.sort_title ASC";
             break;
 
         case Database::SortBy::AlbumDsc:
-            orderBy = "Albums.name DESC, Songs.title ASC";
+            orderBy = "Albums.sort_name DESC, Songs.sort_title ASC";
             break;
 
         case Database::SortBy::LengthAsc:
-            orderBy = "duration ASC, Songs.title ASC, Artists.name ASC, Albums.name ASC";
+            orderBy = "duration ASC, Songs.sort_title ASC, Artists.sort_name ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::LengthDsc:
-            orderBy = "duration DESC, Songs.title ASC, Artists.name ASC, Albums.name ASC";
+            orderBy = "duration DESC, Songs.sort_title ASC, Artists.sort_name ASC, Albums.sort_name ASC";
             break;
     }
 
     // Create a Metadata::Song for each entry
-    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id ORDER BY " + orderBy + ";");
+    bool ok = this->db->prepareQuery("SELECT " SONG_COLUMNS " FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id ORDER BY " + orderBy + ";");
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
         this->setErrorMsg("[getAllSongInfo] Unable to query for all songs");
@@ -1227,29 +1545,10 @@ std::vector<Metadata::Song> Database::getAllSongMetadata(Database::SortBy sort)
     }
     while (ok && this->db->hasRow()) {
         Metadata::Song m;
-        int tmp;
-        std::string tmpStr;
-        ok = this->db->getInt(0, m.ID);
-        ok = keepFalse(ok, this->db->getString(1, m.title));
-        ok = keepFalse(ok, this->db->getString(2, m.artist));
-        ok = keepFalse(ok, this->db->getString(3, m.album));
-        ok = keepFalse(ok, this->db->getInt(4, tmp));
-        m.trackNumber = tmp;
-        ok = keepFalse(ok, this->db->getInt(5, tmp));
-        m.discNumber = tmp;
-        ok = keepFalse(ok, this->db->getInt(6, tmp));
-        m.duration = tmp;
-        ok = keepFalse(ok, this->db->getInt(7, tmp));
-        m.plays = tmp;
-        ok = keepFalse(ok, this->db->getBool(8, m.favourite));
-        ok = keepFalse(ok, this->db->getString(9, m.path));
-        ok = keepFalse(ok, this->db->getString(10, tmpStr));
-        m.format = audioFormatFromString(tmpStr);
-        ok = keepFalse(ok, this->db->getInt(11, tmp));
-        m.modified = tmp;
+        ok = readSong(this->db, m);
 
         if (ok) {
-            v.push_back(m);
+            v.push_back(std::move(m));
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -1268,7 +1567,7 @@ std::vector<Metadata::Song> Database::getSongMetadataForAlbum(AlbumID id) {
 
     // Create a Metadata::Song for each entry given the album (sorted)
     // Note that 0's are treated as 9999's so they are at the end (yes this means it won't always be at the end but no album has 9999 discs or 9999 tracks)
-    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.album_id = ? ORDER BY CASE disc WHEN 0 THEN 9999 ELSE disc END, CASE track WHEN 0 THEN 9999 ELSE track END, title;");
+    bool ok = this->db->prepareQuery("SELECT " SONG_COLUMNS " FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.album_id = ? ORDER BY CASE disc WHEN 0 THEN 9999 ELSE disc END, CASE track WHEN 0 THEN 9999 ELSE track END, Songs.sort_title;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -1277,29 +1576,10 @@ std::vector<Metadata::Song> Database::getSongMetadataForAlbum(AlbumID id) {
     }
     while (ok && this->db->hasRow()) {
         Metadata::Song m;
-        int tmp;
-        std::string tmpStr;
-        ok = this->db->getInt(0, m.ID);
-        ok = keepFalse(ok, this->db->getString(1, m.title));
-        ok = keepFalse(ok, this->db->getString(2, m.artist));
-        ok = keepFalse(ok, this->db->getString(3, m.album));
-        ok = keepFalse(ok, this->db->getInt(4, tmp));
-        m.trackNumber = tmp;
-        ok = keepFalse(ok, this->db->getInt(5, tmp));
-        m.discNumber = tmp;
-        ok = keepFalse(ok, this->db->getInt(6, tmp));
-        m.duration = tmp;
-        ok = keepFalse(ok, this->db->getInt(7, tmp));
-        m.plays = tmp;
-        ok = keepFalse(ok, this->db->getBool(8, m.favourite));
-        ok = keepFalse(ok, this->db->getString(9, m.path));
-        ok = keepFalse(ok, this->db->getString(10, tmpStr));
-        m.format = audioFormatFromString(tmpStr);
-        ok = keepFalse(ok, this->db->getInt(11, tmp));
-        m.modified = tmp;
+        ok = readSong(this->db, m);
 
         if (ok) {
-            v.push_back(m);
+            v.push_back(std::move(m));
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -1317,7 +1597,7 @@ std::vector<Metadata::Song> Database::getSongMetadataForArtist(ArtistID id) {
     }
 
     // Create a Metadata::Song for each entry given the artist
-    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.artist_id = ? ORDER BY Songs.title;");
+    bool ok = this->db->prepareQuery("SELECT " SONG_COLUMNS " FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.artist_id = ? ORDER BY Songs.sort_title;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -1326,29 +1606,10 @@ std::vector<Metadata::Song> Database::getSongMetadataForArtist(ArtistID id) {
     }
     while (ok && this->db->hasRow()) {
         Metadata::Song m;
-        int tmp;
-        std::string tmpStr;
-        ok = this->db->getInt(0, m.ID);
-        ok = keepFalse(ok, this->db->getString(1, m.title));
-        ok = keepFalse(ok, this->db->getString(2, m.artist));
-        ok = keepFalse(ok, this->db->getString(3, m.album));
-        ok = keepFalse(ok, this->db->getInt(4, tmp));
-        m.trackNumber = tmp;
-        ok = keepFalse(ok, this->db->getInt(5, tmp));
-        m.discNumber = tmp;
-        ok = keepFalse(ok, this->db->getInt(6, tmp));
-        m.duration = tmp;
-        ok = keepFalse(ok, this->db->getInt(7, tmp));
-        m.plays = tmp;
-        ok = keepFalse(ok, this->db->getBool(8, m.favourite));
-        ok = keepFalse(ok, this->db->getString(9, m.path));
-        ok = keepFalse(ok, this->db->getString(10, tmpStr));
-        m.format = audioFormatFromString(tmpStr);
-        ok = keepFalse(ok, this->db->getInt(11, tmp));
-        m.modified = tmp;
+        ok = readSong(this->db, m);
 
         if (ok) {
-            v.push_back(m);
+            v.push_back(std::move(m));
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -1367,33 +1628,14 @@ Metadata::Song Database::getSongMetadataForID(SongID id) {
     }
 
     // Query for song info
-    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.ID = ?;");
+    bool ok = this->db->prepareQuery("SELECT " SONG_COLUMNS " FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.ID = ?;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
         this->setErrorMsg("[getSongInfoForID] An error occurred querying for info");
         return m;
     }
-    int tmp;
-    std::string tmpStr;
-    ok = this->db->getInt(0, m.ID);
-    ok = keepFalse(ok, this->db->getString(1, m.title));
-    ok = keepFalse(ok, this->db->getString(2, m.artist));
-    ok = keepFalse(ok, this->db->getString(3, m.album));
-    ok = keepFalse(ok, this->db->getInt(4, tmp));
-    m.trackNumber = tmp;
-    ok = keepFalse(ok, this->db->getInt(5, tmp));
-    m.discNumber = tmp;
-    ok = keepFalse(ok, this->db->getInt(6, tmp));
-    m.duration = tmp;
-    ok = keepFalse(ok, this->db->getInt(7, tmp));
-    m.plays = tmp;
-    ok = keepFalse(ok, this->db->getBool(8, m.favourite));
-    ok = keepFalse(ok, this->db->getString(9, m.path));
-    ok = keepFalse(ok, this->db->getString(10, tmpStr));
-    m.format = audioFormatFromString(tmpStr);
-    ok = keepFalse(ok, this->db->getInt(11, tmp));
-    m.modified = tmp;
+    ok = readSong(this->db, m);
 
     if (!ok) {
         this->setErrorMsg("[getSongInfoForID] An error occurred reading from the query results");
@@ -1404,151 +1646,9 @@ Metadata::Song Database::getSongMetadataForID(SongID id) {
 }
 
 // ===== Search Queries ===== //
-bool Database::needsSearchUpdate() {
-    // Check if we have read permission
-    if (this->db->connectionType() == SQLite::Connection::None) {
-        this->setErrorMsg("[needsSearchUpdate] Database has not been opened");
-        return false;
-    }
-
-    // Return true if search_update does not equal 0
-    int val;
-    bool ok = this->db->prepareAndExecuteQuery("SELECT value FROM Variables WHERE name = 'search_update';");
-    ok = keepFalse(ok, this->db->getInt(0, val));
-    if (!ok) {
-        this->setErrorMsg("[needsSearchUpdate] Unable to query update variable");
-        return false;
-    }
-    return (val != 0);
-}
-
-bool Database::prepareSearch() {
-    // First check we have write permission
-    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
-        this->setErrorMsg("[prepareSearch] Can't perform indexing as the database is unwritable");
-        return false;
-    }
-
-    // Update fts tables
-    bool ok = this->db->prepareAndExecuteQuery("DELETE FROM FtsSongs;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Unable to empty FtsSongs");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("INSERT INTO FtsSongs SELECT title, Artists.name, Albums.name FROM Songs JOIN Artists ON artist_id = Artists.id JOIN Albums ON album_id = Albums.id;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to populate FtsSongs");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("DELETE FROM FtsArtists;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Unable to empty FtsArtists");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("INSERT INTO FtsArtists SELECT name FROM Artists;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to populate FtsArtists");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("DELETE FROM FtsAlbums;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Unable to empty FtsAlbums");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("INSERT INTO FtsAlbums SELECT DISTINCT Albums.name, Artists.name FROM Songs JOIN Artists ON artist_id = Artists.id JOIN Albums ON album_id = Albums.id;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to populate FtsAlbums");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("DELETE FROM FtsPlaylists;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Unable to empty FtsPlaylists");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("INSERT INTO FtsPlaylists SELECT name FROM Playlists;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to populate FtsPlaylists");
-        return false;
-    }
-
-    // Update fts4aux tables (used to populate spellfix tables)
-    this->db->prepareAndExecuteQuery("DROP TABLE IF EXISTS FtsAuxSongs;");
-    ok = this->db->prepareAndExecuteQuery("CREATE VIRTUAL TABLE FtsAuxSongs USING fts4aux(FtsSongs);");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to create FtsAuxSongs table");
-        return false;
-    }
-    this->db->prepareAndExecuteQuery("DROP TABLE IF EXISTS FtsAuxArtists;");
-    ok = this->db->prepareAndExecuteQuery("CREATE VIRTUAL TABLE FtsAuxArtists USING fts4aux(FtsArtists);");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to create FtsAuxArtists table");
-        return false;
-    }
-    this->db->prepareAndExecuteQuery("DROP TABLE IF EXISTS FtsAuxAlbums;");
-    ok = this->db->prepareAndExecuteQuery("CREATE VIRTUAL TABLE FtsAuxAlbums USING fts4aux(FtsAlbums);");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to create FtsAuxAlbums table");
-        return false;
-    }
-    this->db->prepareAndExecuteQuery("DROP TABLE IF EXISTS FtsAuxPlaylists;");
-    ok = this->db->prepareAndExecuteQuery("CREATE VIRTUAL TABLE FtsAuxPlaylists USING fts4aux(FtsPlaylists);");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to create FtsAuxPlaylists table");
-        return false;
-    }
-
-    // Now populate spellfix tables
-    ok = this->db->prepareAndExecuteQuery("DELETE FROM SpellfixSongs;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Unable to empty SpellfixSongs");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("INSERT INTO SpellfixSongs (word, rank) SELECT term, documents FROM FtsAuxSongs WHERE col='*';");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to populate SpellfixSongs with terms");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("DELETE FROM SpellfixArtists;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Unable to empty SpellfixArtists");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("INSERT INTO SpellfixArtists (word, rank) SELECT term, documents FROM FtsAuxArtists WHERE col='*';");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to populate SpellfixArtists with terms");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("DELETE FROM SpellfixAlbums;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Unable to empty SpellfixAlbums");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("INSERT INTO SpellfixAlbums (word, rank) SELECT term, documents FROM FtsAuxAlbums WHERE col='*';");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to populate SpellfixAlbums with terms");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("DELETE FROM SpellfixPlaylists;");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Unable to empty SpellfixPlaylists");
-        return false;
-    }
-    ok = this->db->prepareAndExecuteQuery("INSERT INTO SpellfixPlaylists (word, rank) SELECT term, documents FROM FtsAuxPlaylists WHERE col='*';");
-    if (!ok) {
-        this->setErrorMsg("[prepareSearch] Failed to populate SpellfixPlaylists with terms");
-        return false;
-    }
-
-    // Update variable to indicate no update is needed
-    ok = this->setSearchUpdate(0);
-    if (ok) {
-        Log::writeSuccess("[DB] [prepareSearch] Search tables updated successfully!");
-    }
-    return ok;
-}
-
-std::vector<Metadata::Album> Database::searchAlbums(std::string str, int limit) {
+std::vector<Metadata::Album> Database::searchAlbums(std::string str, const unsigned int token, bool & success, int limit) {
     std::vector<Metadata::Album> v;
+    success = true;
     if (limit == 0) {
         return v;
     }
@@ -1556,67 +1656,60 @@ std::vector<Metadata::Album> Database::searchAlbums(std::string str, int limit)
     // Check we can read
     if (this->db->connectionType() == SQLite::Connection::None) {
         this->setErrorMsg("[searchAlbums] No open connection");
+        success = false;
         return v;
     }
 
-    // Fix any spelling mistakes and get suggested searches based on input
-    std::vector<std::string> phrases = this->getSearchPhrases("SpellfixAlbums", str);
-    if (phrases.empty()) {
+    // Form the MATCH expression from the input
+    std::string match = this->getSearchQuery(str);
+    if (match.empty()) {
         return v;
     }
 
-    // Iterate over each phrase and store results
-    for (size_t i = 0; i < phrases.size(); i++) {
-        // Create query and optionally append LIMIT
-        std::string query = "SELECT Albums.id, Albums.name, CASE WHEN COUNT(DISTINCT Songs.artist_id) > 1 THEN 'Various Artists' ELSE Artists.name END, Albums.tadb_id, Albums.image_path, COUNT(*) FROM Songs JOIN Artists ON Songs.artist_id = Artists.id JOIN Albums ON Songs.album_id = Albums.id LEFT JOIN (SELECT DISTINCT name AS content, okapi_bm25(matchinfo(FtsAlbums, 'pcxnal'), 0) AS score FROM FtsAlbums WHERE FtsAlbums MATCH ?) ON Albums.name = content WHERE score IS NOT NULL GROUP BY album_id ORDER BY score DESC, Albums.name";
-        query += (limit >= 0 ? " LIMIT ?;" : ";");
-        bool ok = this->db->prepareQuery(query);
-        std::string str = phrases[i];
-        ok = keepFalse(ok, this->db->bindString(0, str));
-        if (limit >= 0) {
-            ok = keepFalse(ok, this->db->bindInt(1, limit));
-        }
-        ok = keepFalse(ok, this->db->executeQuery());
-        if (!ok) {
-            this->setErrorMsg("[searchAlbums] An error occurred searching with the phrase: " + phrases[i]);
-            return v;
+    // Create query and optionally append LIMIT
+    // A little note: "SELECT DISTINCT docid AS doc" has to be in the subquery otherwise SQLite says "matchinfo can't be used in this context"...
+    std::string query = "SELECT " ALBUM_COLUMNS " FROM AlbumStats JOIN Artists ON AlbumStats.artist_id = Artists.id JOIN Albums ON AlbumStats.album_id = Albums.id JOIN (SELECT DISTINCT docid AS doc, okapi_bm25(matchinfo(FtsAlbums, 'pcxnal'), 0) + okapi_bm25(matchinfo(FtsAlbums, 'pcxnal'), 1) AS score FROM FtsAlbums WHERE FtsAlbums MATCH ? AND matchPercent(matchinfo(FtsAlbums, 'pcx')) >= ?) ON Albums.id = doc ORDER BY score DESC, Albums.sort_name";
+    query += (limit >= 0 ? " LIMIT ?;" : ";");
+    bool ok = this->db->prepareQuery(query);
+    ok = keepFalse(ok, this->db->bindValues(0, match, this->searchMatch));
+    if (limit >= 0) {
+        ok = keepFalse(ok, this->db->bindInt(2, limit));
+    }
+    // Allow the search to be interrupted while it's running (or before, if it was interrupted while waiting for the lock)
+    this->searchStart = token;
+    this->db->setProgressHandler(Database::searchProgress, this);
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->db->setProgressHandler(nullptr, nullptr);
+        if (this->searchInterrupts == token) {
+            this->setErrorMsg("[searchAlbums] An error occurred searching for: " + str);
+            success = false;
         }
+        return v;
+    }
 
-        // Iterate over returned rows
-        int tmp;
-        while (ok && this->db->hasRow()) {
-            Metadata::Album m;
-            ok = this->db->getInt(0, m.ID);
-
-            // Skip over album if already in vector
-            std::vector<Metadata::Album>::iterator it = std::find_if(v.begin(), v.end(), [m](const Metadata::Album e) {
-                return e.ID == m.ID;
-            });
-            if (it != v.end()) {
-                ok = keepFalse(ok, this->db->nextRow());
-                continue;
-            }
-
-            ok = keepFalse(ok, this->db->getString(1, m.name));
-            ok = keepFalse(ok, this->db->getString(2, m.artist));
-            ok = keepFalse(ok, this->db->getInt(3, tmp));
-            m.tadbID = tmp;
-            ok = keepFalse(ok, this->db->getString(4, m.imagePath));
-            ok = keepFalse(ok, this->db->getInt(5, tmp));
-            m.songCount = tmp;
+    // Iterate over returned rows
+    while (ok && this->db->hasRow()) {
+        Metadata::Album m;
+        ok = readAlbum(this->db, m);
 
-            if (ok) {
-                v.push_back(m);
-            }
-            ok = keepFalse(ok, this->db->nextRow());
+        if (ok) {
+            v.push_back(std::move(m));
+        } else {
+            this->setErrorMsg("[searchAlbums] Unable to read a result for: " + str);
+            success = false;
         }
+        ok = keepFalse(ok, this->db->nextRow());
     }
 
+    // Stop other queries from being interrupted
+    this->db->setProgressHandler(nullptr, nullptr);
     return v;
 }
 
-std::vector<Metadata::Artist> Database::searchArtists(std::string str, int limit) {
+std::vector<Metadata::Artist> Database::searchArtists(std::string str, const unsigned int token, bool & success, int limit) {
     std::vector<Metadata::Artist> v;
+    success = true;
     if (limit == 0) {
         return v;
     }
@@ -1624,69 +1717,59 @@ std::vector<Metadata::Artist> Database::searchArtists(std::string str, int limit
     // Check we can read
     if (this->db->connectionType() == SQLite::Connection::None) {
         this->setErrorMsg("[searchArtists] No open connection");
+        success = false;
         return v;
     }
 
-    // Fix any spelling mistakes and get suggested searches based on input
-    std::vector<std::string> phrases = this->getSearchPhrases("SpellfixArtists", str);
-    if (phrases.empty()) {
+    // Form the MATCH expression from the input
+    std::string match = this->getSearchQuery(str);
+    if (match.empty()) {
         return v;
     }
 
-    // Iterate over each phrase and store results
-    for (size_t i = 0; i < phrases.size(); i++) {
-        // Create query and optionally append LIMIT
-        // A little note: "SELECT DISTINCT content AS text" has to be in the subquery otherwise SQLite says "matchinfo can't be used in this context"...
-        // It works fine on Linux with "SELECT content" so who knows why it's disagreeing here
-        std::string query = "SELECT Artists.id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id), COUNT(*) FROM Songs JOIN Artists ON Songs.artist_id = Artists.id LEFT JOIN (SELECT DISTINCT content AS text, okapi_bm25(matchinfo(FtsArtists, 'pcxnal'), 0) AS score FROM FtsArtists WHERE FtsArtists MATCH ?) ON Artists.name = text WHERE score IS NOT NULL GROUP BY artist_id ORDER BY score DESC, Artists.name";
-        query += (limit >= 0 ? " LIMIT ?;" : ";");
-        bool ok = this->db->prepareQuery(query);
-        std::string str = phrases[i];
-        ok = keepFalse(ok, this->db->bindString(0, str));
-        if (limit >= 0) {
-            ok = keepFalse(ok, this->db->bindInt(1, limit));
-        }
-        ok = keepFalse(ok, this->db->executeQuery());
-        if (!ok) {
-            this->setErrorMsg("[searchArtists] An error occurred searching with the phrase: " + phrases[i]);
-            return v;
+    // Create query and optionally append LIMIT
+    std::string query = "SELECT " ARTIST_COLUMNS " FROM ArtistStats JOIN Artists ON ArtistStats.artist_id = Artists.id JOIN (SELECT DISTINCT docid AS doc, okapi_bm25(matchinfo(FtsArtists, 'pcxnal'), 0) AS score FROM FtsArtists WHERE FtsArtists MATCH ? AND matchPercent(matchinfo(FtsArtists, 'pcx')) >= ?) ON Artists.id = doc ORDER BY score DESC, Artists.sort_name";
+    query += (limit >= 0 ? " LIMIT ?;" : ";");
+    bool ok = this->db->prepareQuery(query);
+    ok = keepFalse(ok, this->db->bindValues(0, match, this->searchMatch));
+    if (limit >= 0) {
+        ok = keepFalse(ok, this->db->bindInt(2, limit));
+    }
+    // Allow the search to be interrupted while it's running (or before, if it was interrupted while waiting for the lock)
+    this->searchStart = token;
+    this->db->setProgressHandler(Database::searchProgress, this);
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->db->setProgressHandler(nullptr, nullptr);
+        if (this->searchInterrupts == token) {
+            this->setErrorMsg("[searchArtists] An error occurred searching for: " + str);
+            success = false;
         }
+        return v;
+    }
 
-        // Iterate over returned rows
-        int tmp;
-        while (ok && this->db->hasRow()) {
-            Metadata::Artist m;
-            ok = this->db->getInt(0, m.ID);
-
-            // Skip over artist if already in vector
-            std::vector<Metadata::Artist>::iterator it = std::find_if(v.begin(), v.end(), [m](const Metadata::Artist e) {
-                return e.ID == m.ID;
-            });
-            if (it != v.end()) {
-                ok = keepFalse(ok, this->db->nextRow());
-                continue;
-            }
-
-            ok = keepFalse(ok, this->db->getString(1, m.name));
-            ok = keepFalse(ok, this->db->getInt(2, m.tadbID));
-            ok = keepFalse(ok, this->db->getString(3, m.imagePath));
-            ok = keepFalse(ok, this->db->getInt(4, tmp));
-            m.albumCount = tmp;
-            ok = keepFalse(ok, this->db->getInt(5, tmp));
-            m.songCount = tmp;
+    // Iterate over returned rows
+    while (ok && this->db->hasRow()) {
+        Metadata::Artist m;
+        ok = readArtist(this->db, m);
 
-            if (ok) {
-                v.push_back(m);
-            }
-            ok = keepFalse(ok, this->db->nextRow());
+        if (ok) {
+            v.push_back(std::move(m));
+        } else {
+            this->setErrorMsg("[searchArtists] Unable to read a result for: " + str);
+            success = false;
         }
+        ok = keepFalse(ok, this->db->nextRow());
     }
 
+    // Stop other queries from being interrupted
+    this->db->setProgressHandler(nullptr, nullptr);
     return v;
 }
 
-std::vector<Metadata::Playlist> Database::searchPlaylists(std::string str, int limit) {
+std::vector<Metadata::Playlist> Database::searchPlaylists(std::string str, const unsigned int token, bool & success, int limit) {
     std::vector<Metadata::Playlist> v;
+    success = true;
     if (limit == 0) {
         return v;
     }
@@ -1694,67 +1777,59 @@ std::vector<Metadata::Playlist> Database::searchPlaylists(std::string str, int l
     // Check we can read
     if (this->db->connectionType() == SQLite::Connection::None) {
         this->setErrorMsg("[searchPlaylists] No open connection");
+        success = false;
         return v;
     }
 
-    // Fix any spelling mistakes and get suggested searches based on input
-    std::vector<std::string> phrases = this->getSearchPhrases("SpellfixPlaylists", str);
-    if (phrases.empty()) {
+    // Form the MATCH expression from the input
+    std::string match = this->getSearchQuery(str);
+    if (match.empty()) {
         return v;
     }
 
-    // Iterate over each phrase and store results
-    for (size_t i = 0; i < phrases.size(); i++) {
-        // Create query and optionally append LIMIT
-        // A little note: "SELECT DISTINCT content AS text" has to be in the subquery otherwise SQLite says "matchinfo can't be used in this context"...
-        // It works fine on Linux with "SELECT content" so who knows why it's disagreeing here
-        std::string query = "SELECT id, name, description, image_path, COUNT(PlaylistSongs.song_id), score FROM Playlists LEFT JOIN PlaylistSongs ON playlist_id = Playlists.id LEFT JOIN (SELECT DISTINCT content AS text, okapi_bm25(matchinfo(FtsPlaylists, 'pcxnal'), 0) AS score FROM FtsPlaylists WHERE FtsPlaylists MATCH ?) ON name = text WHERE score IS NOT NULL GROUP BY Playlists.id ORDER BY score DESC, name";
-        query += (limit >= 0 ? " LIMIT ?;" : ";");
-        bool ok = this->db->prepareQuery(query);
-        std::string str = phrases[i];
-        ok = keepFalse(ok, this->db->bindString(0, str));
-        if (limit >= 0) {
-            ok = keepFalse(ok, this->db->bindInt(1, limit));
-        }
-        ok = keepFalse(ok, this->db->executeQuery());
-        if (!ok) {
-            this->setErrorMsg("[searchPlaylists] An error occurred searching with the phrase: " + phrases[i]);
-            return v;
+    // Create query and optionally append LIMIT
+    std::string query = "SELECT " PLAYLIST_COLUMNS " FROM Playlists LEFT JOIN PlaylistSongs ON playlist_id = Playlists.id JOIN (SELECT DISTINCT docid AS doc, okapi_bm25(matchinfo(FtsPlaylists, 'pcxnal'), 0) AS score FROM FtsPlaylists WHERE FtsPlaylists MATCH ? AND matchPercent(matchinfo(FtsPlaylists, 'pcx')) >= ?) ON Playlists.id = doc GROUP BY Playlists.id ORDER BY score DESC, sort_name";
+    query += (limit >= 0 ? " LIMIT ?;" : ";");
+    bool ok = this->db->prepareQuery(query);
+    ok = keepFalse(ok, this->db->bindValues(0, match, this->searchMatch));
+    if (limit >= 0) {
+        ok = keepFalse(ok, this->db->bindInt(2, limit));
+    }
+    // Allow the search to be interrupted while it's running (or before, if it was interrupted while waiting for the lock)
+    this->searchStart = token;
+    this->db->setProgressHandler(Database::searchProgress, this);
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->db->setProgressHandler(nullptr, nullptr);
+        if (this->searchInterrupts == token) {
+            this->setErrorMsg("[searchPlaylists] An error occurred searching for: " + str);
+            success = false;
         }
+        return v;
+    }
 
-        // Iterate over returned rows
-        int tmp;
-        while (ok && this->db->hasRow()) {
-            Metadata::Playlist m;
-            ok = this->db->getInt(0, m.ID);
-
-            // Skip over playlist if already in vector
-            std::vector<Metadata::Playlist>::iterator it = std::find_if(v.begin(), v.end(), [m](const Metadata::Playlist e) {
-                return e.ID == m.ID;
-            });
-            if (it != v.end()) {
-                ok = keepFalse(ok, this->db->nextRow());
-                continue;
-            }
-
-            ok = keepFalse(ok, this->db->getString(1, m.name));
-            ok = keepFalse(ok, this->db->getString(2, m.description));
-            ok = keepFalse(ok, this->db->getString(3, m.imagePath));
-            ok = keepFalse(ok, this->db->getInt(4, tmp));
-            m.songCount = tmp;
+    // Iterate over returned rows
+    while (ok && this->db->hasRow()) {
+        Metadata::Playlist m;
+        ok = readPlaylist(this->db, m);
 
-            if (ok) {
-                v.push_back(m);
-            }
-            ok = keepFalse(ok, this->db->nextRow());
+        if (ok) {
+            v.push_back(std::move(m));
+        } else {
+            this->setErrorMsg("[searchPlaylists] Unable to read a result for: " + str);
+            success = false;
         }
+        ok = keepFalse(ok, this->db->nextRow());
     }
 
+    // Stop other queries from being interrupted
+    this->db->setProgressHandler(nullptr, nullptr);
     return v;
 }
 
-std::vector<Metadata::Song> Database::searchSongs(std::string str, int limit) {
+std::vector<Metadata::Song> Database::searchSongs(std::string str, const unsigned int token, bool & success, int limit) {
     std::vector<Metadata::Song> v;
+    success = true;
     if (limit == 0) {
         return v;
     }
@@ -1762,73 +1837,53 @@ std::vector<Metadata::Song> Database::searchSongs(std::string str, int limit) {
     // Check we can read
     if (this->db->connectionType() == SQLite::Connection::None) {
         this->setErrorMsg("[searchSongs] No open connection");
+        success = false;
         return v;
     }
 
-    // Fix any spelling mistakes and get suggested searches based on input
-    std::vector<std::string> phrases = this->getSearchPhrases("SpellfixSongs", str);
-    if (phrases.empty()) {
+    // Form the MATCH expression from the input
+    std::string match = this->getSearchQuery(str);
+    if (match.empty()) {
         return v;
     }
 
-    // Iterate over each phrase and store results
-    for (size_t i = 0; i < phrases.size(); i++) {
-        // Create query and optionally append LIMIT
-        std::string query = "SELECT Songs.id, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN FtsSongs ON Songs.title = FtsSongs.title JOIN Artists ON artist_id = Artists.id JOIN Albums ON album_id = Albums.id WHERE FtsSongs MATCH ? ORDER BY okapi_bm25(matchinfo(FtsSongs, 'pcxnal'), 0) DESC, Songs.title";
-        query += (limit >= 0 ? " LIMIT ?;" : ";");
-        bool ok = this->db->prepareQuery(query);
-        std::string str = phrases[i];
-        ok = keepFalse(ok, this->db->bindString(0, str));
-        if (limit >= 0) {
-            ok = keepFalse(ok, this->db->bindInt(1, limit));
-        }
-        ok = keepFalse(ok, this->db->executeQuery());
-        if (!ok) {
-            this->setErrorMsg("[searchSongs] An error occurred searching with the phrase: " + phrases[i]);
-            return v;
+    // Create query and optionally append LIMIT
+    std::string query = "SELECT " SONG_COLUMNS " FROM (SELECT DISTINCT docid AS doc, okapi_bm25(matchinfo(FtsSongs, 'pcxnal'), 0) + okapi_bm25(matchinfo(FtsSongs, 'pcxnal'), 1) + okapi_bm25(matchinfo(FtsSongs, 'pcxnal'), 2) AS score FROM FtsSongs WHERE FtsSongs MATCH ? AND matchPercent(matchinfo(FtsSongs, 'pcx')) >= ?) JOIN Songs ON Songs.id = doc JOIN Artists ON artist_id = Artists.id JOIN Albums ON album_id = Albums.id ORDER BY score DESC, Songs.sort_title";
+    query += (limit >= 0 ? " LIMIT ?;" : ";");
+    bool ok = this->db->prepareQuery(query);
+    ok = keepFalse(ok, this->db->bindValues(0, match, this->searchMatch));
+    if (limit >= 0) {
+        ok = keepFalse(ok, this->db->bindInt(2, limit));
+    }
+    // Allow the search to be interrupted while it's running (or before, if it was interrupted while waiting for the lock)
+    this->searchStart = token;
+    this->db->setProgressHandler(Database::searchProgress, this);
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->db->setProgressHandler(nullptr, nullptr);
+        if (this->searchInterrupts == token) {
+            this->setErrorMsg("[searchSongs] An error occurred searching for: " + str);
+            success = false;
         }
+        return v;
+    }
 
-        // Iterate over returned rows
-        int tmp;
-        std::string tmpStr;
-        while (ok && this->db->hasRow()) {
-            Metadata::Song m;
-            ok = this->db->getInt(0, m.ID);
-
-            // Skip over song if already in vector
-            std::vector<Metadata::Song>::iterator it = std::find_if(v.begin(), v.end(), [m](const Metadata::Song e) {
-                return e.ID == m.ID;
-            });
-            if (it != v.end()) {
-                ok = keepFalse(ok, this->db->nextRow());
-                continue;
-            }
+    // Iterate over returned rows
+    while (ok && this->db->hasRow()) {
+        Metadata::Song m;
+        ok = readSong(this->db, m);
 
-            ok = keepFalse(ok, this->db->getString(1, m.title));
-            ok = keepFalse(ok, this->db->getString(2, m.artist));
-            ok = keepFalse(ok, this->db->getString(3, m.album));
-            ok = keepFalse(ok, this->db->getInt(4, tmp));
-            m.trackNumber = tmp;
-            ok = keepFalse(ok, this->db->getInt(5, tmp));
-            m.discNumber = tmp;
-            ok = keepFalse(ok, this->db->getInt(6, tmp));
-            m.duration = tmp;
-            ok = keepFalse(ok, this->db->getInt(7, tmp));
-            m.plays = tmp;
-            ok = keepFalse(ok, this->db->getBool(8, m.favourite));
-            ok = keepFalse(ok, this->db->getString(9, m.path));
-            ok = keepFalse(ok, this->db->getString(10, tmpStr));
-            m.format = audioFormatFromString(tmpStr);
-            ok = keepFalse(ok, this->db->getInt(11, tmp));
-            m.modified = tmp;
-
-            if (ok) {
-                v.push_back(m);
-            }
-            ok = keepFalse(ok, this->db->nextRow());
+        if (ok) {
+            v.push_back(std::move(m));
+        } else {
+            this->setErrorMsg("[searchSongs] Unable to read a result for: " + str);
+            success = false;
         }
+        ok = keepFalse(ok, this->db->nextRow());
     }
 
+    // Stop other queries from being interrupted
+    this->db->setProgressHandler(nullptr, nullptr);
     return v;
 }
 
@@ -1843,32 +1898,163 @@ std::vector<std::string> Database::getAllImagePaths(bool & success) {
         return v;
     }
 
-    // Get all paths by iterating over tables (alphabetically)
-    std::string tables[3] = {"Albums", "Artists", "Playlists"};
-    for (size_t i = 0; i < 3; i++) {
-        // Query database
-        bool ok = this->db->prepareAndExecuteQuery("SELECT image_path FROM " + tables[i] + " ORDER BY image_path;");
-        if (!ok) {
-            this->setErrorMsg("[getAllImagePaths] Couldn't read from " + tables[i] + " table");
-            success = false;
-            return v;
-        }
+    // Every image set on a row is counted in the Images table (including those no longer used)
+    bool ok = this->db->prepareAndExecuteQuery("SELECT path FROM Images ORDER BY path;");
+    if (!ok) {
+        this->setErrorMsg("[getAllImagePaths] Couldn't read from Images table");
+        success = false;
+        return v;
+    }
 
-        // Iterate over returned rows
-        while (ok && this->db->hasRow()) {
-            std::string str;
-            ok = this->db->getString(0, str);
-            if (ok && !str.empty()) {
-                v.push_back(str);
-            }
-            ok = keepFalse(ok, this->db->nextRow());
+    // Iterate over returned rows
+    while (ok && this->db->hasRow()) {
+        std::string str;
+        ok = this->db->getString(0, str);
+        if (ok) {
+            v.push_back(str);
         }
+        ok = keepFalse(ok, this->db->nextRow());
     }
 
     success = true;
     return v;
 }
 
+bool Database::removeUnusedImages(int limit) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[removeUnusedImages] Can't remove images as the database is unwritable");
+        return false;
+    }
+
+    // Get the images which aren't used by any row
+    std::vector<std::string> paths;
+    bool ok = this->db->prepareQuery("SELECT path FROM Images WHERE refs < 1 LIMIT ?;");
+    ok = keepFalse(ok, this->db->bindInt(0, limit));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[removeUnusedImages] Couldn't read from Images table");
+        return false;
+    }
+    while (ok && this->db->hasRow()) {
+        std::string str;
+        ok = this->db->getString(0, str);
+        if (ok) {
+            paths.push_back(str);
+        }
+        ok = keepFalse(ok, this->db->nextRow());
+    }
+    if (paths.empty()) {
+        return true;
+    }
+
+    // Forget each image within one transaction, only deleting the files once that's been committed
+    // (as the database lock is held, nothing can start using them in the meantime)
+    ok = this->db->beginTransaction();
+    for (size_t i = 0; ok && i < paths.size(); i++) {
+        ok = this->db->prepareQuery("DELETE FROM Images WHERE path = ? AND refs < 1;");
+        ok = keepFalse(ok, this->db->bindString(0, paths[i]));
+        ok = keepFalse(ok, this->db->executeQuery());
+    }
+
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[removeUnusedImages] An error occurred removing the images");
+        return false;
+    }
+
+    for (const std::string & path : paths) {
+        Utils::Image::deleteArt(path);
+    }
+    Log::writeInfo("[DB] Removed " + std::to_string(paths.size()) + " unused images");
+    return true;
+}
+
+std::vector<std::string> Database::getAlbumImagesWithoutPalette() {
+    std::vector<std::string> v;
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getAlbumImagesWithoutPalette] No open connection");
+        return v;
+    }
+
+    bool ok = this->db->prepareAndExecuteQuery("SELECT path FROM Images WHERE palette_background IS NULL AND path IN (SELECT image_path FROM Albums);");
+    if (!ok) {
+        this->setErrorMsg("[getAlbumImagesWithoutPalette] Couldn't read from Images table");
+        return v;
+    }
+
+    while (ok && this->db->hasRow()) {
+        std::string str;
+        ok = this->db->getString(0, str);
+        if (ok) {
+            v.push_back(str);
+        }
+        ok = keepFalse(ok, this->db->nextRow());
+    }
+    return v;
+}
+
+Metadata::Palette Database::getPaletteForImage(const std::string & path) {
+    Metadata::Palette palette;
+    palette.valid = false;
+
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getPaletteForImage] No open connection");
+        return palette;
+    }
+
+    // Colours are stored as signed integers, so are cast back to unsigned
+    bool ok = this->db->prepareQuery("SELECT palette_background, palette_primary, palette_secondary, palette_light FROM Images WHERE path = ? AND palette_background IS NOT NULL;");
+    ok = keepFalse(ok, this->db->bindString(0, path));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok || !this->db->hasRow()) {
+        return palette;
+    }
+
+    int background, primary, secondary;
+    ok = this->db->getColumns(0, background, primary, secondary, palette.bgLight);
+    if (ok) {
+        palette.background = static_cast<uint32_t>(background);
+        palette.primary = static_cast<uint32_t>(primary);
+        palette.secondary = static_cast<uint32_t>(secondary);
+        palette.valid = true;
+    }
+    return palette;
+}
+
+bool Database::setImagePalettes(const std::vector< std::pair<std::string, Metadata::Palette> > & palettes) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[setImagePalettes] Can't update images as the database is unwritable");
+        return false;
+    }
+
+    // Update each image within one transaction so there's only one commit
+    bool ok = this->db->beginTransaction();
+    for (size_t i = 0; ok && i < palettes.size(); i++) {
+        const Metadata::Palette & palette = palettes[i].second;
+        ok = this->db->prepareQuery("UPDATE Images SET palette_background = ?, palette_primary = ?, palette_secondary = ?, palette_light = ? WHERE path = ?;");
+        ok = keepFalse(ok, this->db->bindValues(0, static_cast<int>(palette.background), static_cast<int>(palette.primary), static_cast<int>(palette.secondary), palette.bgLight, palettes[i].first));
+        ok = keepFalse(ok, this->db->executeQuery());
+    }
+
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[setImagePalettes] An error occurred updating the images");
+    }
+    return ok;
+}
+
 std::vector< std::pair<std::string, unsigned int> > Database::getAllSongFileInfo(bool & success) {
     std::vector< std::pair<std::string, unsigned int> > v;
 
@@ -1889,10 +2075,9 @@ std::vector< std::pair<std::string, unsigned int> > Database::getAllSongFileInfo
     while (ok && this->db->hasRow()) {
         std::string path;
         int modified;
-        ok = this->db->getString(0, path);
-        ok = keepFalse(ok, this->db->getInt(1, modified));
+        ok = this->db->getColumns(0, path, modified);
         if (ok) {
-            v.push_back(std::make_pair(path, modified));
+            v.push_back(std::make_pair(std::move(path), modified));
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -1992,6 +2177,403 @@ SongID Database::getSongIDForPath(std::string & path) {
     return id;
 }
 
+std::string Database::getSongFingerprintForPath(const std::string & path) {
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getSongFingerprintForPath] No open connection");
+        return "";
+    }
+
+    // Query fingerprint (NULL is read as blank)
+    std::string fingerprint;
+    bool ok = this->db->prepareQuery("SELECT fingerprint FROM Songs WHERE path = ?;");
+    ok = keepFalse(ok, this->db->bindString(0, path));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (ok && this->db->hasRow()) {
+        ok = this->db->getString(0, fingerprint);
+    }
+    if (!ok) {
+        this->setErrorMsg("[getSongFingerprintForPath] An error occurred querying path");
+        return "";
+    }
+
+    return fingerprint;
+}
+
+std::vector<std::string> Database::getSongPathsWithoutFingerprint(int limit) {
+    std::vector<std::string> v;
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getSongPathsWithoutFingerprint] No open connection");
+        return v;
+    }
+
+    bool ok = this->db->prepareQuery("SELECT path FROM Songs WHERE fingerprint IS NULL ORDER BY path LIMIT ?;");
+    ok = keepFalse(ok, this->db->bindInt(0, limit));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[getSongPathsWithoutFingerprint] Unable to query for songs without a fingerprint");
+        return v;
+    }
+
+    while (ok && this->db->hasRow()) {
+        std::string str;
+        ok = this->db->getString(0, str);
+        if (ok) {
+            v.push_back(str);
+        }
+        ok = keepFalse(ok, this->db->nextRow());
+    }
+    return v;
+}
+
+bool Database::setSongFingerprints(const std::vector< std::pair<std::string, std::string> > & fingerprints) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[setSongFingerprints] Can't update fingerprints as the database is unwritable");
+        return false;
+    }
+
+    bool ok = this->db->beginTransaction();
+    for (size_t i = 0; ok && i < fingerprints.size(); i++) {
+        ok = this->db->prepareQuery("UPDATE Songs SET fingerprint = ? WHERE path = ?;");
+        ok = keepFalse(ok, this->db->bindValues(0, fingerprints[i].second, fingerprints[i].first));
+        ok = keepFalse(ok, this->db->executeQuery());
+    }
+
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[setSongFingerprints] An error occurred updating the fingerprints");
+    }
+    return ok;
+}
+
+// ===== Play History ===== //
+bool Database::importPlayJournal() {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[importPlayJournal] Can't import plays as the database is unwritable");
+        return false;
+    }
+
+    // Move the journal aside so the sysmodule starts a new one while we read it
+    // If it's already there then the last import didn't finish, so that is imported first
+    std::string tmp = Path::Common::PlayJournalFile + ".tmp";
+    if (!Utils::Fs::fileExists(tmp)) {
+        if (!Utils::Fs::fileExists(Path::Common::PlayJournalFile)) {
+            return true;
+        }
+        if (!Utils::Fs::moveFile(Path::Common::PlayJournalFile, tmp)) {
+            this->setErrorMsg("[importPlayJournal] Unable to move the play journal");
+            return false;
+        }
+    }
+
+    // Read all complete events
+    std::vector<unsigned char> data;
+    if (!Utils::Fs::readFile(tmp, data)) {
+        this->setErrorMsg("[importPlayJournal] Unable to read the play journal");
+        return false;
+    }
+    size_t count = data.size() / sizeof(PlayJournal::Event);
+    std::vector<PlayJournal::Event> events(count);
+    std::copy(data.begin(), data.begin() + count * sizeof(PlayJournal::Event), reinterpret_cast<unsigned char *>(events.data()));
+
+    // Add every event in one transaction, ignoring songs which have since been removed
+    // A song only counts as played if it wasn't skipped
+    bool ok = this->db->beginTransaction();
+    for (size_t i = 0; ok && i < events.size(); i++) {
+        const PlayJournal::Event & e = events[i];
+        ok = this->db->prepareQuery("INSERT INTO History (song_id, time, percent, skipped) SELECT id, ?, ?, ? FROM Songs WHERE id = ?;");
+        ok = keepFalse(ok, this->db->bindValues(0, e.time, std::min<int>(e.percent, 100), e.skipped != 0, e.songID));
+        ok = keepFalse(ok, this->db->executeQuery());
+        if (ok && e.skipped == 0) {
+            ok = this->db->prepareQuery("UPDATE Songs SET plays = plays + 1 WHERE id = ?;");
+            ok = keepFalse(ok, this->db->bindInt(0, e.songID));
+            ok = keepFalse(ok, this->db->executeQuery());
+        }
+    }
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[importPlayJournal] An error occurred adding plays to the database");
+        return false;
+    }
+
+    // Only remove the journal once it's safely in the database
+    Utils::Fs::deleteFile(tmp);
+    if (Log::loggingLevel() == Log::Level::Info) {
+        Log::writeInfo("[DB] [importPlayJournal] Imported " + std::to_string(events.size()) + " plays");
+    }
+    return true;
+}
+
+// ===== Directory Manifest ===== //
+std::vector<Metadata::Directory> Database::getAllDirectoryInfo(bool & success) {
+    std::vector<Metadata::Directory> v;
+
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getAllDirectoryInfo] No open connection");
+        success = false;
+        return v;
+    }
+
+    bool ok = this->db->prepareAndExecuteQuery("SELECT path, modified, entries FROM Directories ORDER BY path;");
+    if (!ok) {
+        this->setErrorMsg("[getAllDirectoryInfo] Unable to query information for all directories");
+        success = false;
+        return v;
+    }
+    while (ok && this->db->hasRow()) {
+        Metadata::Directory dir;
+        ok = this->db->getColumns(0, dir.path, dir.modified, dir.entries);
+        if (ok) {
+            v.push_back(std::move(dir));
+        }
+        ok = keepFalse(ok, this->db->nextRow());
+    }
+
+    success = true;
+    v.shrink_to_fit();
+    return v;
+}
+
+bool Database::setAllDirectoryInfo(const std::vector<Metadata::Directory> & dirs) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[setAllDirectoryInfo] Can't update directories as the database is unwritable");
+        return false;
+    }
+
+    // Replace everything in one transaction
+    bool ok = this->db->beginTransaction();
+    ok = keepFalse(ok, this->db->prepareAndExecuteQuery("DELETE FROM Directories;"));
+    for (size_t i = 0; ok && i < dirs.size(); i++) {
+        ok = this->db->prepareQuery("INSERT INTO Directories (path, modified, entries) VALUES (?, ?, ?);");
+        ok = keepFalse(ok, this->db->bindValues(0, dirs[i].path, dirs[i].modified, dirs[i].entries));
+        ok = keepFalse(ok, this->db->executeQuery());
+    }
+
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[setAllDirectoryInfo] An error occurred updating the directories");
+    }
+    return ok;
+}
+
+bool Database::removeAllDirectoryInfo() {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[removeAllDirectoryInfo] Can't remove directories as the database is unwritable");
+        return false;
+    }
+
+    bool ok = this->db->prepareAndExecuteQuery("DELETE FROM Directories;");
+    if (!ok) {
+        this->setErrorMsg("[removeAllDirectoryInfo] An error occurred removing the directories");
+    }
+    return ok;
+}
+
+// ===== Scan Journal ===== //
+bool Database::addToScanJournal(const std::vector<std::string> & paths) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[addToScanJournal] Can't add to the scan journal as the database is unwritable");
+        return false;
+    }
+
+    // Files left by an interrupted scan keep their state
+    bool ok = this->db->beginTransaction();
+    for (size_t i = 0; ok && i < paths.size(); i++) {
+        ok = this->db->prepareQuery("INSERT OR IGNORE INTO ScanJournal (path) VALUES (?);");
+        ok = keepFalse(ok, this->db->bindString(0, paths[i]));
+        ok = keepFalse(ok, this->db->executeQuery());
+    }
+
+    if (ok) {
+        ok = this->db->commitTransaction();
+    } else {
+        this->db->rollbackTransaction();
+    }
+    if (!ok) {
+        this->setErrorMsg("[addToScanJournal] An error occurred adding files to the scan journal");
+    }
+    return ok;
+}
+
+bool Database::setScanJournalStored(const std::vector<std::string> & paths) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[setScanJournalStored] Can't update the scan journal as the database is unwritable");
+        return false;
+    }
+
+    // No transaction is used, as the caller's transaction also stores the songs
+    bool ok = true;
+    for (size_t i = 0; ok && i < paths.size(); i++) {
+        ok = this->db->prepareQuery("UPDATE ScanJournal SET stored = 1 WHERE path = ?;");
+        ok = keepFalse(ok, this->db->bindString(0, paths[i]));
+        ok = keepFalse(ok, this->db->executeQuery());
+    }
+    if (!ok) {
+        this->setErrorMsg("[setScanJournalStored] An error occurred updating the scan journal");
+    }
+    return ok;
+}
+
+std::vector<Metadata::Song> Database::getStoredScanJournalSongs(bool & success) {
+    std::vector<Metadata::Song> v;
+
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getStoredScanJournalSongs] No open connection");
+        success = false;
+        return v;
+    }
+
+    // Files which have since been removed won't have a matching song
+    bool ok = this->db->prepareAndExecuteQuery("SELECT " SONG_COLUMNS " FROM ScanJournal JOIN Songs ON Songs.path = ScanJournal.path JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE ScanJournal.stored = 1 ORDER BY Songs.path;");
+    if (!ok) {
+        this->setErrorMsg("[getStoredScanJournalSongs] Unable to query the scan journal");
+        success = false;
+        return v;
+    }
+    bool readOK = true;
+    while (ok && this->db->hasRow()) {
+        Metadata::Song m;
+        readOK = readSong(this->db, m);
+        if (readOK) {
+            v.push_back(std::move(m));
+        }
+        ok = keepFalse(readOK, this->db->nextRow());
+    }
+
+    // A partial list would cause art to be skipped for the missing songs
+    if (!readOK) {
+        this->setErrorMsg("[getStoredScanJournalSongs] Unable to read a song from the scan journal");
+        success = false;
+        v.clear();
+        return v;
+    }
+
+    success = true;
+    v.shrink_to_fit();
+    return v;
+}
+
+bool Database::clearScanJournal() {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[clearScanJournal] Can't clear the scan journal as the database is unwritable");
+        return false;
+    }
+
+    bool ok = this->db->prepareAndExecuteQuery("DELETE FROM ScanJournal;");
+    if (!ok) {
+        this->setErrorMsg("[clearScanJournal] An error occurred clearing the scan journal");
+    }
+    return ok;
+}
+
+// ===== Path Index ===== //
+bool Database::exportPathIndex() {
+    // Nothing to do if songs haven't changed since the last export
+    if (!this->pathIndexOutdated && Utils::Fs::fileExists(Path::Common::PathIndexFile)) {
+        return true;
+    }
+
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[exportPathIndex] No open connection");
+        return false;
+    }
+
+    // Read every song in order of ID
+    bool ok = this->db->prepareAndExecuteQuery("SELECT Songs.id, Songs.duration, Songs.path, Songs.title, Artists.name, Albums.name, Albums.image_path FROM Songs JOIN Artists ON Artists.id = Songs.artist_id JOIN Albums ON Albums.id = Songs.album_id ORDER BY Songs.id;");
+    if (!ok) {
+        this->setErrorMsg("[exportPathIndex] Couldn't read from Songs table");
+        return false;
+    }
+
+    std::vector<PathIndex::Entry> entries;
+    std::string records;
+    bool readOK = true;
+    while (ok && this->db->hasRow()) {
+        SongID id;
+        int duration;
+        std::string record;
+        readOK = this->db->getColumns(0, id, duration);
+        for (int col = 2; col <= 6; col++) {
+            std::string str;
+            readOK = keepFalse(readOK, this->db->getString(col, str));
+            record += str;
+            record += '\0';
+        }
+        if (readOK) {
+            PathIndex::Entry e;
+            e.id = id;
+            e.offset = records.length();
+            e.length = record.length();
+            e.duration = duration;
+            entries.push_back(e);
+            records += record;
+        }
+        ok = keepFalse(readOK, this->db->nextRow());
+    }
+
+    // Keep the old index rather than replacing it with one that's missing songs
+    if (!readOK) {
+        this->setErrorMsg("[exportPathIndex] Unable to read a song from the Songs table");
+        return false;
+    }
+
+    // Store the first ID of each block so a lookup only needs to read one block of entries
+    std::vector<int32_t> fences;
+    for (size_t i = 0; i < entries.size(); i += PathIndex::BlockSize) {
+        fences.push_back(entries[i].id);
+    }
+    PathIndex::Header header = {PathIndex::Magic, PathIndex::Version, static_cast<uint32_t>(entries.size()), static_cast<uint32_t>(fences.size())};
+
+    // Form the file in memory
+    std::vector<unsigned char> data;
+    auto append = [&data](const void * ptr, const size_t size) {
+        const unsigned char * bytes = static_cast<const unsigned char *>(ptr);
+        data.insert(data.end(), bytes, bytes + size);
+    };
+    append(&header, sizeof(PathIndex::Header));
+    append(fences.data(), fences.size() * sizeof(int32_t));
+    append(entries.data(), entries.size() * sizeof(PathIndex::Entry));
+    append(records.data(), records.length());
+
+    // Write to a temporary file first so the old index is only replaced once the new one is complete
+    std::string tmp = Path::Common::PathIndexFile + ".tmp";
+    ok = Utils::Fs::writeFile(tmp, data);
+    ok = keepFalse(ok, Utils::Fs::moveFile(tmp, Path::Common::PathIndexFile));
+    if (!ok) {
+        this->setErrorMsg("[exportPathIndex] Unable to write the path index");
+        return false;
+    }
+
+    this->pathIndexOutdated = false;
+    if (Log::loggingLevel() == Log::Level::Info) {
+        Log::writeInfo("[DB] [exportPathIndex] Exported " + std::to_string(entries.size()) + " songs");
+    }
+    return true;
+}
+
 // ===== Destructor ===== //
 Database::~Database() {
     this->close();
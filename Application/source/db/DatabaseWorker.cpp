@@ -0,0 +1,92 @@
+#include <algorithm>
+#include "db/DatabaseWorker.hpp"
+
+DatabaseWorker::DatabaseWorker(const SyncDatabase & db) : database(db) {
+    this->runningOwner = nullptr;
+    this->runningCancelled = false;
+    this->exit_ = false;
+    this->thread = std::async(std::launch::async, &DatabaseWorker::process, this);
+}
+
+void DatabaseWorker::process() {
+    while (true) {
+        // Wait for a job to be queued
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->condition.wait(lock, [this]() {
+                return this->exit_ || !this->queued.empty();
+            });
+            if (this->exit_) {
+                break;
+            }
+
+            job = this->queued.front();
+            this->queued.pop_front();
+            this->runningOwner = job.owner;
+            this->runningCancelled = false;
+        }
+
+        // Run it without holding the queue's mutex
+        {
+            std::lock_guard<std::mutex> lock(this->jobMutex);
+            job.job(this->database);
+        }
+
+        // Pass the callback back unless the owner has since cancelled it
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->runningCancelled) {
+            this->finished.push_back(job);
+        }
+        this->runningOwner = nullptr;
+    }
+}
+
+void DatabaseWorker::queueJob(const void * owner, const std::function<void(const SyncDatabase &)> & job, const std::function<void()> & done) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->queued.push_back(Job{owner, job, done});
+    this->condition.notify_one();
+}
+
+void DatabaseWorker::cancel(const void * owner) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto matches = [owner](const Job & j) {
+        return j.owner == owner;
+    };
+    this->queued.erase(std::remove_if(this->queued.begin(), this->queued.end(), matches), this->queued.end());
+    this->finished.erase(std::remove_if(this->finished.begin(), this->finished.end(), matches), this->finished.end());
+    if (this->runningOwner == owner) {
+        this->runningCancelled = true;
+    }
+}
+
+void DatabaseWorker::dispatch() {
+    // Callbacks are taken one at a time as they may cancel jobs (e.g. by deleting a frame)
+    while (true) {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if (this->finished.empty()) {
+                break;
+            }
+            job = this->finished.front();
+            this->finished.pop_front();
+        }
+        job.done();
+    }
+}
+
+std::unique_lock<std::mutex> DatabaseWorker::pause() {
+    return std::unique_lock<std::mutex>(this->jobMutex);
+}
+
+DatabaseWorker::~DatabaseWorker() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->exit_ = true;
+        this->queued.clear();
+        this->finished.clear();
+        this->condition.notify_one();
+    }
+    this->thread.get();
+}
\ No newline at end of file
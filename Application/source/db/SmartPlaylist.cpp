@@ -0,0 +1,103 @@
+#include <cstdlib>
+#include "db/SmartPlaylist.hpp"
+
+namespace SmartPlaylist {
+    // Returns the expression used to read the given field (the boolean is set true for text fields)
+    static std::string fieldExpression(const Field field, bool & text, bool & relative) {
+        text = false;
+        switch (field) {
+            case Field::Title:
+                text = true;
+                return "Songs.title";
+
+            case Field::Artist:
+                text = true;
+                return "(SELECT name FROM Artists WHERE Artists.id = Songs.artist_id)";
+
+            case Field::Album:
+                text = true;
+                return "(SELECT name FROM Albums WHERE Albums.id = Songs.album_id)";
+
+            case Field::Duration:
+                return "Songs.duration";
+
+            case Field::Plays:
+                return "Songs.plays";
+
+            case Field::Favourite:
+                return "Songs.favourite";
+
+            case Field::DaysSincePlayed:
+                relative = true;
+                return "((strftime('%s', 'now') - IFNULL((SELECT MAX(time) FROM History WHERE History.song_id = Songs.id), 0)) / 86400)";
+
+            case Field::DaysSinceModified:
+                relative = true;
+                return "((strftime('%s', 'now') - Songs.modified) / 86400)";
+        }
+
+        return "NULL";
+    }
+
+    // Returns the value as an SQL literal
+    static std::string valueLiteral(const std::string & value, const bool text) {
+        // Numbers are converted to ensure nothing else gets through
+        if (!text) {
+            return std::to_string(std::strtoll(value.c_str(), nullptr, 10));
+        }
+
+        // Otherwise quote the string, escaping any quotes within it
+        std::string str = "'";
+        for (const char c : value) {
+            str += c;
+            if (c == '\'') {
+                str += '\'';
+            }
+        }
+        return str + "'";
+    }
+
+    std::string compile(const std::vector<Rule> & rules, bool & relative) {
+        relative = false;
+
+        // No rules matches everything
+        if (rules.empty()) {
+            return "1";
+        }
+
+        std::string predicate;
+        for (const Rule & rule : rules) {
+            bool text;
+            std::string field = fieldExpression(rule.field, text, relative);
+            std::string value = valueLiteral(rule.value, text);
+            std::string collate = (text ? " COLLATE NOCASE" : "");
+
+            std::string expr;
+            switch (rule.comparison) {
+                case Comparison::Is:
+                    expr = field + " = " + value + collate;
+                    break;
+
+                case Comparison::IsNot:
+                    expr = field + " <> " + value + collate;
+                    break;
+
+                case Comparison::Contains:
+                    expr = (text ? "instr(LOWER(" + field + "), LOWER(" + value + ")) > 0" : field + " = " + value);
+                    break;
+
+                case Comparison::LessThan:
+                    expr = field + " < " + value + collate;
+                    break;
+
+                case Comparison::GreaterThan:
+                    expr = field + " > " + value + collate;
+                    break;
+            }
+
+            predicate += (predicate.empty() ? "(" : " AND (") + expr + ")";
+        }
+
+        return predicate;
+    }
+};
\ No newline at end of file
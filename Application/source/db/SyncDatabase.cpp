@@ -33,4 +33,12 @@ SyncDatabase::SyncDatabaseProxy SyncDatabase::operator->() const {
     }, [this]() {
         mutex.unlock();
     });
+}
+
+unsigned int SyncDatabase::searchToken() const {
+    return this->ptr->searchToken();
+}
+
+void SyncDatabase::interruptSearch() const {
+    this->ptr->interruptSearch();
 }
\ No newline at end of file
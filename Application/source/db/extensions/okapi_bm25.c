@@ -33,7 +33,8 @@ static void okapi_bm25(sqlite3_context *pCtx, int nVal, sqlite3_value **apVal) {
     double sum = 0.0;
 
     for (int i = 0; i < termCount; i++) {
-        int currentX = X_OFFSET + (3 * searchTextCol * (i + 1));
+        // Stats are stored per phrase, then per column
+        int currentX = X_OFFSET + (3 * (i * colCount + searchTextCol));
         double termFrequency = matchinfo[currentX];
         double docsWithTerm = matchinfo[currentX + 2];
 
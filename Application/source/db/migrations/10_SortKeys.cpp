@@ -0,0 +1,76 @@
+#include "db/migrations/10_SortKeys.hpp"
+
+namespace Migration {
+    std::string migrateTo10(SQLite * db) {
+        // Add a sort key column to each table which is sorted by name
+        // Keys are computed by sortKey() (see Database.cpp) whenever a row is added or renamed
+        std::string tables[4] = {"Songs", "Artists", "Albums", "Playlists"};
+        std::string columns[4] = {"title", "name", "name", "name"};
+        for (size_t i = 0; i < 4; i++) {
+            bool ok = db->prepareAndExecuteQuery("ALTER TABLE " + tables[i] + " ADD COLUMN sort_" + columns[i] + " TEXT NOT NULL DEFAULT '';");
+            if (!ok) {
+                return "Unable to add sort_" + columns[i] + " to " + tables[i];
+            }
+            ok = db->prepareAndExecuteQuery("UPDATE " + tables[i] + " SET sort_" + columns[i] + " = sortKey(" + columns[i] + ");");
+            if (!ok) {
+                return "Unable to populate sort_" + columns[i] + " in " + tables[i];
+            }
+
+            // Note that the update doesn't retrigger itself as only the key is changed
+            ok = db->prepareAndExecuteQuery("CREATE TRIGGER sortKey" + tables[i] + "Insert AFTER INSERT ON " + tables[i] + " BEGIN UPDATE " + tables[i] + " SET sort_" + columns[i] + " = sortKey(NEW." + columns[i] + ") WHERE id = NEW.id; END;");
+            if (!ok) {
+                return "Unable to create 'sortKey" + tables[i] + "Insert' trigger";
+            }
+            ok = db->prepareAndExecuteQuery("CREATE TRIGGER sortKey" + tables[i] + "Update AFTER UPDATE OF " + columns[i] + " ON " + tables[i] + " WHEN OLD." + columns[i] + " IS NOT NEW." + columns[i] + " BEGIN UPDATE " + tables[i] + " SET sort_" + columns[i] + " = sortKey(NEW." + columns[i] + ") WHERE id = NEW.id; END;");
+            if (!ok) {
+                return "Unable to create 'sortKey" + tables[i] + "Update' trigger";
+            }
+        }
+
+        // Allow artists/albums (and their songs, using the indexes below) to be listed in order straight from an index
+        // Songs aren't indexed by title as reading every row in index order is slower than sorting them afterwards
+        bool ok = db->prepareAndExecuteQuery("CREATE INDEX ArtistsBySortKey ON Artists (sort_name);");
+        if (!ok) {
+            return "Unable to create index on Artists (sort_name)";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE INDEX AlbumsBySortKey ON Albums (sort_name);");
+        if (!ok) {
+            return "Unable to create index on Albums (sort_name)";
+        }
+
+        // Songs are looked up by artist/album, so index both in title order
+        // The other ID is included to cover grouping by artist/album (and counting the other)
+        ok = db->prepareAndExecuteQuery("CREATE INDEX SongsByArtist ON Songs (artist_id, sort_title, album_id);");
+        if (!ok) {
+            return "Unable to create index on Songs (artist_id)";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE INDEX SongsByAlbum ON Songs (album_id, sort_title, artist_id);");
+        if (!ok) {
+            return "Unable to create index on Songs (album_id)";
+        }
+
+        // Playlist songs are looked up by playlist, and by song when a song is removed (cascaded delete)
+        ok = db->prepareAndExecuteQuery("CREATE INDEX PlaylistSongsByPlaylist ON PlaylistSongs (playlist_id, song_id);");
+        if (!ok) {
+            return "Unable to create index on PlaylistSongs (playlist_id)";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE INDEX PlaylistSongsBySong ON PlaylistSongs (song_id);");
+        if (!ok) {
+            return "Unable to create index on PlaylistSongs (song_id)";
+        }
+
+        // Gather statistics so the indexes are used sensibly
+        ok = db->prepareAndExecuteQuery("ANALYZE;");
+        if (!ok) {
+            return "Unable to analyze the database";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 10 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 10";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
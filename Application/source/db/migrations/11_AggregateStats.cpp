@@ -0,0 +1,76 @@
+#include "db/migrations/11_AggregateStats.hpp"
+
+namespace Migration {
+    std::string migrateTo11(SQLite * db) {
+        // Create tables holding the counts for each album/artist (so they aren't counted on every query)
+        // artist_id is any one of the album's artists, which is only shown if artist_count is one
+        bool ok = db->prepareAndExecuteQuery("CREATE TABLE AlbumStats (album_id INTEGER NOT NULL PRIMARY KEY, artist_id INT NOT NULL, artist_count INT NOT NULL, song_count INT NOT NULL, duration INT NOT NULL);");
+        if (!ok) {
+            return "Unable to create the AlbumStats table";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TABLE ArtistStats (artist_id INTEGER NOT NULL PRIMARY KEY, album_count INT NOT NULL, song_count INT NOT NULL, duration INT NOT NULL);");
+        if (!ok) {
+            return "Unable to create the ArtistStats table";
+        }
+
+        // Create views which act as 'procedures' to recount a single album/artist (by inserting its id)
+        // If it no longer has any songs it is simply left out
+        ok = db->prepareAndExecuteQuery("CREATE VIEW RecountAlbums AS SELECT 0 AS id WHERE 0;");
+        if (!ok) {
+            return "Unable to create the RecountAlbums view";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER recountAlbums INSTEAD OF INSERT ON RecountAlbums BEGIN "
+                                        "DELETE FROM AlbumStats WHERE album_id = NEW.id; "
+                                        "INSERT INTO AlbumStats (album_id, artist_id, artist_count, song_count, duration) SELECT album_id, MIN(artist_id), COUNT(DISTINCT artist_id), COUNT(*), SUM(duration) FROM Songs WHERE album_id = NEW.id GROUP BY album_id; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'recountAlbums' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE VIEW RecountArtists AS SELECT 0 AS id WHERE 0;");
+        if (!ok) {
+            return "Unable to create the RecountArtists view";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER recountArtists INSTEAD OF INSERT ON RecountArtists BEGIN "
+                                        "DELETE FROM ArtistStats WHERE artist_id = NEW.id; "
+                                        "INSERT INTO ArtistStats (artist_id, album_count, song_count, duration) SELECT artist_id, COUNT(DISTINCT album_id), COUNT(*), SUM(duration) FROM Songs WHERE artist_id = NEW.id GROUP BY artist_id; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'recountArtists' trigger";
+        }
+
+        // Recount the affected album(s)/artist(s) whenever a song is added, moved or removed
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER statsSongInsert AFTER INSERT ON Songs BEGIN INSERT INTO RecountAlbums VALUES (NEW.album_id); INSERT INTO RecountArtists VALUES (NEW.artist_id); END;");
+        if (!ok) {
+            return "Failed to create 'statsSongInsert' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER statsSongUpdate AFTER UPDATE OF artist_id, album_id, duration ON Songs WHEN OLD.artist_id IS NOT NEW.artist_id OR OLD.album_id IS NOT NEW.album_id OR OLD.duration IS NOT NEW.duration BEGIN "
+                                        "INSERT INTO RecountAlbums VALUES (OLD.album_id); INSERT INTO RecountAlbums VALUES (NEW.album_id); "
+                                        "INSERT INTO RecountArtists VALUES (OLD.artist_id); INSERT INTO RecountArtists VALUES (NEW.artist_id); "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'statsSongUpdate' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER statsSongDelete AFTER DELETE ON Songs BEGIN INSERT INTO RecountAlbums VALUES (OLD.album_id); INSERT INTO RecountArtists VALUES (OLD.artist_id); END;");
+        if (!ok) {
+            return "Failed to create 'statsSongDelete' trigger";
+        }
+
+        // Count the existing library
+        ok = db->prepareAndExecuteQuery("INSERT INTO AlbumStats (album_id, artist_id, artist_count, song_count, duration) SELECT album_id, MIN(artist_id), COUNT(DISTINCT artist_id), COUNT(*), SUM(duration) FROM Songs GROUP BY album_id;");
+        if (!ok) {
+            return "Failed to populate AlbumStats";
+        }
+        ok = db->prepareAndExecuteQuery("INSERT INTO ArtistStats (artist_id, album_count, song_count, duration) SELECT artist_id, COUNT(DISTINCT album_id), COUNT(*), SUM(duration) FROM Songs GROUP BY artist_id;");
+        if (!ok) {
+            return "Failed to populate ArtistStats";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 11 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 11";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "db/migrations/12_PlayHistory.hpp"
+
+namespace Migration {
+    std::string migrateTo12(SQLite * db) {
+        // Create a table holding one row per play (removed along with the song)
+        bool ok = db->prepareAndExecuteQuery("CREATE TABLE History (id INTEGER PRIMARY KEY, song_id INTEGER NOT NULL, time INT NOT NULL, percent INT NOT NULL, skipped BOOLEAN NOT NULL, FOREIGN KEY (song_id) REFERENCES Songs (id) ON DELETE CASCADE);");
+        if (!ok) {
+            return "Unable to create the History table";
+        }
+
+        // Index for 'recently played' and for the cascading delete
+        ok = db->prepareAndExecuteQuery("CREATE INDEX HistoryByTime ON History (time);");
+        if (!ok) {
+            return "Unable to create the HistoryByTime index";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE INDEX HistoryBySong ON History (song_id);");
+        if (!ok) {
+            return "Unable to create the HistoryBySong index";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 12 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 12";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "db/migrations/13_SmartPlaylists.hpp"
+
+namespace Migration {
+    std::string migrateTo13(SQLite * db) {
+        // Create table storing each smart playlist's compiled rules (see SmartPlaylist.hpp)
+        // 'relative' is set when the rules depend on the current time
+        bool ok = db->prepareAndExecuteQuery("CREATE TABLE SmartPlaylists (playlist_id INTEGER NOT NULL PRIMARY KEY, predicate TEXT NOT NULL, relative BOOLEAN NOT NULL, FOREIGN KEY (playlist_id) REFERENCES Playlists (id) ON DELETE CASCADE);");
+        if (!ok) {
+            return "Unable to create the SmartPlaylists table";
+        }
+
+        // Create table holding the songs which need to be re-tested against each smart playlist
+        ok = db->prepareAndExecuteQuery("CREATE TABLE DirtySongs (song_id INTEGER NOT NULL PRIMARY KEY);");
+        if (!ok) {
+            return "Unable to create the DirtySongs table";
+        }
+
+        // Mark songs as dirty whenever something a rule can test changes (only if there are smart playlists)
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER dirtySongInsert AFTER INSERT ON Songs WHEN EXISTS (SELECT 1 FROM SmartPlaylists) BEGIN INSERT OR IGNORE INTO DirtySongs VALUES (NEW.id); END;");
+        if (!ok) {
+            return "Failed to create 'dirtySongInsert' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER dirtySongUpdate AFTER UPDATE OF title, artist_id, album_id, duration, plays, favourite, modified ON Songs WHEN EXISTS (SELECT 1 FROM SmartPlaylists) BEGIN INSERT OR IGNORE INTO DirtySongs VALUES (NEW.id); END;");
+        if (!ok) {
+            return "Failed to create 'dirtySongUpdate' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER dirtyHistoryInsert AFTER INSERT ON History WHEN EXISTS (SELECT 1 FROM SmartPlaylists) BEGIN INSERT OR IGNORE INTO DirtySongs VALUES (NEW.song_id); END;");
+        if (!ok) {
+            return "Failed to create 'dirtyHistoryInsert' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER dirtyArtistUpdate AFTER UPDATE OF name ON Artists WHEN OLD.name IS NOT NEW.name AND EXISTS (SELECT 1 FROM SmartPlaylists) BEGIN INSERT OR IGNORE INTO DirtySongs SELECT id FROM Songs WHERE artist_id = NEW.id; END;");
+        if (!ok) {
+            return "Failed to create 'dirtyArtistUpdate' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER dirtyAlbumUpdate AFTER UPDATE OF name ON Albums WHEN OLD.name IS NOT NEW.name AND EXISTS (SELECT 1 FROM SmartPlaylists) BEGIN INSERT OR IGNORE INTO DirtySongs SELECT id FROM Songs WHERE album_id = NEW.id; END;");
+        if (!ok) {
+            return "Failed to create 'dirtyAlbumUpdate' trigger";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 13 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 13";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
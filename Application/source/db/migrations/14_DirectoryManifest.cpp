@@ -0,0 +1,19 @@
+#include "db/migrations/14_DirectoryManifest.hpp"
+
+namespace Migration {
+    std::string migrateTo14(SQLite * db) {
+        // Create table storing each directory's modified time and number of entries as of the last scan
+        bool ok = db->prepareAndExecuteQuery("CREATE TABLE Directories (path TEXT NOT NULL PRIMARY KEY, modified INTEGER NOT NULL, entries INTEGER NOT NULL) WITHOUT ROWID;");
+        if (!ok) {
+            return "Unable to create the Directories table";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 14 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 14";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
@@ -0,0 +1,19 @@
+#include "db/migrations/15_SongFingerprints.hpp"
+
+namespace Migration {
+    std::string migrateTo15(SQLite * db) {
+        // Add column storing the fingerprint (left NULL for existing songs until they're next updated)
+        bool ok = db->prepareAndExecuteQuery("ALTER TABLE Songs ADD COLUMN fingerprint TEXT;");
+        if (!ok) {
+            return "Unable to add 'fingerprint' column to Songs";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 15 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 15";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "db/migrations/16_ImageReferences.hpp"
+
+namespace Migration {
+    std::string migrateTo16(SQLite * db) {
+        // Images are no longer deleted along with a row, as another row may be using the same image
+        std::string tables[3] = {"Albums", "Artists", "Playlists"};
+        std::string names[3] = {"Album", "Artist", "Playlist"};
+        bool ok;
+        for (size_t i = 0; i < 3; i++) {
+            ok = db->prepareAndExecuteQuery("DROP TRIGGER IF EXISTS delete" + names[i] + "Image;");
+            if (!ok) {
+                return "Unable to drop 'delete" + names[i] + "Image' trigger";
+            }
+        }
+
+        // Create table storing how many rows use each image (images with no references are deleted later on)
+        ok = db->prepareAndExecuteQuery("CREATE TABLE Images (path TEXT NOT NULL PRIMARY KEY, refs INTEGER NOT NULL DEFAULT 0) WITHOUT ROWID;");
+        if (!ok) {
+            return "Unable to create the Images table";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE INDEX ImagesByRefs ON Images (refs);");
+        if (!ok) {
+            return "Unable to create 'ImagesByRefs' index";
+        }
+
+        // Keep the counts up to date as images are set/changed/removed
+        for (size_t i = 0; i < 3; i++) {
+            ok = db->prepareAndExecuteQuery("CREATE TRIGGER imageRef" + names[i] + "Insert AFTER INSERT ON " + tables[i] + " WHEN NEW.image_path != '' BEGIN "
+                                            "INSERT OR IGNORE INTO Images (path) VALUES (NEW.image_path); "
+                                            "UPDATE Images SET refs = refs + 1 WHERE path = NEW.image_path; END;");
+            if (!ok) {
+                return "Unable to create 'imageRef" + names[i] + "Insert' trigger";
+            }
+            ok = db->prepareAndExecuteQuery("CREATE TRIGGER imageRef" + names[i] + "Update AFTER UPDATE OF image_path ON " + tables[i] + " WHEN OLD.image_path IS NOT NEW.image_path BEGIN "
+                                            "UPDATE Images SET refs = refs - 1 WHERE path = OLD.image_path; "
+                                            "INSERT OR IGNORE INTO Images (path) SELECT NEW.image_path WHERE NEW.image_path != ''; "
+                                            "UPDATE Images SET refs = refs + 1 WHERE path = NEW.image_path; END;");
+            if (!ok) {
+                return "Unable to create 'imageRef" + names[i] + "Update' trigger";
+            }
+            ok = db->prepareAndExecuteQuery("CREATE TRIGGER imageRef" + names[i] + "Delete AFTER DELETE ON " + tables[i] + " WHEN OLD.image_path != '' BEGIN "
+                                            "UPDATE Images SET refs = refs - 1 WHERE path = OLD.image_path; END;");
+            if (!ok) {
+                return "Unable to create 'imageRef" + names[i] + "Delete' trigger";
+            }
+        }
+
+        // Count the images that are already set
+        ok = db->prepareAndExecuteQuery("INSERT INTO Images (path, refs) SELECT image_path, COUNT(*) FROM (SELECT image_path FROM Albums UNION ALL SELECT image_path FROM Artists UNION ALL SELECT image_path FROM Playlists) WHERE image_path != '' GROUP BY image_path;");
+        if (!ok) {
+            return "Unable to count existing image references";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 16 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 16";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
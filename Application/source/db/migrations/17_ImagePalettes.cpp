@@ -0,0 +1,23 @@
+#include "db/migrations/17_ImagePalettes.hpp"
+
+namespace Migration {
+    std::string migrateTo17(SQLite * db) {
+        // Add columns storing each colour (left NULL until the image's colours have been picked)
+        std::string columns[4] = {"palette_background", "palette_primary", "palette_secondary", "palette_light"};
+        bool ok;
+        for (size_t i = 0; i < 4; i++) {
+            ok = db->prepareAndExecuteQuery("ALTER TABLE Images ADD COLUMN " + columns[i] + " INTEGER;");
+            if (!ok) {
+                return "Unable to add '" + columns[i] + "' column to Images";
+            }
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 17 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 17";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
@@ -0,0 +1,19 @@
+#include "db/migrations/18_ScanJournal.hpp"
+
+namespace Migration {
+    std::string migrateTo18(SQLite * db) {
+        // Create table listing the files to be added/updated by the current scan, and whether each has been stored yet
+        bool ok = db->prepareAndExecuteQuery("CREATE TABLE ScanJournal (path TEXT NOT NULL PRIMARY KEY, stored BOOLEAN NOT NULL DEFAULT 0) WITHOUT ROWID;");
+        if (!ok) {
+            return "Unable to create the ScanJournal table";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 18 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 18";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
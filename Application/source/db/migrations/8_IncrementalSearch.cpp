@@ -0,0 +1,201 @@
+#include "db/migrations/8_IncrementalSearch.hpp"
+
+namespace Migration {
+    std::string migrateTo8(SQLite * db) {
+        // Search tables are always up to date from now on, so the flag is no longer needed
+        bool ok = db->prepareAndExecuteQuery("DELETE FROM Variables WHERE name = 'search_update';");
+        if (!ok) {
+            return "Unable to remove 'search_update' variable";
+        }
+
+        // Create a tokenizer matching the one used by the FTS tables (needed to count terms within triggers)
+        ok = db->prepareAndExecuteQuery("CREATE VIRTUAL TABLE FtsTokenizer USING fts3tokenize(simple);");
+        if (!ok) {
+            return "Failed to create FtsTokenizer table";
+        }
+
+        // Repopulate FTS tables so that each document's docid matches the id of the row it indexes
+        ok = db->prepareAndExecuteQuery("DELETE FROM FtsSongs;");
+        if (!ok) {
+            return "Unable to empty FtsSongs";
+        }
+        ok = db->prepareAndExecuteQuery("INSERT INTO FtsSongs (docid, title, artist, album) SELECT Songs.id, Songs.title, Artists.name, Albums.name FROM Songs JOIN Artists ON Artists.id = Songs.artist_id JOIN Albums ON Albums.id = Songs.album_id;");
+        if (!ok) {
+            return "Failed to populate FtsSongs";
+        }
+        ok = db->prepareAndExecuteQuery("DELETE FROM FtsArtists;");
+        if (!ok) {
+            return "Unable to empty FtsArtists";
+        }
+        ok = db->prepareAndExecuteQuery("INSERT INTO FtsArtists (docid, content) SELECT id, name FROM Artists;");
+        if (!ok) {
+            return "Failed to populate FtsArtists";
+        }
+        ok = db->prepareAndExecuteQuery("DELETE FROM FtsAlbums;");
+        if (!ok) {
+            return "Unable to empty FtsAlbums";
+        }
+        ok = db->prepareAndExecuteQuery("INSERT INTO FtsAlbums (docid, name, artist) SELECT Albums.id, Albums.name, group_concat(DISTINCT Artists.name) FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id GROUP BY Albums.id;");
+        if (!ok) {
+            return "Failed to populate FtsAlbums";
+        }
+        ok = db->prepareAndExecuteQuery("DELETE FROM FtsPlaylists;");
+        if (!ok) {
+            return "Unable to empty FtsPlaylists";
+        }
+        ok = db->prepareAndExecuteQuery("INSERT INTO FtsPlaylists (docid, content) SELECT id, name FROM Playlists;");
+        if (!ok) {
+            return "Failed to populate FtsPlaylists";
+        }
+
+        // Create a table per search type to count the number of documents each term appears in,
+        // along with triggers to mirror any changes into the matching spellfix table
+        std::string types[4] = {"Songs", "Artists", "Albums", "Playlists"};
+        for (size_t i = 0; i < 4; i++) {
+            ok = db->prepareAndExecuteQuery("CREATE TABLE Terms" + types[i] + " (id INTEGER NOT NULL PRIMARY KEY, term TEXT UNIQUE NOT NULL, documents INTEGER NOT NULL);");
+            if (!ok) {
+                return "Unable to create the Terms" + types[i] + " table";
+            }
+            ok = db->prepareAndExecuteQuery("CREATE TRIGGER addTerms" + types[i] + " AFTER INSERT ON Terms" + types[i] + " BEGIN INSERT INTO Spellfix" + types[i] + " (rowid, word, rank) VALUES (NEW.id, NEW.term, NEW.documents); END;");
+            if (!ok) {
+                return "Failed to create 'addTerms" + types[i] + "' trigger";
+            }
+            ok = db->prepareAndExecuteQuery("CREATE TRIGGER updateTerms" + types[i] + " AFTER UPDATE OF documents ON Terms" + types[i] + " WHEN NEW.documents > 0 BEGIN UPDATE Spellfix" + types[i] + " SET rank = NEW.documents WHERE rowid = NEW.id; END;");
+            if (!ok) {
+                return "Failed to create 'updateTerms" + types[i] + "' trigger";
+            }
+            ok = db->prepareAndExecuteQuery("CREATE TRIGGER removeTerms" + types[i] + " AFTER UPDATE OF documents ON Terms" + types[i] + " WHEN NEW.documents < 1 BEGIN DELETE FROM Terms" + types[i] + " WHERE id = NEW.id; END;");
+            if (!ok) {
+                return "Failed to create 'removeTerms" + types[i] + "' trigger";
+            }
+            ok = db->prepareAndExecuteQuery("CREATE TRIGGER deleteTerms" + types[i] + " AFTER DELETE ON Terms" + types[i] + " BEGIN DELETE FROM Spellfix" + types[i] + " WHERE rowid = OLD.id; END;");
+            if (!ok) {
+                return "Failed to create 'deleteTerms" + types[i] + "' trigger";
+            }
+
+            // Seed the terms (and therefore spellfix table) using a temporary fts4aux table
+            ok = db->prepareAndExecuteQuery("DELETE FROM Spellfix" + types[i] + ";");
+            if (!ok) {
+                return "Unable to empty Spellfix" + types[i];
+            }
+            db->prepareAndExecuteQuery("DROP TABLE IF EXISTS FtsAux" + types[i] + ";");
+            ok = db->prepareAndExecuteQuery("CREATE VIRTUAL TABLE FtsAux" + types[i] + " USING fts4aux(Fts" + types[i] + ");");
+            if (!ok) {
+                return "Failed to create FtsAux" + types[i] + " table";
+            }
+            ok = db->prepareAndExecuteQuery("INSERT INTO Terms" + types[i] + " (term, documents) SELECT term, documents FROM FtsAux" + types[i] + " WHERE col = '*';");
+            if (!ok) {
+                return "Failed to populate Terms" + types[i];
+            }
+            ok = db->prepareAndExecuteQuery("DROP TABLE FtsAux" + types[i] + ";");
+            if (!ok) {
+                return "Unable to drop FtsAux" + types[i];
+            }
+
+            // Create a view which acts as a 'procedure' to reindex a single row (by inserting its id)
+            ok = db->prepareAndExecuteQuery("CREATE VIEW Reindex" + types[i] + " AS SELECT 0 AS id WHERE 0;");
+            if (!ok) {
+                return "Unable to create the Reindex" + types[i] + " view";
+            }
+        }
+
+        // The 'procedures' remove the indexed document (decrementing its terms) and then reinsert the current row (incrementing its terms)
+        // If the row no longer exists (or has no songs) it is simply left out of the index
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER reindexSongs INSTEAD OF INSERT ON ReindexSongs BEGIN "
+                                        "UPDATE TermsSongs SET documents = documents - 1 WHERE term IN (SELECT token FROM FtsTokenizer WHERE input = (SELECT title || ' ' || artist || ' ' || album FROM FtsSongs WHERE docid = NEW.id)); "
+                                        "DELETE FROM FtsSongs WHERE docid = NEW.id; "
+                                        "INSERT INTO FtsSongs (docid, title, artist, album) SELECT Songs.id, Songs.title, Artists.name, Albums.name FROM Songs JOIN Artists ON Artists.id = Songs.artist_id JOIN Albums ON Albums.id = Songs.album_id WHERE Songs.id = NEW.id; "
+                                        "INSERT INTO TermsSongs (term, documents) SELECT DISTINCT token, 1 FROM FtsTokenizer WHERE input = (SELECT title || ' ' || artist || ' ' || album FROM FtsSongs WHERE docid = NEW.id) ON CONFLICT (term) DO UPDATE SET documents = documents + 1; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'reindexSongs' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER reindexArtists INSTEAD OF INSERT ON ReindexArtists BEGIN "
+                                        "UPDATE TermsArtists SET documents = documents - 1 WHERE term IN (SELECT token FROM FtsTokenizer WHERE input = (SELECT content FROM FtsArtists WHERE docid = NEW.id)); "
+                                        "DELETE FROM FtsArtists WHERE docid = NEW.id; "
+                                        "INSERT INTO FtsArtists (docid, content) SELECT id, name FROM Artists WHERE id = NEW.id; "
+                                        "INSERT INTO TermsArtists (term, documents) SELECT DISTINCT token, 1 FROM FtsTokenizer WHERE input = (SELECT content FROM FtsArtists WHERE docid = NEW.id) ON CONFLICT (term) DO UPDATE SET documents = documents + 1; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'reindexArtists' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER reindexAlbums INSTEAD OF INSERT ON ReindexAlbums BEGIN "
+                                        "UPDATE TermsAlbums SET documents = documents - 1 WHERE term IN (SELECT token FROM FtsTokenizer WHERE input = (SELECT name || ' ' || artist FROM FtsAlbums WHERE docid = NEW.id)); "
+                                        "DELETE FROM FtsAlbums WHERE docid = NEW.id; "
+                                        "INSERT INTO FtsAlbums (docid, name, artist) SELECT Albums.id, Albums.name, group_concat(DISTINCT Artists.name) FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.album_id = NEW.id GROUP BY Albums.id; "
+                                        "INSERT INTO TermsAlbums (term, documents) SELECT DISTINCT token, 1 FROM FtsTokenizer WHERE input = (SELECT name || ' ' || artist FROM FtsAlbums WHERE docid = NEW.id) ON CONFLICT (term) DO UPDATE SET documents = documents + 1; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'reindexAlbums' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER reindexPlaylists INSTEAD OF INSERT ON ReindexPlaylists BEGIN "
+                                        "UPDATE TermsPlaylists SET documents = documents - 1 WHERE term IN (SELECT token FROM FtsTokenizer WHERE input = (SELECT content FROM FtsPlaylists WHERE docid = NEW.id)); "
+                                        "DELETE FROM FtsPlaylists WHERE docid = NEW.id; "
+                                        "INSERT INTO FtsPlaylists (docid, content) SELECT id, name FROM Playlists WHERE id = NEW.id; "
+                                        "INSERT INTO TermsPlaylists (term, documents) SELECT DISTINCT token, 1 FROM FtsTokenizer WHERE input = (SELECT content FROM FtsPlaylists WHERE docid = NEW.id) ON CONFLICT (term) DO UPDATE SET documents = documents + 1; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'reindexPlaylists' trigger";
+        }
+
+        // Songs (also reindexes the album(s) as an album's document contains its artists)
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexSongInsert AFTER INSERT ON Songs BEGIN INSERT INTO ReindexSongs VALUES (NEW.id); INSERT INTO ReindexAlbums VALUES (NEW.album_id); END;");
+        if (!ok) {
+            return "Failed to create 'indexSongInsert' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexSongUpdate AFTER UPDATE OF title, artist_id, album_id ON Songs WHEN OLD.title IS NOT NEW.title OR OLD.artist_id IS NOT NEW.artist_id OR OLD.album_id IS NOT NEW.album_id BEGIN INSERT INTO ReindexSongs VALUES (NEW.id); INSERT INTO ReindexAlbums SELECT OLD.album_id UNION SELECT NEW.album_id; END;");
+        if (!ok) {
+            return "Failed to create 'indexSongUpdate' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexSongDelete AFTER DELETE ON Songs BEGIN INSERT INTO ReindexSongs VALUES (OLD.id); INSERT INTO ReindexAlbums VALUES (OLD.album_id); END;");
+        if (!ok) {
+            return "Failed to create 'indexSongDelete' trigger";
+        }
+
+        // Artists (renaming requires the artist's songs and albums to be reindexed too)
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexArtistInsert AFTER INSERT ON Artists BEGIN INSERT INTO ReindexArtists VALUES (NEW.id); END;");
+        if (!ok) {
+            return "Failed to create 'indexArtistInsert' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexArtistUpdate AFTER UPDATE OF name ON Artists WHEN OLD.name IS NOT NEW.name BEGIN INSERT INTO ReindexArtists VALUES (NEW.id); INSERT INTO ReindexSongs SELECT id FROM Songs WHERE artist_id = NEW.id; INSERT INTO ReindexAlbums SELECT DISTINCT album_id FROM Songs WHERE artist_id = NEW.id; END;");
+        if (!ok) {
+            return "Failed to create 'indexArtistUpdate' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexArtistDelete AFTER DELETE ON Artists BEGIN INSERT INTO ReindexArtists VALUES (OLD.id); END;");
+        if (!ok) {
+            return "Failed to create 'indexArtistDelete' trigger";
+        }
+
+        // Albums (inserting isn't handled as an album without songs is not indexed)
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexAlbumUpdate AFTER UPDATE OF name ON Albums WHEN OLD.name IS NOT NEW.name BEGIN INSERT INTO ReindexAlbums VALUES (NEW.id); INSERT INTO ReindexSongs SELECT id FROM Songs WHERE album_id = NEW.id; END;");
+        if (!ok) {
+            return "Failed to create 'indexAlbumUpdate' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexAlbumDelete AFTER DELETE ON Albums BEGIN INSERT INTO ReindexAlbums VALUES (OLD.id); END;");
+        if (!ok) {
+            return "Failed to create 'indexAlbumDelete' trigger";
+        }
+
+        // Playlists
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexPlaylistInsert AFTER INSERT ON Playlists BEGIN INSERT INTO ReindexPlaylists VALUES (NEW.id); END;");
+        if (!ok) {
+            return "Failed to create 'indexPlaylistInsert' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexPlaylistUpdate AFTER UPDATE OF name ON Playlists WHEN OLD.name IS NOT NEW.name BEGIN INSERT INTO ReindexPlaylists VALUES (NEW.id); END;");
+        if (!ok) {
+            return "Failed to create 'indexPlaylistUpdate' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER indexPlaylistDelete AFTER DELETE ON Playlists BEGIN INSERT INTO ReindexPlaylists VALUES (OLD.id); END;");
+        if (!ok) {
+            return "Failed to create 'indexPlaylistDelete' trigger";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 8 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 8";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "db/migrations/9_TrigramSearch.hpp"
+
+namespace Migration {
+    std::string migrateTo9(SQLite * db) {
+        // Remove the term counting/spellfix tables as trigrams handle misspelt words themselves
+        // Note that the old 'procedures' have to be dropped first as they refer to these tables
+        std::string types[4] = {"Songs", "Artists", "Albums", "Playlists"};
+        for (size_t i = 0; i < 4; i++) {
+            bool ok = db->prepareAndExecuteQuery("DROP TRIGGER reindex" + types[i] + ";");
+            if (!ok) {
+                return "Unable to drop 'reindex" + types[i] + "' trigger";
+            }
+            ok = db->prepareAndExecuteQuery("DROP TABLE Terms" + types[i] + ";");
+            if (!ok) {
+                return "Unable to drop Terms" + types[i];
+            }
+            ok = db->prepareAndExecuteQuery("DROP TABLE Spellfix" + types[i] + ";");
+            if (!ok) {
+                return "Unable to drop Spellfix" + types[i];
+            }
+        }
+        bool ok = db->prepareAndExecuteQuery("DROP TABLE FtsTokenizer;");
+        if (!ok) {
+            return "Unable to drop FtsTokenizer";
+        }
+
+        // Reindex everything using trigrams (see the trigrams() function in Database.cpp)
+        ok = db->prepareAndExecuteQuery("DELETE FROM FtsSongs;");
+        if (!ok) {
+            return "Unable to empty FtsSongs";
+        }
+        ok = db->prepareAndExecuteQuery("INSERT INTO FtsSongs (docid, title, artist, album) SELECT Songs.id, trigrams(Songs.title), trigrams(Artists.name), trigrams(Albums.name) FROM Songs JOIN Artists ON Artists.id = Songs.artist_id JOIN Albums ON Albums.id = Songs.album_id;");
+        if (!ok) {
+            return "Failed to populate FtsSongs";
+        }
+        ok = db->prepareAndExecuteQuery("DELETE FROM FtsArtists;");
+        if (!ok) {
+            return "Unable to empty FtsArtists";
+        }
+        ok = db->prepareAndExecuteQuery("INSERT INTO FtsArtists (docid, content) SELECT id, trigrams(name) FROM Artists;");
+        if (!ok) {
+            return "Failed to populate FtsArtists";
+        }
+        ok = db->prepareAndExecuteQuery("DELETE FROM FtsAlbums;");
+        if (!ok) {
+            return "Unable to empty FtsAlbums";
+        }
+        ok = db->prepareAndExecuteQuery("INSERT INTO FtsAlbums (docid, name, artist) SELECT Albums.id, trigrams(Albums.name), trigrams(group_concat(DISTINCT Artists.name)) FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id GROUP BY Albums.id;");
+        if (!ok) {
+            return "Failed to populate FtsAlbums";
+        }
+        ok = db->prepareAndExecuteQuery("DELETE FROM FtsPlaylists;");
+        if (!ok) {
+            return "Unable to empty FtsPlaylists";
+        }
+        ok = db->prepareAndExecuteQuery("INSERT INTO FtsPlaylists (docid, content) SELECT id, trigrams(name) FROM Playlists;");
+        if (!ok) {
+            return "Failed to populate FtsPlaylists";
+        }
+
+        // Recreate the 'procedures' (the triggers calling them are unchanged)
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER reindexSongs INSTEAD OF INSERT ON ReindexSongs BEGIN "
+                                        "DELETE FROM FtsSongs WHERE docid = NEW.id; "
+                                        "INSERT INTO FtsSongs (docid, title, artist, album) SELECT Songs.id, trigrams(Songs.title), trigrams(Artists.name), trigrams(Albums.name) FROM Songs JOIN Artists ON Artists.id = Songs.artist_id JOIN Albums ON Albums.id = Songs.album_id WHERE Songs.id = NEW.id; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'reindexSongs' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER reindexArtists INSTEAD OF INSERT ON ReindexArtists BEGIN "
+                                        "DELETE FROM FtsArtists WHERE docid = NEW.id; "
+                                        "INSERT INTO FtsArtists (docid, content) SELECT id, trigrams(name) FROM Artists WHERE id = NEW.id; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'reindexArtists' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER reindexAlbums INSTEAD OF INSERT ON ReindexAlbums BEGIN "
+                                        "DELETE FROM FtsAlbums WHERE docid = NEW.id; "
+                                        "INSERT INTO FtsAlbums (docid, name, artist) SELECT Albums.id, trigrams(Albums.name), trigrams(group_concat(DISTINCT Artists.name)) FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.album_id = NEW.id GROUP BY Albums.id; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'reindexAlbums' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER reindexPlaylists INSTEAD OF INSERT ON ReindexPlaylists BEGIN "
+                                        "DELETE FROM FtsPlaylists WHERE docid = NEW.id; "
+                                        "INSERT INTO FtsPlaylists (docid, content) SELECT id, trigrams(name) FROM Playlists WHERE id = NEW.id; "
+                                        "END;");
+        if (!ok) {
+            return "Failed to create 'reindexPlaylists' trigger";
+        }
+
+        // Bump up version number (only done if everything passes)
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 9 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 9";
+        }
+
+        return "";
+    }
+};
\ No newline at end of file
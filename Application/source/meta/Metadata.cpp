@@ -1,6 +1,7 @@
 #include "Log.hpp"
 #include "meta/AudioDB.hpp"
 #include "meta/Metadata.hpp"
+#include "meta/TagReader.hpp"
 #include "utils/FS.hpp"
 
 // Taglib headers
@@ -530,7 +531,18 @@ namespace Metadata {
     }
 
     Song readFromFile(const std::string & path, const AudioFormat format) {
-        // Call relevant function
+        // Try reading just the tags first, as TagLib reads a lot more of the file than is needed
+        Song m = getBlankMetadata();
+        m.format = format;
+        m.path = path;
+        if (TagReader::readFromFile(path, format, m)) {
+            m.ID = -1;
+            fillMissingValues(path, m);
+            return m;
+        }
+        Log::writeInfo("[META] Falling back to TagLib for: " + path);
+
+        // Otherwise call relevant function
         switch (format) {
             case AudioFormat::FLAC:
                 return readFromFLAC(path);
@@ -0,0 +1,681 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "meta/TagReader.hpp"
+#include <unordered_map>
+#include <vector>
+
+// Minimum number of bytes read from the file at once (most reads are tiny, but each one
+// has a high latency on the SD card)
+#define READ_AHEAD_SIZE 4096
+// Size of an ID3v1 tag, which is always at the end of the file
+#define ID3V1_SIZE 128
+// Size of an APE tag's footer
+#define APE_FOOTER_SIZE 32
+
+namespace Metadata::TagReader {
+    // Values read from a tag before they're merged into a Song
+    // (a blank string indicates the value wasn't present)
+    struct Tags {
+        std::string title;
+        std::string artist;
+        std::string album;
+        std::string track;
+        std::string disc;
+    };
+
+    // Reads parts of a file, keeping the most recently read block in memory so that
+    // several small reads close together only hit the SD card once
+    class Reader {
+        private:
+            std::FILE * file;
+            long size_;
+            long bufferOffset;
+            std::vector<unsigned char> buffer;
+
+        public:
+            Reader(const std::string & path) {
+                this->file = std::fopen(path.c_str(), "rb");
+                this->size_ = -1;
+                this->bufferOffset = 0;
+                if (this->file != nullptr) {
+                    // Buffering is done here instead, so stdio doesn't read more than requested
+                    std::setvbuf(this->file, nullptr, _IONBF, 0);
+                    if (std::fseek(this->file, 0, SEEK_END) == 0) {
+                        this->size_ = std::ftell(this->file);
+                    }
+                }
+            }
+
+            // Returns whether the file was opened
+            bool ok() {
+                return (this->size_ >= 0);
+            }
+
+            // Returns the size of the file in bytes
+            long size() {
+                return this->size_;
+            }
+
+            // Copies the given number of bytes at the given offset into the buffer
+            // Returns false if they couldn't all be read
+            bool read(long offset, size_t len, unsigned char * dst) {
+                if (offset < 0 || offset > this->size_ || (long)len > this->size_ - offset) {
+                    return false;
+                }
+
+                if (offset < this->bufferOffset || offset + (long)len > this->bufferOffset + (long)this->buffer.size()) {
+                    size_t toRead = std::min<long>(std::max<size_t>(len, READ_AHEAD_SIZE), this->size_ - offset);
+                    this->buffer.resize(toRead);
+                    if (std::fseek(this->file, offset, SEEK_SET) != 0 || std::fread(this->buffer.data(), 1, toRead, this->file) != toRead) {
+                        this->buffer.clear();
+                        return false;
+                    }
+                    this->bufferOffset = offset;
+                }
+
+                std::memcpy(dst, this->buffer.data() + (offset - this->bufferOffset), len);
+                return true;
+            }
+
+            ~Reader() {
+                if (this->file != nullptr) {
+                    std::fclose(this->file);
+                }
+            }
+    };
+
+    // Read unsigned integers stored with the given number of bytes
+    static uint32_t readBE(const unsigned char * data, size_t bytes) {
+        uint32_t val = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            val = (val << 8) | data[i];
+        }
+        return val;
+    }
+
+    static uint32_t readLE(const unsigned char * data, size_t bytes) {
+        uint32_t val = 0;
+        for (size_t i = bytes; i > 0; i--) {
+            val = (val << 8) | data[i - 1];
+        }
+        return val;
+    }
+
+    // Read a 28-bit "synchsafe" integer (used by ID3v2)
+    static uint32_t readSyncsafe(const unsigned char * data) {
+        return ((data[0] & 0x7F) << 21) | ((data[1] & 0x7F) << 14) | ((data[2] & 0x7F) << 7) | (data[3] & 0x7F);
+    }
+
+    // Append the given code point to a UTF-8 string
+    static void appendUTF8(std::string & str, uint32_t cp) {
+        if (cp < 0x80) {
+            str += (char)cp;
+        } else if (cp < 0x800) {
+            str += (char)(0xC0 | (cp >> 6));
+            str += (char)(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            str += (char)(0xE0 | (cp >> 12));
+            str += (char)(0x80 | ((cp >> 6) & 0x3F));
+            str += (char)(0x80 | (cp & 0x3F));
+        } else {
+            str += (char)(0xF0 | (cp >> 18));
+            str += (char)(0x80 | ((cp >> 12) & 0x3F));
+            str += (char)(0x80 | ((cp >> 6) & 0x3F));
+            str += (char)(0x80 | (cp & 0x3F));
+        }
+    }
+
+    // Convert an ISO-8859-1 string to UTF-8, stopping at the first null
+    static std::string latin1ToUTF8(const unsigned char * data, size_t len) {
+        std::string str;
+        for (size_t i = 0; i < len && data[i] != '\0'; i++) {
+            appendUTF8(str, data[i]);
+        }
+        return str;
+    }
+
+    // Convert a UTF-16 string to UTF-8, stopping at the first null
+    // If there's no byte order mark the given endianness is used, otherwise a blank string is returned
+    static std::string utf16ToUTF8(const unsigned char * data, size_t len, bool needsBOM, bool bigEndian) {
+        std::string str;
+        size_t i = 0;
+        if (needsBOM) {
+            if (len >= 2 && data[0] == 0xFF && data[1] == 0xFE) {
+                bigEndian = false;
+            } else if (len >= 2 && data[0] == 0xFE && data[1] == 0xFF) {
+                bigEndian = true;
+            } else {
+                return str;
+            }
+            i = 2;
+        }
+
+        for (; i + 1 < len; i += 2) {
+            uint32_t cp = (bigEndian ? readBE(data + i, 2) : readLE(data + i, 2));
+            if (cp == 0) {
+                break;
+            }
+
+            // Combine surrogate pairs
+            if (cp >= 0xD800 && cp < 0xDC00 && i + 3 < len) {
+                uint32_t low = (bigEndian ? readBE(data + i + 2, 2) : readLE(data + i + 2, 2));
+                if (low >= 0xDC00 && low < 0xE000) {
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                    i += 2;
+                }
+            }
+            appendUTF8(str, cp);
+        }
+        return str;
+    }
+
+    // Remove whitespace from either end of the string (using the same characters as TagLib)
+    static std::string stripWhitespace(const std::string & str) {
+        const char * whitespace = "\t\n\f\r ";
+        size_t start = str.find_first_not_of(whitespace);
+        if (start == std::string::npos) {
+            return "";
+        }
+        return str.substr(start, str.find_last_not_of(whitespace) - start + 1);
+    }
+
+    // Return the leading integer in a string (e.g. 1 for "1/12")
+    static int toInt(const std::string & str) {
+        return static_cast<int>(std::strtol(str.c_str(), nullptr, 10));
+    }
+
+    // Merge values read from a tag, only replacing empty values
+    static void mergeTags(const Tags & tags, Song & m) {
+        if (m.title.empty() && !tags.title.empty()) {
+            m.title = tags.title;
+        }
+
+        if (m.artist.empty() && !tags.artist.empty()) {
+            m.artist = tags.artist;
+        }
+
+        if (m.album.empty() && !tags.album.empty()) {
+            m.album = tags.album;
+        }
+
+        if (m.trackNumber < 0 && toInt(tags.track) != 0) {
+            m.trackNumber = toInt(tags.track);
+        }
+
+        if (m.discNumber < 0 && !tags.disc.empty()) {
+            m.discNumber = toInt(tags.disc);
+        }
+    }
+
+    // Parse an ID3v1 tag (which is assumed to start with "TAG")
+    static void parseID3v1(const unsigned char * data, Song & m) {
+        Tags tags;
+        tags.title = stripWhitespace(latin1ToUTF8(data + 3, 30));
+        tags.artist = stripWhitespace(latin1ToUTF8(data + 33, 30));
+        tags.album = stripWhitespace(latin1ToUTF8(data + 63, 30));
+
+        // ID3v1.1 stores the track number in the last byte of the comment
+        if (data[125] == 0 && data[126] != 0) {
+            tags.track = std::to_string(data[126]);
+        }
+
+        // ID3v1 tags don't store a disc number
+        mergeTags(tags, m);
+    }
+
+    // Decode an ID3v2 text frame, joining multiple values with a space
+    // Returns false if the encoding is unknown
+    static bool parseID3v2Text(const unsigned char * data, size_t len, std::string & str) {
+        if (len < 1 || data[0] > 3) {
+            return false;
+        }
+
+        // Split into values on the encoding's null terminator (which is two bytes for UTF-16)
+        unsigned char encoding = data[0];
+        size_t step = (encoding == 1 || encoding == 2 ? 2 : 1);
+        size_t start = 1;
+        str.clear();
+        for (size_t i = 1; i <= len; i += step) {
+            bool end = (i + step > len);
+            if (!end && !(data[i] == 0 && data[i + step - 1] == 0)) {
+                continue;
+            }
+
+            size_t valueLen = (end ? len - start : i - start);
+            if (valueLen > 0) {
+                std::string value;
+                switch (encoding) {
+                    case 0:
+                        value = latin1ToUTF8(data + start, valueLen);
+                        break;
+
+                    case 1:
+                        value = utf16ToUTF8(data + start, valueLen, true, false);
+                        break;
+
+                    case 2:
+                        value = utf16ToUTF8(data + start, valueLen, false, true);
+                        break;
+
+                    case 3:
+                        value = std::string((const char *)(data + start), strnlen((const char *)(data + start), valueLen));
+                        break;
+                }
+                str += (str.empty() ? "" : " ") + value;
+            }
+            start = i + step;
+            if (end) {
+                break;
+            }
+        }
+        return true;
+    }
+
+    // Parse the ID3v2 tag at the given offset, only reading the frames that are needed
+    // Sets the end offset to the first byte after the tag
+    // Returns false if the tag uses something that isn't handled
+    static bool parseID3v2(Reader & reader, long offset, Song & m, long & end) {
+        unsigned char header[10];
+        if (!reader.read(offset, sizeof(header), header) || std::memcmp(header, "ID3", 3) != 0) {
+            return false;
+        }
+
+        // Only v2.3 and v2.4 are handled, and neither unsynchronisation or an extended header is
+        unsigned char version = header[3];
+        unsigned char flags = header[5];
+        if ((version != 3 && version != 4) || (flags & 0xC0) != 0) {
+            return false;
+        }
+        long tagEnd = offset + sizeof(header) + readSyncsafe(header + 6);
+        end = tagEnd + (version == 4 && (flags & 0x10) ? sizeof(header) : 0);
+
+        // Walk each frame, skipping over those that aren't needed (i.e. images)
+        const std::vector<std::string> ids = {"TIT2", "TPE1", "TALB", "TRCK", "TPOS"};
+        std::vector<bool> found(ids.size(), false);
+        std::vector<std::string> values(ids.size());
+        std::vector<unsigned char> data;
+        long pos = offset + sizeof(header);
+        while (pos + (long)sizeof(header) <= tagEnd && std::find(found.begin(), found.end(), false) != found.end()) {
+            unsigned char frame[10];
+            if (!reader.read(pos, sizeof(frame), frame)) {
+                return false;
+            }
+
+            // Stop on padding or an invalid frame ID (as TagLib does)
+            bool valid = true;
+            for (size_t i = 0; i < 4; i++) {
+                valid = (valid && ((frame[i] >= 'A' && frame[i] <= 'Z') || (frame[i] >= '0' && frame[i] <= '9')));
+            }
+            if (!valid) {
+                break;
+            }
+
+            // Some v2.4 writers don't store frame sizes as synchsafe, which isn't handled
+            if (version == 4 && ((frame[4] | frame[5] | frame[6] | frame[7]) & 0x80)) {
+                return false;
+            }
+            uint32_t size = (version == 4 ? readSyncsafe(frame + 4) : readBE(frame + 4, 4));
+            // (the tag's size is checked against the file's too, so a corrupt size can't cause a huge allocation)
+            if (size == 0 || pos + (long)sizeof(frame) + (long)size > std::min(tagEnd, reader.size())) {
+                return false;
+            }
+
+            std::vector<std::string>::const_iterator it = std::find(ids.begin(), ids.end(), std::string((const char *)frame, 4));
+            size_t idx = it - ids.begin();
+            if (it != ids.end() && !found[idx]) {
+                // Compressed, encrypted or unsynchronised frames aren't handled
+                if ((version == 3 && (frame[9] & 0xC0)) || (version == 4 && (frame[9] & 0x0F))) {
+                    return false;
+                }
+
+                data.resize(size);
+                if (!reader.read(pos + sizeof(frame), size, data.data()) || !parseID3v2Text(data.data(), size, values[idx])) {
+                    return false;
+                }
+                found[idx] = true;
+            }
+            pos += sizeof(frame) + size;
+        }
+
+        Tags tags{values[0], values[1], values[2], values[3], values[4]};
+        mergeTags(tags, m);
+        return true;
+    }
+
+    // Read the duration of an MPEG Layer III stream starting at the given offset
+    // Returns false if there isn't a valid frame at the given offset
+    static bool readMP3Duration(Reader & reader, long offset, long end, Song & m) {
+        // Read enough to contain both the frame header and any VBR header
+        unsigned char data[64];
+        if (end - offset < (long)sizeof(data) || !reader.read(offset, sizeof(data), data)) {
+            return false;
+        }
+
+        uint32_t header = readBE(data, 4);
+        unsigned char versionBits = (header >> 19) & 0x3;
+        unsigned char layerBits = (header >> 17) & 0x3;
+        unsigned char bitrateIndex = (header >> 12) & 0xF;
+        unsigned char sampleRateIndex = (header >> 10) & 0x3;
+        if ((header & 0xFFE00000) != 0xFFE00000 || versionBits == 1 || layerBits != 1 || bitrateIndex == 0 || bitrateIndex == 15 || sampleRateIndex == 3) {
+            return false;
+        }
+
+        static const int bitrates[2][15] = {
+            {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},
+            {0,  8, 16, 24, 32, 40, 48, 56,  64,  80,  96, 112, 128, 144, 160}
+        };
+        static const int sampleRates[3] = {44100, 48000, 32000};
+        bool mpeg1 = (versionBits == 3);
+        bool mono = (((header >> 6) & 0x3) == 0x3);
+        int bitrate = bitrates[mpeg1 ? 0 : 1][bitrateIndex];
+        int sampleRate = sampleRates[sampleRateIndex] >> (mpeg1 ? 0 : (versionBits == 2 ? 1 : 2));
+        int samplesPerFrame = (mpeg1 ? 1152 : 576);
+
+        // VBR files (including those written by LAME) store the number of frames in a Xing/Info or
+        // VBRI header within the first frame. Otherwise assume a constant bitrate.
+        size_t xing = 4 + (mpeg1 ? (mono ? 17 : 32) : (mono ? 9 : 17));
+        size_t vbri = 4 + 32;
+        uint32_t frames = 0;
+        if (std::memcmp(data + xing, "Xing", 4) == 0 || std::memcmp(data + xing, "Info", 4) == 0) {
+            // TagLib ignores the header unless both the frame count and stream size are present
+            if ((readBE(data + xing + 4, 4) & 0x3) != 0x3) {
+                return false;
+            }
+            frames = readBE(data + xing + 8, 4);
+            if (frames == 0 || readBE(data + xing + 12, 4) == 0) {
+                return false;
+            }
+
+        } else if (std::memcmp(data + vbri, "VBRI", 4) == 0) {
+            frames = readBE(data + vbri + 14, 4);
+            if (frames == 0 || readBE(data + vbri + 10, 4) == 0) {
+                return false;
+            }
+        }
+
+        double length;
+        if (frames > 0) {
+            length = (samplesPerFrame * 1000.0 / sampleRate) * frames;
+        } else {
+            length = (end - offset) * 8.0 / bitrate;
+        }
+        m.duration = static_cast<int>(length + 0.5) / 1000;
+        return true;
+    }
+
+    static bool readFromMP3(Reader & reader, Song & m) {
+        // Tags at the start of the file
+        long audioStart = 0;
+        unsigned char magic[3];
+        if (!reader.read(0, sizeof(magic), magic)) {
+            return false;
+        }
+        if (std::memcmp(magic, "ID3", 3) == 0 && !parseID3v2(reader, 0, m, audioStart)) {
+            return false;
+        }
+
+        // Tags at the end of the file (APE tags aren't handled as the audio's end can't be found)
+        long audioEnd = reader.size();
+        unsigned char tail[ID3V1_SIZE + APE_FOOTER_SIZE];
+        if (audioEnd >= (long)sizeof(tail)) {
+            if (!reader.read(audioEnd - sizeof(tail), sizeof(tail), tail)) {
+                return false;
+            }
+            if (std::memcmp(tail + APE_FOOTER_SIZE, "TAG", 3) == 0) {
+                parseID3v1(tail + APE_FOOTER_SIZE, m);
+                audioEnd -= ID3V1_SIZE;
+                if (std::memcmp(tail, "APETAGEX", 8) == 0) {
+                    return false;
+                }
+            } else if (std::memcmp(tail + ID3V1_SIZE, "APETAGEX", 8) == 0) {
+                return false;
+            }
+        }
+
+        return readMP3Duration(reader, audioStart, audioEnd, m);
+    }
+
+    // Parse a FLAC VORBIS_COMMENT block
+    // Returns false if it's malformed
+    static bool parseVorbisComment(const std::vector<unsigned char> & data, Song & m) {
+        // Skip the vendor string
+        size_t pos = 0;
+        if (data.size() < 4 || data.size() - 4 < readLE(data.data(), 4)) {
+            return false;
+        }
+        pos = 4 + readLE(data.data(), 4);
+        if (data.size() - pos < 4) {
+            return false;
+        }
+        uint32_t count = readLE(data.data() + pos, 4);
+        pos += 4;
+
+        // Group each field's values by name (case insensitive)
+        std::unordered_map< std::string, std::vector<std::string> > fields;
+        for (uint32_t i = 0; i < count; i++) {
+            if (data.size() - pos < 4 || data.size() - pos - 4 < readLE(data.data() + pos, 4)) {
+                return false;
+            }
+            uint32_t len = readLE(data.data() + pos, 4);
+            std::string field((const char *)(data.data() + pos + 4), len);
+            pos += 4 + len;
+
+            size_t split = field.find('=');
+            if (split == std::string::npos || split == 0 || split + 1 == field.length()) {
+                continue;
+            }
+            std::string name = field.substr(0, split);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) {
+                return std::toupper(c);
+            });
+            fields[name].push_back(field.substr(split + 1));
+        }
+
+        auto join = [&fields](const std::string & name) {
+            std::string str;
+            for (const std::string & value : fields[name]) {
+                str += (str.empty() ? "" : " ") + value;
+            }
+            return str;
+        };
+        auto first = [&fields](const std::string & name) {
+            return (fields[name].empty() ? std::string() : fields[name].front());
+        };
+
+        Tags tags;
+        tags.title = join("TITLE");
+        tags.artist = join("ARTIST");
+        tags.album = join("ALBUM");
+        tags.track = (fields["TRACKNUMBER"].empty() ? first("TRACKNUM") : first("TRACKNUMBER"));
+        tags.disc = first("DISCNUMBER");
+        mergeTags(tags, m);
+        return true;
+    }
+
+    static bool readFromFLAC(Reader & reader, Song & m) {
+        // Files with ID3v2 tags at the start are left to TagLib
+        unsigned char magic[4];
+        if (!reader.read(0, sizeof(magic), magic) || std::memcmp(magic, "fLaC", 4) != 0) {
+            return false;
+        }
+
+        // Walk the metadata blocks until the comment is found, skipping everything else (i.e. pictures)
+        bool haveInfo = false;
+        bool last = false;
+        long pos = sizeof(magic);
+        while (!last) {
+            unsigned char header[4];
+            if (!reader.read(pos, sizeof(header), header)) {
+                return false;
+            }
+            last = (header[0] & 0x80);
+            unsigned char type = (header[0] & 0x7F);
+            uint32_t len = readBE(header + 1, 3);
+            pos += sizeof(header);
+
+            // STREAMINFO must always be first
+            if (!haveInfo) {
+                unsigned char info[18];
+                if (type != 0 || len < sizeof(info) || !reader.read(pos, sizeof(info), info)) {
+                    return false;
+                }
+                uint32_t sampleRate = readBE(info + 10, 3) >> 4;
+                uint64_t samples = ((uint64_t)(info[13] & 0x0F) << 32) | readBE(info + 14, 4);
+                m.duration = (sampleRate > 0 ? static_cast<int>(samples * 1000.0 / sampleRate + 0.5) / 1000 : 0);
+                haveInfo = true;
+
+            } else if (type == 4) {
+                std::vector<unsigned char> data(len);
+                if (!reader.read(pos, len, data.data()) || !parseVorbisComment(data, m)) {
+                    return false;
+                }
+                break;
+
+            } else if (type == 127) {
+                return false;
+            }
+            pos += len;
+        }
+
+        // Check for an ID3v1 tag at the end too
+        unsigned char tail[ID3V1_SIZE];
+        if (reader.size() >= (long)sizeof(tail) && reader.read(reader.size() - sizeof(tail), sizeof(tail), tail) && std::memcmp(tail, "TAG", 3) == 0) {
+            parseID3v1(tail, m);
+        }
+        return true;
+    }
+
+    // Parse the subchunks of a RIFF LIST INFO chunk (which is assumed to start with "INFO")
+    static void parseRIFFInfo(const std::vector<unsigned char> & data, Song & m) {
+        std::unordered_map<std::string, std::string> fields;
+        size_t pos = 4;
+        while (pos + 8 <= data.size()) {
+            uint32_t size = readLE(data.data() + pos + 4, 4);
+            if (size > data.size() - pos - 8) {
+                break;
+            }
+            const char * text = (const char *)(data.data() + pos + 8);
+            fields[std::string((const char *)(data.data() + pos), 4)] = stripWhitespace(std::string(text, strnlen(text, size)));
+            pos += ((size + 1) & ~1) + 8;
+        }
+
+        // Note that RIFF Info chunks don't appear to store disc number
+        Tags tags;
+        tags.title = fields["INAM"];
+        tags.artist = fields["IART"];
+        tags.album = fields["IPRD"];
+        tags.track = fields["IPRT"];
+        mergeTags(tags, m);
+    }
+
+    static bool readFromWAV(Reader & reader, Song & m) {
+        unsigned char header[12];
+        if (!reader.read(0, sizeof(header), header) || std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) {
+            return false;
+        }
+
+        // Find the chunks that are needed, only reading the format and info chunks
+        unsigned char format[16];
+        bool haveFormat = false;
+        long dataSize = -1;
+        std::vector<unsigned char> info;
+        long id3Offset = -1;
+        long pos = sizeof(header);
+        while (reader.size() - pos >= 8) {
+            unsigned char chunk[8];
+            if (!reader.read(pos, sizeof(chunk), chunk)) {
+                return false;
+            }
+            uint32_t len = readLE(chunk + 4, 4);
+            long dataPos = pos + sizeof(chunk);
+            if (len > reader.size() - dataPos) {
+                return false;
+            }
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0 && !haveFormat) {
+                if (len < sizeof(format) || !reader.read(dataPos, sizeof(format), format)) {
+                    return false;
+                }
+                haveFormat = true;
+
+            } else if (std::memcmp(chunk, "data", 4) == 0 && dataSize < 0) {
+                dataSize = len + (len & 1);
+
+            } else if (std::memcmp(chunk, "LIST", 4) == 0 && info.empty()) {
+                // Other types of list (e.g. cue labels) aren't needed
+                unsigned char type[4];
+                if (len >= sizeof(type) && reader.read(dataPos, sizeof(type), type) && std::memcmp(type, "INFO", 4) == 0) {
+                    info.resize(len);
+                    if (!reader.read(dataPos, len, info.data())) {
+                        return false;
+                    }
+                }
+
+            } else if ((std::memcmp(chunk, "ID3 ", 4) == 0 || std::memcmp(chunk, "id3 ", 4) == 0) && id3Offset < 0) {
+                id3Offset = dataPos;
+            }
+            pos = dataPos + len + (len & 1);
+        }
+
+        // Only PCM is handled, as other formats need the 'fact' chunk
+        if (!haveFormat || dataSize < 0 || readLE(format, 2) != 1) {
+            return false;
+        }
+        uint32_t channels = readLE(format + 2, 2);
+        uint32_t sampleRate = readLE(format + 4, 4);
+        uint32_t byteRate = readLE(format + 8, 4);
+        uint32_t bitsPerSample = readLE(format + 14, 2);
+        uint32_t frames = (channels > 0 && bitsPerSample > 0 ? dataSize / (channels * ((bitsPerSample + 7) / 8)) : 0);
+        double length = 0;
+        if (frames > 0 && sampleRate > 0) {
+            length = frames * 1000.0 / sampleRate;
+        } else if (byteRate > 0) {
+            length = dataSize * 1000.0 / byteRate;
+        }
+
+        m.duration = static_cast<int>(length + 0.5) / 1000;
+
+        // Check RIFF metadata first, then ID3v2
+        if (!info.empty()) {
+            parseRIFFInfo(info, m);
+        }
+        long id3End;
+        return (id3Offset < 0 || parseID3v2(reader, id3Offset, m, id3End));
+    }
+
+    bool readFromFile(const std::string & path, const AudioFormat format, Song & m) {
+        Reader reader(path);
+        if (!reader.ok()) {
+            return false;
+        }
+
+        // Work on a copy so nothing is changed if the file can't be handled
+        Song tmp = m;
+        bool ok;
+        switch (format) {
+            case AudioFormat::FLAC:
+                ok = readFromFLAC(reader, tmp);
+                break;
+
+            case AudioFormat::MP3:
+                ok = readFromMP3(reader, tmp);
+                break;
+
+            case AudioFormat::WAV:
+                ok = readFromWAV(reader, tmp);
+                break;
+
+            default:
+                ok = false;
+                break;
+        }
+
+        if (ok) {
+            m = tmp;
+        }
+        return ok;
+    }
+};
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "ui/frame/Album.hpp"
 #include "ui/overlay/ArtistList.hpp"
 #include "ui/overlay/ItemMenu.hpp"
+#include "utils/Image.hpp"
 #include "utils/Utils.hpp"
 
 // Play button dimensions
@@ -31,11 +32,32 @@ namespace Frame {
         this->list->setY(this->list->y() + 80);
         this->list->setH(this->list->h() - 80);
 
-        // First get metadata for the provided album
-        this->metadata = this->app->database()->getAlbumMetadataForID(id);
+        this->artistsList = nullptr;
+        this->albumMenu = nullptr;
+        this->songMenu = nullptr;
+        this->playButton = nullptr;
+
+        // Show placeholders until the album's metadata and songs (ordered by disc, track number and finally
+        // alphabetically) have been fetched
+        this->heading->setString("Frame.Album.Album"_lang);
+        this->subHeading->setString("Common.Loading"_lang);
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            std::pair<Metadata::Album, std::vector<Metadata::Song> > p;
+            p.first = db->getAlbumMetadataForID(id);
+            if (p.first.ID >= 0) {
+                p.second = db->getSongMetadataForAlbum(id);
+            }
+            return p;
+        }, [this](const std::pair<Metadata::Album, std::vector<Metadata::Song> > & p) {
+            this->populate(p.first, p.second);
+        });
+    }
+
+    void Album::populate(const Metadata::Album & album, const std::vector<Metadata::Song> & songs) {
+        this->metadata = album;
         if (this->metadata.ID < 0) {
             // Helps show there was an error (should never appear)
-            this->heading->setString("Frame.Album.Album"_lang);
+            this->subHeading->setString("");
             return;
         }
         this->oneArtist = (this->metadata.artist != "Various Artists");
@@ -44,7 +66,7 @@ namespace Frame {
         }
 
         // Populate with Album's data
-        Aether::Image * image = new Aether::Image(this->x() + 50, this->y() + 50, this->metadata.imagePath.empty() ? Path::App::DefaultArtFile : this->metadata.imagePath);
+        Aether::Image * image = new Aether::Image(this->x() + 50, this->y() + 50, this->metadata.imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(this->metadata.imagePath, Utils::Image::ArtSize::Tile));
         image->setWH(IMAGE_SIZE, IMAGE_SIZE);
         this->addElement(image);
         this->heading->setString(this->metadata.name);
@@ -68,6 +90,7 @@ namespace Frame {
         this->subHeading->setXY(this->heading->x() + 2, this->heading->y() + this->heading->h());
 
         // Play and 'more' buttons
+        this->songs = songs;
         this->playButton = new Aether::FilledButton(this->subHeading->x(), this->subHeading->y() + this->subHeading->h() + 20, BUTTON_W, BUTTON_H, "Common.Play"_lang, BUTTON_F, [this]() {
             this->playAlbum(std::numeric_limits<size_t>::max());
         });
@@ -88,9 +111,6 @@ namespace Frame {
         this->topContainer->addElement(this->playButton);
         this->topContainer->addElement(moreButton);
 
-        // Get all the songs in the album (ordered by disc, track number and finally alphabetically)
-        this->songs = this->app->database()->getSongMetadataForAlbum(this->metadata.ID);
-
         // Create list elements for each song
         if (this->songs.size() > 0) {
             int lastDisc = -1;
@@ -145,10 +165,6 @@ namespace Frame {
 
         this->setFocused(this->topContainer);
         this->topContainer->setFocused(this->playButton);
-
-        this->artistsList = nullptr;
-        this->albumMenu = nullptr;
-        this->songMenu = nullptr;
     }
 
     void Album::playAlbum(size_t pos) {
@@ -160,9 +176,16 @@ namespace Frame {
     }
 
     void Album::createArtistsList() {
-        // Query database for artists first
-        std::vector<Metadata::Artist> m = this->app->database()->getArtistMetadataForAlbum(this->metadata.ID);
+        // Query database for artists first (the list is shown once they're found)
+        AlbumID id = this->metadata.ID;
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getArtistMetadataForAlbum(id);
+        }, [this](const std::vector<Metadata::Artist> & m) {
+            this->showArtistsList(m);
+        });
+    }
 
+    void Album::showArtistsList(const std::vector<Metadata::Artist> & m) {
         // Create menu
         delete this->artistsList;
         this->artistsList = new CustomOvl::ArtistList();
@@ -198,9 +221,8 @@ namespace Frame {
             b->setText("Common.AddToQueue"_lang);
             b->setTextColour(this->app->theme()->FG());
             b->onPress([this]() {
-                std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(this->metadata.ID);
-                for (size_t i = 0; i < v.size(); i++) {
-                    this->app->sysmodule()->sendAddToSubQueue(v[i].ID);
+                for (size_t i = 0; i < this->songs.size(); i++) {
+                    this->app->sysmodule()->sendAddToSubQueue(this->songs[i].ID);
                 }
                 this->albumMenu->close();
             });
@@ -215,10 +237,7 @@ namespace Frame {
             b->onPress([this]() {
                 this->showAddToPlaylist([this](PlaylistID i) {
                     if (i >= 0) {
-                        std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(this->metadata.ID);
-                        for (size_t j = 0; j < v.size(); j++) {
-                            this->app->database()->addSongToPlaylist(i, v[j].ID);
-                        }
+                        this->app->database()->addAlbumToPlaylist(i, this->metadata.ID);
                         this->albumMenu->close();
                     }
                 });
@@ -234,8 +253,7 @@ namespace Frame {
             if (this->oneArtist) {
                 b->setText("Common.GoToArtist"_lang);
                 b->onPress([this]() {
-                    ArtistID aID = this->app->database()->getArtistIDForName(this->metadata.artist);
-                    this->changeFrame(Type::Artist, Action::Push, aID);
+                    this->goToArtistNamed(this->metadata.artist);
                     this->albumMenu->close();
                 });
 
@@ -281,7 +299,7 @@ namespace Frame {
         // Song metadata
         this->songMenu->setMainText(this->songs[pos].title);
         this->songMenu->setSubText(this->songs[pos].artist);
-        this->songMenu->setImage(new Aether::Image(0, 0, this->metadata.imagePath.empty() ? Path::App::DefaultArtFile : this->metadata.imagePath));
+        this->songMenu->setImage(new Aether::Image(0, 0, this->metadata.imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(this->metadata.imagePath, Utils::Image::ArtSize::Thumbnail)));
 
         // Add to Queue
         CustomElm::MenuButton * b = new CustomElm::MenuButton();
@@ -320,10 +338,7 @@ namespace Frame {
             b->setText("Common.GoToArtist"_lang);
             b->setTextColour(this->app->theme()->FG());
             b->onPress([this, pos]() {
-                ArtistID a = this->app->database()->getArtistIDForSong(this->songs[pos].ID);
-                if (a >= 0) {
-                    this->changeFrame(Type::Artist, Action::Push, a);
-                }
+                this->goToArtistForSong(this->songs[pos].ID);
                 this->songMenu->close();
             });
             this->songMenu->addButton(b);
@@ -348,6 +363,9 @@ namespace Frame {
     }
 
     void Album::updateColours() {
+        if (this->playButton == nullptr) {
+            return;
+        }
         this->playButton->setFillColour(this->app->theme()->accent());
     }
 
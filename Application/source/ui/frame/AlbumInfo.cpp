@@ -25,8 +25,27 @@ namespace Frame {
         this->sort->setHidden(true);
         this->topContainer->setHasSelectable(false);
 
-        // Get album metadata from ID
-        this->metadata = this->app->database()->getAlbumMetadataForID(id);
+        this->checkFB = false;
+        this->browser = nullptr;
+        this->updateImage = false;
+        this->oldmsgbox = nullptr;
+        this->msgbox = nullptr;
+        this->threadRunning = false;
+        this->saveButton = nullptr;
+
+        // Show a placeholder until the album's metadata has been fetched
+        this->heading->setString("Album.Information.Heading"_lang);
+        this->subHeading->setString("Common.Loading"_lang);
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getAlbumMetadataForID(id);
+        }, [this](const Metadata::Album & m) {
+            this->populate(m);
+        });
+    }
+
+    void AlbumInfo::populate(const Metadata::Album & m) {
+        this->metadata = m;
+        this->subHeading->setString("");
         if (this->metadata.ID < 0) {
             // Error message
             Aether::Text * t = new Aether::Text(this->x() + this->w()/2, this->y() + this->h()/2, "Common.Error.Database"_lang, 20);
@@ -37,9 +56,6 @@ namespace Frame {
             return;
         }
 
-        // Create and position all elements next
-        this->heading->setString("Album.Information.Heading"_lang);
-
         // Name
         Aether::Text * txt = new Aether::Text(this->heading->x(), this->heading->y() + this->heading->h() + 20, "Album.Information.Name"_lang, 30);
         txt->setColour(this->app->theme()->FG());
@@ -133,13 +149,6 @@ namespace Frame {
         this->saveButton->setFillColour(this->app->theme()->accent());
         this->saveButton->setTextColour(Aether::Colour{0, 0, 0, 255});
         this->bottomContainer->addElement(this->saveButton);
-
-        this->checkFB = false;
-        this->browser = nullptr;
-        this->updateImage = false;
-        this->oldmsgbox = nullptr;
-        this->msgbox = nullptr;
-        this->threadRunning = false;
     }
 
     void AlbumInfo::createAudioDBOverlay() {
@@ -259,45 +268,29 @@ namespace Frame {
             return;
         }
 
-        // Set image path if needed
-        std::string oldPath = this->metadata.imagePath;
+        // Copy new image to disk (named by its contents, so it may already exist)
         if (this->updateImage) {
-            if (!this->metadata.imagePath.empty()) {
-                this->metadata.imagePath = "";
-            }
+            this->metadata.imagePath = "";
             if (!this->newImagePath.empty() || !this->dlBuffer.empty()) {
-                this->metadata.imagePath = this->imagePath->string();
-            }
-        }
-
-        // Copy new image to disk
-        if (this->updateImage && !this->metadata.imagePath.empty()) {
-            // Extract image (if needed) and resize
-            if (!this->newImagePath.empty()) {
-                Utils::Fs::readFile(this->newImagePath, this->dlBuffer);
-            }
-            bool resized = Utils::Image::resize(this->dlBuffer, 400, 400);
-            if (!resized) {
-                Log::writeWarning("[META] Couldn't resize playlist image, saving with original dimensions");
+                // Extract image (if needed)
+                if (!this->newImagePath.empty()) {
+                    Utils::Fs::readFile(this->newImagePath, this->dlBuffer);
+                }
+                // Write at each size, or as is if it can't be resized
+                this->metadata.imagePath = Utils::Image::writeArt(this->dlBuffer, Path::App::AlbumImageFolder);
+                if (this->metadata.imagePath.empty()) {
+                    this->metadata.imagePath = Utils::Image::writeImage(this->dlBuffer, Path::App::AlbumImageFolder, 400);
+                }
             }
-
-            // Write (hopefully resized) to file
-            Utils::Fs::writeFile(this->metadata.imagePath, this->dlBuffer);
         }
 
         // Commit changes to db (acquires lock and then writes)
+        // The old image isn't deleted here as it may be used elsewhere, it's removed once it's unused instead
         this->app->lockDatabase();
         bool ok = this->app->database()->updateAlbum(this->metadata);
         this->app->unlockDatabase();
-
-        // Delete image if everything succeeded, revert copied image on an error
-        if (this->updateImage) {
-            if (ok && !oldPath.empty()) {
-                Utils::Fs::deleteFile(oldPath);
-
-            } else if (!ok && !this->metadata.imagePath.empty()) {
-                Utils::Fs::deleteFile(this->metadata.imagePath);
-            }
+        if (ok && this->updateImage) {
+            this->imagePath->setString(this->metadata.imagePath.empty() ? Path::App::DefaultArtFile : this->metadata.imagePath);
         }
 
         // Show message box indicating result
@@ -411,13 +404,9 @@ namespace Frame {
             this->bottomContainer->addElement(this->image);
             this->updateImage = true;
 
-            // Generate unique path (if you're really unlucky this could run indefinitely - but with 62^10 combinations we should be right :P)
-            std::string rand;
-            do {
-                rand = Utils::randomString(10);
-            } while (Utils::Fs::fileExists(Path::App::AlbumImageFolder + rand + ".png"));
+            // Show where the image came from until it's saved
             this->newImagePath.clear();
-            this->imagePath->setString(Path::App::AlbumImageFolder + rand + ".png");
+            this->imagePath->setString(path);
         }
     }
 
@@ -438,19 +427,17 @@ namespace Frame {
             this->bottomContainer->addElement(this->image);
             this->updateImage = true;
 
-            // Generate unique path (if you're really unlucky this could run indefinitely - but with 62^10 combinations we should be right :P)
-            std::string ext = Utils::Fs::getExtension(path);
-            std::string rand;
-            do {
-                rand = Utils::randomString(10);
-            } while (Utils::Fs::fileExists(Path::App::AlbumImageFolder + rand + ext));
-            this->imagePath->setString(Path::App::AlbumImageFolder + rand + ext);
+            // Show where the image came from until it's saved
+            this->imagePath->setString(path);
             this->newImagePath = path;
             this->dlBuffer.clear();
         }
     }
 
     void AlbumInfo::updateColours() {
+        if (this->saveButton == nullptr) {
+            return;
+        }
         this->saveButton->setFillColour(this->app->theme()->accent());
     }
 
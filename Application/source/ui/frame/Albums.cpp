@@ -6,6 +6,7 @@
 #include "ui/element/ScrollableGrid.hpp"
 #include "ui/frame/Albums.hpp"
 #include "ui/overlay/SortBy.hpp"
+#include "utils/Image.hpp"
 #include "utils/Utils.hpp"
 
 // Number of GridItems per row
@@ -50,9 +51,15 @@ namespace Frame {
     }
 
     void Albums::createArtistsList(AlbumID id) {
-        // Query database for artists first
-        std::vector<Metadata::Artist> m = this->app->database()->getArtistMetadataForAlbum(id);
+        // Query database for artists first (the list is shown once they're found)
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getArtistMetadataForAlbum(id);
+        }, [this](const std::vector<Metadata::Artist> & m) {
+            this->showArtistsList(m);
+        });
+    }
 
+    void Albums::showArtistsList(const std::vector<Metadata::Artist> & m) {
         // Create menu
         delete this->artistsList;
         this->artistsList = new CustomOvl::ArtistList();
@@ -78,12 +85,22 @@ namespace Frame {
     void Albums::createList(Database::SortBy sort) {
         // Remove previous items
         this->grid->removeAllElements();
+        this->subHeading->setString("Common.Loading"_lang);
+
+        // Fetch albums in the background, dropping any previous request
+        this->app->databaseWorker()->cancel(this);
+        this->app->databaseWorker()->queue(this, [sort](const SyncDatabase & db) {
+            return db->getAllAlbumMetadata(sort);
+        }, [this](const std::vector<Metadata::Album> & m) {
+            this->populateList(m);
+        });
+    }
 
+    void Albums::populateList(const std::vector<Metadata::Album> & m) {
         // Create items for albums
-        std::vector<Metadata::Album> m = this->app->database()->getAllAlbumMetadata(sort);
         if (m.size() > 0) {
             for (size_t i = 0; i < m.size(); i++) {
-                std::string img = (m[i].imagePath.empty() ? Path::App::DefaultArtFile : m[i].imagePath);
+                std::string img = (m[i].imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(m[i].imagePath, Utils::Image::ArtSize::Tile));
                 CustomElm::GridItem * l = new CustomElm::GridItem(img);
                 l->setMainString(m[i].name);
                 l->setSubString(m[i].artist);
@@ -94,8 +111,8 @@ namespace Frame {
                 l->onPress([this, id](){
                     this->changeFrame(Type::Album, Action::Push, id);
                 });
-                l->setMoreCallback([this, id]() {
-                    this->createMenu(id);
+                l->setMoreCallback([this, album = m[i]]() {
+                    this->createMenu(album);
                 });
                 this->grid->addElement(l);
             }
@@ -113,14 +130,9 @@ namespace Frame {
 
     }
 
-    void Albums::createMenu(AlbumID id) {
-        // Query database first
-        Metadata::Album m = this->app->database()->getAlbumMetadataForID(id);
-        if (m.ID < 0) {
-            return;
-        }
-
-        // Create menu
+    void Albums::createMenu(const Metadata::Album & m) {
+        // Create menu (using the metadata from the list, so there's nothing to wait for)
+        AlbumID id = m.ID;
         delete this->albumMenu;
         this->albumMenu = new CustomOvl::ItemMenu();
         this->albumMenu->setBackgroundColour(this->app->theme()->popupBG());
@@ -129,7 +141,7 @@ namespace Frame {
         this->albumMenu->addSeparator(this->app->theme()->muted2());
 
         // Album metadata
-        this->albumMenu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath));
+        this->albumMenu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(m.imagePath, Utils::Image::ArtSize::Thumbnail)));
         this->albumMenu->setMainText(m.name);
         this->albumMenu->setSubText(m.artist);
 
@@ -140,12 +152,9 @@ namespace Frame {
         b->setText("Common.Play"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, m]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(m.ID);
-            std::vector<SongID> ids;
-            for (size_t i = 0; i < v.size(); i++) {
-                ids.push_back(v[i].ID);
-            }
-            this->playNewQueue(m.name, ids, 0, true);
+            this->withAlbumSongs(m.ID, [this, name = m.name](const std::vector<SongID> & ids) {
+                this->playNewQueue(name, ids, 0, true);
+            });
             this->albumMenu->close();
         });
         this->albumMenu->addButton(b);
@@ -158,10 +167,11 @@ namespace Frame {
         b->setText("Common.AddToQueue"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(id);
-            for (size_t i = 0; i < v.size(); i++) {
-                this->app->sysmodule()->sendAddToSubQueue(v[i].ID);
-            }
+            this->withAlbumSongs(id, [this](const std::vector<SongID> & ids) {
+                for (SongID song : ids) {
+                    this->app->sysmodule()->sendAddToSubQueue(song);
+                }
+            });
             this->albumMenu->close();
         });
         this->albumMenu->addButton(b);
@@ -175,10 +185,7 @@ namespace Frame {
         b->onPress([this, id]() {
             this->showAddToPlaylist([this, id](PlaylistID i) {
                 if (i >= 0) {
-                    std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(id);
-                    for (size_t j = 0; j < v.size(); j++) {
-                        this->app->database()->addSongToPlaylist(i, v[j].ID);
-                    }
+                    this->app->database()->addAlbumToPlaylist(i, id);
                     this->albumMenu->close();
                 }
             });
@@ -193,9 +200,8 @@ namespace Frame {
         b->setTextColour(this->app->theme()->FG());
         if (m.artist != "Various Artists") {
             b->setText("Common.GoToArtist"_lang);
-            ArtistID aID = this->app->database()->getArtistIDForName(m.artist);
-            b->onPress([this, aID]() {
-                this->changeFrame(Type::Artist, Action::Push, aID);
+            b->onPress([this, name = m.artist]() {
+                this->goToArtistNamed(name);
                 this->albumMenu->close();
             });
 
@@ -5,6 +5,7 @@
 #include "ui/element/ScrollableGrid.hpp"
 #include "ui/frame/Artist.hpp"
 #include "ui/overlay/SortBy.hpp"
+#include "utils/Image.hpp"
 #include "utils/Utils.hpp"
 
 // Play button dimensions
@@ -24,14 +25,27 @@ namespace Frame {
         this->topContainer->removeElement(this->albumH);
         this->topContainer->removeElement(this->lengthH);
 
-        // First get metadata for the provided artist
-        this->meta = this->app->database()->getArtistMetadataForID(id);
+        this->albumMenu = nullptr;
+        this->artistMenu = nullptr;
+        this->sortMenu = nullptr;
+        this->playButton = nullptr;
+        this->grid = nullptr;
+
+        // Show placeholders until the artist's metadata has been fetched
+        this->heading->setString("Artist.Artist"_lang);
+        this->subHeading->setString("Common.Loading"_lang);
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getArtistMetadataForID(id);
+        }, [this](const Metadata::Artist & m) {
+            this->populate(m);
+        });
+    }
+
+    void Artist::populate(const Metadata::Artist & m) {
+        this->meta = m;
         if (this->meta.ID < 0) {
             // Helps show there was an error (should never appear)
-            this->heading->setString("Artist.Artist"_lang);
-            this->albumMenu = nullptr;
-            this->artistMenu = nullptr;
-            this->sortMenu = nullptr;
+            this->subHeading->setString("");
             return;
         }
 
@@ -68,19 +82,16 @@ namespace Frame {
 
         // Play and 'more' buttons
         this->playButton = new Aether::FilledButton(this->subHeading->x(), this->subHeading->y() + this->subHeading->h() + 20, BUTTON_W, BUTTON_H, "Common.Play"_lang, BUTTON_F, [this]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForArtist(this->meta.ID);
-            std::vector<SongID> ids;
-            for (size_t i = 0; i < v.size(); i++) {
-                ids.push_back(v[i].ID);
-            }
-            this->playNewQueue(this->meta.name, ids, 0, true);
+            this->withArtistSongs(this->meta.ID, [this](const std::vector<SongID> & ids) {
+                this->playNewQueue(this->meta.name, ids, 0, true);
+            });
         });
         this->playButton->setFillColour(this->app->theme()->accent());
         this->playButton->setTextColour(Aether::Colour{0, 0, 0, 255});
         this->sort->setY(this->playButton->y());
 
-        Aether::BorderButton * moreButton = new Aether::BorderButton(this->playButton->x() + this->playButton->w() + 20, this->playButton->y(), BUTTON_H, BUTTON_H, 2, "", BUTTON_F, [this, id]() {
-            this->createArtistMenu(id);
+        Aether::BorderButton * moreButton = new Aether::BorderButton(this->playButton->x() + this->playButton->w() + 20, this->playButton->y(), BUTTON_H, BUTTON_H, 2, "", BUTTON_F, [this]() {
+            this->createArtistMenu();
         });
         moreButton->setBorderColour(this->app->theme()->FG());
         moreButton->setTextColour(this->app->theme()->FG());
@@ -119,20 +130,12 @@ namespace Frame {
 
         this->setFocused(this->topContainer);
         this->topContainer->setFocused(this->playButton);
-
-        this->albumMenu = nullptr;
-        this->artistMenu = nullptr;
     }
 
-    void Artist::createArtistMenu(ArtistID id) {
+    void Artist::createArtistMenu() {
         // Create menu if it doesn't exist
         if (this->artistMenu == nullptr) {
-            // Query database first
-            Metadata::Artist m = this->app->database()->getArtistMetadataForID(id);
-            if (m.ID < 0) {
-                return;
-            }
-
+            ArtistID id = this->meta.ID;
             this->artistMenu = new CustomOvl::Menu();
             this->artistMenu->setBackgroundColour(this->app->theme()->popupBG());
 
@@ -143,10 +146,11 @@ namespace Frame {
             b->setText("Common.AddToQueue"_lang);
             b->setTextColour(this->app->theme()->FG());
             b->onPress([this, id]() {
-                std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForArtist(id);
-                for (size_t i = 0; i < v.size(); i++) {
-                    this->app->sysmodule()->sendAddToSubQueue(v[i].ID);
-                }
+                this->withArtistSongs(id, [this](const std::vector<SongID> & ids) {
+                    for (size_t i = 0; i < ids.size(); i++) {
+                        this->app->sysmodule()->sendAddToSubQueue(ids[i]);
+                    }
+                });
                 this->artistMenu->close();
             });
             this->artistMenu->addButton(b);
@@ -160,10 +164,7 @@ namespace Frame {
             b->onPress([this, id]() {
                 this->showAddToPlaylist([this, id](PlaylistID i) {
                     if (i >= 0) {
-                        std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForArtist(id);
-                        for (size_t j = 0; j < v.size(); j++) {
-                            this->app->database()->addSongToPlaylist(i, v[j].ID);
-                        }
+                        this->app->database()->addArtistToPlaylist(i, id);
                         this->artistMenu->close();
                     }
                 });
@@ -191,14 +192,9 @@ namespace Frame {
         this->app->addOverlay(this->artistMenu);
     }
 
-    void Artist::createAlbumMenu(AlbumID id) {
-        // Get metadata first
-        Metadata::Album m = this->app->database()->getAlbumMetadataForID(id);
-        if (m.ID < 0) {
-            return;
-        }
-
-        // Create menu
+    void Artist::createAlbumMenu(const Metadata::Album & m) {
+        // Create menu (using the metadata from the grid, so there's nothing to wait for)
+        AlbumID id = m.ID;
         delete this->albumMenu;
         this->albumMenu = new CustomOvl::ItemMenu();
         this->albumMenu->setBackgroundColour(this->app->theme()->popupBG());
@@ -207,7 +203,7 @@ namespace Frame {
         this->albumMenu->addSeparator(this->app->theme()->muted2());
 
         // Album metadata
-        this->albumMenu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath));
+        this->albumMenu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(m.imagePath, Utils::Image::ArtSize::Thumbnail)));
         this->albumMenu->setMainText(m.name);
         this->albumMenu->setSubText(m.artist);
 
@@ -217,13 +213,10 @@ namespace Frame {
         b->setIconColour(this->app->theme()->muted());
         b->setText("Artist.PlayAlbum"_lang);
         b->setTextColour(this->app->theme()->FG());
-        b->onPress([this, m]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(m.ID);
-            std::vector<SongID> ids;
-            for (size_t i = 0; i < v.size(); i++) {
-                ids.push_back(v[i].ID);
-            }
-            this->playNewQueue(m.name, ids, 0, true);
+        b->onPress([this, id, name = m.name]() {
+            this->withAlbumSongs(id, [this, name](const std::vector<SongID> & ids) {
+                this->playNewQueue(name, ids, 0, true);
+            });
             this->albumMenu->close();
         });
         this->albumMenu->addButton(b);
@@ -236,10 +229,11 @@ namespace Frame {
         b->setText("Artist.AddAlbumToQueue"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(id);
-            for (size_t i = 0; i < v.size(); i++) {
-                this->app->sysmodule()->sendAddToSubQueue(v[i].ID);
-            }
+            this->withAlbumSongs(id, [this](const std::vector<SongID> & ids) {
+                for (size_t i = 0; i < ids.size(); i++) {
+                    this->app->sysmodule()->sendAddToSubQueue(ids[i]);
+                }
+            });
             this->albumMenu->close();
         });
         this->albumMenu->addButton(b);
@@ -253,10 +247,7 @@ namespace Frame {
         b->onPress([this, id]() {
             this->showAddToPlaylist([this, id](PlaylistID i) {
                 if (i >= 0) {
-                    std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(id);
-                    for (size_t j = 0; j < v.size(); j++) {
-                        this->app->database()->addSongToPlaylist(i, v[j].ID);
-                    }
+                    this->app->database()->addAlbumToPlaylist(i, id);
                     this->albumMenu->close();
                 }
             });
@@ -285,12 +276,22 @@ namespace Frame {
         // Remove previous items
         this->grid->removeAllElements();
 
+        // Fetch albums in the background, dropping any previous request
+        ArtistID id = this->meta.ID;
+        this->app->databaseWorker()->cancel(this);
+        this->app->databaseWorker()->queue(this, [id, sort](const SyncDatabase & db) {
+            return db->getAlbumMetadataForArtist(id, sort);
+        }, [this](const std::vector<Metadata::Album> & md) {
+            this->populateList(md);
+        });
+    }
+
+    void Artist::populateList(const std::vector<Metadata::Album> & md) {
         // Create grid if there are albums
-        std::vector<Metadata::Album> md = this->app->database()->getAlbumMetadataForArtist(this->meta.ID, sort);
         if (md.size() > 0) {
             // Populate grid with albums
             for (size_t i = 0; i < md.size(); i++) {
-                CustomElm::GridItem * l = new CustomElm::GridItem(md[i].imagePath.empty() ? Path::App::DefaultArtFile : md[i].imagePath);
+                CustomElm::GridItem * l = new CustomElm::GridItem(md[i].imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(md[i].imagePath, Utils::Image::ArtSize::Tile));
                 l->setMainString(md[i].name);
                 std::string str = (md[i].songCount == 1 ? "Common.Song"_lang : Utils::substituteTokens("Common.Songs"_lang, std::to_string(md[i].songCount)));
                 l->setSubString(str);
@@ -301,8 +302,8 @@ namespace Frame {
                 l->onPress([this, id](){
                     this->changeFrame(Type::Album, Action::Push, id);
                 });
-                l->setMoreCallback([this, id]() {
-                    this->createAlbumMenu(id);
+                l->setMoreCallback([this, album = md[i]]() {
+                    this->createAlbumMenu(album);
                 });
                 this->grid->addElement(l);
             }
@@ -310,6 +311,9 @@ namespace Frame {
     }
 
     void Artist::updateColours() {
+        if (this->playButton == nullptr) {
+            return;
+        }
         this->playButton->setFillColour(this->app->theme()->accent());
     }
 
@@ -51,9 +51,19 @@ namespace Frame {
     void Artists::createList(Database::SortBy sort) {
         // Remove previous items
         this->grid->removeAllElements();
+        this->subHeading->setString("Common.Loading"_lang);
+
+        // Fetch artists in the background, dropping any previous request
+        this->app->databaseWorker()->cancel(this);
+        this->app->databaseWorker()->queue(this, [sort](const SyncDatabase & db) {
+            return db->getAllArtistMetadata(sort);
+        }, [this](const std::vector<Metadata::Artist> & m) {
+            this->populateList(m);
+        });
+    }
 
+    void Artists::populateList(const std::vector<Metadata::Artist> & m) {
         // Create items for artists
-        std::vector<Metadata::Artist> m = this->app->database()->getAllArtistMetadata(sort);
         if (m.size() > 0) {
             for (size_t i = 0; i < m.size(); i++) {
                 std::string img = (m[i].imagePath.empty() ? "romfs:/misc/noartist.png" : m[i].imagePath);
@@ -80,8 +90,8 @@ namespace Frame {
                 l->onPress([this, id](){
                     this->changeFrame(Type::Artist, Action::Push, id);
                 });
-                l->setMoreCallback([this, id]() {
-                    this->createMenu(id);
+                l->setMoreCallback([this, artist = m[i]]() {
+                    this->createMenu(artist);
                 });
                 this->grid->addElement(l);
             }
@@ -98,14 +108,9 @@ namespace Frame {
         }
     }
 
-    void Artists::createMenu(ArtistID id) {
-        // Query database first
-        Metadata::Artist m = this->app->database()->getArtistMetadataForID(id);
-        if (m.ID < 0) {
-            return;
-        }
-
-        // Create menu
+    void Artists::createMenu(const Metadata::Artist & m) {
+        // Create menu (using the metadata from the list, so there's nothing to wait for)
+        ArtistID id = m.ID;
         delete this->menu;
         this->menu = new CustomOvl::ItemMenu();
         this->menu->setBackgroundColour(this->app->theme()->popupBG());
@@ -138,12 +143,9 @@ namespace Frame {
         b->setText("Artist.PlayAll"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, m]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForArtist(m.ID);
-            std::vector<SongID> ids;
-            for (size_t i = 0; i < v.size(); i++) {
-                ids.push_back(v[i].ID);
-            }
-            this->playNewQueue(m.name, ids, 0, true);
+            this->withArtistSongs(m.ID, [this, name = m.name](const std::vector<SongID> & ids) {
+                this->playNewQueue(name, ids, 0, true);
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -156,10 +158,11 @@ namespace Frame {
         b->setText("Common.AddToQueue"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForArtist(id);
-            for (size_t i = 0; i < v.size(); i++) {
-                this->app->sysmodule()->sendAddToSubQueue(v[i].ID);
-            }
+            this->withArtistSongs(id, [this](const std::vector<SongID> & ids) {
+                for (SongID song : ids) {
+                    this->app->sysmodule()->sendAddToSubQueue(song);
+                }
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -173,10 +176,7 @@ namespace Frame {
         b->onPress([this, id]() {
             this->showAddToPlaylist([this, id](PlaylistID i) {
                 if (i >= 0) {
-                    std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForArtist(id);
-                    for (size_t j = 0; j < v.size(); j++) {
-                        this->app->database()->addSongToPlaylist(i, v[j].ID);
-                    }
+                    this->app->database()->addArtistToPlaylist(i, id);
                     this->menu->close();
                 }
             });
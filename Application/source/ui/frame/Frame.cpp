@@ -1,6 +1,9 @@
 #include "Application.hpp"
 #include "lang/Lang.hpp"
+#include "Paths.hpp"
 #include "ui/frame/Frame.hpp"
+#include "ui/overlay/ItemMenu.hpp"
+#include "utils/Image.hpp"
 
 // Size and position of all frames
 #define X 320
@@ -90,6 +93,98 @@ namespace Frame {
         // Do nothing by default
     }
 
+    void Frame::withAlbumSongs(AlbumID id, const std::function<void(const std::vector<SongID> &)> & func) {
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            std::vector<Metadata::Song> v = db->getSongMetadataForAlbum(id);
+            std::vector<SongID> ids;
+            for (const Metadata::Song & m : v) {
+                ids.push_back(m.ID);
+            }
+            return ids;
+        }, func);
+    }
+
+    void Frame::withArtistSongs(ArtistID id, const std::function<void(const std::vector<SongID> &)> & func) {
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            std::vector<Metadata::Song> v = db->getSongMetadataForArtist(id);
+            std::vector<SongID> ids;
+            for (const Metadata::Song & m : v) {
+                ids.push_back(m.ID);
+            }
+            return ids;
+        }, func);
+    }
+
+    void Frame::withPlaylistSongs(PlaylistID id, const std::function<void(const std::vector<SongID> &)> & func) {
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            std::vector<Metadata::PlaylistSong> v = db->getSongMetadataForPlaylist(id, Database::SortBy::TitleAsc);
+            std::vector<SongID> ids;
+            for (const Metadata::PlaylistSong & m : v) {
+                ids.push_back(m.song.ID);
+            }
+            return ids;
+        }, func);
+    }
+
+    void Frame::withSongArt(SongID id, const std::function<void(const std::string &)> & func) {
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            AlbumID album = db->getAlbumIDForSong(id);
+            Metadata::Album m = db->getAlbumMetadataForID(album);
+            return (m.imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(m.imagePath, Utils::Image::ArtSize::Thumbnail));
+        }, func);
+    }
+
+    void Frame::goToArtistForSong(SongID id) {
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getArtistIDForSong(id);
+        }, [this](ArtistID a) {
+            if (a >= 0) {
+                this->changeFrame(Type::Artist, Action::Push, a);
+            }
+        });
+    }
+
+    void Frame::goToArtistNamed(const std::string & name) {
+        this->app->databaseWorker()->queue(this, [name](const SyncDatabase & db) {
+            return db->getArtistIDForName(name);
+        }, [this](ArtistID a) {
+            if (a >= 0) {
+                this->changeFrame(Type::Artist, Action::Push, a);
+            }
+        });
+    }
+
+    void Frame::goToAlbumForSong(SongID id) {
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getAlbumIDForSong(id);
+        }, [this](AlbumID a) {
+            if (a >= 0) {
+                this->changeFrame(Type::Album, Action::Push, a);
+            }
+        });
+    }
+
+    void Frame::fillSongMenu(CustomOvl::ItemMenu * const & menu, SongID id) {
+        menu->setMainText("Common.Loading"_lang);
+        menu->setImage(new Aether::Image(0, 0, Path::App::DefaultArtFile));
+
+        // The menu may be replaced (or deleted) before the results arrive, so it's compared before being used
+        CustomOvl::ItemMenu * current = menu;
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getSongMetadataForID(id);
+        }, [&menu, current](const Metadata::Song & m) {
+            if (menu == current && m.ID >= 0) {
+                menu->setMainText(m.title);
+                menu->setSubText(m.artist);
+            }
+        });
+        this->withSongArt(id, [&menu, current](const std::string & path) {
+            if (menu == current) {
+                menu->setImage(new Aether::Image(0, 0, path));
+            }
+        });
+    }
+
     void Frame::setChangeFrameFunc(std::function<void(Type, Action, int)> f) {
         this->changeFrame = f;
     }
@@ -101,4 +196,8 @@ namespace Frame {
     void Frame::setShowAddToPlaylistFunc(std::function<void(std::function<void(PlaylistID)>)> f) {
         this->showAddToPlaylist = f;
     }
+
+    Frame::~Frame() {
+        this->app->databaseWorker()->cancel(this);
+    }
 };
\ No newline at end of file
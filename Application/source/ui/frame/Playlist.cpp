@@ -28,15 +28,30 @@ namespace Frame {
         this->list->setY(this->list->y() + 80);
         this->list->setH(this->list->h() - 80);
 
-        // First get metadata for the provided playlist
-        this->metadata = this->app->database()->getPlaylistMetadataForID(id);
+        this->emptyMsg = nullptr;
+        this->goBack = false;
+        this->image = nullptr;
+        this->msgbox = nullptr;
+        this->playButton = nullptr;
+        this->playlistMenu = nullptr;
+        this->songMenu = nullptr;
+        this->sortMenu = nullptr;
+
+        // Show placeholders until the playlist's metadata has been fetched
+        this->heading->setString("Playlist.Playlist"_lang);
+        this->subHeading->setString("Common.Loading"_lang);
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getPlaylistMetadataForID(id);
+        }, [this](const Metadata::Playlist & m) {
+            this->populate(m);
+        });
+    }
+
+    void Playlist::populate(const Metadata::Playlist & m) {
+        this->metadata = m;
         if (this->metadata.ID < 0) {
             // Helps show there was an error (should never appear)
-            this->heading->setString("Playlist.Playlist"_lang);
-            this->msgbox = nullptr;
-            this->playlistMenu = nullptr;
-            this->songMenu = nullptr;
-            this->sortMenu = nullptr;
+            this->subHeading->setString("");
             return;
         }
 
@@ -76,12 +91,6 @@ namespace Frame {
         this->topContainer->addElement(this->playButton);
         this->topContainer->addElement(moreButton);
 
-        this->emptyMsg = nullptr;
-        this->goBack = false;
-        this->msgbox = nullptr;
-        this->playlistMenu = nullptr;
-        this->songMenu = nullptr;
-
         // Create sort menu
         this->sort->onPress([this]() {
             this->app->addOverlay(this->sortMenu);
@@ -197,11 +206,29 @@ namespace Frame {
     void Playlist::refreshList(Database::SortBy sort) {
         this->sortType = sort;
 
-        // Create list elements for each song
+        // Remove previous items
         this->elms.clear();
         this->list->removeAllElements();
-        this->metadata = this->app->database()->getPlaylistMetadataForID(this->metadata.ID);
-        this->songs = this->app->database()->getSongMetadataForPlaylist(this->metadata.ID, sort);
+        this->songs.clear();
+        this->subHeading->setString("Common.Loading"_lang);
+
+        // Fetch the playlist's songs in the background, dropping any previous request
+        PlaylistID id = this->metadata.ID;
+        this->app->databaseWorker()->cancel(this);
+        this->app->databaseWorker()->queue(this, [id, sort](const SyncDatabase & db) {
+            std::pair<Metadata::Playlist, std::vector<Metadata::PlaylistSong> > p;
+            p.first = db->getPlaylistMetadataForID(id);
+            p.second = db->getSongMetadataForPlaylist(id, sort);
+            return p;
+        }, [this](const std::pair<Metadata::Playlist, std::vector<Metadata::PlaylistSong> > & p) {
+            this->populateList(p.first, p.second);
+        });
+    }
+
+    void Playlist::populateList(const Metadata::Playlist & m, const std::vector<Metadata::PlaylistSong> & songs) {
+        // Create list elements for each song
+        this->metadata = m;
+        this->songs = songs;
         if (this->songs.size() > 0) {
             for (size_t i = 0; i < this->songs.size(); i++) {
                 CustomElm::ListItem::Song * l = new CustomElm::ListItem::Song();
@@ -298,9 +325,7 @@ namespace Frame {
             b->onPress([this]() {
                 this->showAddToPlaylist([this](PlaylistID i) {
                     if (i >= 0) {
-                        for (size_t j = 0; j < this->songs.size(); j++) {
-                            this->app->database()->addSongToPlaylist(i, this->songs[j].song.ID);
-                        }
+                        this->app->database()->addPlaylistToPlaylist(i, this->metadata.ID);
                         this->playlistMenu->close();
 
                         // Refresh the list if it's this playlist
@@ -368,9 +393,15 @@ namespace Frame {
         // Song metadata
         this->songMenu->setMainText(this->songs[pos].song.title);
         this->songMenu->setSubText(this->songs[pos].song.artist);
-        AlbumID id = this->app->database()->getAlbumIDForSong(this->songs[pos].song.ID);
-        Metadata::Album md = this->app->database()->getAlbumMetadataForID(id);
-        this->songMenu->setImage(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
+        this->songMenu->setImage(new Aether::Image(0, 0, Path::App::DefaultArtFile));
+
+        // Album art is shown once found (unless the menu has since been replaced)
+        CustomOvl::ItemMenu * menu = this->songMenu;
+        this->withSongArt(this->songs[pos].song.ID, [this, menu](const std::string & path) {
+            if (this->songMenu == menu) {
+                this->songMenu->setImage(new Aether::Image(0, 0, path));
+            }
+        });
 
         // Add to Queue
         CustomElm::MenuButton * b = new CustomElm::MenuButton();
@@ -405,28 +436,30 @@ namespace Frame {
         });
         this->songMenu->addButton(b);
 
-        // Remove from Playlist
-        b = new CustomElm::MenuButton();
-        b->setIcon(new Aether::Image(0, 0, "romfs:/icons/removefromplaylist.png"));
-        b->setIconColour(this->app->theme()->muted());
-        b->setText("Playlist.RemoveFromPlaylist"_lang);
-        b->setTextColour(this->app->theme()->FG());
-        b->onPress([this, pos]() {
-            // Remove from database
-            this->app->lockDatabase();
-            bool ok = this->app->database()->removeSongFromPlaylist(this->songs[pos].ID);
-            this->app->unlockDatabase();
-
-            // Remove from lists
-            if (ok) {
-                this->list->removeElement(this->elms[pos]);
-                this->elms.erase(this->elms.begin() + pos);
-                this->songs.erase(this->songs.begin() + pos);
-                this->calculateStats();
-            }
-            this->songMenu->close();
-        });
-        this->songMenu->addButton(b);
+        // Remove from Playlist (not possible for smart playlists, as their songs are chosen by rules)
+        if (!this->metadata.smart) {
+            b = new CustomElm::MenuButton();
+            b->setIcon(new Aether::Image(0, 0, "romfs:/icons/removefromplaylist.png"));
+            b->setIconColour(this->app->theme()->muted());
+            b->setText("Playlist.RemoveFromPlaylist"_lang);
+            b->setTextColour(this->app->theme()->FG());
+            b->onPress([this, pos]() {
+                // Remove from database
+                this->app->lockDatabase();
+                bool ok = this->app->database()->removeSongFromPlaylist(this->songs[pos].ID);
+                this->app->unlockDatabase();
+
+                // Remove from lists
+                if (ok) {
+                    this->list->removeElement(this->elms[pos]);
+                    this->elms.erase(this->elms.begin() + pos);
+                    this->songs.erase(this->songs.begin() + pos);
+                    this->calculateStats();
+                }
+                this->songMenu->close();
+            });
+            this->songMenu->addButton(b);
+        }
         this->songMenu->addSeparator(this->app->theme()->muted2());
 
         // Go to Artist
@@ -436,10 +469,7 @@ namespace Frame {
         b->setText("Common.GoToArtist"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, pos]() {
-            ArtistID a = this->app->database()->getArtistIDForSong(this->songs[pos].song.ID);
-            if (a >= 0) {
-                this->changeFrame(Type::Artist, Action::Push, a);
-            }
+            this->goToArtistForSong(this->songs[pos].song.ID);
             this->songMenu->close();
         });
         this->songMenu->addButton(b);
@@ -478,19 +508,34 @@ namespace Frame {
         // Only take action if frame was PlaylistInfo
         if (t == Type::PlaylistInfo) {
             // Get updated metadata and update elements if needed
-            Metadata::Playlist m = this->app->database()->getPlaylistMetadataForID(this->metadata.ID);
-            if (m.imagePath != this->metadata.imagePath) {
-                this->removeElement(this->image);
-                this->image = new Aether::Image(this->x() + 50, this->y() + 50, m.imagePath.empty() ? "romfs:/misc/noplaylist.png" : m.imagePath);
-                this->image->setWH(IMAGE_SIZE, IMAGE_SIZE);
-                this->addElement(this->image);
-            }
-            this->heading->setString(m.name);
-            this->metadata = m;
+            PlaylistID id = this->metadata.ID;
+            this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+                return db->getPlaylistMetadataForID(id);
+            }, [this](const Metadata::Playlist & m) {
+                this->updateMetadata(m);
+            });
         }
     }
 
+    void Playlist::updateMetadata(const Metadata::Playlist & m) {
+        if (m.ID < 0) {
+            return;
+        }
+
+        if (m.imagePath != this->metadata.imagePath) {
+            this->removeElement(this->image);
+            this->image = new Aether::Image(this->x() + 50, this->y() + 50, m.imagePath.empty() ? "romfs:/misc/noplaylist.png" : m.imagePath);
+            this->image->setWH(IMAGE_SIZE, IMAGE_SIZE);
+            this->addElement(this->image);
+        }
+        this->heading->setString(m.name);
+        this->metadata = m;
+    }
+
     void Playlist::updateColours() {
+        if (this->playButton == nullptr) {
+            return;
+        }
         this->playButton->setFillColour(this->app->theme()->accent());
     }
 
@@ -27,8 +27,26 @@ namespace Frame {
         this->sort->setHidden(true);
         this->topContainer->setHasSelectable(false);
 
-        // Get album metadata from ID
-        this->metadata = this->app->database()->getPlaylistMetadataForID(id);
+        this->checkFB = false;
+        this->browser = nullptr;
+        this->updateImage = false;
+        this->oldmsgbox = nullptr;
+        this->msgbox = nullptr;
+        this->saveButton = nullptr;
+
+        // Show a placeholder until the playlist's metadata has been fetched
+        this->heading->setString("Playlist.Information.Heading"_lang);
+        this->subHeading->setString("Common.Loading"_lang);
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getPlaylistMetadataForID(id);
+        }, [this](const Metadata::Playlist & m) {
+            this->populate(m);
+        });
+    }
+
+    void PlaylistInfo::populate(const Metadata::Playlist & m) {
+        this->metadata = m;
+        this->subHeading->setString("");
         if (this->metadata.ID < 0) {
             // Error message
             Aether::Text * t = new Aether::Text(this->x() + this->w()/2, this->y() + this->h()/2, "Common.Error.Database"_lang, 20);
@@ -39,9 +57,6 @@ namespace Frame {
             return;
         }
 
-        // Create and position all elements next
-        this->heading->setString("Playlist.Information.Heading"_lang);
-
         // Name
         Aether::Text * txt = new Aether::Text(this->heading->x(), this->heading->y() + this->heading->h() + 20, "Playlist.Information.Name"_lang, 30);
         txt->setColour(this->app->theme()->FG());
@@ -127,12 +142,6 @@ namespace Frame {
         this->saveButton->setFillColour(this->app->theme()->accent());
         this->saveButton->setTextColour(Aether::Colour{0, 0, 0, 255});
         this->bottomContainer->addElement(this->saveButton);
-
-        this->checkFB = false;
-        this->browser = nullptr;
-        this->updateImage = false;
-        this->oldmsgbox = nullptr;
-        this->msgbox = nullptr;
     }
 
     void PlaylistInfo::createInfoOverlay(const std::string & msg) {
@@ -352,6 +361,9 @@ namespace Frame {
     }
 
     void PlaylistInfo::updateColours() {
+        if (this->saveButton == nullptr) {
+            return;
+        }
         this->saveButton->setFillColour(this->app->theme()->accent());
     }
 
@@ -57,11 +57,22 @@ namespace Frame {
         btn->addElement(img);
         this->topContainer->addElement(btn);
 
+        Aether::BorderButton * smartBtn = new Aether::BorderButton(btn->x() - 70, btn->y(), 50, 50, 2, "", BUTTON_F, [this]() {
+            this->createSmartPlaylistMenu();
+        });
+        smartBtn->setBorderColour(this->app->theme()->FG());
+        smartBtn->setTextColour(this->app->theme()->FG());
+        img = new Aether::Image(smartBtn->x() + smartBtn->w()/2, smartBtn->y() + smartBtn->h()/2, "romfs:/icons/playlist.png");
+        img->setXY(img->x() - img->w()/2, img->y() - img->h()/2);
+        img->setColour(this->app->theme()->FG());
+        smartBtn->addElement(img);
+        this->topContainer->addElement(smartBtn);
+
         this->setHasSelectable(true);
         this->refreshList(Database::SortBy::TitleAsc);
 
         // Move sort button and prepare menu
-        this->sort->setX(btn->x() - 20 - this->sort->w());
+        this->sort->setX(smartBtn->x() - 20 - this->sort->w());
         this->sort->onPress([this]() {
             this->app->addOverlay(this->sortMenu);
         });
@@ -82,6 +93,7 @@ namespace Frame {
         this->menu = nullptr;
         this->msgbox = nullptr;
         this->newMenu = nullptr;
+        this->smartMenu = nullptr;
         this->pushedIdx = -1;
     }
 
@@ -241,14 +253,11 @@ namespace Frame {
         b->setText("Common.Play"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, pos]() {
-            std::vector<Metadata::PlaylistSong> v = this->app->database()->getSongMetadataForPlaylist(this->items[pos].meta.ID, Database::SortBy::TitleAsc);
-            if (v.size() > 0) {
-                std::vector<SongID> ids;
-                for (size_t i = 0; i < v.size(); i++) {
-                    ids.push_back(v[i].song.ID);
+            this->withPlaylistSongs(this->items[pos].meta.ID, [this, name = this->items[pos].meta.name](const std::vector<SongID> & ids) {
+                if (ids.size() > 0) {
+                    this->playNewQueue(name, ids, 0, true);
                 }
-                this->playNewQueue(this->items[pos].meta.name, ids, 0, true);
-            }
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -261,10 +270,11 @@ namespace Frame {
         b->setText("Common.AddToQueue"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, pos]() {
-            std::vector<Metadata::PlaylistSong> v = this->app->database()->getSongMetadataForPlaylist(this->items[pos].meta.ID, Database::SortBy::TitleAsc);
-            for (size_t i = 0; i < v.size(); i++) {
-                this->app->sysmodule()->sendAddToSubQueue(v[i].song.ID);
-            }
+            this->withPlaylistSongs(this->items[pos].meta.ID, [this](const std::vector<SongID> & ids) {
+                for (size_t i = 0; i < ids.size(); i++) {
+                    this->app->sysmodule()->sendAddToSubQueue(ids[i]);
+                }
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -278,11 +288,8 @@ namespace Frame {
         b->onPress([this, pos]() {
             this->showAddToPlaylist([this, pos](PlaylistID i) {
                 if (i >= 0) {
-                    // Get list of songs and add one-by-one to other playlist
-                    std::vector<Metadata::PlaylistSong> v = this->app->database()->getSongMetadataForPlaylist(this->items[pos].meta.ID, Database::SortBy::TitleAsc);
-                    for (size_t j = 0; j < v.size(); j++) {
-                        this->app->database()->addSongToPlaylist(i, v[j].song.ID);
-                    }
+                    // Copy all songs to the other playlist
+                    this->app->database()->addPlaylistToPlaylist(i, this->items[pos].meta.ID);
 
                     // Recreate list item in order to update song count
                     std::vector<Item>::iterator it = std::find_if(this->items.begin(), this->items.end(), [this, i](const Item e) {
@@ -384,6 +391,34 @@ namespace Frame {
         this->app->addOverlay(this->newMenu);
     }
 
+    void Playlists::createSmartPlaylistMenu() {
+        delete this->smartMenu;
+        this->smartMenu = new CustomOvl::Menu();
+        this->smartMenu->setBackgroundColour(this->app->theme()->popupBG());
+
+        // Each button creates a smart playlist from a preset rule (named after the button)
+        auto addPreset = [this](const std::string & name, const std::string & icon, const SmartPlaylist::Rule & rule) {
+            CustomElm::MenuButton * b = new CustomElm::MenuButton();
+            b->setIcon(new Aether::Image(0, 0, icon));
+            b->setIconColour(this->app->theme()->muted());
+            b->setText(name);
+            b->setTextColour(this->app->theme()->FG());
+            b->onPress([this, name, rule]() {
+                this->smartMenu->close();
+                this->saveSmartPlaylist(name, {rule});
+            });
+            this->smartMenu->addButton(b);
+        };
+        addPreset("Playlist.Smart.Favourites"_lang, "romfs:/icons/musicnote.png", {SmartPlaylist::Field::Favourite, SmartPlaylist::Comparison::Is, "1"});
+        addPreset("Playlist.Smart.MostPlayed"_lang, "romfs:/icons/repeat.png", {SmartPlaylist::Field::Plays, SmartPlaylist::Comparison::GreaterThan, "9"});
+        addPreset("Playlist.Smart.RecentlyChanged"_lang, "romfs:/icons/file.png", {SmartPlaylist::Field::DaysSinceModified, SmartPlaylist::Comparison::LessThan, "30"});
+        addPreset("Playlist.Smart.NotPlayedRecently"_lang, "romfs:/icons/clock.png", {SmartPlaylist::Field::DaysSincePlayed, SmartPlaylist::Comparison::GreaterThan, "90"});
+
+        // Finalize the menu
+        this->smartMenu->addButton(nullptr);
+        this->app->addOverlay(this->smartMenu);
+    }
+
     void Playlists::createInfoOverlay(const std::string & msg) {
         delete this->msgbox;
         this->msgbox = new Aether::MessageBox();
@@ -502,12 +537,7 @@ namespace Frame {
             }
         }
 
-        for (const SongID id : ids) {
-            ok = this->app->database()->addSongToPlaylist(meta.ID, id);
-            if (!ok) {
-                break;
-            }
-        }
+        ok = this->app->database()->addSongsToPlaylist(meta.ID, ids);
         this->app->unlockDatabase();
 
         // Inform user of result
@@ -553,6 +583,24 @@ namespace Frame {
         }
     }
 
+    void Playlists::saveSmartPlaylist(const std::string & name, const std::vector<SmartPlaylist::Rule> & rules) {
+        Metadata::Playlist meta;
+        meta.name = name;
+        meta.description = "";
+        meta.imagePath = "";
+
+        // Commit changes to db (the playlist is filled with the matching songs straight away)
+        this->app->lockDatabase();
+        bool ok = this->app->database()->addSmartPlaylist(meta, rules);
+        this->app->unlockDatabase();
+
+        if (ok) {
+            this->refreshList(this->sortType);
+        } else {
+            this->createInfoOverlay("Common.Error.DatabaseLocked"_lang);
+        }
+    }
+
     void Playlists::update(uint32_t dt) {
         Frame::update(dt);
 
@@ -666,6 +714,7 @@ namespace Frame {
         delete this->menu;
         delete this->msgbox;
         delete this->newMenu;
+        delete this->smartMenu;
         delete this->sortMenu;
     }
 };
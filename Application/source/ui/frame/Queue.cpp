@@ -2,7 +2,6 @@
 #include "Application.hpp"
 #include "dtl.hpp"
 #include "lang/Lang.hpp"
-#include "Paths.hpp"
 #include "ui/element/listitem/Song.hpp"
 #include "ui/frame/Queue.hpp"
 #include "ui/overlay/ItemMenu.hpp"
@@ -327,13 +326,8 @@ namespace Frame {
         this->menu->setSubTextColour(this->app->theme()->muted());
         this->menu->addSeparator(this->app->theme()->muted2());
 
-        // Song metadata
-        Metadata::Song m = this->app->database()->getSongMetadataForID(id);
-        this->menu->setMainText(m.title);
-        this->menu->setSubText(m.artist);
-        AlbumID aID = this->app->database()->getAlbumIDForSong(m.ID);
-        Metadata::Album md = this->app->database()->getAlbumMetadataForID(aID);
-        this->menu->setImage(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
+        // Song metadata (filled in once fetched)
+        this->fillSongMenu(this->menu, id);
 
         // Remove from Queue (if not playing)
         CustomElm::MenuButton * b;
@@ -394,10 +388,7 @@ namespace Frame {
         b->setText("Common.GoToArtist"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            ArtistID a = this->app->database()->getArtistIDForSong(id);
-            if (a >= 0) {
-                this->changeFrame(Type::Artist, Action::Push, a);
-            }
+            this->goToArtistForSong(id);
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -409,10 +400,7 @@ namespace Frame {
         b->setText("Common.GoToAlbum"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            AlbumID a = this->app->database()->getAlbumIDForSong(id);
-            if (a >= 0) {
-                this->changeFrame(Type::Album, Action::Push, a);
-            }
+            this->goToAlbumForSong(id);
             this->menu->close();
         });
         this->menu->addButton(b);
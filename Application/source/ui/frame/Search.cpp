@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Application.hpp"
 #include "lang/Lang.hpp"
 #include "Paths.hpp"
@@ -6,9 +7,14 @@
 #include "ui/element/ListHeadingCount.hpp"
 #include "ui/element/listitem/Song.hpp"
 #include "ui/frame/Search.hpp"
+#include "utils/Image.hpp"
 #include "utils/NX.hpp"
+#include "utils/Search.hpp"
 #include "utils/Utils.hpp"
 
+// Maximum number of queries to cache results for
+#define MAX_CACHED_QUERIES 20
+
 // Keyboard config (see utils/NX.hpp)
 static struct Utils::NX::Keyboard keyboard = {
     "",             // buffer
@@ -31,9 +37,31 @@ namespace Frame {
         this->topContainer->setHasSelectable(false);
         this->artistsList = nullptr;
         this->menu = nullptr;
+        this->errorContainer = nullptr;
+        this->ellipsis = nullptr;
+        this->noResults = nullptr;
         this->searchContainer = nullptr;
         this->heading->setString("Search.ResultsEmpty"_lang);
 
+        // Button (in place of sort) to edit the query
+        this->edit = new Aether::BorderButton(this->sort->x(), this->sort->y(), this->sort->w(), this->sort->h(), 2, "", 10, [this]() {
+            this->openKeyboard();
+        });
+        this->edit->setBorderColour(this->app->theme()->FG());
+        this->edit->setTextColour(this->app->theme()->FG());
+        Aether::Image * icon = new Aether::Image(this->edit->x() + this->edit->w()/2, this->edit->y() + this->edit->h()/2, "romfs:/icons/search.png");
+        icon->setXY(icon->x() - icon->w()/2, icon->y() - icon->h()/2);
+        icon->setColour(this->app->theme()->FG());
+        this->edit->addElement(icon);
+        this->edit->setHidden(true);
+        this->topContainer->addElement(this->edit);
+
+        // Nothing is searched for until we have input
+        this->generation = 0;
+        this->threadGeneration = 0;
+        this->searchPending = false;
+        this->threadDone = true;
+
         // Get input first
         keyboard.heading = "Search.Search"_lang;
         keyboard.ok = "Search.Search"_lang;
@@ -42,31 +70,145 @@ namespace Frame {
         if (!haveInput) {
             // Show error message if we couldn't launch the keyboard
             this->showError("Search.KeyboardError"_lang);
-            this->threadDone = true;
             return;
         }
 
-        // Search the database and populate the list!
-        std::string copy = keyboard.buffer;
+        // The query can be edited from now on
+        this->edit->setHidden(false);
+        this->topContainer->setHasSelectable(true);
+        this->setQuery(keyboard.buffer);
+    }
+
+    void Search::openKeyboard() {
+        // Keep the current results if the keyboard is closed without a new query
+        keyboard.buffer = this->query;
+        if (!Utils::NX::getUserInput(keyboard) || keyboard.buffer == this->query) {
+            return;
+        }
+        this->setQuery(keyboard.buffer);
+    }
+
+    void Search::setQuery(const std::string & str) {
+        // Supersede the running search (if there is one)
+        this->query = str;
+        this->generation++;
+        if (!this->threadDone) {
+            this->app->database().interruptSearch();
+        }
+
+        // Show cached results straight away if we've searched for this before
+        std::string key = Utils::toLowercase(str);
+        std::unordered_map<std::string, Results>::iterator it = this->cache.find(key);
+        if (it != this->cache.end()) {
+            this->searchPending = false;
+            this->showResults(it->second);
+            return;
+        }
+
+        // Otherwise show what we can (refined from a shorter query) while the database is searched
+        Results results;
+        if (this->refineCached(key, results)) {
+            this->showResults(results);
+        } else {
+            this->showSearching();
+        }
+        this->searchPending = true;
+    }
+
+    bool Search::refineCached(const std::string & key, Results & results) {
+        // Find the longest cached query which the new one extends
+        std::unordered_map<std::string, Results>::iterator best = this->cache.end();
+        for (std::unordered_map<std::string, Results>::iterator it = this->cache.begin(); it != this->cache.end(); it++) {
+            if (key.compare(0, it->first.length(), it->first) == 0) {
+                if (best == this->cache.end() || it->first.length() > best->first.length()) {
+                    best = it;
+                }
+            }
+        }
+        if (best == this->cache.end()) {
+            return false;
+        }
+
+        // Keep entries which would still match the new query
+        std::vector<std::string> trigrams = Utils::removeDuplicates(Utils::Search::getTrigrams(key));
+        unsigned int percent = this->app->config()->searchMinMatch();
+        std::copy_if(best->second.playlists.begin(), best->second.playlists.end(), std::back_inserter(results.playlists), [&trigrams, percent](const Metadata::Playlist & m) {
+            return (Utils::Search::matchPercent(trigrams, m.name) >= percent);
+        });
+        std::copy_if(best->second.artists.begin(), best->second.artists.end(), std::back_inserter(results.artists), [&trigrams, percent](const Metadata::Artist & m) {
+            return (Utils::Search::matchPercent(trigrams, m.name) >= percent);
+        });
+        std::copy_if(best->second.albums.begin(), best->second.albums.end(), std::back_inserter(results.albums), [&trigrams, percent](const Metadata::Album & m) {
+            return (Utils::Search::matchPercent(trigrams, m.name + " " + m.artist) >= percent);
+        });
+        std::copy_if(best->second.songs.begin(), best->second.songs.end(), std::back_inserter(results.songs), [&trigrams, percent](const Metadata::Song & m) {
+            return (Utils::Search::matchPercent(trigrams, m.title + " " + m.artist + " " + m.album) >= percent);
+        });
+        return true;
+    }
+
+    void Search::clearResults() {
+        // Remove everything shown for the previous query
+        if (this->errorContainer != nullptr) {
+            this->removeElement(this->errorContainer);
+            this->errorContainer = nullptr;
+        }
+        if (this->searchContainer != nullptr) {
+            this->removeElement(this->searchContainer);
+            this->searchContainer = nullptr;
+        }
+        if (this->ellipsis != nullptr) {
+            this->removeElement(this->ellipsis);
+            this->ellipsis = nullptr;
+        }
+        if (this->noResults != nullptr) {
+            this->removeElement(this->noResults);
+            this->noResults = nullptr;
+        }
+        this->list->removeAllElements();
+        this->songIDs.clear();
+    }
+
+    void Search::showResults(const Results & results) {
+        this->clearResults();
+
+        // Copy into the vectors used to populate the list
+        this->playlists = results.playlists;
+        this->artists = results.artists;
+        this->albums = results.albums;
+        this->songs = results.songs;
+        this->heading->setHidden(false);
+        this->list->setHidden(false);
+        this->addEntries();
+    }
+
+    void Search::startSearch() {
+        // Search the database for the current query
+        std::string copy = this->query;
+        unsigned int gen = this->generation;
+        this->threadGeneration = gen;
         this->threadDone = false;
-        this->showSearching();
-        this->searchThread = std::async(std::launch::async, [this, copy]() -> bool {
+        this->searchPending = false;
+
+        // The token is taken now so the search is still interrupted if the query changes while the thread waits for the database
+        unsigned int token = this->app->database().searchToken();
+        this->searchThread = std::async(std::launch::async, [this, copy, gen, token]() -> bool {
             Utils::NX::setCPUBoost(true);
-            bool ok = this->searchDatabase(copy);
+            bool ok = this->searchDatabase(copy, gen, token);
             Utils::NX::setCPUBoost(false);
             return ok;
         });
     }
 
     void Search::addEntries() {
-        // Set heading and position
-        this->heading->setString(Utils::substituteTokens("Search.Results"_lang, keyboard.buffer));
-        int maxW = (this->w() - (this->heading->x() - this->x())*2);
+        // Set heading and position (leaving room for the edit button)
+        this->heading->setString(Utils::substituteTokens("Search.Results"_lang, this->query));
+        int maxW = (this->edit->x() - this->heading->x()) - 30;
         if (this->heading->w() > maxW) {
-            Aether::Text * tmp = new Aether::Text(this->heading->x() + maxW, this->heading->y(), "...", 46);
-            tmp->setX(tmp->x() - tmp->w());
-            this->addElement(tmp);
-            this->heading->setW(maxW - tmp->w());
+            this->ellipsis = new Aether::Text(this->heading->x() + maxW, this->heading->y(), "...", 46);
+            this->ellipsis->setX(this->ellipsis->x() - this->ellipsis->w());
+            this->addElement(this->ellipsis);
+            this->heading->setW(maxW - this->ellipsis->w());
         }
 
         // Position the list
@@ -76,10 +218,10 @@ namespace Frame {
 
         // Show message if no results found
         if (this->playlists.empty() && this->artists.empty() && this->albums.empty() && this->songs.empty()) {
-            Aether::Text * text = new Aether::Text(this->x() + this->w()/2, this->y() + this->h()/2, "Search.NoResults"_lang, 26);
-            text->setX(text->x() - text->w()/2);
-            text->setColour(this->app->theme()->FG());
-            this->addElement(text);
+            this->noResults = new Aether::Text(this->x() + this->w()/2, this->y() + this->h()/2, "Search.NoResults"_lang, 26);
+            this->noResults->setX(this->noResults->x() - this->noResults->w()/2);
+            this->noResults->setColour(this->app->theme()->FG());
+            this->addElement(this->noResults);
             return;
         }
 
@@ -120,8 +262,8 @@ namespace Frame {
             l->onPress([this, id](){
                 this->changeFrame(Type::Playlist, Action::Push, id);
             });
-            l->setMoreCallback([this, id]() {
-                this->createPlaylistMenu(id);
+            l->setMoreCallback([this, m = this->playlists[i]]() {
+                this->createPlaylistMenu(m);
             });
             hlist->addElement(l);
         }
@@ -172,8 +314,8 @@ namespace Frame {
             l->onPress([this, id](){
                 this->changeFrame(Type::Artist, Action::Push, id);
             });
-            l->setMoreCallback([this, id]() {
-                this->createArtistMenu(id);
+            l->setMoreCallback([this, m = this->artists[i]]() {
+                this->createArtistMenu(m);
             });
             hlist->addElement(l);
         }
@@ -200,7 +342,7 @@ namespace Frame {
         // Create horizontal list and populate with items
         CustomElm::HorizontalList * hlist = new CustomElm::HorizontalList(this->list->x(), 0, this->list->w(), 250);
         for (size_t i = 0; i < this->albums.size(); i++) {
-            std::string img = (this->albums[i].imagePath.empty() ? Path::App::DefaultArtFile : this->albums[i].imagePath);
+            std::string img = (this->albums[i].imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(this->albums[i].imagePath, Utils::Image::ArtSize::Tile));
             CustomElm::GridItem * l = new CustomElm::GridItem(img);
             l->setMainString(this->albums[i].name);
             l->setSubString(this->albums[i].artist);
@@ -211,8 +353,8 @@ namespace Frame {
             l->onPress([this, id](){
                 this->changeFrame(Type::Album, Action::Push, id);
             });
-            l->setMoreCallback([this, id]() {
-                this->createAlbumMenu(id);
+            l->setMoreCallback([this, m = this->albums[i]]() {
+                this->createAlbumMenu(m);
             });
             hlist->addElement(l);
         }
@@ -248,7 +390,7 @@ namespace Frame {
             l->setLineColour(this->app->theme()->muted2());
             l->setMoreColour(this->app->theme()->muted());
             l->setTextColour(this->app->theme()->FG());
-            std::string phrase = keyboard.buffer;
+            std::string phrase = this->query;
             l->onPress([this, phrase, i](){
                 this->playNewQueue("'" + phrase + "'", this->songIDs, i, false);
             });
@@ -261,44 +403,49 @@ namespace Frame {
         this->songs.clear();
     }
 
-    bool Search::searchDatabase(const std::string & phrase) {
-        // Ensure the database is up to date
-        if (this->app->database()->needsSearchUpdate()) {
-            this->app->lockDatabase();
-            bool ok = this->app->database()->prepareSearch();
-            this->app->unlockDatabase();
-
-            if (!ok) {
-                return false;
-            }
+    bool Search::searchDatabase(const std::string & phrase, const unsigned int gen, const unsigned int token) {
+        // Search for each type of entry, stopping early if the query has changed or a search failed
+        bool ok;
+        this->threadResults = Results();
+        this->threadResults.playlists = this->app->database()->searchPlaylists(phrase, token, ok, this->app->config()->searchMaxPlaylists());
+        if (!ok || this->generation != gen) {
+            return ok;
         }
-
-        // Search for each type of entry and return
-        this->playlists = this->app->database()->searchPlaylists(phrase, this->app->config()->searchMaxPlaylists());
-        this->artists = this->app->database()->searchArtists(phrase, this->app->config()->searchMaxArtists());
-        this->albums = this->app->database()->searchAlbums(phrase, this->app->config()->searchMaxAlbums());
-        this->songs = this->app->database()->searchSongs(phrase, this->app->config()->searchMaxSongs());
-        return true;
+        this->threadResults.artists = this->app->database()->searchArtists(phrase, token, ok, this->app->config()->searchMaxArtists());
+        if (!ok || this->generation != gen) {
+            return ok;
+        }
+        this->threadResults.albums = this->app->database()->searchAlbums(phrase, token, ok, this->app->config()->searchMaxAlbums());
+        if (!ok || this->generation != gen) {
+            return ok;
+        }
+        this->threadResults.songs = this->app->database()->searchSongs(phrase, token, ok, this->app->config()->searchMaxSongs());
+        return ok;
     }
 
     void Search::showError(const std::string & message) {
+        this->clearResults();
         this->heading->setHidden(true);
+        this->errorContainer = new Aether::Container(this->x(), this->y(), this->w(), this->h());
 
         // ! icon
         Aether::Image * icon = new Aether::Image(0, 0, "romfs:/icons/exclamation.png");
         icon->setWH(100, 100);
         icon->setXY(this->x() + (this->w() - icon->w())/2, this->y() + this->h()/4);
         icon->setColour(this->app->theme()->FG());
-        this->addElement(icon);
+        this->errorContainer->addElement(icon);
 
         // Message
         Aether::TextBlock * msg = new Aether::TextBlock(0, icon->y() + icon->h() + 30, message, 26, this->w()*0.75);
         msg->setX(this->x() + (this->w() - msg->w())/2);
         msg->setColour(this->app->theme()->FG());
-        this->addElement(msg);
+        this->errorContainer->addElement(msg);
+
+        this->addElement(this->errorContainer);
     }
 
     void Search::showSearching() {
+        this->clearResults();
         this->searchContainer = new Aether::Container(0, 0, 500, 60);
         this->searchContainer->setXY(this->x() + (this->w() - this->searchContainer->w())/2, this->y() + this->h()/2);
 
@@ -332,11 +479,10 @@ namespace Frame {
         this->menu->addSeparator(this->app->theme()->muted2());
     }
 
-    void Search::createPlaylistMenu(PlaylistID id) {
+    void Search::createPlaylistMenu(const Metadata::Playlist & m) {
         this->createNewMenu();
 
-        // Set playlist specific things
-        Metadata::Playlist m = this->app->database()->getPlaylistMetadataForID(id);
+        // Set playlist specific things (using the metadata from the results, so there's nothing to wait for)
         this->menu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? "romfs:/misc/noplaylist.png" : m.imagePath));
         this->menu->setMainText(m.name);
         std::string str = (m.songCount == 1 ? "Common.Song"_lang : Utils::substituteTokens("Common.Songs"_lang, std::to_string(m.songCount)));
@@ -349,14 +495,11 @@ namespace Frame {
         b->setText("Common.Play"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, m]() {
-            std::vector<Metadata::PlaylistSong> v = this->app->database()->getSongMetadataForPlaylist(m.ID, Database::SortBy::TitleAsc);
-            if (v.size() > 0) {
-                std::vector<SongID> ids;
-                for (size_t i = 0; i < v.size(); i++) {
-                    ids.push_back(v[i].song.ID);
+            this->withPlaylistSongs(m.ID, [this, name = m.name](const std::vector<SongID> & ids) {
+                if (ids.size() > 0) {
+                    this->playNewQueue(name, ids, 0, true);
                 }
-                this->playNewQueue(m.name, ids, 0, true);
-            }
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -369,10 +512,11 @@ namespace Frame {
         b->setText("Common.AddToQueue"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, m]() {
-            std::vector<Metadata::PlaylistSong> v = this->app->database()->getSongMetadataForPlaylist(m.ID, Database::SortBy::TitleAsc);
-            for (size_t i = 0; i < v.size(); i++) {
-                this->app->sysmodule()->sendAddToSubQueue(v[i].song.ID);
-            }
+            this->withPlaylistSongs(m.ID, [this](const std::vector<SongID> & ids) {
+                for (size_t i = 0; i < ids.size(); i++) {
+                    this->app->sysmodule()->sendAddToSubQueue(ids[i]);
+                }
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -386,11 +530,8 @@ namespace Frame {
         b->onPress([this, m]() {
             this->showAddToPlaylist([this, m](PlaylistID i) {
                 if (i >= 0) {
-                    // Get list of songs and add one-by-one to other playlist
-                    std::vector<Metadata::PlaylistSong> v = this->app->database()->getSongMetadataForPlaylist(m.ID, Database::SortBy::TitleAsc);
-                    for (size_t j = 0; j < v.size(); j++) {
-                        this->app->database()->addSongToPlaylist(i, v[j].song.ID);
-                    }
+                    // Copy all songs to the other playlist
+                    this->app->database()->addPlaylistToPlaylist(i, m.ID);
                     this->menu->close();
                 }
             });
@@ -414,11 +555,11 @@ namespace Frame {
         this->app->addOverlay(this->menu);
     }
 
-    void Search::createArtistMenu(ArtistID id) {
+    void Search::createArtistMenu(const Metadata::Artist & m) {
         this->createNewMenu();
 
-        // Set artist specific things
-        Metadata::Artist m = this->app->database()->getArtistMetadataForID(id);
+        // Set artist specific things (using the metadata from the results, so there's nothing to wait for)
+        ArtistID id = m.ID;
         this->menu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? "romfs:/misc/noartist.png" : m.imagePath));
         this->menu->setMainText(m.name);
         std::string str;
@@ -443,12 +584,9 @@ namespace Frame {
         b->setText("Artist.PlayAll"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, m]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForArtist(m.ID);
-            std::vector<SongID> ids;
-            for (size_t i = 0; i < v.size(); i++) {
-                ids.push_back(v[i].ID);
-            }
-            this->playNewQueue(m.name, ids, 0, true);
+            this->withArtistSongs(m.ID, [this, name = m.name](const std::vector<SongID> & ids) {
+                this->playNewQueue(name, ids, 0, true);
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -461,10 +599,11 @@ namespace Frame {
         b->setText("Common.AddToQueue"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForArtist(id);
-            for (size_t i = 0; i < v.size(); i++) {
-                this->app->sysmodule()->sendAddToSubQueue(v[i].ID);
-            }
+            this->withArtistSongs(id, [this](const std::vector<SongID> & ids) {
+                for (size_t i = 0; i < ids.size(); i++) {
+                    this->app->sysmodule()->sendAddToSubQueue(ids[i]);
+                }
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -478,10 +617,7 @@ namespace Frame {
         b->onPress([this, id]() {
             this->showAddToPlaylist([this, id](PlaylistID i) {
                 if (i >= 0) {
-                    std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForArtist(id);
-                    for (size_t j = 0; j < v.size(); j++) {
-                        this->app->database()->addSongToPlaylist(i, v[j].ID);
-                    }
+                    this->app->database()->addArtistToPlaylist(i, id);
                     this->menu->close();
                 }
             });
@@ -505,12 +641,12 @@ namespace Frame {
         this->app->addOverlay(this->menu);
     }
 
-    void Search::createAlbumMenu(AlbumID id) {
+    void Search::createAlbumMenu(const Metadata::Album & m) {
         this->createNewMenu();
 
-        // Album metadata
-        Metadata::Album m = this->app->database()->getAlbumMetadataForID(id);
-        this->menu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath));
+        // Album metadata (from the results, so there's nothing to wait for)
+        AlbumID id = m.ID;
+        this->menu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(m.imagePath, Utils::Image::ArtSize::Thumbnail)));
         this->menu->setMainText(m.name);
         this->menu->setSubText(m.artist);
 
@@ -521,12 +657,9 @@ namespace Frame {
         b->setText("Common.Play"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, m]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(m.ID);
-            std::vector<SongID> ids;
-            for (size_t i = 0; i < v.size(); i++) {
-                ids.push_back(v[i].ID);
-            }
-            this->playNewQueue(m.name, ids, 0, true);
+            this->withAlbumSongs(m.ID, [this, name = m.name](const std::vector<SongID> & ids) {
+                this->playNewQueue(name, ids, 0, true);
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -539,10 +672,11 @@ namespace Frame {
         b->setText("Common.AddToQueue"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(id);
-            for (size_t i = 0; i < v.size(); i++) {
-                this->app->sysmodule()->sendAddToSubQueue(v[i].ID);
-            }
+            this->withAlbumSongs(id, [this](const std::vector<SongID> & ids) {
+                for (size_t i = 0; i < ids.size(); i++) {
+                    this->app->sysmodule()->sendAddToSubQueue(ids[i]);
+                }
+            });
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -556,10 +690,7 @@ namespace Frame {
         b->onPress([this, id]() {
             this->showAddToPlaylist([this, id](PlaylistID i) {
                 if (i >= 0) {
-                    std::vector<Metadata::Song> v = this->app->database()->getSongMetadataForAlbum(id);
-                    for (size_t j = 0; j < v.size(); j++) {
-                        this->app->database()->addSongToPlaylist(i, v[j].ID);
-                    }
+                    this->app->database()->addAlbumToPlaylist(i, id);
                     this->menu->close();
                 }
             });
@@ -574,9 +705,8 @@ namespace Frame {
         b->setTextColour(this->app->theme()->FG());
         if (m.artist != "Various Artists") {
             b->setText("Common.GoToArtist"_lang);
-            ArtistID aID = this->app->database()->getArtistIDForName(m.artist);
-            b->onPress([this, aID]() {
-                this->changeFrame(Type::Artist, Action::Push, aID);
+            b->onPress([this, artist = m.artist]() {
+                this->goToArtistNamed(artist);
                 this->menu->close();
             });
 
@@ -609,13 +739,8 @@ namespace Frame {
     void Search::createSongMenu(SongID id) {
         this->createNewMenu();
 
-        // Song metadata
-        Metadata::Song m = this->app->database()->getSongMetadataForID(id);
-        this->menu->setMainText(m.title);
-        this->menu->setSubText(m.artist);
-        AlbumID aID = this->app->database()->getAlbumIDForSong(m.ID);
-        Metadata::Album md = this->app->database()->getAlbumMetadataForID(aID);
-        this->menu->setImage(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
+        // Song metadata (filled in once fetched)
+        this->fillSongMenu(this->menu, id);
 
         // Add to Queue
         CustomElm::MenuButton * b = new CustomElm::MenuButton();
@@ -653,10 +778,7 @@ namespace Frame {
         b->setText("Common.GoToArtist"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            ArtistID a = this->app->database()->getArtistIDForSong(id);
-            if (a >= 0) {
-                this->changeFrame(Type::Artist, Action::Push, a);
-            }
+            this->goToArtistForSong(id);
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -668,10 +790,7 @@ namespace Frame {
         b->setText("Common.GoToAlbum"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            AlbumID a = this->app->database()->getAlbumIDForSong(id);
-            if (a >= 0) {
-                this->changeFrame(Type::Album, Action::Push, a);
-            }
+            this->goToAlbumForSong(id);
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -694,9 +813,15 @@ namespace Frame {
     }
 
     void Search::createArtistsList(AlbumID id) {
-        // Query database for artists first
-        std::vector<Metadata::Artist> m = this->app->database()->getArtistMetadataForAlbum(id);
+        // Query database for artists first (the list is shown once they're found)
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getArtistMetadataForAlbum(id);
+        }, [this](const std::vector<Metadata::Artist> & m) {
+            this->showArtistsList(m);
+        });
+    }
 
+    void Search::showArtistsList(const std::vector<Metadata::Artist> & m) {
         // Create menu
         delete this->artistsList;
         this->artistsList = new CustomOvl::ArtistList();
@@ -724,21 +849,40 @@ namespace Frame {
         if (!this->threadDone) {
             if (this->searchThread.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
                 bool result = this->searchThread.get();
-                if (!result) {
-                    this->showError("Search.SearchError"_lang);
-                } else {
-                    this->removeElement(this->searchContainer);
-                    this->addEntries();
-                }
                 this->threadDone = true;
+
+                // Ignore the results if the query changed while searching
+                if (this->threadGeneration == this->generation) {
+                    if (!result) {
+                        this->showError("Search.SearchError"_lang);
+                    } else {
+                        if (this->cache.size() >= MAX_CACHED_QUERIES) {
+                            this->cache.clear();
+                        }
+                        this->cache[Utils::toLowercase(this->query)] = this->threadResults;
+                        this->showResults(this->threadResults);
+                    }
+                }
             }
         }
 
+        // Search for the latest query once the previous search has stopped
+        if (this->threadDone && this->searchPending) {
+            this->startSearch();
+        }
+
         Frame::update(dt);
     }
 
     Search::~Search() {
+        // Stop the search as soon as possible (the future blocks until it's done)
+        if (!this->threadDone) {
+            this->generation++;
+            this->app->database().interruptSearch();
+            this->searchThread.wait();
+        }
+
         delete this->artistsList;
         delete this->menu;
     }
-};
+};
\ No newline at end of file
@@ -18,8 +18,22 @@ namespace Frame {
         this->sort->setHidden(true);
         this->topContainer->setHasSelectable(false);
 
-        // Get artist metadata from ID
-        this->metadata = this->app->database()->getSongMetadataForID(id);
+        this->msgbox = nullptr;
+        this->saveButton = nullptr;
+
+        // Show a placeholder until the song's metadata has been fetched
+        this->heading->setString("Song.Information.Heading"_lang);
+        this->subHeading->setString("Common.Loading"_lang);
+        this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+            return db->getSongMetadataForID(id);
+        }, [this](const Metadata::Song & m) {
+            this->populate(m);
+        });
+    }
+
+    void SongInfo::populate(const Metadata::Song & m) {
+        this->metadata = m;
+        this->subHeading->setString("");
         if (this->metadata.ID < 0) {
             // Error message
             Aether::Text * t = new Aether::Text(this->x() + this->w()/2, this->y() + this->h()/2, "Common.Error.Database"_lang, 20);
@@ -30,9 +44,6 @@ namespace Frame {
             return;
         }
 
-        // Create and position all elements next
-        this->heading->setString("Song.Information.Heading"_lang);
-
         // Title
         Aether::Text * txt = new Aether::Text(this->heading->x(), this->heading->y() + this->heading->h() + 20, "Common.Title"_lang, 30);
         txt->setColour(this->app->theme()->FG());
@@ -173,8 +184,6 @@ namespace Frame {
         this->saveButton->setFillColour(this->app->theme()->accent());
         this->saveButton->setTextColour(Aether::Colour{0, 0, 0, 255});
         this->bottomContainer->addElement(this->saveButton);
-
-        this->msgbox = nullptr;
     }
 
     void SongInfo::createInfoOverlay(const std::string & msg) {
@@ -214,6 +223,9 @@ namespace Frame {
     }
 
     void SongInfo::updateColours() {
+        if (this->saveButton == nullptr) {
+            return;
+        }
         this->saveButton->setFillColour(this->app->theme()->accent());
     }
 
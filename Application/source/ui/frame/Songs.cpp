@@ -1,6 +1,5 @@
 #include "Application.hpp"
 #include "lang/Lang.hpp"
-#include "Paths.hpp"
 #include "ui/element/listitem/Song.hpp"
 #include "ui/frame/Songs.hpp"
 #include "ui/overlay/ItemMenu.hpp"
@@ -39,10 +38,20 @@ namespace Frame {
         // Remove old items
         this->list->removeAllElements();
         this->songIDs.clear();
+        this->subHeading->setString("Common.Loading"_lang);
+
+        // Fetch songs in the background, dropping any previous request
+        this->app->databaseWorker()->cancel(this);
+        this->app->databaseWorker()->queue(this, [sort](const SyncDatabase & db) {
+            return db->getAllSongMetadata(sort);
+        }, [this](const std::vector<Metadata::Song> & m) {
+            this->populateList(m);
+        });
+    }
 
+    void Songs::populateList(const std::vector<Metadata::Song> & m) {
         // Create items for songs
         unsigned int totalSecs = 0;
-        std::vector<Metadata::Song> m = this->app->database()->getAllSongMetadata(sort);
         if (m.size() > 0) {
             for (size_t i = 0; i < m.size(); i++) {
                 this->songIDs.push_back(m[i].ID);
@@ -98,13 +107,8 @@ namespace Frame {
         this->menu->setSubTextColour(this->app->theme()->muted());
         this->menu->addSeparator(this->app->theme()->muted2());
 
-        // Song metadata
-        Metadata::Song m = this->app->database()->getSongMetadataForID(id);
-        this->menu->setMainText(m.title);
-        this->menu->setSubText(m.artist);
-        AlbumID aID = this->app->database()->getAlbumIDForSong(m.ID);
-        Metadata::Album md = this->app->database()->getAlbumMetadataForID(aID);
-        this->menu->setImage(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
+        // Song metadata (filled in once fetched)
+        this->fillSongMenu(this->menu, id);
 
         // Add to Queue
         CustomElm::MenuButton * b = new CustomElm::MenuButton();
@@ -142,10 +146,7 @@ namespace Frame {
         b->setText("Common.GoToArtist"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            ArtistID a = this->app->database()->getArtistIDForSong(id);
-            if (a >= 0) {
-                this->changeFrame(Type::Artist, Action::Push, a);
-            }
+            this->goToArtistForSong(id);
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -157,10 +158,7 @@ namespace Frame {
         b->setText("Common.GoToAlbum"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->onPress([this, id]() {
-            AlbumID a = this->app->database()->getAlbumIDForSong(id);
-            if (a >= 0) {
-                this->changeFrame(Type::Album, Action::Push, a);
-            }
+            this->goToAlbumForSong(id);
             this->menu->close();
         });
         this->menu->addButton(b);
@@ -3,6 +3,7 @@
 #include "lang/Lang.hpp"
 #include "ui/frame/settings/AppAdvanced.hpp"
 #include "utils/FS.hpp"
+#include "utils/Image.hpp"
 
 namespace Frame::Settings {
     AppAdvanced::AppAdvanced(Main::Application * a) : Frame(a) {
@@ -43,48 +44,66 @@ namespace Frame::Settings {
         this->addComment("Settings.AppAdvanced.InitialQueueSizeText"_lang);
         this->list->addElement(new Aether::ListSeparator());
 
-        // Advanced::search_max_phrases
-        opt = new Aether::ListOption("Settings.AppAdvanced.MaximumSearchPhrases"_lang, std::to_string(cfg->searchMaxPhrases()), nullptr);
+        // Advanced::search_min_match
+        opt = new Aether::ListOption("Settings.AppAdvanced.MinimumSearchMatch"_lang, std::to_string(cfg->searchMinMatch()), nullptr);
         opt->onPress([this, cfg, opt]() {
-            int val = cfg->searchMaxPhrases();
-            if (this->getNumberInput(val, "Settings.AppAdvanced.MaximumSearchPhrases"_lang, "", false)) {
-                val = (val < 1 ? 1 : val);
-                if (cfg->setSearchMaxPhrases(val)) {
+            int val = cfg->searchMinMatch();
+            if (this->getNumberInput(val, "Settings.AppAdvanced.MinimumSearchMatch"_lang, "", false)) {
+                val = (val < 1 ? 1 : (val > 100 ? 100 : val));
+                if (cfg->setSearchMinMatch(val)) {
                     opt->setValue(std::to_string(val));
-                    this->app->database()->setSearchPhraseCount(val);
+                    this->app->database()->setSearchMatchPercent(val);
                 }
             }
         });
         opt->setColours(this->app->theme()->muted2(), this->app->theme()->FG(), this->app->theme()->accent());
         this->list->addElement(opt);
-        this->addComment("Settings.AppAdvanced.MaximumSearchPhrasesText"_lang);
+        this->addComment("Settings.AppAdvanced.MinimumSearchMatchText"_lang);
+        this->list->addElement(new Aether::ListSeparator());
 
-        // Advanced::search_max_score
-        opt = new Aether::ListOption("Settings.AppAdvanced.MaximumSearchScore"_lang, std::to_string(cfg->searchMaxScore()), nullptr);
+        // Advanced::database_cache
+        opt = new Aether::ListOption("Settings.AppAdvanced.DatabaseCache"_lang, std::to_string(cfg->databaseCache()), nullptr);
         opt->onPress([this, cfg, opt]() {
-            int val = cfg->searchMaxScore();
-            if (this->getNumberInput(val, "Settings.AppAdvanced.MaximumSearchScore"_lang, "", false)) {
-                val = (val < 30 ? 30 : val);
-                if (cfg->setSearchMaxScore(val)) {
+            int val = cfg->databaseCache();
+            if (this->getNumberInput(val, "Settings.AppAdvanced.DatabaseCache"_lang, "", false)) {
+                val = (val < 0 ? 0 : (val > 65536 ? 65536 : val));
+                if (cfg->setDatabaseCache(val)) {
                     opt->setValue(std::to_string(val));
-                    this->app->database()->setSpellfixScore(val);
+                    this->app->database()->setReadCache(val);
                 }
             }
         });
         opt->setColours(this->app->theme()->muted2(), this->app->theme()->FG(), this->app->theme()->accent());
         this->list->addElement(opt);
-        this->addComment("Settings.AppAdvanced.MaximumSearchScoreText"_lang);
+        this->addComment("Settings.AppAdvanced.DatabaseCacheText"_lang);
     }
 
     void AppAdvanced::removeImages() {
-        // Get list of all images referenced in database (returned in order)
-        bool ok;
-        std::vector<std::string> dbFiles = this->app->database()->getAllImagePaths(ok);
+        // Delete every image that is no longer used, then get the list of those which are still stored
+        this->app->lockDatabase();
+        bool ok = this->app->database()->removeUnusedImages();
+        std::vector<std::string> dbFiles;
+        if (ok) {
+            dbFiles = this->app->database()->getAllImagePaths(ok);
+        }
+        this->app->unlockDatabase();
         if (!ok) {
             return;
         }
 
-        // Get list of all files in folder
+        // Keep the other sizes of any album art too
+        size_t count = dbFiles.size();
+        for (size_t i = 0; i < count; i++) {
+            for (Utils::Image::ArtSize size : {Utils::Image::ArtSize::Thumbnail, Utils::Image::ArtSize::Tile}) {
+                std::string path = Utils::Image::artPath(dbFiles[i], size);
+                if (path != dbFiles[i]) {
+                    dbFiles.push_back(path);
+                }
+            }
+        }
+        std::sort(dbFiles.begin(), dbFiles.end());
+
+        // Get list of all files in folder (which may include files written before an error that the database doesn't know about)
         std::vector<std::string> folderFiles;
         for (auto & entry: std::filesystem::recursive_directory_iterator("/switch/TriPlayer/images/")) {
             if (entry.is_directory()) {
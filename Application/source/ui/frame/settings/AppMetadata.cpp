@@ -3,11 +3,13 @@
 #include "Paths.hpp"
 #include "ui/frame/settings/AppMetadata.hpp"
 #include "ui/overlay/ProgressBox.hpp"
-#include "utils/FS.hpp"
 #include "utils/Image.hpp"
 #include "meta/Metadata.hpp"
 #include "utils/Utils.hpp"
 
+// Number of downloaded images to hold before writing them to the database
+#define WRITE_BATCH_SIZE 20
+
 namespace Frame::Settings {
     AppMetadata::AppMetadata(Main::Application * a) : Frame(a) {
         // Temporary variables
@@ -27,6 +29,14 @@ namespace Frame::Settings {
             this->app->setScreen(Main::ScreenID::Splash);
         });
         this->addComment("Settings.AppMetadata.ScanNowText"_lang);
+
+        // Rescan everything (files whose tags were edited in place aren't found by a normal scan)
+        this->addButton("Settings.AppMetadata.RescanLibrary"_lang, [this]() {
+            this->app->setFullScan(true);
+            this->app->popScreen();
+            this->app->setScreen(Main::ScreenID::Splash);
+        });
+        this->addComment("Settings.AppMetadata.RescanLibraryText"_lang);
         this->list->addElement(new Aether::ListSeparator());
 
         // Search for images
@@ -95,10 +105,27 @@ namespace Frame::Settings {
             return !m.imagePath.empty();
         }), albums.end());
 
-        // Lock database for writing
-        this->app->lockDatabase();
+        // Images are written to the database in batches, so that it isn't locked (which also blocks
+        // the sysmodule from starting the next song) while waiting on the network
+        // The path index is only exported after the last batch, as otherwise each batch would rewrite it
+        std::vector<Metadata::Album> pending;
+        bool written = false;
+        auto writePending = [this, &pending, &written](const bool last) {
+            if (pending.empty() && !(last && written)) {
+                return;
+            }
 
-        // Iterate over each artist
+            // Update database (images aren't deleted if an error occurs as they may be used elsewhere)
+            this->app->lockDatabase();
+            for (const Metadata::Album & m : pending) {
+                this->app->database()->updateAlbum(m);
+            }
+            this->app->unlockDatabase(last);
+            written = true;
+            pending.clear();
+        };
+
+        // Iterate over each album
         std::vector<unsigned char> buffer;
         int id;
         for (size_t i = 0; i < albums.size(); i++) {
@@ -112,28 +139,27 @@ namespace Frame::Settings {
             // Search for and download image using album name (skips over any errors)
             buffer.clear();
             if (Metadata::downloadAlbumImage(albums[i].name, buffer, id) == Metadata::DownloadResult::Success) {
-                // If successful, resize and write to file
-                bool resized = Utils::Image::resize(buffer, 400, 400);
-                if (!resized) {
-                    Log::writeWarning("[META] Couldn't resize album image, saving with original dimensions");
+                // If successful, write to file at each size
+                std::string filename = Utils::Image::writeArt(buffer, Path::App::AlbumImageFolder);
+                if (filename.empty()) {
+                    filename = Utils::Image::writeImage(buffer, Path::App::AlbumImageFolder, 400);
+                    if (filename.empty()) {
+                        continue;
+                    }
                 }
 
-                std::string filename = Path::App::AlbumImageFolder + std::to_string(id) + ".png";
-                if (!Utils::Fs::writeFile(filename, buffer)) {
-                    continue;
-                }
-
-                // Update database, deleting file if an error occurs
+                // Queue the database update
                 albums[i].tadbID = id;
                 albums[i].imagePath = filename;
-                if (!this->app->database()->updateAlbum(albums[i])) {
-                    Utils::Fs::deleteFile(filename);
+                pending.push_back(albums[i]);
+                if (pending.size() >= WRITE_BATCH_SIZE) {
+                    writePending(false);
                 }
             }
         }
 
-        // Unlock database
-        this->app->unlockDatabase();
+        // Write any remaining images (and export the path index)
+        writePending(true);
     }
 
     void AppMetadata::searchArtistsThread() {
@@ -143,8 +169,25 @@ namespace Frame::Settings {
             return !m.imagePath.empty();
         }), artists.end());
 
-        // Lock database for writing
-        this->app->lockDatabase();
+        // Images are written to the database in batches, so that it isn't locked (which also blocks
+        // the sysmodule from starting the next song) while waiting on the network
+        // The path index is only exported after the last batch, as otherwise each batch would rewrite it
+        std::vector<Metadata::Artist> pending;
+        bool written = false;
+        auto writePending = [this, &pending, &written](const bool last) {
+            if (pending.empty() && !(last && written)) {
+                return;
+            }
+
+            // Update database (images aren't deleted if an error occurs as they may be used elsewhere)
+            this->app->lockDatabase();
+            for (const Metadata::Artist & m : pending) {
+                this->app->database()->updateArtist(m);
+            }
+            this->app->unlockDatabase(last);
+            written = true;
+            pending.clear();
+        };
 
         // Iterate over each artist
         std::vector<unsigned char> buffer;
@@ -161,27 +204,23 @@ namespace Frame::Settings {
             buffer.clear();
             if (Metadata::downloadArtistImage(artists[i].name, buffer, id) == Metadata::DownloadResult::Success) {
                 // If successful, resize and write to file
-                bool resized = Utils::Image::resize(buffer, 400, 400);
-                if (!resized) {
-                    Log::writeWarning("[META] Couldn't resize artist image, saving with original dimensions");
-                }
-
-                std::string filename = Path::App::ArtistImageFolder + std::to_string(id) + ".png";
-                if (!Utils::Fs::writeFile(filename, buffer)) {
+                std::string filename = Utils::Image::writeImage(buffer, Path::App::ArtistImageFolder, 400);
+                if (filename.empty()) {
                     continue;
                 }
 
-                // Update database, deleting file if an error occurs
+                // Queue the database update
                 artists[i].tadbID = id;
                 artists[i].imagePath = filename;
-                if (!this->app->database()->updateArtist(artists[i])) {
-                    Utils::Fs::deleteFile(filename);
+                pending.push_back(artists[i]);
+                if (pending.size() >= WRITE_BATCH_SIZE) {
+                    writePending(false);
                 }
             }
         }
 
-        // Unlock database
-        this->app->unlockDatabase();
+        // Write any remaining images (and export the path index)
+        writePending(true);
     }
 
     void AppMetadata::update(uint32_t dt) {
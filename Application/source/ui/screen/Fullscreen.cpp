@@ -66,7 +66,7 @@ namespace Screen {
         this->seekBar->setKnobColour(this->primary);
     }
 
-    void Fullscreen::updateImage(const std::string & path) {
+    void Fullscreen::updateImage(const std::string & path, const Metadata::Palette & stored) {
         // Move old image into vector
         if (this->albumArt != nullptr) {
             this->oldAlbumArt.push_back(this->albumArt);
@@ -79,7 +79,11 @@ namespace Screen {
         Aether::Drawable * image = this->renderer->renderImageSurface(path, 0, 0);
 
         if (!useDefault) {
-            Utils::Splash::Palette palette = Utils::Splash::getPaletteForDrawable(image);
+            // Colours are picked when the library is scanned, so they only need to be picked here for new images
+            Utils::Splash::Palette palette = Utils::Splash::fromMetadata(stored);
+            if (palette.invalid) {
+                palette = Utils::Splash::getPaletteForDrawable(image);
+            }
             if (!palette.invalid) {
                 // Set matching colours if valid
                 if (palette.bgLight) {
@@ -146,6 +150,27 @@ namespace Screen {
         return Screen::handleEvent(e);
     }
 
+    void Fullscreen::showPlayingSong(const PlayingSong & p) {
+        const Metadata::Song & m = p.song;
+        if (m.ID != -1) {
+            this->title->setString(m.title);
+            if (this->title->textureWidth() > MAX_TEXT_WIDTH) {
+                this->title->setW(MAX_TEXT_WIDTH);
+            }
+            this->title->setX(640 - this->title->w()/2);
+            this->artist->setString(m.artist);
+            if (this->artist->textureWidth() > MAX_TEXT_WIDTH) {
+                this->artist->setW(MAX_TEXT_WIDTH);
+            }
+            this->artist->setX(640 - this->artist->w()/2);
+            this->duration->setString(Utils::secondsToHMS(m.duration));
+            this->durationVal = m.duration;
+        }
+
+        // Change album cover
+        this->updateImage(p.imagePath, p.palette);
+    }
+
     void Fullscreen::update(uint32_t dt) {
         // Update the playing status
         PlaybackStatus ps = this->app->sysmodule()->status();
@@ -247,30 +272,23 @@ namespace Screen {
             this->gradient->setColour(this->currentBackground);
         }
 
-        // Update song metadata
+        // Update song metadata (fetched in the background, ignoring results for a song that's no longer playing)
         SongID id = this->app->sysmodule()->currentSong();
         if (id != this->playingID) {
             this->playingID = id;
-            Metadata::Song m = this->app->database()->getSongMetadataForID(id);
-            if (m.ID != -1) {
-                this->title->setString(m.title);
-                if (this->title->textureWidth() > MAX_TEXT_WIDTH) {
-                    this->title->setW(MAX_TEXT_WIDTH);
-                }
-                this->title->setX(640 - this->title->w()/2);
-                this->artist->setString(m.artist);
-                if (this->artist->textureWidth() > MAX_TEXT_WIDTH) {
-                    this->artist->setW(MAX_TEXT_WIDTH);
+            this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+                PlayingSong p;
+                p.song = db->getSongMetadataForID(id);
+                AlbumID album = db->getAlbumIDForSong(id);
+                Metadata::Album md = db->getAlbumMetadataForID(album);
+                p.imagePath = (md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath);
+                p.palette = db->getPaletteForImage(p.imagePath);
+                return p;
+            }, [this, id](const PlayingSong & p) {
+                if (id == this->playingID) {
+                    this->showPlayingSong(p);
                 }
-                this->artist->setX(640 - this->artist->w()/2);
-                this->duration->setString(Utils::secondsToHMS(m.duration));
-                this->durationVal = m.duration;
-            }
-
-            // Change album cover
-            AlbumID id = this->app->database()->getAlbumIDForSong(m.ID);
-            Metadata::Album md = this->app->database()->getAlbumMetadataForID(id);
-            this->updateImage(md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath);
+            });
         }
 
         // Update the seekbar
@@ -439,14 +457,17 @@ namespace Screen {
         this->buttonMs = 0;
         this->playingID = -1;
 
-        // Start with no song
+        // Start with no song (colours aren't stored for the default art)
         this->title->setX(640 - this->title->w()/2);
         this->artist->setX(640 - this->artist->w()/2);
-        this->updateImage(Path::App::DefaultArtFile);
+        Metadata::Palette palette;
+        palette.valid = false;
+        this->updateImage(Path::App::DefaultArtFile, palette);
     }
 
     void Fullscreen::onUnload() {
         Screen::onUnload();
+        this->app->databaseWorker()->cancel(this);
 
         // Remove added elements
         this->removeElement(this->noteElement);
@@ -15,6 +15,7 @@
 #include "ui/frame/Songs.hpp"
 #include "ui/frame/SongInfo.hpp"
 #include "ui/screen/Home.hpp"
+#include "utils/Image.hpp"
 #include "utils/Random.hpp"
 #include "utils/Utils.hpp"
 
@@ -94,9 +95,13 @@ namespace Screen {
             }
         });
 
-        // Insert items for playlists
+        // Insert items for playlists (except smart playlists, as their songs can't be chosen by hand)
         std::vector<Metadata::Playlist> pls = this->app->database()->getAllPlaylistMetadata(Database::SortBy::TitleAsc);
         for (size_t i = 0; i < pls.size(); i++) {
+            if (pls[i].smart) {
+                continue;
+            }
+
             CustomElm::ListItem::Playlist * l = new CustomElm::ListItem::Playlist(pls[i].imagePath.empty() ? "romfs:/misc/noplaylist.png" : pls[i].imagePath, false);
             l->setNameString(pls[i].name);
             std::string str = (pls[i].songCount == 1 ? "Common.Song"_lang : Utils::substituteTokens("Common.Songs"_lang, std::to_string(pls[i].songCount)));
@@ -253,32 +258,26 @@ namespace Screen {
         this->player->setPosition(this->app->sysmodule()->position());
         this->player->setVolume(this->app->sysmodule()->volume());
 
-        // Update song metadata
+        // Update song metadata (fetched in the background, ignoring results for a song that's no longer playing)
         SongID id = this->app->sysmodule()->currentSong();
         if (id != this->playingID) {
             this->playingID = id;
-            bool updated = false;
             if (id > -1) {
-                Metadata::Song m = this->app->database()->getSongMetadataForID(id);
-
-                // Repeated check as ID is set negative on error
-                if (m.ID > -1) {
-                    this->player->setTrackName(m.title);
-                    this->player->setTrackArtist(m.artist);
-                    this->player->setDuration(m.duration);
-                    AlbumID id = this->app->database()->getAlbumIDForSong(m.ID);
-                    Metadata::Album md = this->app->database()->getAlbumMetadataForID(id);
-                    this->player->setAlbumCover(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
-                    updated = true;
-                }
-            }
+                this->app->databaseWorker()->queue(this, [id](const SyncDatabase & db) {
+                    std::pair<Metadata::Song, std::string> p;
+                    p.first = db->getSongMetadataForID(id);
+                    AlbumID album = db->getAlbumIDForSong(id);
+                    Metadata::Album md = db->getAlbumMetadataForID(album);
+                    p.second = (md.imagePath.empty() ? Path::App::DefaultArtFile : Utils::Image::artPath(md.imagePath, Utils::Image::ArtSize::Thumbnail));
+                    return p;
+                }, [this, id](const std::pair<Metadata::Song, std::string> & p) {
+                    if (id == this->playingID) {
+                        this->showPlayingSong(p.first, p.second);
+                    }
+                });
 
-            // Use default text if an error occurs or the ID is negative
-            if (!updated) {
-                this->player->setTrackName("Common.NotPlaying1"_lang);
-                this->player->setTrackArtist("Common.NotPlaying2"_lang);
-                this->player->setDuration(0);
-                this->player->setAlbumCover(new Aether::Image(0, 0, Path::App::DefaultArtFile));
+            } else {
+                this->showNotPlaying();
             }
         }
 
@@ -691,8 +690,30 @@ namespace Screen {
         this->playingID = -100;     // This number needs to be less than -1, as >= -1 are valid values
     }
 
+    void Home::showPlayingSong(const Metadata::Song & m, const std::string & art) {
+        // Repeated check as ID is set negative on error
+        if (m.ID < 0) {
+            this->showNotPlaying();
+            return;
+        }
+
+        this->player->setTrackName(m.title);
+        this->player->setTrackArtist(m.artist);
+        this->player->setDuration(m.duration);
+        this->player->setAlbumCover(new Aether::Image(0, 0, art));
+    }
+
+    void Home::showNotPlaying() {
+        // Use default text if an error occurs or the ID is negative
+        this->player->setTrackName("Common.NotPlaying1"_lang);
+        this->player->setTrackArtist("Common.NotPlaying2"_lang);
+        this->player->setDuration(0);
+        this->player->setAlbumCover(new Aether::Image(0, 0, Path::App::DefaultArtFile));
+    }
+
     void Home::onUnload() {
         Screen::onUnload();
+        this->app->databaseWorker()->cancel(this);
 
         delete this->addToPlMenu;
         delete this->confirmQueue;
@@ -1,10 +1,14 @@
 #include "Application.hpp"
 #include "lang/Lang.hpp"
 #include "LibraryScanner.hpp"
+#include "Log.hpp"
 #include "ui/screen/Splash.hpp"
 #include "utils/NX.hpp"
 #include "utils/Utils.hpp"
 
+// Maximum number of unused images to delete on each launch (any others are deleted on the following launches)
+#define IMAGES_PER_LAUNCH 50
+
 namespace Screen {
     Splash::Splash(Main::Application * a) : Screen(a) {
         // Can only exit on an error
@@ -24,14 +28,40 @@ namespace Screen {
         // Ensure the database is up to date
         this->app->lockDatabase();
         bool ok = this->app->database()->migrate();
+
+        // Add any plays recorded by the sysmodule since the last launch (which may change smart playlists)
+        if (ok) {
+            this->app->database()->openReadWrite();
+            if (!this->app->database()->importPlayJournal()) {
+                Log::writeWarning("[SPLASH] Unable to import the play journal, it will be retried on the next launch");
+            }
+            if (!this->app->database()->refreshSmartPlaylists()) {
+                Log::writeWarning("[SPLASH] Unable to refresh smart playlists");
+            }
+
+            // Remove a few images which aren't used anymore (i.e. replaced or from albums that were removed)
+            if (!this->app->database()->removeUnusedImages(IMAGES_PER_LAUNCH)) {
+                Log::writeWarning("[SPLASH] Unable to remove unused images");
+            }
+
+            // Forget the directories if a full scan was requested, as otherwise files in unchanged
+            // directories are never read again (even if they were edited in place)
+            if (this->app->fullScan()) {
+                if (!this->app->database()->removeAllDirectoryInfo()) {
+                    Log::writeWarning("[SPLASH] Unable to remove the stored directories, only changed directories will be scanned");
+                }
+            }
+        }
         this->app->unlockDatabase();
         if (!ok) {
             this->currentStage = ScanStage::Error;
             return;
         }
 
-        // Skip scanning if the config option is set
-        if (!this->app->config()->scanOnLaunch()) {
+        // Skip scanning if the config option is set (unless a full scan was requested)
+        bool fullScan = this->app->fullScan();
+        this->app->setFullScan(false);
+        if (!fullScan && !this->app->config()->scanOnLaunch()) {
             this->currentStage = ScanStage::Done;
             return;
         }
@@ -44,8 +74,16 @@ namespace Screen {
         this->currentStage = ScanStage::Files;
         LibraryScanner::Status result = scanner.processFiles();
 
-        // Everything is up to date!
+        // Everything is up to date! (although the directories may need to be remembered
+        // if something other than a song has changed, or they weren't stored previously,
+        // and fingerprints may have been calculated for songs stored without one)
         if (result == LibraryScanner::Status::Done) {
+            if (scanner.directoriesChanged() || scanner.hasFingerprints()) {
+                this->app->lockDatabase();
+                scanner.updateDirectories();
+                scanner.updateFingerprints();
+                this->app->unlockDatabase();
+            }
             this->currentStage = ScanStage::Done;
             return;
 
@@ -55,34 +93,61 @@ namespace Screen {
             return;
         }
 
-        // Parse all required files and get their metadata
-        if (result != LibraryScanner::Status::DoneRemove) {
-            this->currentStage = ScanStage::Metadata;
-            result = scanner.processMetadata(this->currentFile, this->totalFiles, this->estRemaining);
-
+        // Record the files which are about to be stored, so that art can still be found for them if the scan is interrupted
+        bool removeOnly = (result == LibraryScanner::Status::DoneRemove);
+        if (!removeOnly) {
+            this->app->lockDatabase();
+            result = scanner.startJournal();
+            this->app->unlockDatabase();
             if (result != LibraryScanner::Status::Ok) {
                 this->currentStage = ScanStage::Error;
                 return;
             }
         }
 
-        // Lock the database for writing and update with metadata
-        this->currentStage = ScanStage::Database;
-        this->app->sysmodule()->waitReset();
-        this->app->lockDatabase();
-        result = scanner.updateDatabase();
-        this->app->unlockDatabase();
-        if (result != LibraryScanner::Status::Ok) {
-            this->currentStage = ScanStage::Error;
-            return;
+        // Parse the required files in batches, locking the database to store each one, so that an
+        // interrupted scan resumes from the last batch (as the songs already stored are up to date)
+        // Playback is stopped before the first batch is stored, and the path index is only exported after the last
+        if (!removeOnly) {
+            this->currentStage = ScanStage::Metadata;
         }
+        bool reset = false;
+        do {
+            if (scanner.filesRemaining() > 0) {
+                result = scanner.processMetadata(this->currentFile, this->totalFiles, this->estRemaining);
+                if (result != LibraryScanner::Status::Ok) {
+                    this->currentStage = ScanStage::Error;
+                    return;
+                }
+            }
 
-        // Now re-lock the database to update for album art
-        if (result != LibraryScanner::Status::DoneRemove) {
-            this->currentStage = ScanStage::Art;
+            // Lock the database for writing and update with metadata
+            bool last = (scanner.filesRemaining() == 0);
+            if (last) {
+                this->currentStage = ScanStage::Database;
+            }
+            if (!reset) {
+                this->app->sysmodule()->waitReset();
+                reset = true;
+            }
             this->app->lockDatabase();
+            result = scanner.updateDatabase();
+            this->app->unlockDatabase(last || result != LibraryScanner::Status::Ok);
+            if (result != LibraryScanner::Status::Ok) {
+                this->currentStage = ScanStage::Error;
+                return;
+            }
+        } while (scanner.filesRemaining() > 0);
+
+        // Extract album art (which only reads the database), then re-lock the database to store it
+        if (!removeOnly) {
+            this->currentStage = ScanStage::Art;
             result = scanner.processArt(this->currentFile);
-            this->app->unlockDatabase();
+            if (result == LibraryScanner::Status::Ok) {
+                this->app->lockDatabase();
+                result = scanner.updateArt();
+                this->app->unlockDatabase();
+            }
             if (result != LibraryScanner::Status::Ok) {
                 this->currentStage = ScanStage::Error;
                 return;
@@ -1,10 +1,15 @@
 #include "avir.h"
+#include <algorithm>
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <jpeglib.h>
 #include "Log.hpp"
+#include <mutex>
 #include <png.h>
+#include "utils/FS.hpp"
 #include "utils/Image.hpp"
+#include "utils/Utils.hpp"
 
 namespace Utils::Image {
     // Type of image
@@ -51,7 +56,9 @@ namespace Utils::Image {
     }
 
     // Extracts the raw pixel values from the given JPEG buffer
-    ImageData extractJPEG(std::vector<unsigned char> & data) {
+    // If a minimum size is given the JPEG is scaled down while decoding (by 1/2, 1/4 or 1/8) as long as it
+    // stays at least that size, which is much quicker than decoding every pixel of a large image
+    ImageData extractJPEG(std::vector<unsigned char> & data, size_t minW, size_t minH) {
         ImageData extracted;
         extracted.width = 0;
         extracted.height = 0;
@@ -71,6 +78,17 @@ namespace Utils::Image {
             Log::writeError("[IMAGE] JPEG is corrupt or invalid");
             return extracted;
         }
+
+        // Pick the smallest scale that is still large enough (only applied to sizes libjpeg scales in the DCT)
+        if (minW > 0 && minH > 0) {
+            for (unsigned int denom = 8; denom > 1; denom /= 2) {
+                if ((jpeg.image_width + denom - 1) / denom >= minW && (jpeg.image_height + denom - 1) / denom >= minH) {
+                    jpeg.scale_num = 1;
+                    jpeg.scale_denom = denom;
+                    break;
+                }
+            }
+        }
         jpeg_start_decompress(&jpeg);
 
         // Set metadata
@@ -166,6 +184,9 @@ namespace Utils::Image {
         // Write pixel data
         compressPNGPixels(image, png, info);
         png_write_end(png, info);
+
+        // Clean up and return
+        png_destroy_write_struct(&png, &info);
         return compressed;
     }
 
@@ -249,54 +270,295 @@ namespace Utils::Image {
         return extracted;
     }
 
-    bool resize(std::vector<unsigned char> & data, size_t destW, size_t destH) {
-        // Determine the format of the image first and then extract raw pixel data
-        ImageFormat format = getImageFormat(data);
+    // Determine the format of the image and then extract raw pixel data
+    // The image may be extracted at a smaller size than it's stored at, but will be at least the minimum size
+    // Returns an image with no pixels on an error
+    ImageData extractImage(std::vector<unsigned char> & data, size_t minW, size_t minH) {
         ImageData image;
-        switch (format) {
+        image.width = 0;
+        image.height = 0;
+        image.channels = 0;
+        switch (getImageFormat(data)) {
             case ImageFormat::PNG:
                 image = extractPNG(data);
                 break;
 
             case ImageFormat::JPEG:
-                image = extractJPEG(data);
+                image = extractJPEG(data, minW, minH);
                 break;
 
             default:
                 Log::writeError("[IMAGE] Couldn't determine image format");
-                return false;
                 break;
         }
 
-        // Stop if we have no pixels
         if (image.pixels.empty()) {
             Log::writeInfo("[IMAGE] Extracted zero pixels from image; can't resize");
-            return false;
         }
+        return image;
+    }
 
-        // Resize if it's not the destination size
-        if (!(image.width == destW && image.height == destH)) {
-            // Create the output buffer
-            std::vector<uint8_t> resized;
-            resized.resize(destW * destH * image.channels, 0);
+    // Number of fractional bits in the weights used by shrinkPixels()
+    static const unsigned int WEIGHT_BITS = 14;
 
-            // Resize and fill buffer
-            avir::CImageResizer<> ImageResizer(8);
-            ImageResizer.resizeImage(&image.pixels[0], image.width, image.height, 0, &resized[0], destW, destH, image.channels, 0);
+    // Source pixels which are averaged to produce one destination pixel
+    struct Coverage {
+        size_t first;                   // Index of the first source pixel
+        std::vector<uint32_t> weights;  // Weight of each source pixel (summing to 1 << WEIGHT_BITS)
+    };
 
-            // Update ImageData struct
-            image.pixels = resized;
-            image.width = destW;
-            image.height = destH;
+    // Returns how much of each source pixel is covered by each destination pixel when shrinking along one axis
+    static std::vector<Coverage> getCoverage(size_t src, size_t dest) {
+        std::vector<Coverage> coverage(dest);
+        double scale = static_cast<double>(src) / dest;
+        for (size_t i = 0; i < dest; i++) {
+            double start = i * scale;
+            double end = (i + 1) * scale;
+            coverage[i].first = static_cast<size_t>(start);
+            size_t last = std::min(static_cast<size_t>(std::ceil(end)), src);
+
+            uint32_t total = 0;
+            size_t largest = 0;
+            for (size_t j = coverage[i].first; j < last; j++) {
+                double overlap = std::min(end, j + 1.0) - std::max(start, static_cast<double>(j));
+                coverage[i].weights.push_back(std::lround(overlap / scale * (1 << WEIGHT_BITS)));
+                total += coverage[i].weights.back();
+                if (coverage[i].weights.back() > coverage[i].weights[largest]) {
+                    largest = coverage[i].weights.size() - 1;
+                }
+            }
+
+            // Give any rounding error to the largest weight so the total is exact
+            coverage[i].weights[largest] += (1 << WEIGHT_BITS) - total;
+        }
+        return coverage;
+    }
 
-        } else {
+    // Shrinks the image by averaging the area of the source image covered by each destination pixel
+    // This is a lot quicker than avir and looks just as good when shrinking, but can't be used to enlarge an image
+    static ImageData shrinkPixels(const ImageData & image, size_t destW, size_t destH) {
+        ImageData resized = image;
+        resized.width = destW;
+        resized.height = destH;
+        resized.pixels.resize(destW * destH * image.channels);
+
+        // Shrink horizontally first, keeping 8 extra bits per value so precision isn't lost before shrinking vertically
+        const size_t channels = image.channels;
+        std::vector<Coverage> coverage = getCoverage(image.width, destW);
+        std::vector<uint16_t> rows(destW * image.height * channels);
+        for (size_t y = 0; y < image.height; y++) {
+            const uint8_t * src = &image.pixels[y * image.width * channels];
+            uint16_t * dest = &rows[y * destW * channels];
+            for (size_t x = 0; x < destW; x++) {
+                const Coverage & cover = coverage[x];
+                for (size_t c = 0; c < channels; c++) {
+                    uint32_t sum = 0;
+                    for (size_t i = 0; i < cover.weights.size(); i++) {
+                        sum += src[(cover.first + i) * channels + c] * cover.weights[i];
+                    }
+                    dest[x * channels + c] = (sum + (1 << (WEIGHT_BITS - 9))) >> (WEIGHT_BITS - 8);
+                }
+            }
+        }
+
+        // Then shrink vertically by adding whole rows at once (which the compiler is able to vectorize)
+        coverage = getCoverage(image.height, destH);
+        const size_t rowLength = destW * channels;
+        std::vector<uint32_t> sums(rowLength);
+        for (size_t y = 0; y < destH; y++) {
+            std::fill(sums.begin(), sums.end(), 0);
+            for (size_t i = 0; i < coverage[y].weights.size(); i++) {
+                const uint16_t * src = &rows[(coverage[y].first + i) * rowLength];
+                const uint32_t weight = coverage[y].weights[i];
+                for (size_t x = 0; x < rowLength; x++) {
+                    sums[x] += src[x] * weight;
+                }
+            }
+
+            uint8_t * dest = &resized.pixels[y * rowLength];
+            for (size_t x = 0; x < rowLength; x++) {
+                dest[x] = (sums[x] + (1 << (WEIGHT_BITS + 7))) >> (WEIGHT_BITS + 8);
+            }
+        }
+        return resized;
+    }
+
+    // Returns a copy of the image resized to the given dimensions
+    ImageData resizePixels(const ImageData & image, size_t destW, size_t destH) {
+        // Nothing to do if it's already the destination size
+        if (image.width == destW && image.height == destH) {
             Log::writeInfo("[IMAGE] No need to resize image as it has the required dimensions");
+            return image;
+        }
+
+        // Shrinking is handled by averaging, avir is only needed when the image has to be enlarged
+        if (destW <= image.width && destH <= image.height) {
+            return shrinkPixels(image, destW, destH);
+        }
+
+        // Create the output buffer
+        ImageData resized = image;
+        resized.pixels.resize(destW * destH * image.channels, 0);
+        resized.width = destW;
+        resized.height = destH;
+
+        // Resize and fill buffer
+        avir::CImageResizer<> ImageResizer(8);
+        ImageResizer.resizeImage(&image.pixels[0], image.width, image.height, 0, &resized.pixels[0], destW, destH, image.channels, 0);
+        return resized;
+    }
+
+    bool resize(std::vector<unsigned char> & data, size_t destW, size_t destH) {
+        ImageData image = extractImage(data, destW, destH);
+        if (image.pixels.empty()) {
+            return false;
         }
 
         // We're going to save a PNG cause they're better than JPEG
-        data = compressPNG(image);
+        data = compressPNG(resizePixels(image, destW, destH));
         data.shrink_to_fit();
         Log::writeInfo("[IMAGE] Resized successfully");
         return true;
     }
+
+    bool resize(std::vector<unsigned char> & data, const std::vector<size_t> & sizes, std::vector< std::vector<unsigned char> > & resized) {
+        size_t largest = (sizes.empty() ? 0 : *std::max_element(sizes.begin(), sizes.end()));
+        ImageData image = extractImage(data, largest, largest);
+        if (image.pixels.empty()) {
+            return false;
+        }
+
+        // Each size is resized from the original pixels to avoid losing any more detail
+        resized.clear();
+        for (size_t size : sizes) {
+            resized.push_back(compressPNG(resizePixels(image, size, size)));
+            resized.back().shrink_to_fit();
+        }
+        Log::writeInfo("[IMAGE] Resized successfully");
+        return true;
+    }
+
+    bool getPixels(std::vector<unsigned char> & data, size_t size, std::vector<unsigned char> & pixels, size_t & width, size_t & height) {
+        ImageData image = extractImage(data, size, size);
+        if (image.pixels.empty()) {
+            return false;
+        }
+
+        // Only shrink if it's too big
+        if (image.width > size || image.height > size) {
+            double scale = std::min(static_cast<double>(size) / image.width, static_cast<double>(size) / image.height);
+            image = shrinkPixels(image, std::max<size_t>(image.width * scale, 1), std::max<size_t>(image.height * scale, 1));
+        }
+
+        // Add an alpha channel if there isn't one (greyscale images are copied into each colour)
+        width = image.width;
+        height = image.height;
+        if (image.channels == 4) {
+            pixels = std::move(image.pixels);
+        } else {
+            pixels.resize(width * height * 4);
+            for (size_t i = 0; i < width * height; i++) {
+                const uint8_t * src = &image.pixels[i * image.channels];
+                for (size_t c = 0; c < 3; c++) {
+                    pixels[i * 4 + c] = src[image.channels < 3 ? 0 : c];
+                }
+                pixels[i * 4 + 3] = 255;
+            }
+        }
+        return true;
+    }
+
+    // Sizes written by writeArt(), with the full size last so that it only exists once the others do
+    static const std::vector<ArtSize> artSizes = {ArtSize::Thumbnail, ArtSize::Tile, ArtSize::Full};
+
+    // Held while checking if an image exists and writing it, so that two threads writing the same image
+    // don't write to the same file at once
+    static std::mutex writeMutex;
+
+    // Returns the path to the given size of album art given the path without an extension
+    static std::string sizedPath(const std::string & path, const ArtSize size) {
+        return path + "_" + std::to_string(static_cast<int>(size)) + ".png";
+    }
+
+    // Returns a 64-bit FNV-1a hash of the given file as a hex string, used to name images by their contents
+    static std::string hashName(const std::vector<unsigned char> & data) {
+        uint64_t hash = Utils::fnv1a(data.data(), data.size());
+        char str[17];
+        std::snprintf(str, sizeof(str), "%016llx", (unsigned long long)hash);
+        return std::string(str);
+    }
+
+    std::string writeArt(std::vector<unsigned char> & data, const std::string & folder) {
+        // Nothing needs to be decoded if this image has already been written
+        std::string path = folder + hashName(data);
+        if (Utils::Fs::fileExists(sizedPath(path, ArtSize::Full))) {
+            return sizedPath(path, ArtSize::Full);
+        }
+
+        std::vector<size_t> sizes;
+        for (ArtSize size : artSizes) {
+            sizes.push_back(static_cast<size_t>(size));
+        }
+        std::vector< std::vector<unsigned char> > images;
+        if (!resize(data, sizes, images)) {
+            return "";
+        }
+
+        // Check again in case another thread wrote it while it was being resized
+        std::scoped_lock<std::mutex> mtx(writeMutex);
+        if (Utils::Fs::fileExists(sizedPath(path, ArtSize::Full))) {
+            return sizedPath(path, ArtSize::Full);
+        }
+
+        // Remove anything already written if a file can't be written
+        for (size_t i = 0; i < artSizes.size(); i++) {
+            if (!Utils::Fs::writeFile(sizedPath(path, artSizes[i]), images[i])) {
+                Log::writeError("[IMAGE] Unable to write album art to: " + sizedPath(path, artSizes[i]));
+                for (size_t j = 0; j < i; j++) {
+                    Utils::Fs::deleteFile(sizedPath(path, artSizes[j]));
+                }
+                return "";
+            }
+        }
+        return sizedPath(path, ArtSize::Full);
+    }
+
+    std::string writeImage(std::vector<unsigned char> & data, const std::string & folder, size_t size) {
+        std::string path = folder + hashName(data) + ".png";
+        if (Utils::Fs::fileExists(path)) {
+            return path;
+        }
+
+        if (!resize(data, size, size)) {
+            Log::writeWarning("[IMAGE] Couldn't resize image, saving with original dimensions");
+        }
+
+        std::scoped_lock<std::mutex> mtx(writeMutex);
+        if (Utils::Fs::fileExists(path)) {
+            return path;
+        }
+        if (!Utils::Fs::writeFile(path, data)) {
+            Log::writeError("[IMAGE] Unable to write image to: " + path);
+            return "";
+        }
+        return path;
+    }
+
+    std::string artPath(const std::string & path, const ArtSize size) {
+        // Only images named by writeArt() have other sizes
+        std::string suffix = sizedPath("", ArtSize::Full);
+        if (path.length() <= suffix.length() || path.compare(path.length() - suffix.length(), suffix.length(), suffix) != 0) {
+            return path;
+        }
+        return sizedPath(path.substr(0, path.length() - suffix.length()), size);
+    }
+
+    void deleteArt(const std::string & path) {
+        for (ArtSize size : artSizes) {
+            if (artPath(path, size) != path) {
+                Utils::Fs::deleteFile(artPath(path, size));
+            }
+        }
+        Utils::Fs::deleteFile(path);
+    }
 };
\ No newline at end of file
@@ -1,119 +1,90 @@
-#include <queue>
-#include <set>
 #include "utils/Search.hpp"
 
 namespace Utils::Search {
-    // Combination of values to store in priority queue
-    struct QueueEntry {
-        ScoredString phrase;            // Phrase formed from words
-        std::vector<size_t> indices;    // Vector of indices that words were grabbed from
-    };
-
-    // Custom operator for priority queue which places lower scores at the top
-    struct MIN_QUEUEENTRY {
-        bool operator()(const QueueEntry & lhs, const QueueEntry & rhs) {
-            return lhs.phrase.score > rhs.phrase.score;
+    // Returns true if the given byte separates words
+    // Matches SQLite's 'simple' tokenizer, which treats all non-alphanumeric ASCII as a separator
+    static bool isSeparator(const unsigned char c) {
+        if (c >= 0x80) {
+            return false;
         }
-    };
-
-    // Helper function to form QueueEntry
-    // Expect words.size() == indices.size()
-    static QueueEntry getQueueEntry(const std::vector< std::vector<ScoredString> > & words, const std::vector<size_t> & indices) {
-        // Initialize as empty
-        QueueEntry tmp;
-        tmp.phrase.string = "";
-        tmp.phrase.score = 0;
+        return !((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'));
+    }
 
-        // Iterate over vector and populate
-        for (size_t k = 0; k < words.size(); k++) {
-            size_t index = indices[k];
+    // Returns true if the given byte continues a multi-byte UTF-8 character
+    static bool isContinuation(const unsigned char c) {
+        return ((c & 0xC0) == 0x80);
+    }
 
-            // Concatenate phrase
-            tmp.phrase.string += words[k][index].string;
-            if (k != words.size() - 1) {
-                tmp.phrase.string += " ";
+    // Appends the trigrams of a single word (stored as a vector of UTF-8 characters)
+    static void appendWord(const std::vector<std::string> & word, std::vector<std::string> & trigrams) {
+        // Short words are kept whole
+        if (word.size() < 3) {
+            std::string str;
+            for (const std::string & chr : word) {
+                str += chr;
             }
-
-            // Sum up scores
-            tmp.phrase.score += words[k][index].score;
-            tmp.indices.push_back(index);
+            trigrams.push_back(str);
+            return;
         }
 
-        return tmp;
+        for (size_t i = 0; i + 2 < word.size(); i++) {
+            trigrams.push_back(word[i] + word[i + 1] + word[i + 2]);
+        }
     }
 
-    std::vector<std::string> getPhrases(std::vector< std::vector<ScoredString> > & words, size_t num) {
-        // Vector of phrases to return
-        std::vector<std::string> phrases;
+    std::vector<std::string> getTrigrams(const std::string & str) {
+        std::vector<std::string> trigrams;
+        std::vector<std::string> word;
 
-        // Remove any empty 'columns'
         size_t i = 0;
-        while (i < words.size()) {
-            if (words[i].empty()) {
-                words.erase(words.begin() + i);
-            } else {
+        while (i < str.length()) {
+            unsigned char c = str[i];
+
+            // End the current word when a separator is found
+            if (isSeparator(c)) {
+                if (!word.empty()) {
+                    appendWord(word, trigrams);
+                    word.clear();
+                }
                 i++;
+                continue;
             }
-        }
-
-        // Simply return if only one 'column' or none
-        if (words.empty()) {
-            return phrases;
 
-        } else if (words.size() == 1) {
-            // Push back required number of words
-            for (size_t i = 0; i < words[0].size(); i++) {
-                if (phrases.size() >= num) {
-                    break;
-                }
-                phrases.push_back(words[0][i].string);
+            // Lowercase ASCII (again like the 'simple' tokenizer), otherwise copy the whole UTF-8 character
+            std::string chr(1, (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c);
+            i++;
+            while (i < str.length() && isContinuation(str[i])) {
+                chr += str[i];
+                i++;
             }
-            return phrases;
+            word.push_back(chr);
         }
 
-        // Priority queue used to grab highest scoring phrases
-        std::priority_queue<QueueEntry, std::vector<QueueEntry>, MIN_QUEUEENTRY> pq;
-        std::set< std::vector<size_t> > indices;
-
-        // Create an entry using the best phrase
-        std::vector<size_t> zeroes;
-        zeroes.resize(words.size(), 0);
-        QueueEntry entry = getQueueEntry(words, zeroes);
-
-        // Push above entry on queue
-        pq.push(entry);
-        indices.insert(entry.indices);
-
-        // Pick up to num best scoring phrases
-        for (i = 0; i < num; i++) {
-            // Stop if queue empty
-            if (pq.empty()) {
-                break;
-            }
-
-            // Get top element
-            QueueEntry top = pq.top();
-            pq.pop();
-            phrases.push_back(top.phrase.string);
+        // Don't forget the last word
+        if (!word.empty()) {
+            appendWord(word, trigrams);
+        }
 
-            // Form phrases using next index in each column
-            for (size_t j = 0; j < top.indices.size(); j++) {
-                QueueEntry tmp = top;
+        return trigrams;
+    }
 
-                // Increment the jth index and keep within bounds
-                if (tmp.indices[j] < words[j].size()-1) {
-                    tmp.indices[j]++;
-                }
+    unsigned int matchPercent(const std::vector<std::string> & query, const std::string & str) {
+        if (query.empty()) {
+            return 0;
+        }
 
-                // Get new entry and insert if not already inserted
-                QueueEntry pot = getQueueEntry(words, tmp.indices);
-                if (indices.find(pot.indices) == indices.end()) {
-                    pq.push(pot);
-                    indices.insert(pot.indices);
+        // Count the number of query trigrams which start any of the string's trigrams
+        std::vector<std::string> trigrams = getTrigrams(str);
+        size_t hits = 0;
+        for (const std::string & q : query) {
+            for (const std::string & t : trigrams) {
+                if (t.compare(0, q.length(), q) == 0) {
+                    hits++;
+                    break;
                 }
             }
         }
 
-        return phrases;
+        return (hits * 100)/query.size();
     }
 };
\ No newline at end of file
@@ -1,7 +1,13 @@
 #include "Log.hpp"
 #include "splash/Splash.hpp"
+#include "utils/FS.hpp"
+#include "utils/Image.hpp"
 #include "utils/Splash.hpp"
 
+// Maximum size (in pixels) images are shrunk to before picking colours, as the colours are picked from
+// a histogram of the image and so don't need every pixel
+#define PALETTE_IMAGE_SIZE 110
+
 namespace Utils::Splash {
     Aether::Colour changeLightness(Aether::Colour old, int val) {
         ::Splash::Colour col = ::Splash::Colour(old.a(), old.r(), old.g(), old.b());
@@ -9,6 +15,33 @@ namespace Utils::Splash {
         return Aether::Colour{(uint8_t)col.r(), (uint8_t)col.g(), (uint8_t)col.b(), (uint8_t)col.a()};
     }
 
+    // Returns the palette for the given pixels, which must be for an image of the given dimensions
+    static Palette getPaletteForPixels(const std::vector<::Splash::Colour> & pixels, size_t width, size_t height) {
+        // Create a Splash::Bitmap and fill with pixels
+        ::Splash::Bitmap image = ::Splash::Bitmap(width, height);
+        size_t amt = image.setPixels(pixels, 0, 0, image.getWidth(), image.getHeight());
+        if (amt != pixels.size()) {
+            Log::writeWarning("[SPLASH] Not enough pixels were written to the bitmap - this may result in incorrect colours being picked (wrote: " + std::to_string(amt) + ", wanted: " + std::to_string(width * height) + ")");
+        }
+
+        // Create a MediaStyle object to extract the colours
+        Palette palette;
+        ::Splash::MediaStyle style = ::Splash::MediaStyle(image);
+        palette.invalid = false;
+        palette.bgLight = style.isLight();
+
+        ::Splash::Colour tmp = style.getBackgroundColour();
+        palette.background = Aether::Colour{(uint8_t)tmp.r(), (uint8_t)tmp.g(), (uint8_t)tmp.b(), (uint8_t)tmp.a()};
+
+        tmp = style.getPrimaryTextColour();
+        palette.primary = Aether::Colour{(uint8_t)tmp.r(), (uint8_t)tmp.g(), (uint8_t)tmp.b(), (uint8_t)tmp.a()};
+
+        tmp = style.getSecondaryTextColour();
+        palette.secondary = Aether::Colour{(uint8_t)tmp.r(), (uint8_t)tmp.g(), (uint8_t)tmp.b(), (uint8_t)tmp.a()};
+
+        return palette;
+    }
+
     Palette getPaletteForDrawable(Aether::Drawable * drawable) {
         // Struct to return
         Palette palette;
@@ -33,32 +66,60 @@ namespace Utils::Splash {
         for (const Aether::Colour & c : colours) {
             pixels.push_back(::Splash::Colour(c.a(), c.r(), c.g(), c.b()));
         }
+        return getPaletteForPixels(pixels, drawable->width(), drawable->height());
+    }
 
-        // Now create a Splash::Bitmap and fill with pixels
-        ::Splash::Bitmap image = ::Splash::Bitmap(drawable->width(), drawable->height());
-        size_t amt = image.setPixels(pixels, 0, 0, image.getWidth(), image.getHeight());
-        if (amt != pixels.size()) {
-            Log::writeWarning("[SPLASH] Not enough pixels were written to the bitmap - this may result in incorrect colours being picked (wrote: " + std::to_string(amt) + ", wanted: " + std::to_string(drawable->width() * drawable->height()) + ")");
-        }
-        pixels.clear();
+    Palette getPaletteForFile(const std::string & path) {
+        Palette palette;
+        palette.invalid = true;
 
-        // Create a MediaStyle object to extract the colours
-        ::Splash::MediaStyle style = ::Splash::MediaStyle(image);
-        palette.invalid = false;
-        palette.bgLight = style.isLight();
+        // Decode the image, shrinking it first if needed
+        std::vector<unsigned char> data;
+        std::vector<unsigned char> rgba;
+        size_t width, height;
+        if (!Utils::Fs::readFile(path, data) || !Utils::Image::getPixels(data, PALETTE_IMAGE_SIZE, rgba, width, height)) {
+            Log::writeError("[SPLASH] Unable to read image to get a palette: " + path);
+            return palette;
+        }
 
-        ::Splash::Colour tmp = style.getBackgroundColour();
-        palette.background = Aether::Colour{(uint8_t)tmp.r(), (uint8_t)tmp.g(), (uint8_t)tmp.b(), (uint8_t)tmp.a()};
+        // Convert to Splash::Colour
+        std::vector<::Splash::Colour> pixels;
+        pixels.reserve(width * height);
+        for (size_t i = 0; i < rgba.size(); i += 4) {
+            pixels.push_back(::Splash::Colour(rgba[i + 3], rgba[i], rgba[i + 1], rgba[i + 2]));
+        }
+        return getPaletteForPixels(pixels, width, height);
+    }
 
-        tmp = style.getPrimaryTextColour();
-        palette.primary = Aether::Colour{(uint8_t)tmp.r(), (uint8_t)tmp.g(), (uint8_t)tmp.b(), (uint8_t)tmp.a()};
+    // Colours are packed as 0xRRGGBBAA
+    static uint32_t packColour(const Aether::Colour & colour) {
+        return ((uint32_t)colour.r() << 24) | ((uint32_t)colour.g() << 16) | ((uint32_t)colour.b() << 8) | (uint32_t)colour.a();
+    }
 
-        tmp = style.getSecondaryTextColour();
-        palette.secondary = Aether::Colour{(uint8_t)tmp.r(), (uint8_t)tmp.g(), (uint8_t)tmp.b(), (uint8_t)tmp.a()};
+    static Aether::Colour unpackColour(const uint32_t colour) {
+        return Aether::Colour{(uint8_t)(colour >> 24), (uint8_t)(colour >> 16), (uint8_t)(colour >> 8), (uint8_t)colour};
+    }
 
+    Palette fromMetadata(const Metadata::Palette & stored) {
+        Palette palette;
+        palette.invalid = !stored.valid;
+        palette.bgLight = stored.bgLight;
+        palette.background = unpackColour(stored.background);
+        palette.primary = unpackColour(stored.primary);
+        palette.secondary = unpackColour(stored.secondary);
         return palette;
     }
 
+    Metadata::Palette toMetadata(const Palette & palette) {
+        Metadata::Palette stored;
+        stored.valid = !palette.invalid;
+        stored.bgLight = palette.bgLight;
+        stored.background = packColour(palette.background);
+        stored.primary = packColour(palette.primary);
+        stored.secondary = packColour(palette.secondary);
+        return stored;
+    }
+
     Aether::Colour interpolateColours(const Aether::Colour & start, const Aether::Colour & end, double amt) {
         amt = (amt < 0.0 ? 0.0 : amt);
         amt = (amt > 1.0 ? 1.0 : amt);
@@ -6,6 +6,14 @@
 #include "utils/Utils.hpp"
 
 namespace Utils {
+    uint64_t fnv1a(const unsigned char * data, size_t len, uint64_t hash) {
+        for (size_t i = 0; i < len; i++) {
+            hash ^= data[i];
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
     std::string formatBytes(long long bytes) {
         // Divide until smaller than 1024
         double val = bytes;
@@ -137,6 +145,71 @@ namespace Utils {
         return substituteTokens(Lang::string(str), std::to_string(h <= 1 ? m : h), std::to_string(m));
     }
 
+    // Base letter of each character from U+00C0 to U+017F (Latin-1 Supplement and Latin Extended-A)
+    // A space marks a character which is kept as is, while an asterisk marks one which becomes two letters
+    static const char * latinBase = "aaaaaa*ceeeeiiiidnooooo ouuuuy**aaaaaa*ceeeeiiiidnooooo ouuuuy*y"
+                                    "aaaaaaccccccccddddeeeeeeeeeegggggggghhhhiiiiiiiiii**jjkkklllllll"
+                                    "lllnnnnnnnnnoooooo**rrrrrrssssssssttttttuuuuuuuuuuuuwwyyyzzzzzzs";
+
+    std::string sortKey(const std::string & str) {
+        std::string key;
+        size_t i = 0;
+        while (i < str.length()) {
+            unsigned char c = str[i];
+
+            // ASCII is simply lowercased
+            if (c < 0x80) {
+                key += static_cast<char>(tolower(c));
+                i++;
+                continue;
+            }
+
+            // Decode two byte characters to see if they're in the table (anything else is copied)
+            size_t len = ((c & 0xE0) == 0xC0 ? 2 : ((c & 0xF0) == 0xE0 ? 3 : ((c & 0xF8) == 0xF0 ? 4 : 1)));
+            unsigned int cp = (len == 2 && i + 1 < str.length() ? ((c & 0x1F) << 6) | (str[i + 1] & 0x3F) : 0);
+            if (cp >= 0xC0 && cp <= 0x17F && latinBase[cp - 0xC0] != ' ') {
+                switch (cp) {
+                    case 0xC6:
+                    case 0xE6:
+                        key += "ae";
+                        break;
+
+                    case 0xDE:
+                    case 0xFE:
+                        key += "th";
+                        break;
+
+                    case 0xDF:
+                        key += "ss";
+                        break;
+
+                    case 0x132:
+                    case 0x133:
+                        key += "ij";
+                        break;
+
+                    case 0x152:
+                    case 0x153:
+                        key += "oe";
+                        break;
+
+                    default:
+                        key += latinBase[cp - 0xC0];
+                        break;
+                }
+            } else {
+                key += str.substr(i, len);
+            }
+            i += len;
+        }
+
+        // Ignore a leading 'the' (unless that's all there is)
+        if (key.length() > 4 && key.compare(0, 4, "the ") == 0) {
+            key.erase(0, 4);
+        }
+        return key;
+    }
+
     std::vector<std::string> splitIntoWords(const std::string & str, const char delim) {
         std::vector<std::string> words;
 
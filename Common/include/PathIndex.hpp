@@ -0,0 +1,39 @@
+#ifndef PATHINDEX_HPP
+#define PATHINDEX_HPP
+
+#include <cstdint>
+
+// This file describes the layout of the path index, which maps song IDs to their paths (along with
+// the metadata shown by the overlay). It's exported by the application whenever songs change so
+// that the sysmodule can look up a song with a couple of reads, instead of opening the database.
+//
+// The file is made up of (in order):
+// - Header
+// - Fences: the ID of the first entry in every block of BlockSize entries
+// - Entries: one per song, sorted by ID
+// - Records: one per song, packed one after another. Each is made up of the following
+//   null terminated strings: path, title, artist, album, album art path
+namespace PathIndex {
+    // Magic identifying the file ('TPPI')
+    constexpr uint32_t Magic = 0x49505054;
+    // Incremented whenever the layout changes
+    constexpr uint32_t Version = 2;
+    // Number of entries between each fence
+    constexpr uint32_t BlockSize = 128;
+
+    struct Header {
+        uint32_t magic;             // Always Magic
+        uint32_t version;           // Version of layout
+        uint32_t entries;           // Number of entries
+        uint32_t fences;            // Number of fences (each is an int32_t)
+    };
+
+    struct Entry {
+        int32_t id;                 // ID of song
+        uint32_t offset;            // Offset of record (from start of records)
+        uint32_t length;            // Length of record in bytes
+        uint32_t duration;          // Duration of song in seconds
+    };
+};
+
+#endif
\ No newline at end of file
@@ -14,6 +14,8 @@ namespace Path {
 
         extern const std::string DatabaseFile;
         extern const std::string DatabaseBackupFile;
+        extern const std::string PathIndexFile;
+        extern const std::string PlayJournalFile;
     };
 
     // Application specific paths
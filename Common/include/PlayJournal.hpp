@@ -0,0 +1,24 @@
+#ifndef PLAYJOURNAL_HPP
+#define PLAYJOURNAL_HPP
+
+#include <cstdint>
+
+// This file describes the layout of the play journal. The sysmodule can't write to the database,
+// so instead it appends an event to the journal each time a song stops playing. The application
+// later moves the journal aside and adds the events to the database in one transaction.
+//
+// The file is simply a sequence of events with no header. An incomplete event at the end of the
+// file (i.e. the sysmodule was interrupted while writing) is ignored. If the layout ever changes,
+// the file name must also change so old events aren't misread.
+namespace PlayJournal {
+    struct Event {
+        int32_t songID;             // ID of song that was played
+        uint32_t time;              // Time playback started (seconds since epoch)
+        uint8_t percent;            // How much of the song was played (0 - 100)
+        uint8_t skipped;            // 1 if the song was changed before it finished, 0 otherwise
+        uint16_t reserved;          // Unused (always 0)
+    };
+    static_assert(sizeof(Event) == 12, "PlayJournal::Event must be 12 bytes");
+};
+
+#endif
\ No newline at end of file
@@ -1,8 +1,10 @@
 #ifndef SQLITE_CLASS_HPP
 #define SQLITE_CLASS_HPP
 
+#include <chrono>
 #include "sqlite3.h"
 #include <string>
+#include <string_view>
 
 // A wrapper class for SQLite3 (only handles one query at a time).
 // It takes care of a few things behind the scenes that SQLite3
@@ -31,6 +33,8 @@ class SQLite {
         sqlite3 * db;
         // Whether to ignore SQLITE_CONSTRAINT* result codes
         bool ignoreConstraints_;
+        // Number of blocks to cache when reading the file (0 disables)
+        unsigned int readCacheBlocks;
         // Whether we are in a transaction
         bool inTransaction;
         // Path to file
@@ -40,12 +44,35 @@ class SQLite {
         // Status of query
         Query queryStatus;
 
+        // Whether the current query should be profiled (only done when logging info)
+        bool profileQuery;
+        // Number of rows returned by the current query
+        unsigned int queryRows;
+        // Time spent stepping the current query (excludes time spent by the caller between rows)
+        std::chrono::steady_clock::duration queryTime;
+        // Writes the plan of the current query to the log
+        void logQueryPlan();
+
         // Last logged error
         std::string errorMsg_;
         // Sets the above string (reads from SQLite) and also writes to application log
         void setErrorMsg(const std::string &);
 
-        // Finalizes the current query
+        // Overloads used by bindValues() to bind a parameter based on the passed type
+        bool bindValue(int, const bool);
+        bool bindValue(int, const int);
+        bool bindValue(int, const unsigned int);
+        bool bindValue(int, const std::string &);
+        bool bindValue(int, const char *);
+
+        // Overloads used by getColumns() to read a column based on the passed type
+        bool getColumn(int, bool &);
+        bool getColumn(int, int &);
+        bool getColumn(int, unsigned int &);
+        bool getColumn(int, std::string &);
+        bool getColumn(int, std::string_view &);
+
+        // Finalizes the current query (logging how long it took if being profiled)
         void finalizeQuery();
         // Runs required PRAGMA statements
         bool prepare();
@@ -61,6 +88,12 @@ class SQLite {
         std::string errorMsg();
         // Set whether to ignore constraint errors (don't interpret them as errors)
         void ignoreConstraints(bool);
+        // Set a function which is called periodically while a query is running (function pointer, user data)
+        // The query is interrupted if it returns non-zero, pass nullptr to remove it
+        void setProgressHandler(int (*)(void *), void *);
+        // Set the size of the read cache (in KB) used by connections opened afterwards (0 disables)
+        // The file is read in large blocks as small reads are slow on the SD card
+        void setReadCache(unsigned int);
 
         // Returns the current type of connection to the database file
         Connection connectionType();
@@ -90,9 +123,19 @@ class SQLite {
         bool bindBool(int, const bool);
         bool bindInt(int, const int);
         bool bindString(int, const std::string &);
+        // Binds each value to consecutive parameters (beginning at the given parameter), with the
+        // type of each parameter determined by the value's type. Prefer this over calling the above
+        // individually as the parameter numbers can't get out of sync with the query.
+        // Returns true if successful, false on an error
+        template <typename... Values>
+        bool bindValues(int col, const Values &... data) {
+            bool ok = true;
+            ((ok = (ok && this->bindValue(col++, data))), ...);
+            return ok;
+        }
 
         // Performs the provided query on the database
-        // Returns true if successful, false on an error
+        // Returns true if successful, false on an error (or if interrupted by the progress handler)
         bool executeQuery();
         // Accesses values given in the results (undefined if outside of range!)
         // Parameters have order: (column number (starting from 0), reference to fill with data)
@@ -100,6 +143,18 @@ class SQLite {
         bool getBool(int, bool &);
         bool getInt(int, int &);
         bool getString(int, std::string &);
+        // Same as above but doesn't copy the string (only valid until the next call to nextRow()!)
+        bool getStringView(int, std::string_view &);
+        // Reads consecutive columns (beginning at the given column) into each reference, with
+        // the type of each column determined by the reference's type. Prefer this over calling
+        // the above individually as the column numbers can't get out of sync with the query.
+        // Returns true if successful, false on an error
+        template <typename... Columns>
+        bool getColumns(int col, Columns &... data) {
+            bool ok = true;
+            ((ok = (ok && this->getColumn(col++, data))), ...);
+            return ok;
+        }
         // Returns true if currently viewing a row, false otherwise
         bool hasRow();
         // Move to the next row in the results
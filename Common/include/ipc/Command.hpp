@@ -54,7 +54,9 @@ namespace Ipc {
 
         ReloadConfig,       // Get the sysmodule to update it's config          // Nothing                                          // Nothing
         Reset,              // Reinitialize sysmodule (except ipc service)      // Nothing                                          // Version of sysmodule (string)
-        Quit                // Properly terminate the sysmodule                 // Nothing                                          // Nothing
+        Quit,               // Properly terminate the sysmodule                 // Nothing                                          // Nothing
+
+        GetNowPlaying       // Get info about the current and next songs        // Nothing                                          // Info for the current song, then the next song
     };
 };
 
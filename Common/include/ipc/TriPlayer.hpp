@@ -32,6 +32,16 @@ namespace TriPlayer {
         Error       // A fatal error occurred
     };
 
+    // Metadata about a song
+    struct SongInfo {
+        int ID;                 // ID of the song (negative if there is no song/info)
+        std::string title;      // Title of the song
+        std::string artist;     // Name of the song's artist
+        std::string album;      // Name of the song's album
+        unsigned int duration;  // Length of the song in seconds
+        std::string imagePath;  // Path to the album's art (may be empty)
+    };
+
     // Initialize and connect to the sysmodule
     // Common reasons of failure are either it's not running or there's a version mismatch
     bool initialize();
@@ -97,6 +107,9 @@ namespace TriPlayer {
 
     // Get the currently playing song's ID
     bool getSongID(int & outID);
+    // Get metadata for the current song and the song that will play after it
+    // A song's ID will be negative if there isn't one, or if the sysmodule couldn't read it's info yet
+    bool getNowPlaying(SongInfo & outCurrent, SongInfo & outNext);
     // Get the TriPlayer::Status of the sysmodule
     bool getStatus(Status & outStatus);
 
@@ -32,6 +32,9 @@ namespace Utils::Fs {
     bool appendFile(const std::string &, const std::vector<unsigned char> &);
     // Delete a file
     void deleteFile(const std::string &);
+    // Move a file from src to dest, replacing dest if it exists
+    // Returns true if successful, false otherwise
+    bool moveFile(const std::string &, const std::string &);
     // Read an entire file into the buffer
     bool readFile(const std::string &, std::vector<unsigned char> &);
     // Write entire contents of buffer to file
@@ -0,0 +1,27 @@
+#ifndef SQLITE_CACHEVFS_H
+#define SQLITE_CACHEVFS_H
+
+#include "sqlite3.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Name of the VFS to pass to sqlite3_open_v2()
+#define SQLITE_CACHEVFS_NAME "cache"
+
+// Registers (or updates) the "cache" VFS, which is layered on top of the VFS
+// with the given name. The main database file is read in aligned blocks of
+// the given size (in bytes), with the given number of blocks kept in memory.
+// Changes only affect files opened afterwards.
+int sqlite3_cachevfs_register(const char * base, int blockSize, int blockCount);
+
+// Sleep for the given number of microseconds before each read which is passed
+// to the underlying VFS (used to imitate the SD card when testing on a PC)
+void sqlite3_cachevfs_latency(int usecs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
\ No newline at end of file
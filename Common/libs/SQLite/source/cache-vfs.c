@@ -0,0 +1,418 @@
+#include "cache-vfs.h"
+#include <string.h>
+
+// Important points:
+// - Only the main database file is cached, everything else goes straight to
+//   the underlying VFS
+// - The cache belongs to the file handle, so it assumes the file is not
+//   modified through another connection while open (the SQLite class only
+//   ever has one connection open)
+// - Pages can be 'fetched' directly from the cache by read-only connections
+//   (requires mmap_size to be set and SQLITE_MAX_MMAP_SIZE > 0)
+
+// VFS that files are actually opened with, and parameters for new files
+static sqlite3_vfs * baseVfs = NULL;
+static int cacheBlockSize = 0;
+static int cacheBlockCount = 0;
+static int readLatency = 0;
+
+// A block of the file held in memory
+typedef struct cacheBlock cacheBlock;
+struct cacheBlock {
+    sqlite3_int64 offset;       // Offset of block in file (-1 if unused)
+    int size;                   // Number of valid bytes (less than block size at EOF)
+    int refs;                   // Number of pages fetched from this block
+    unsigned int used;          // Value of file's counter when last used
+    char * data;                // Block's data
+};
+
+// sqlite3_file * actually points to this structure
+// The underlying VFS's file object is allocated directly after it
+typedef struct cacheFile cacheFile;
+struct cacheFile {
+    sqlite3_file base;          // Base class
+    sqlite3_file * real;        // File opened by the underlying VFS
+    int readOnly;               // Whether pages may be fetched
+    int blockSize;              // Size of each block (in bytes)
+    int blockCount;             // Number of blocks (0 if not cached)
+    unsigned int counter;       // Incremented on each access (for LRU)
+    cacheBlock * blocks;        // Array of blocks
+};
+
+// Read from the underlying file (after the injected delay)
+static int cacheReadReal(cacheFile * file, void * buf, int bytes, sqlite3_int64 offset) {
+    if (readLatency > 0) {
+        baseVfs->xSleep(baseVfs, readLatency);
+    }
+    return file->real->pMethods->xRead(file->real, buf, bytes, offset);
+}
+
+// Returns the cached block starting at the given offset (or NULL if not cached)
+static cacheBlock * cacheFind(cacheFile * file, sqlite3_int64 offset) {
+    for (int i = 0; i < file->blockCount; i++) {
+        if (file->blocks[i].offset == offset) {
+            file->blocks[i].used = ++file->counter;
+            return &file->blocks[i];
+        }
+    }
+    return NULL;
+}
+
+// Returns the block starting at the given offset, reading it into the least
+// recently used block if needed. NULL is returned (and rc set) if the read fails,
+// or if every block is in use by a fetched page (rc is SQLITE_OK).
+static cacheBlock * cacheLoad(cacheFile * file, sqlite3_int64 offset, int * rc) {
+    *rc = SQLITE_OK;
+    cacheBlock * block = cacheFind(file, offset);
+    if (block) {
+        return block;
+    }
+
+    // Pick a victim which isn't pinned
+    for (int i = 0; i < file->blockCount; i++) {
+        cacheBlock * b = &file->blocks[i];
+        if (b->refs == 0 && (block == NULL || b->offset < 0 || (block->offset >= 0 && b->used < block->used))) {
+            block = b;
+        }
+    }
+    if (block == NULL) {
+        return NULL;
+    }
+
+    // Read the whole block in one go
+    block->offset = -1;
+    int tmp = cacheReadReal(file, block->data, file->blockSize, offset);
+    if (tmp == SQLITE_IOERR_SHORT_READ) {
+        // Find how much of the block is actually in the file
+        sqlite3_int64 size;
+        tmp = file->real->pMethods->xFileSize(file->real, &size);
+        if (tmp != SQLITE_OK) {
+            *rc = tmp;
+            return NULL;
+        }
+        block->size = (size > offset ? (int) (size - offset) : 0);
+
+    } else if (tmp != SQLITE_OK) {
+        *rc = tmp;
+        return NULL;
+
+    } else {
+        block->size = file->blockSize;
+    }
+
+    block->offset = offset;
+    block->used = ++file->counter;
+    return block;
+}
+
+// Close a file (freeing the cache)
+static int cacheClose(sqlite3_file * pFile) {
+    cacheFile * file = (cacheFile *) pFile;
+    if (file->blocks) {
+        sqlite3_free(file->blocks[0].data);
+        sqlite3_free(file->blocks);
+    }
+    return file->real->pMethods->xClose(file->real);
+}
+
+// Read data from a file, going through the cache
+static int cacheRead(sqlite3_file * pFile, void * buf, int bytes, sqlite_int64 offset) {
+    cacheFile * file = (cacheFile *) pFile;
+    if (file->blockCount == 0) {
+        return cacheReadReal(file, buf, bytes, offset);
+    }
+
+    // Copy from each block the read spans
+    char * out = (char *) buf;
+    while (bytes > 0) {
+        sqlite3_int64 start = offset - (offset % file->blockSize);
+        int rc;
+        cacheBlock * block = cacheLoad(file, start, &rc);
+        if (block == NULL) {
+            // Read the rest directly if everything is pinned
+            return (rc == SQLITE_OK ? cacheReadReal(file, out, bytes, offset) : rc);
+        }
+
+        // Zero-pad the remaining buffer if the file ends in this block
+        int pos = (int) (offset - start);
+        int copy = block->size - pos;
+        if (copy < bytes && block->size < file->blockSize) {
+            copy = (copy < 0 ? 0 : copy);
+            memcpy(out, &block->data[pos], copy);
+            memset(&out[copy], 0, bytes - copy);
+            return SQLITE_IOERR_SHORT_READ;
+        }
+
+        if (copy > bytes) {
+            copy = bytes;
+        }
+        memcpy(out, &block->data[pos], copy);
+        out += copy;
+        bytes -= copy;
+        offset += copy;
+    }
+
+    return SQLITE_OK;
+}
+
+// Write to a file and update any cached blocks it overlaps
+static int cacheWrite(sqlite3_file * pFile, const void * buf, int bytes, sqlite_int64 offset) {
+    cacheFile * file = (cacheFile *) pFile;
+    int rc = file->real->pMethods->xWrite(file->real, buf, bytes, offset);
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+
+    for (int i = 0; i < file->blockCount; i++) {
+        cacheBlock * block = &file->blocks[i];
+        if (block->offset < 0 || offset >= block->offset + file->blockSize || offset + bytes <= block->offset) {
+            continue;
+        }
+
+        // Drop the block if the write leaves a gap past the cached data
+        sqlite3_int64 start = (offset > block->offset ? offset : block->offset);
+        sqlite3_int64 end = (offset + bytes < block->offset + file->blockSize ? offset + bytes : block->offset + file->blockSize);
+        if (start > block->offset + block->size) {
+            block->offset = -1;
+            continue;
+        }
+
+        memcpy(&block->data[start - block->offset], &((const char *) buf)[start - offset], end - start);
+        if (end - block->offset > block->size) {
+            block->size = (int) (end - block->offset);
+        }
+    }
+
+    return SQLITE_OK;
+}
+
+// Truncate a file and drop anything cached past the new end
+static int cacheTruncate(sqlite3_file * pFile, sqlite_int64 size) {
+    cacheFile * file = (cacheFile *) pFile;
+    int rc = file->real->pMethods->xTruncate(file->real, size);
+    if (rc != SQLITE_OK) {
+        return rc;
+    }
+
+    for (int i = 0; i < file->blockCount; i++) {
+        cacheBlock * block = &file->blocks[i];
+        if (block->offset >= size) {
+            block->offset = -1;
+        } else if (block->offset >= 0 && block->offset + block->size > size) {
+            block->size = (int) (size - block->offset);
+        }
+    }
+
+    return SQLITE_OK;
+}
+
+// The remaining file methods are handled by the underlying file
+static int cacheSync(sqlite3_file * pFile, int flags) {
+    cacheFile * file = (cacheFile *) pFile;
+    return file->real->pMethods->xSync(file->real, flags);
+}
+static int cacheFileSize(sqlite3_file * pFile, sqlite_int64 * size) {
+    cacheFile * file = (cacheFile *) pFile;
+    return file->real->pMethods->xFileSize(file->real, size);
+}
+static int cacheLock(sqlite3_file * pFile, int lock) {
+    cacheFile * file = (cacheFile *) pFile;
+    return file->real->pMethods->xLock(file->real, lock);
+}
+static int cacheUnlock(sqlite3_file * pFile, int lock) {
+    cacheFile * file = (cacheFile *) pFile;
+    return file->real->pMethods->xUnlock(file->real, lock);
+}
+static int cacheCheckReservedLock(sqlite3_file * pFile, int * out) {
+    cacheFile * file = (cacheFile *) pFile;
+    return file->real->pMethods->xCheckReservedLock(file->real, out);
+}
+static int cacheSectorSize(sqlite3_file * pFile) {
+    cacheFile * file = (cacheFile *) pFile;
+    return file->real->pMethods->xSectorSize(file->real);
+}
+static int cacheDeviceCharacteristics(sqlite3_file * pFile) {
+    cacheFile * file = (cacheFile *) pFile;
+    return file->real->pMethods->xDeviceCharacteristics(file->real);
+}
+
+// Pages are fetched from the cache, so the underlying file must not map itself
+static int cacheFileControl(sqlite3_file * pFile, int op, void * arg) {
+    cacheFile * file = (cacheFile *) pFile;
+    if (op == SQLITE_FCNTL_MMAP_SIZE) {
+        return SQLITE_OK;
+    }
+    return file->real->pMethods->xFileControl(file->real, op, arg);
+}
+
+// Return a pointer to a page if it's entirely within a cached block
+// Setting the pointer to NULL makes SQLite fall back to cacheRead()
+static int cacheFetch(sqlite3_file * pFile, sqlite3_int64 offset, int bytes, void ** out) {
+    cacheFile * file = (cacheFile *) pFile;
+    *out = NULL;
+    if (!file->readOnly || file->blockCount == 0) {
+        return SQLITE_OK;
+    }
+
+    sqlite3_int64 start = offset - (offset % file->blockSize);
+    int pos = (int) (offset - start);
+    if (pos + bytes > file->blockSize) {
+        return SQLITE_OK;
+    }
+
+    int rc;
+    cacheBlock * block = cacheLoad(file, start, &rc);
+    if (block == NULL || pos + bytes > block->size) {
+        return rc;
+    }
+
+    block->refs++;
+    *out = &block->data[pos];
+    return SQLITE_OK;
+}
+
+// Release a page returned by cacheFetch()
+static int cacheUnfetch(sqlite3_file * pFile, sqlite3_int64 offset, void * page) {
+    cacheFile * file = (cacheFile *) pFile;
+    if (page == NULL) {
+        return SQLITE_OK;
+    }
+
+    cacheBlock * block = cacheFind(file, offset - (offset % file->blockSize));
+    if (block && block->refs > 0) {
+        block->refs--;
+    }
+    return SQLITE_OK;
+}
+
+// Open a file with the underlying VFS, and allocate a cache if it's the main database
+static int cacheOpen(sqlite3_vfs * vfs, const char * path, sqlite3_file * pFile, int flags, int * outFlags) {
+    static const sqlite3_io_methods cacheIO = {
+        3,                              // iVersion
+        cacheClose,                     // xClose
+        cacheRead,                      // xRead
+        cacheWrite,                     // xWrite
+        cacheTruncate,                  // xTruncate
+        cacheSync,                      // xSync
+        cacheFileSize,                  // xFileSize
+        cacheLock,                      // xLock
+        cacheUnlock,                    // xUnlock
+        cacheCheckReservedLock,         // xCheckReservedLock
+        cacheFileControl,               // xFileControl
+        cacheSectorSize,                // xSectorSize
+        cacheDeviceCharacteristics,     // xDeviceCharacteristics
+        NULL,                           // xShmMap (WAL is omitted)
+        NULL,                           // xShmLock
+        NULL,                           // xShmBarrier
+        NULL,                           // xShmUnmap
+        cacheFetch,                     // xFetch
+        cacheUnfetch                    // xUnfetch
+    };
+
+    cacheFile * file = (cacheFile *) pFile;
+    memset(file, 0, sizeof(cacheFile));
+    file->real = (sqlite3_file *) &file[1];
+    int rc = baseVfs->xOpen(baseVfs, path, file->real, flags, outFlags);
+    if (rc != SQLITE_OK) {
+        if (file->real->pMethods) {
+            file->real->pMethods->xClose(file->real);
+        }
+        return rc;
+    }
+
+    // Allocate all blocks at once (the file is left uncached if this fails)
+    if ((flags & SQLITE_OPEN_MAIN_DB) && cacheBlockCount > 0) {
+        file->blocks = (cacheBlock *) sqlite3_malloc(cacheBlockCount * sizeof(cacheBlock));
+        char * data = (char *) sqlite3_malloc64((sqlite3_uint64) cacheBlockCount * cacheBlockSize);
+        if (file->blocks && data) {
+            for (int i = 0; i < cacheBlockCount; i++) {
+                file->blocks[i].offset = -1;
+                file->blocks[i].size = 0;
+                file->blocks[i].refs = 0;
+                file->blocks[i].used = 0;
+                file->blocks[i].data = &data[(sqlite3_int64) i * cacheBlockSize];
+            }
+            file->blockSize = cacheBlockSize;
+            file->blockCount = cacheBlockCount;
+        } else {
+            sqlite3_free(file->blocks);
+            sqlite3_free(data);
+            file->blocks = NULL;
+        }
+    }
+    file->readOnly = (flags & SQLITE_OPEN_READONLY) != 0;
+
+    file->base.pMethods = &cacheIO;
+    return SQLITE_OK;
+}
+
+// All other VFS methods are handled by the underlying VFS
+static int cacheDelete(sqlite3_vfs * vfs, const char * path, int sync) {
+    return baseVfs->xDelete(baseVfs, path, sync);
+}
+static int cacheAccess(sqlite3_vfs * vfs, const char * path, int flags, int * out) {
+    return baseVfs->xAccess(baseVfs, path, flags, out);
+}
+static int cacheFullPathname(sqlite3_vfs * vfs, const char * path, int outBytes, char * outPath) {
+    return baseVfs->xFullPathname(baseVfs, path, outBytes, outPath);
+}
+static void * cacheDlOpen(sqlite3_vfs * vfs, const char * path) {
+    return baseVfs->xDlOpen(baseVfs, path);
+}
+static void cacheDlError(sqlite3_vfs * vfs, int bytes, char * err) {
+    baseVfs->xDlError(baseVfs, bytes, err);
+}
+static void (*cacheDlSym(sqlite3_vfs * vfs, void * handle, const char * z))(void) {
+    return baseVfs->xDlSym(baseVfs, handle, z);
+}
+static void cacheDlClose(sqlite3_vfs * vfs, void * handle) {
+    baseVfs->xDlClose(baseVfs, handle);
+}
+static int cacheRandomness(sqlite3_vfs * vfs, int bytes, char * buf) {
+    return baseVfs->xRandomness(baseVfs, bytes, buf);
+}
+static int cacheSleep(sqlite3_vfs * vfs, int usecs) {
+    return baseVfs->xSleep(baseVfs, usecs);
+}
+static int cacheCurrentTime(sqlite3_vfs * vfs, double * time) {
+    return baseVfs->xCurrentTime(baseVfs, time);
+}
+
+int sqlite3_cachevfs_register(const char * base, int blockSize, int blockCount) {
+    static sqlite3_vfs cachevfs = {
+        1,                              // iVersion
+        0,                              // szOsFile (set below)
+        0,                              // mxPathname (set below)
+        0,                              // pNext
+        SQLITE_CACHEVFS_NAME,           // zName
+        0,                              // pAppData
+        cacheOpen,                      // xOpen
+        cacheDelete,                    // xDelete
+        cacheAccess,                    // xAccess
+        cacheFullPathname,              // xFullPathname
+        cacheDlOpen,                    // xDlOpen
+        cacheDlError,                   // xDlError
+        cacheDlSym,                     // xDlSym
+        cacheDlClose,                   // xDlClose
+        cacheRandomness,                // xRandomness
+        cacheSleep,                     // xSleep
+        cacheCurrentTime,               // xCurrentTime
+    };
+
+    // Blocks must be a multiple of the largest page size so pages never span two
+    sqlite3_vfs * vfs = sqlite3_vfs_find(base);
+    if (vfs == NULL || vfs == &cachevfs || blockSize <= 0 || blockSize % 65536 != 0 || blockCount < 0) {
+        return SQLITE_MISUSE;
+    }
+
+    baseVfs = vfs;
+    cacheBlockSize = blockSize;
+    cacheBlockCount = blockCount;
+    cachevfs.szOsFile = sizeof(cacheFile) + baseVfs->szOsFile;
+    cachevfs.mxPathname = baseVfs->mxPathname;
+    return sqlite3_vfs_register(&cachevfs, 0);
+}
+
+void sqlite3_cachevfs_latency(int usecs) {
+    readLatency = usecs;
+}
\ No newline at end of file
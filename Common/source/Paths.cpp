@@ -10,6 +10,8 @@ namespace Path {
 
         const std::string DatabaseFile = Common::SwitchFolder + "data.sqlite3";
         const std::string DatabaseBackupFile = Common::SwitchFolder + "data_old.sqlite3";
+        const std::string PathIndexFile = Common::SwitchFolder + "paths.idx";
+        const std::string PlayJournalFile = Common::SwitchFolder + "plays.jnl";
     };
 
     namespace App {
@@ -1,7 +1,26 @@
+#include "cache-vfs.h"
 #include "Log.hpp"
 #include "SQLite.hpp"
 #include "utils/FS.hpp"
 
+// Number of virtual machine instructions executed between calls to the progress handler
+#define PROGRESS_INTERVAL 1000
+// Queries taking at least this long (in ms) also have their plan logged
+// (the benchmarks in Tools/benchmark set this to zero to log every plan)
+#ifndef SLOW_QUERY_TIME
+#define SLOW_QUERY_TIME 20
+#endif
+// VFS used to access the file, and the size of each block read by the cache (in bytes)
+// (the cache benchmark in Tools/benchmark layers the cache over "unix" and always reads through it,
+// so that the latency it injects applies when nothing is cached too)
+#ifndef BASE_VFS
+#define BASE_VFS "unix-none"
+#endif
+#ifndef ALWAYS_USE_READ_CACHE
+#define ALWAYS_USE_READ_CACHE 0
+#endif
+#define READ_CACHE_BLOCK_SIZE 65536
+
 SQLite::SQLite(const std::string & pth) {
     // Limit overlay and sysmodule memory usage (200KB)
     #if defined(_SYSMODULE_) || defined(_OVERLAY_)
@@ -17,8 +36,12 @@ SQLite::SQLite(const std::string & pth) {
     this->errorMsg_ = "";
     this->ignoreConstraints_ = false;
     this->inTransaction = false;
+    this->profileQuery = false;
     this->query = nullptr;
+    this->queryRows = 0;
     this->queryStatus = SQLite::Query::None;
+    this->queryTime = std::chrono::steady_clock::duration::zero();
+    this->readCacheBlocks = 0;
 }
 
 void SQLite::setErrorMsg(const std::string & msg = "") {
@@ -41,8 +64,33 @@ void SQLite::setErrorMsg(const std::string & msg = "") {
     Log::writeError("[SQLITE] " + this->errorMsg_);
 }
 
+void SQLite::logQueryPlan() {
+    sqlite3_stmt * plan = nullptr;
+    std::string qry = "EXPLAIN QUERY PLAN " + std::string(sqlite3_sql(this->query));
+    if (sqlite3_prepare_v2(this->db, qry.c_str(), -1, &plan, nullptr) != SQLITE_OK || plan == nullptr) {
+        return;
+    }
+
+    // Each row is a step in the plan, with the fourth column describing it
+    while (sqlite3_step(plan) == SQLITE_ROW) {
+        const unsigned char * detail = sqlite3_column_text(plan, 3);
+        if (detail != nullptr) {
+            Log::writeInfo("[SQLITE] PLAN\t" + std::string(reinterpret_cast<const char *>(detail)));
+        }
+    }
+    sqlite3_finalize(plan);
+}
+
 void SQLite::finalizeQuery() {
     if (this->queryStatus != SQLite::Query::None && this->query != nullptr) {
+        // Log as tab separated values so the log can be easily filtered/compared: time (ms), rows, query
+        if (this->profileQuery && this->queryStatus != SQLite::Query::Ready) {
+            std::chrono::duration<double, std::milli> time = this->queryTime;
+            Log::writeInfo("[SQLITE] QUERY\t" + std::to_string(time.count()) + "\t" + std::to_string(this->queryRows) + "\t" + std::string(sqlite3_sql(this->query)));
+            if (time.count() >= SLOW_QUERY_TIME) {
+                this->logQueryPlan();
+            }
+        }
         sqlite3_finalize(this->query);
     }
     this->query = nullptr;
@@ -72,6 +120,11 @@ bool SQLite::prepare() {
         this->setErrorMsg("An error occurred enabling foreign keys");
     }
 
+    // Let read-only connections use pages directly from the read cache instead of copying them
+    if (ok && this->readCacheBlocks > 0 && this->connectionType_ == SQLite::Connection::ReadOnly) {
+        ok = this->prepareAndExecuteQuery("PRAGMA mmap_size=" + std::to_string(this->readCacheBlocks * READ_CACHE_BLOCK_SIZE) + ";");
+    }
+
     return ok;
 }
 
@@ -97,6 +150,19 @@ void SQLite::ignoreConstraints(bool ign) {
     this->ignoreConstraints_ = ign;
 }
 
+void SQLite::setProgressHandler(int (*func)(void *), void * data) {
+    // Only attempt if we have a connection
+    if (this->connectionType_ == SQLite::Connection::None) {
+        return;
+    }
+
+    sqlite3_progress_handler(this->db, (func == nullptr ? 0 : PROGRESS_INTERVAL), func, data);
+}
+
+void SQLite::setReadCache(unsigned int kb) {
+    this->readCacheBlocks = (kb * 1024 + READ_CACHE_BLOCK_SIZE - 1) / READ_CACHE_BLOCK_SIZE;
+}
+
 SQLite::Connection SQLite::connectionType() {
     return this->connectionType_;
 }
@@ -135,11 +201,21 @@ bool SQLite::openConnection(Connection type) {
         return false;
     }
 
+    // Read through the block cache if one is wanted
+    const char * vfs = BASE_VFS;
+    if (this->readCacheBlocks > 0 || ALWAYS_USE_READ_CACHE) {
+        if (sqlite3_cachevfs_register(BASE_VFS, READ_CACHE_BLOCK_SIZE, this->readCacheBlocks) == SQLITE_OK) {
+            vfs = SQLITE_CACHEVFS_NAME;
+        } else {
+            Log::writeWarning("[SQLITE] Unable to set up the read cache");
+        }
+    }
+
     // Open correct type of connection
     this->connectionType_ = type;
     int result;
     if (type == SQLite::Connection::ReadOnly) {
-        result = sqlite3_open_v2(this->path.c_str(), &this->db, SQLITE_OPEN_READONLY, "unix-none");
+        result = sqlite3_open_v2(this->path.c_str(), &this->db, SQLITE_OPEN_READONLY, vfs);
         if (result != SQLITE_OK) {
             this->setErrorMsg();
             this->connectionType_ = SQLite::Connection::None;
@@ -148,7 +224,7 @@ bool SQLite::openConnection(Connection type) {
         }
 
     } else if (type == SQLite::Connection::ReadWrite) {
-        result = sqlite3_open_v2(this->path.c_str(), &this->db, SQLITE_OPEN_READWRITE, "unix-none");
+        result = sqlite3_open_v2(this->path.c_str(), &this->db, SQLITE_OPEN_READWRITE, vfs);
         if (result != SQLITE_OK) {
             this->setErrorMsg();
             this->connectionType_ = SQLite::Connection::None;
@@ -243,6 +319,9 @@ bool SQLite::prepareQuery(const std::string & qry) {
         return false;
     }
 
+    this->profileQuery = (Log::loggingLevel() == Log::Level::Info);
+    this->queryRows = 0;
+    this->queryTime = std::chrono::steady_clock::duration::zero();
     this->queryStatus = SQLite::Query::Ready;
     return true;
 }
@@ -281,8 +360,8 @@ bool SQLite::bindString(int col, const std::string & data) {
         return false;
     }
 
-    // Now bind
-    int result = sqlite3_bind_text(this->query, col+1, data.c_str(), -1, SQLITE_STATIC);
+    // Now bind (SQLite makes a copy, as the string may be a temporary which is gone by the time the query is run)
+    int result = sqlite3_bind_text(this->query, col+1, data.c_str(), data.length(), SQLITE_TRANSIENT);
     if (result != SQLITE_OK) {
         this->setErrorMsg();
         return false;
@@ -299,12 +378,24 @@ bool SQLite::executeQuery() {
     }
 
     // Perform the query
+    std::chrono::steady_clock::time_point start;
+    if (this->profileQuery) {
+        start = std::chrono::steady_clock::now();
+    }
     int result = sqlite3_step(this->query);
+    if (this->profileQuery) {
+        this->queryTime += std::chrono::steady_clock::now() - start;
+    }
     bool ignore = (this->ignoreConstraints_ && (result & 0x000000FF) == SQLITE_CONSTRAINT);
     if (result == SQLITE_DONE || ignore) {
         this->queryStatus = SQLite::Query::Finished;
     } else if (result == SQLITE_ROW) {
         this->queryStatus = SQLite::Query::Results;
+        this->queryRows++;
+    } else if (result == SQLITE_INTERRUPT) {
+        // Interrupted on purpose, so don't log an error
+        this->queryStatus = SQLite::Query::Finished;
+        return false;
     } else {
         this->queryStatus = SQLite::Query::Finished;
         this->setErrorMsg();
@@ -345,11 +436,77 @@ bool SQLite::getString(int col, std::string & data) {
         return false;
     }
 
+    // Assign using the known length to avoid a temporary copy (and handle NULL values)
+    const unsigned char * tmp = sqlite3_column_text(this->query, col);
+    if (tmp == nullptr) {
+        data.clear();
+    } else {
+        data.assign(reinterpret_cast<const char *>(tmp), sqlite3_column_bytes(this->query, col));
+    }
+    return true;
+}
+
+bool SQLite::getStringView(int col, std::string_view & data) {
+    // Check query status first
+    if (this->queryStatus != SQLite::Query::Results) {
+        this->setErrorMsg("Unable to get a string as no more rows are available");
+        return false;
+    }
+
     const unsigned char * tmp = sqlite3_column_text(this->query, col);
-    data = std::string(reinterpret_cast<const char *>(tmp));
+    if (tmp == nullptr) {
+        data = std::string_view();
+    } else {
+        data = std::string_view(reinterpret_cast<const char *>(tmp), sqlite3_column_bytes(this->query, col));
+    }
     return true;
 }
 
+bool SQLite::bindValue(int col, const bool data) {
+    return this->bindBool(col, data);
+}
+
+bool SQLite::bindValue(int col, const int data) {
+    return this->bindInt(col, data);
+}
+
+bool SQLite::bindValue(int col, const unsigned int data) {
+    return this->bindInt(col, data);
+}
+
+bool SQLite::bindValue(int col, const std::string & data) {
+    return this->bindString(col, data);
+}
+
+bool SQLite::bindValue(int col, const char * data) {
+    return this->bindString(col, data);
+}
+
+bool SQLite::getColumn(int col, bool & data) {
+    return this->getBool(col, data);
+}
+
+bool SQLite::getColumn(int col, int & data) {
+    return this->getInt(col, data);
+}
+
+bool SQLite::getColumn(int col, unsigned int & data) {
+    int tmp;
+    bool ok = this->getInt(col, tmp);
+    if (ok) {
+        data = tmp;
+    }
+    return ok;
+}
+
+bool SQLite::getColumn(int col, std::string & data) {
+    return this->getString(col, data);
+}
+
+bool SQLite::getColumn(int col, std::string_view & data) {
+    return this->getStringView(col, data);
+}
+
 bool SQLite::hasRow() {
     return (this->queryStatus == SQLite::Query::Results);
 }
@@ -362,8 +519,16 @@ bool SQLite::nextRow() {
     }
 
     // Attempt to move
+    std::chrono::steady_clock::time_point start;
+    if (this->profileQuery) {
+        start = std::chrono::steady_clock::now();
+    }
     int result = sqlite3_step(this->query);
+    if (this->profileQuery) {
+        this->queryTime += std::chrono::steady_clock::now() - start;
+    }
     if (result == SQLITE_ROW) {
+        this->queryRows++;
         return true;
     } else {
         this->queryStatus = SQLite::Query::Finished;
@@ -383,4 +548,4 @@ bool SQLite::prepareAndExecuteQuery(const std::string & qry) {
 SQLite::~SQLite() {
     // Cleans up both query and connection
     this->closeConnection();
-}
+}
\ No newline at end of file
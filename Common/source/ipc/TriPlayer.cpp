@@ -224,6 +224,46 @@ namespace TriPlayer {
         return (R_SUCCEEDED(serviceDispatchOut(service, static_cast<uint32_t>(Ipc::Command::GetSong), outID)));
     }
 
+    bool getNowPlaying(SongInfo & outCurrent, SongInfo & outNext) {
+        std::vector<char> buf(4096, 0);
+        Result rc = serviceDispatch(service, static_cast<uint32_t>(Ipc::Command::GetNowPlaying),
+            .buffer_attrs = {SfBufferAttr_Out | SfBufferAttr_HipcMapAlias},
+            .buffers = {{&buf[0], buf.size()}},
+        );
+        if (R_FAILED(rc)) {
+            return false;
+        }
+
+        // Each song is sent as: ID, duration, title, artist, album, image path
+        // Strings may have been cut off if they didn't fit, so never read past the end
+        size_t pos = 0;
+        auto readValue = [&buf, &pos](auto & value) {
+            if (pos + sizeof(value) <= buf.size()) {
+                memcpy(&value, &buf[pos], sizeof(value));
+            }
+            pos += sizeof(value);
+        };
+        auto readString = [&buf, &pos](std::string & str) {
+            str.clear();
+            if (pos < buf.size()) {
+                str = std::string(&buf[pos], strnlen(&buf[pos], buf.size() - pos));
+            }
+            pos += str.length() + 1;
+        };
+        for (SongInfo * info : {&outCurrent, &outNext}) {
+            info->ID = -1;
+            info->duration = 0;
+            readValue(info->ID);
+            readValue(info->duration);
+            readString(info->title);
+            readString(info->artist);
+            readString(info->album);
+            readString(info->imagePath);
+        }
+
+        return true;
+    }
+
     bool getStatus(Status & outStatus) {
         return (R_SUCCEEDED(serviceDispatchOut(service, static_cast<uint32_t>(Ipc::Command::GetStatus), outStatus)));
     }
@@ -1,3 +1,4 @@
+#include <cerrno>
 #include <cstdio>
 #include <filesystem>
 #include <fstream>
@@ -72,6 +73,20 @@ namespace Utils::Fs {
         std::filesystem::remove(path);
     }
 
+    bool moveFile(const std::string & src, const std::string & dst) {
+        // Renaming fails on the Switch if the destination exists, so remove it and try again
+        // (but only in that case, otherwise the destination would be lost for nothing)
+        errno = 0;
+        if (std::rename(src.c_str(), dst.c_str()) == 0) {
+            return true;
+        }
+        if (errno != EEXIST) {
+            return false;
+        }
+        deleteFile(dst);
+        return (std::rename(src.c_str(), dst.c_str()) == 0);
+    }
+
     bool readFile(const std::string & path, std::vector<unsigned char> & buffer) {
         // Open file
         std::FILE * fp = std::fopen(path.c_str(), "rb");
@@ -1,10 +1,10 @@
 #ifndef GUI_PLAYER_HPP
 #define GUI_PLAYER_HPP
 
+#include "ipc/TriPlayer.hpp"
 #include "tesla.hpp"
 
 // Forward declarations
-class Database;
 namespace Element {
     class Player;
 };
@@ -15,17 +15,19 @@ namespace Element {
 namespace Gui {
     class Player : public tsl::Gui {
         private:
-            Database * database;        // Database used to read metadata from
             Element::Player * player;   // Main element
             unsigned char ticks;        // Number of ticks in update() since last check
 
             int currentSongID;          // ID of song matching stored metadata
 
+            // Update the element to show the given song (or an error if not ok)
+            void updateMetadata(const bool, const TriPlayer::SongInfo &);
+
         public:
             // Initialize objects
-            Player(Database *);
+            Player();
 
-            // Accepts database object to read metadata from
+            // Create the player element
             tsl::elm::Element * createUI();
 
             // Periodically check if we need to update the element
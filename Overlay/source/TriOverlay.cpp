@@ -1,4 +1,3 @@
-#include "Database.hpp"
 #include "ipc/TriPlayer.hpp"
 #include "gui/Error.hpp"
 #include "gui/Player.hpp"
@@ -14,16 +13,9 @@ void TriOverlay::initServices() {
 
     // Attempt to connect to TriPlayer
     this->triInitialized = TriPlayer::initialize();
-
-    // Attempt to open connection to database to ensure it's working properly
-    this->database = new Database();
-    this->dbInitialized = this->database->openReadOnly();
-    this->database->close();
 }
 
 void TriOverlay::exitServices() {
-    delete this->database;
-
     if (this->triInitialized) {
         TriPlayer::exit();
         this->triInitialized = false;
@@ -34,10 +26,10 @@ void TriOverlay::exitServices() {
 
 std::unique_ptr<tsl::Gui> TriOverlay::loadInitialGui() {
     // Show error frame if service failed to initialize
-    if (!this->dbInitialized || !this->triInitialized) {
+    if (!this->triInitialized) {
         return std::make_unique<Gui::Error>();
     }
 
     // Otherwise proceed to normal (player) frame
-    return std::make_unique<Gui::Player>(this->database);
+    return std::make_unique<Gui::Player>();
 }
\ No newline at end of file
@@ -1,12 +1,10 @@
-#include "Database.hpp"
 #include "element/Player.hpp"
 #include "gui/Player.hpp"
 #include "ipc/TriPlayer.hpp"
 #include "utils/FS.hpp"
 
 namespace Gui {
-    Player::Player(Database * db) {
-        this->database = db;
+    Player::Player() {
         this->player = nullptr;
         this->currentSongID = -100;
         this->ticks = 0;
@@ -27,6 +25,27 @@ namespace Gui {
         return frame;
     }
 
+    void Player::updateMetadata(const bool ok, const TriPlayer::SongInfo & info) {
+        // Update values
+        if (!ok || info.ID < 0) {
+            this->player->setTitle((!ok ? "An error occurred" : "Nothing playing!"));
+            this->player->setArtist((!ok ? "Please restart the overlay" : "Play a song"));
+            this->player->setDuration(0);
+
+        } else {
+            this->player->setTitle(info.title);
+            this->player->setArtist(info.artist);
+            this->player->setDuration(info.duration);
+        }
+
+        // Set new album art (an empty vector will cause default art to be shown)
+        std::vector<uint8_t> buffer;
+        if (ok && !info.imagePath.empty() && !Utils::Fs::readFile(info.imagePath, buffer)) {
+            buffer.clear();
+        }
+        this->player->setAlbumArt(buffer);
+    }
+
     void Player::update() {
         // Only update 10 times per second
         if (this->ticks < 6) {
@@ -41,37 +60,16 @@ namespace Gui {
             return;
         }
         if (songID != this->currentSongID) {
-            // Get metadata from database
-            Metadata meta;
-            meta.id = -3;
-            if (songID >= 0) {
-                // Open a very brief connection to the database to fetch id
-                bool ok = this->database->openReadOnly();
-                if (ok) {
-                    meta = this->database->getMetadataForID(songID);
-                    this->database->close();
-                }
-            }
-            this->currentSongID = songID;
-
-            // Update values
-            if (meta.id < 0) {
-                this->player->setTitle((meta.id == -2 ? "An error occurred" : "Nothing playing!"));
-                this->player->setArtist((meta.id == -2 ? "Please restart the overlay" : "Play a song"));
-                this->player->setDuration(0);
-
-            } else {
-                this->player->setTitle(meta.title);
-                this->player->setArtist(meta.artist);
-                this->player->setDuration(meta.duration);
-            }
+            // Get metadata from the sysmodule
+            TriPlayer::SongInfo info, next;
+            bool ok = TriPlayer::getNowPlaying(info, next);
 
-            // Set new album art (an empty vector will cause default art to be shown)
-            std::vector<uint8_t> buffer;
-            if (!meta.imagePath.empty() && !Utils::Fs::readFile(meta.imagePath, buffer)) {
-                buffer.clear();
+            // The sysmodule may not have read the info yet (i.e. the database is locked),
+            // in which case leave the old values and try again next time
+            if (!ok || songID < 0 || info.ID == songID) {
+                this->currentSongID = songID;
+                this->updateMetadata(ok, info);
             }
-            this->player->setAlbumArt(buffer);
         }
 
         // Check playback status
@@ -1,33 +1,44 @@
 #ifndef DATABASE_HPP
 #define DATABASE_HPP
 
-#include "SQLite.hpp"
+#include <cstdio>
+#include "PathIndex.hpp"
 #include "Types.hpp"
+#include <string>
+#include <vector>
 
-// The Database class interacts with the database stored on the sd card
-// to read/write data. All queries have a way of detecting if they failed.
+// The Database class looks up song paths using the path index exported by the application
+// (see PathIndex.hpp), so that the sysmodule never needs to open the actual database.
 class Database {
     private:
-        // Interface to database
-        SQLite * db;
-
-        // Private queries
-        bool getVersion(int &);
-        bool matchingVersion();
+        // Index file (nullptr if not open)
+        std::FILE * file;
+        // First ID of each block of entries
+        std::vector<int32_t> fences;
+        // Number of entries
+        uint32_t entries;
+        // Offsets of the entries and paths within the file
+        long entriesOffset;
+        long recordsOffset;
+
+        // Reads the record for the given ID (returns false if not found or an error occurred)
+        bool readRecord(SongID, PathIndex::Entry &, std::string &);
 
     public:
-        // Constructor creates + 'migrates' the database to a newer version if needed
+        // Constructor does not open the index
         Database();
 
-        // Open the database read-write (will block until available)
-        bool openReadOnly();
-        // Open the database read-only (will block until available)
-        bool openReadWrite();
-        // Close a open connection (if there is one)
+        // Open the index (does nothing if already open)
+        // Returns false if it doesn't exist or is an unsupported version
+        bool open();
+        // Close the index (if it's open)
         void close();
 
         // Return a path matching given ID (or blank if not found)
         std::string getPathForID(SongID);
+        // Fills the struct with info about the given song
+        // Returns false if not found or an error occurred
+        bool getInfoForID(SongID, SongInfo &);
 
         // Destructor closes handle
         ~Database();
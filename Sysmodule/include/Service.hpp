@@ -70,6 +70,11 @@ class MainService {
         std::shared_mutex sqMutex;
         // Source currently playing
         Source::Source * source;
+        // ID of the song the source is playing, and the time it was started
+        SongID sourceID;
+        std::time_t sourceStart;
+        // Appends an event for the current source to the play journal (source must be locked)
+        void logPlay();
 
         // Mutex for access combo strings
         std::shared_mutex cMutex;
@@ -83,6 +88,18 @@ class MainService {
         std::mutex dbMutex;
         std::atomic<bool> dbLocked;
 
+        // Cached info for the current and next songs (read from the path index)
+        std::mutex infoMutex;
+        SongInfo currentInfo;
+        SongInfo nextInfo;
+
+        // Returns the ID of the song that will be played next (-1 if none)
+        // The queue and sub-queue must be locked
+        SongID nextSongID();
+        // Updates the cached info if the current/next songs have changed
+        // The database must be locked and open
+        void updateSongInfo(const SongID, const SongID);
+
         // Reads config from disk and sets up relevant objects
         void updateConfig();
 
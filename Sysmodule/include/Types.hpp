@@ -1,6 +1,8 @@
 #ifndef TYPES_HPP
 #define TYPES_HPP
 
+#include <string>
+
 // Format of decoded samples (values match libnx)
 enum class Format {
     Int8 = 1,       // 8 bit integer
@@ -18,4 +20,14 @@ enum class RepeatMode {
 
 typedef int SongID;
 
+// Information about a song which is passed on to clients
+struct SongInfo {
+    SongID ID;                  // ID of song (negative if unknown)
+    std::string title;
+    std::string artist;
+    std::string album;
+    unsigned int duration;      // Duration in seconds
+    std::string imagePath;      // Path to album art
+};
+
 #endif
\ No newline at end of file
@@ -1,107 +1,147 @@
+#include <algorithm>
 #include "Database.hpp"
 #include "Log.hpp"
 #include "Paths.hpp"
 
-// Version of the database (database begins with zero from 'template', so this started at 1)
-#define DB_VERSION 7
-
-// Custom boolean 'operator' which instead of 'keeping' true, will 'keep' false
-bool keepFalse(const bool & a, const bool & b) {
-    return !(!a || !b);
-}
-
 Database::Database() {
-    // Create the database object
-    this->db = new SQLite(Path::Common::DatabaseFile);
+    this->file = nullptr;
+    this->entries = 0;
+    this->entriesOffset = 0;
+    this->recordsOffset = 0;
 }
 
-bool Database::getVersion(int & version) {
-    bool ok = this->db->prepareQuery("SELECT value FROM Variables WHERE name = 'version';");
-    if (ok) {
-        ok = this->db->executeQuery();
-    }
-    if (ok) {
-        ok = this->db->getInt(0, version);
+bool Database::open() {
+    if (this->file != nullptr) {
+        return true;
     }
 
-    // Update error if there was one
-    if (!ok) {
-        Log::writeError("[DB] Unable to get the database's version");
+    // Reads are small and random so don't bother buffering them
+    this->file = std::fopen(Path::Common::PathIndexFile.c_str(), "rb");
+    if (this->file == nullptr) {
+        Log::writeError("[DB] Unable to open the path index, has the application been launched?");
+        return false;
     }
-    return ok;
-}
+    std::setvbuf(this->file, nullptr, _IONBF, 0);
 
-bool Database::matchingVersion() {
-    int version;
-    if (!this->getVersion(version)) {
+    // Check the header
+    PathIndex::Header header;
+    if (std::fread(&header, sizeof(PathIndex::Header), 1, this->file) != 1 || header.magic != PathIndex::Magic) {
+        Log::writeError("[DB] The path index is invalid");
+        this->close();
         return false;
     }
-    if (version != DB_VERSION) {
+    if (header.version != PathIndex::Version) {
+        Log::writeError("[DB] Version mismatch! Please check that the sysmodule is up to date! (Index: " + std::to_string(header.version) + ", Supports: " + std::to_string(PathIndex::Version) + ")");
         this->close();
-        Log::writeError("[DB] Version mismatch! Please check that the sysmodule is up to date! (Database: " + std::to_string(version) + ", Supports: " + std::to_string(DB_VERSION) + ")");
         return false;
     }
 
+    // Only the fences are kept in memory
+    this->fences.resize(header.fences);
+    if (std::fread(this->fences.data(), sizeof(int32_t), header.fences, this->file) != header.fences) {
+        Log::writeError("[DB] Unable to read the path index");
+        this->close();
+        return false;
+    }
+    this->fences.shrink_to_fit();
+    this->entries = header.entries;
+    this->entriesOffset = sizeof(PathIndex::Header) + header.fences * sizeof(int32_t);
+    this->recordsOffset = this->entriesOffset + header.entries * sizeof(PathIndex::Entry);
     return true;
 }
 
-// ============================ //
-//       PUBLIC FUNCTIONS       //
-// ============================ //
-bool Database::openReadWrite() {
-    if (!this->db->openConnection(SQLite::Connection::ReadWrite)) {
-        return false;
+void Database::close() {
+    if (this->file != nullptr) {
+        std::fclose(this->file);
+        this->file = nullptr;
     }
+    this->fences.clear();
+    this->fences.shrink_to_fit();
+    this->entries = 0;
+}
 
-    // Close if version is not supported
-    if (!this->matchingVersion()) {
-        this->close();
+bool Database::readRecord(SongID id, PathIndex::Entry & entry, std::string & record) {
+    // Check we can read
+    if (this->file == nullptr) {
+        Log::writeError("[DB] The path index isn't open");
         return false;
     }
 
-    return true;
-}
+    // Find the block which would contain the ID
+    std::vector<int32_t>::iterator it = std::upper_bound(this->fences.begin(), this->fences.end(), id);
+    if (it == this->fences.begin()) {
+        Log::writeError("[DB] No song found for ID: " + std::to_string(id));
+        return false;
+    }
+    size_t first = (it - this->fences.begin() - 1) * PathIndex::BlockSize;
+    size_t count = std::min(static_cast<size_t>(PathIndex::BlockSize), this->entries - first);
 
-bool Database::openReadOnly() {
-    if (!this->db->openConnection(SQLite::Connection::ReadOnly)) {
+    // Read the whole block and search it
+    std::vector<PathIndex::Entry> block(count);
+    bool ok = (std::fseek(this->file, this->entriesOffset + first * sizeof(PathIndex::Entry), SEEK_SET) == 0);
+    ok = ok && (std::fread(block.data(), sizeof(PathIndex::Entry), count, this->file) == count);
+    if (!ok) {
+        Log::writeError("[DB] An error occurred reading the path index");
         return false;
     }
+    std::vector<PathIndex::Entry>::iterator match = std::lower_bound(block.begin(), block.end(), id, [](const PathIndex::Entry & e, const SongID id) {
+        return e.id < id;
+    });
+    if (match == block.end() || match->id != id) {
+        Log::writeError("[DB] No song found for ID: " + std::to_string(id));
+        return false;
+    }
+    entry = *match;
 
-    // Close if version is not supported
-    if (!this->matchingVersion()) {
-        this->close();
+    // Finally read the record
+    record = std::string(entry.length, '\0');
+    ok = (std::fseek(this->file, this->recordsOffset + entry.offset, SEEK_SET) == 0);
+    ok = ok && (std::fread(&record[0], sizeof(char), entry.length, this->file) == entry.length);
+    if (!ok) {
+        Log::writeError("[DB] An error occurred reading the record for ID: " + std::to_string(id));
         return false;
     }
 
     return true;
 }
 
-void Database::close() {
-    this->db->closeConnection();
-}
-
 std::string Database::getPathForID(SongID id) {
-    // Check we can read
-    if (this->db->connectionType() == SQLite::Connection::None) {
-        Log::writeError("[DB] [getPathForID] No open connection");
-        return "";
-    }
-
-    // Query path
-    std::string path;
-    bool ok = this->db->prepareQuery("SELECT path FROM Songs WHERE id = ?;");
-    ok = keepFalse(ok, this->db->bindInt(0, id));
-    ok = keepFalse(ok, this->db->executeQuery());
-    ok = keepFalse(ok, this->db->getString(0, path));
-    if (!ok) {
-        Log::writeError("[DB] [getPathForID] An error occurred querying the path");
+    PathIndex::Entry entry;
+    std::string record;
+    if (!this->readRecord(id, entry, record)) {
         return "";
     }
 
+    // Path is the first string
+    std::string path(record.c_str());
     path.shrink_to_fit();
     return path;
 }
 
+bool Database::getInfoForID(SongID id, SongInfo & info) {
+    PathIndex::Entry entry;
+    std::string record;
+    if (!this->readRecord(id, entry, record)) {
+        return false;
+    }
+
+    // Split the record into its strings
+    std::string strings[5];
+    size_t pos = 0;
+    for (size_t i = 0; i < 5 && pos < record.length(); i++) {
+        strings[i] = std::string(record.c_str() + pos);
+        pos += strings[i].length() + 1;
+    }
+
+    info.ID = id;
+    info.title = strings[1];
+    info.artist = strings[2];
+    info.album = strings[3];
+    info.duration = entry.duration;
+    info.imagePath = strings[4];
+    return true;
+}
+
 Database::~Database() {
     this->close();
 }
\ No newline at end of file
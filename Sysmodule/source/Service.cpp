@@ -1,9 +1,12 @@
+#include <algorithm>
+#include <cmath>
 #include "Config.hpp"
 #include "Database.hpp"
 #include "ipc/TriPlayer.hpp"
 #include "nx/Audio.hpp"
 #include "nx/NX.hpp"
 #include "Paths.hpp"
+#include "PlayJournal.hpp"
 #include "PlayQueue.hpp"
 #include "Service.hpp"
 #include "source/Factory.hpp"
@@ -22,13 +25,19 @@
 MainService::MainService() {
     this->audio = Audio::getInstance();
     this->combosUpdated = false;
+    this->currentInfo.ID = -1;
+    this->currentInfo.duration = 0;
     this->dbLocked = false;
     this->muteLevel = 0.0;
+    this->nextInfo.ID = -1;
+    this->nextInfo.duration = 0;
     this->pressTime = std::time(nullptr);
     this->queue = new PlayQueue();
     this->repeatMode = RepeatMode::Off;
     this->seekTo = -1;
     this->source = nullptr;
+    this->sourceID = -1;
+    this->sourceStart = 0;
     this->songAction = SongAction::Nothing;
 
     // Read and set config
@@ -424,6 +433,39 @@ Ipc::Result MainService::commandThread(Ipc::Request * request) {
             break;
         }
 
+        case Ipc::Command::GetNowPlaying: {
+            // Work out which songs are current/next
+            SongID current, next;
+            {
+                std::shared_lock<std::shared_mutex> sqMtx(this->sqMutex);
+                std::shared_lock<std::shared_mutex> qMtx(this->qMutex);
+                current = this->queue->currentID();
+                next = this->nextSongID();
+            }
+
+            // Update the cache if needed, unless the database is in use (in which case the client can ask again later)
+            {
+                std::unique_lock<std::mutex> mtx(this->dbMutex, std::try_to_lock);
+                if (mtx.owns_lock() && !this->dbLocked && this->db->open()) {
+                    this->updateSongInfo(current, next);
+                }
+            }
+
+            // Reply with both songs, setting a negative ID if the info is not yet available
+            std::scoped_lock<std::mutex> mtx(this->infoMutex);
+            auto appendInfo = [request](const SongInfo & info, const SongID id) {
+                request->appendReplyData(info.ID == id ? id : static_cast<SongID>(-1));
+                request->appendReplyData(info.duration);
+                request->appendReplyData(info.title);
+                request->appendReplyData(info.artist);
+                request->appendReplyData(info.album);
+                request->appendReplyData(info.imagePath);
+            };
+            appendInfo(this->currentInfo, current);
+            appendInfo(this->nextInfo, next);
+            break;
+        }
+
         case Ipc::Command::GetStatus: {
             TriPlayer::Status s = TriPlayer::Status::Error;
 
@@ -500,7 +542,7 @@ Ipc::Result MainService::commandThread(Ipc::Request * request) {
         }
 
         // Lock the mutex and mark that the database is being used for writing by the app
-        // Once we lock the mutex the decode thread is guaranteed to not be using the DB
+        // Once we lock the mutex the decode thread is guaranteed to not be using the path index (which is rewritten afterwards)
         case Ipc::Command::RequestDBLock: {
             std::scoped_lock<std::mutex> mtx(this->dbMutex);
             this->db->close();
@@ -526,8 +568,14 @@ Ipc::Result MainService::commandThread(Ipc::Request * request) {
 
             // Ensure we're disconnected from the DB
             this->db->close();
+            {
+                std::scoped_lock<std::mutex> iMtx(this->infoMutex);
+                this->currentInfo.ID = -1;
+                this->nextInfo.ID = -1;
+            }
 
             // Stop playback and empty queues
+            this->logPlay();
             this->audio->stop();
             this->queue->clear();
             this->subQueue.clear();
@@ -547,6 +595,41 @@ Ipc::Result MainService::commandThread(Ipc::Request * request) {
     return Ipc::Result::Ok;
 }
 
+SongID MainService::nextSongID() {
+    // Songs in the sub-queue are always played next
+    if (!this->subQueue.empty()) {
+        return this->subQueue.front();
+    }
+
+    // Otherwise it's the next song in the queue (wrapping around if repeat is on)
+    if (this->queue->currentIdx() + 1 >= this->queue->size()) {
+        return (this->repeatMode != RepeatMode::Off && this->queue->size() > 0 ? this->queue->IDatPosition(0) : -1);
+    }
+    return this->queue->IDatPosition(this->queue->currentIdx() + 1);
+}
+
+void MainService::updateSongInfo(const SongID current, const SongID next) {
+    std::scoped_lock<std::mutex> mtx(this->infoMutex);
+
+    // Update current song, reusing the old 'next' info if we've moved on to it
+    if (this->currentInfo.ID != current || current < 0) {
+        if (current >= 0 && this->nextInfo.ID == current) {
+            this->currentInfo = this->nextInfo;
+        } else if (current < 0 || !this->db->getInfoForID(current, this->currentInfo)) {
+            this->currentInfo.ID = -1;
+        }
+    }
+
+    // Update next song
+    if (this->nextInfo.ID != next || next < 0) {
+        if (next >= 0 && this->currentInfo.ID == next) {
+            this->nextInfo = this->currentInfo;
+        } else if (next < 0 || !this->db->getInfoForID(next, this->nextInfo)) {
+            this->nextInfo.ID = -1;
+        }
+    }
+}
+
 void MainService::exit() {
     this->exit_ = true;
 }
@@ -666,6 +749,32 @@ void MainService::ipcThread() {
     }
 }
 
+void MainService::logPlay() {
+    // Nothing to record if a song wasn't playing
+    if (this->source == nullptr || !this->source->valid() || this->sourceID < 0) {
+        return;
+    }
+
+    // Work out how much was played, a song is only skipped if it was changed before finishing
+    PlayJournal::Event event;
+    event.songID = this->sourceID;
+    event.time = this->sourceStart;
+    event.percent = 0;
+    if (this->source->totalSamples() > 0) {
+        double played = static_cast<double>(this->audio->samplesPlayed()) / this->source->totalSamples();
+        event.percent = static_cast<uint8_t>(std::round(std::clamp(played, 0.0, 1.0) * 100));
+    }
+    event.skipped = (this->source->done() ? 0 : 1);
+    event.reserved = 0;
+    this->sourceID = -1;
+
+    // The application adds these to the database the next time it's launched
+    const unsigned char * bytes = reinterpret_cast<const unsigned char *>(&event);
+    if (!Utils::Fs::appendFile(Path::Common::PlayJournalFile, std::vector<unsigned char>(bytes, bytes + sizeof(PlayJournal::Event)))) {
+        Log::writeWarning("[JOURNAL] Unable to record play of song with ID: " + std::to_string(event.songID));
+    }
+}
+
 void MainService::playbackThread() {
     // Request a higher priority for FS access
     NX::Fs::setHighPriority(true);
@@ -737,17 +846,19 @@ void MainService::playbackThread() {
                     }
                 }
 
-                // Now that the database is available actually read from it (note that this read-only connection
-                // is left intact until either RESET or REQUESTDBLOCK is received)
-                if (!this->db->openReadOnly()) {
-                    this->exit_ = true;
-                }
+                // Now that the path index is available actually read from it (note that it is left
+                // open until either RESET or REQUESTDBLOCK is received)
+                this->db->open();
                 std::string path = this->db->getPathForID(this->queue->currentID());
+                this->updateSongInfo(this->queue->currentID(), this->nextSongID());
                 mtx.unlock();
 
                 // Delete old source and prepare a new one
+                this->logPlay();
                 delete this->source;
                 this->source = Source::Factory::getSource(path);
+                this->sourceID = this->queue->currentID();
+                this->sourceStart = std::time(nullptr);
 
                 // Skip to next song if renderer didn't init successfully
                 if (this->source != nullptr) {
@@ -824,7 +935,9 @@ void MainService::playbackThread() {
                 qMtx.unlock();
                 sqMtx.unlock();
 
+                // Record the last song now that the queue has ended (it won't be logged again as logPlay() forgets it)
                 if (this->songAction == SongAction::Nothing) {
+                    this->logPlay();
                     sleep = true;
                 }
             }
@@ -861,6 +974,9 @@ void MainService::sleepEventThread() {
 }
 
 MainService::~MainService() {
+    // Record the song that was playing when the sysmodule was stopped
+    this->logPlay();
+
     delete this->cfg;
     delete this->db;
     delete this->ipcServer;
@@ -0,0 +1,52 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <functional>
+#include <string>
+#include "Types.hpp"
+#include <vector>
+
+// Helpers shared by the host benchmarks. Results are printed to stdout as tab separated
+// values (a header line followed by one line per measurement) so runs can be diffed or
+// loaded into a spreadsheet, while progress and errors are printed to stderr.
+namespace Benchmark {
+    // Summary of an action which was timed one or more times (times are in milliseconds)
+    struct Result {
+        unsigned int runs;          // Number of times the action was run
+        double mean;                // Mean time of each run
+        double median;              // Median time of each run
+        double min;                 // Fastest run
+        double max;                 // Slowest run
+        bool ok;                    // Set false if any run returned false
+    };
+
+    // Runs the given function the given number of times, stopping early if it returns false
+    Result time(const std::function<bool()> &, const unsigned int);
+
+    // Print the names of each column, or a row of values
+    void printHeader(const std::vector<std::string> &);
+    void printRow(const std::vector<std::string> &);
+    // Print a row made up of the given values followed by the result's columns
+    // (runs, mean, median, min, max, ok), matching resultColumns()
+    void printResult(const std::vector<std::string> &, const Result &);
+    std::vector<std::string> resultColumns();
+
+    // Print a progress message/error to stderr (the latter also exits)
+    void progress(const std::string &);
+    void fail(const std::string &);
+
+    // Returns a made up word (or several separated by spaces) for the given number
+    // The same number always gives the same word(s), so every run uses the same data
+    std::string word(size_t);
+    std::string words(size_t, size_t);
+
+    // Returns the metadata of a library with the given number of songs. Albums have 1-20 songs
+    // and artists have 1-8 albums, with some songs credited to a second artist
+    std::vector<Metadata::Song> makeLibrary(const size_t);
+
+    // Removes anything stored by a previous run and recreates the data folder (Path::Common::SwitchFolder),
+    // copying the template database into it
+    void resetData();
+};
+
+#endif
\ No newline at end of file
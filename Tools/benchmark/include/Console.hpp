@@ -0,0 +1,19 @@
+#ifndef CONSOLE_HPP
+#define CONSOLE_HPP
+
+// Makes the host behave a little more like the console when benchmarking the library scanner.
+// The application is given three cores, so std::thread::hardware_concurrency() reports three
+// regardless of the host. Reading a song's metadata, opening a directory and reading a file's
+// status all wait as if they were accessing the sd card.
+namespace Console {
+    // Set the time (in microseconds) to wait each time a song's metadata is read
+    void setReadLatency(const unsigned int);
+
+    // Set the time (in microseconds) to wait each time a directory is opened or a file's status is read
+    void setFsLatency(const unsigned int);
+
+    // Waits for the read latency set above
+    void waitForRead();
+};
+
+#endif
\ No newline at end of file
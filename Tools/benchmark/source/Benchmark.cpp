@@ -0,0 +1,155 @@
+#include <algorithm>
+#include "Benchmark.hpp"
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include "Paths.hpp"
+#include <random>
+#include "utils/FS.hpp"
+
+// Letters which words are made from (a consonant, a vowel, then sometimes another consonant
+// for each syllable), which gives a realistic spread of trigrams for searching
+static const std::string consonants = "bcdfghjklmnprstvwyz";
+static const std::string vowels = "aeiou";
+
+namespace Benchmark {
+    Result time(const std::function<bool()> & func, const unsigned int runs) {
+        Result result = {0, 0, 0, 0, 0, true};
+        std::vector<double> times;
+        for (unsigned int i = 0; i < runs && result.ok; i++) {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            result.ok = func();
+            std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+            times.push_back(time.count());
+        }
+
+        std::sort(times.begin(), times.end());
+        result.runs = times.size();
+        for (double t : times) {
+            result.mean += t / times.size();
+        }
+        result.median = times[times.size() / 2];
+        result.min = times.front();
+        result.max = times.back();
+        return result;
+    }
+
+    void printHeader(const std::vector<std::string> & columns) {
+        printRow(columns);
+    }
+
+    void printRow(const std::vector<std::string> & values) {
+        std::string line = "";
+        for (size_t i = 0; i < values.size(); i++) {
+            line += (i == 0 ? "" : "\t") + values[i];
+        }
+        std::printf("%s\n", line.c_str());
+        std::fflush(stdout);
+    }
+
+    void printResult(const std::vector<std::string> & values, const Result & result) {
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "%u\t%.3f\t%.3f\t%.3f\t%.3f\t%d", result.runs, result.mean, result.median, result.min, result.max, result.ok ? 1 : 0);
+        std::vector<std::string> row = values;
+        row.push_back(buf);
+        printRow(row);
+    }
+
+    std::vector<std::string> resultColumns() {
+        return {"runs", "mean_ms", "median_ms", "min_ms", "max_ms", "ok"};
+    }
+
+    void progress(const std::string & msg) {
+        std::fprintf(stderr, "%s\n", msg.c_str());
+    }
+
+    void fail(const std::string & msg) {
+        std::fprintf(stderr, "Error: %s\n", msg.c_str());
+        std::exit(1);
+    }
+
+    std::string word(size_t num) {
+        // Mix the number so neighbouring numbers don't share syllables
+        std::mt19937 rng(num);
+        size_t count = 1 + rng() % 3;
+        std::string str = "";
+        for (size_t i = 0; i < count; i++) {
+            str += consonants[rng() % consonants.length()];
+            str += vowels[rng() % vowels.length()];
+            if (rng() % 2 == 0) {
+                str += consonants[rng() % consonants.length()];
+            }
+        }
+        str[0] = std::toupper(str[0]);
+        return str;
+    }
+
+    std::string words(size_t num, size_t count) {
+        std::string str = "";
+        for (size_t i = 0; i < count; i++) {
+            str += (i == 0 ? "" : " ") + word(num * 8 + i);
+        }
+        return str;
+    }
+
+    std::vector<Metadata::Song> makeLibrary(const size_t count) {
+        std::vector<Metadata::Song> songs;
+        std::mt19937 rng(count);
+
+        size_t album = 0;
+        size_t artist = 0;
+        size_t albumsLeft = 0;
+        while (songs.size() < count) {
+            // Move to the next artist once they have no albums left
+            if (albumsLeft == 0) {
+                artist++;
+                albumsLeft = 1 + rng() % 8;
+            }
+            albumsLeft--;
+            album++;
+
+            std::string artistName = words(artist, 1 + artist % 2);
+            std::string albumName = words(1000000 + album, 1 + album % 3);
+            size_t tracks = std::min<size_t>(1 + rng() % 20, count - songs.size());
+            for (size_t track = 1; track <= tracks; track++) {
+                Metadata::Song m;
+                m.ID = -1;
+                m.title = words(2000000 + songs.size(), 1 + rng() % 4);
+                m.artist = artistName;
+                if (rng() % 15 == 0) {
+                    m.artist += " & " + words(1 + rng() % artist, 1);
+                }
+                m.album = albumName;
+                m.trackNumber = track;
+                m.discNumber = 1;
+                m.duration = 90 + rng() % 400;
+                m.plays = 0;
+                m.favourite = false;
+                m.path = "/music/" + artistName + "/" + albumName + "/" + std::to_string(track) + " " + m.title + ".mp3";
+                m.format = AudioFormat::MP3;
+                m.modified = 1600000000 + rng() % 100000000;
+                std::string fingerprint = std::to_string(rng()) + std::to_string(rng());
+#ifndef SPELLFIX_SEARCH
+                // The spellfix search predates fingerprints, but the same numbers are drawn to keep the library identical
+                m.fingerprint = fingerprint;
+#endif
+                songs.push_back(m);
+            }
+        }
+
+        return songs;
+    }
+
+    void resetData() {
+        std::error_code err;
+        std::filesystem::remove_all(Path::Common::SwitchFolder, err);
+        if (!Utils::Fs::createPath(Path::Common::SwitchFolder)) {
+            fail("Unable to create " + Path::Common::SwitchFolder);
+        }
+        if (!Utils::Fs::copyFile(TEMPLATE_DATABASE, Path::Common::DatabaseFile)) {
+            fail("Unable to copy the template database from " + std::string(TEMPLATE_DATABASE));
+        }
+    }
+};
\ No newline at end of file
@@ -0,0 +1,87 @@
+// Times reading a synthetic library through the read cache with different cache sizes, while each
+// read which reaches the file is delayed to imitate the SD card.
+// Usage: cache [songs] [latency] (defaults to a library of 20000 songs, and 500us per read)
+//
+// SQLite.cpp is built for this benchmark with the cache layered over the "unix" VFS, and reading
+// through it even when the size is 0 (in which case every read reaches the file). A row is printed
+// for each cache size and method. The connection is kept open between runs (as the application
+// does), so the first run reads into an empty cache and is the slowest. SQLite's own page cache is
+// left at its default size.
+#include "Benchmark.hpp"
+#include "cache-vfs.h"
+#include "db/Database.hpp"
+
+// Number of times to run each method
+#define RUNS 5
+
+int main(int argc, char * argv[]) {
+    size_t count = (argc > 1 ? std::stoul(argv[1]) : 20000);
+    int latency = (argc > 2 ? std::stoi(argv[2]) : 500);
+    std::string songCount = std::to_string(count);
+    Benchmark::progress("Creating a library of " + songCount + " songs...");
+    Benchmark::resetData();
+    std::vector<Metadata::Song> songs = Benchmark::makeLibrary(count);
+
+    Database db;
+    if (!db.migrate() || !db.openReadWrite()) {
+        Benchmark::fail("Unable to open the database: " + db.error());
+    }
+    bool ok = db.beginTransaction();
+    for (size_t i = 0; i < songs.size() && ok; i++) {
+        ok = db.addSong(songs[i]);
+    }
+    ok = (ok && db.commitTransaction() && db.analyze());
+    if (!ok) {
+        Benchmark::fail("Unable to store the library: " + db.error());
+    }
+
+    // Pick a few albums/artists/songs from throughout the library to look up
+    std::vector<Metadata::Song> picked;
+    std::vector<AlbumID> albums;
+    std::vector<ArtistID> artists;
+    for (size_t i = 0; i < 10; i++) {
+        Metadata::Song m = songs[i * songs.size() / 10];
+        m.ID = db.getSongIDForPath(m.path);
+        picked.push_back(m);
+        albums.push_back(db.getAlbumIDForSong(m.ID));
+        artists.push_back(db.getArtistIDForSong(m.ID));
+    }
+    db.close();
+    size_t next = 0;
+    auto pick = [&next]() {
+        return (next++) % 10;
+    };
+
+    // The methods used by the main screens, along with a search
+    std::vector< std::pair<std::string, std::function<bool()> > > methods = {
+        {"getAllSongMetadata(TitleAsc)", [&db]() { return !db.getAllSongMetadata(Database::SortBy::TitleAsc).empty(); }},
+        {"getAllAlbumMetadata(AlbumAsc)", [&db]() { return !db.getAllAlbumMetadata(Database::SortBy::AlbumAsc).empty(); }},
+        {"getAllArtistMetadata(ArtistAsc)", [&db]() { return !db.getAllArtistMetadata(Database::SortBy::ArtistAsc).empty(); }},
+        {"getAlbumMetadataForID", [&]() { return db.getAlbumMetadataForID(albums[pick()]).ID >= 0; }},
+        {"getSongMetadataForAlbum", [&]() { return !db.getSongMetadataForAlbum(albums[pick()]).empty(); }},
+        {"getSongMetadataForArtist", [&]() { return !db.getSongMetadataForArtist(artists[pick()]).empty(); }},
+        {"getSongMetadataForID", [&]() { return db.getSongMetadataForID(picked[pick()].ID).ID >= 0; }},
+        {"searchSongs", [&]() { bool ok; db.searchSongs(picked[pick()].title, db.searchToken(), ok); return ok; }}
+    };
+
+    std::vector<std::string> columns = {"songs", "latency_us", "cache_kb", "method"};
+    for (const std::string & column : Benchmark::resultColumns()) {
+        columns.push_back(column);
+    }
+    Benchmark::printHeader(columns);
+
+    sqlite3_cachevfs_latency(latency);
+    for (unsigned int kb : {0, 4096, 8192}) {
+        db.setReadCache(kb);
+        if (!db.openReadOnly()) {
+            Benchmark::fail("Unable to open the database: " + db.error());
+        }
+        for (const std::pair<std::string, std::function<bool()> > & method : methods) {
+            Benchmark::Result result = Benchmark::time(method.second, RUNS);
+            Benchmark::printResult({songCount, std::to_string(latency), std::to_string(kb), method.first}, result);
+        }
+        db.close();
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include <chrono>
+#include "Console.hpp"
+#include <dirent.h>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <thread>
+
+// Time to wait for each read/file system call (in microseconds)
+static unsigned int readLatency = 0;
+static unsigned int fsLatency = 0;
+
+// Waits for the given number of microseconds
+static void wait(const unsigned int us) {
+    if (us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    }
+}
+
+// The functions below take the place of glibc's as they're defined in the executable
+// libstdc++ asks glibc for the number of cores, so report the number given to applications
+extern "C" int get_nprocs() {
+    return 3;
+}
+
+// std::filesystem opens directories and reads statuses through these, so wait before calling glibc's
+extern "C" DIR * opendir(const char * path) {
+    static DIR * (*func)(const char *) = reinterpret_cast<DIR * (*)(const char *)>(dlsym(RTLD_NEXT, "opendir"));
+    wait(fsLatency);
+    return func(path);
+}
+
+extern "C" int stat(const char * path, struct stat * buf) {
+    static int (*func)(const char *, struct stat *) = reinterpret_cast<int (*)(const char *, struct stat *)>(dlsym(RTLD_NEXT, "stat"));
+    wait(fsLatency);
+    return func(path, buf);
+}
+
+namespace Console {
+    void setReadLatency(const unsigned int us) {
+        readLatency = us;
+    }
+
+    void setFsLatency(const unsigned int us) {
+        fsLatency = us;
+    }
+
+    void waitForRead() {
+        wait(readLatency);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,402 @@
+// Times the public Database methods against synthetic libraries of different sizes.
+// Usage: database [songs...] (defaults to libraries of 1000, 10000 and 100000 songs)
+//
+// A row is printed for each method and library size. The plan of every query run by each method is
+// then written to plans-<songs>.log (as '[SQLITE] PLAN' lines following each '[SQLITE] QUERY' line).
+// Lastly, migrating the same library from version 7 (the last before the trigram search) is timed.
+#include "Benchmark.hpp"
+#include <cstdio>
+#include "db/Database.hpp"
+#include "db/migrations/Migration.hpp"
+#include "Log.hpp"
+#include <map>
+#include "Paths.hpp"
+#include "PlayJournal.hpp"
+#include "SQLite.hpp"
+
+// A method to time, which returns false if it failed (or returned nothing when it shouldn't have)
+struct Case {
+    std::string name;               // Name printed in the results
+    unsigned int runs;              // Number of times to run it
+    bool write;                     // Does it need a read-write connection?
+    std::function<bool()> func;     // Calls the method
+};
+
+// Opens the type of connection needed by the case (if not already open)
+static void openConnection(Database & db, bool & writable, const bool write) {
+    if (write != writable) {
+        db.close();
+        if (!(write ? db.openReadWrite() : db.openReadOnly())) {
+            Benchmark::fail("Unable to open the database: " + db.error());
+        }
+        writable = write;
+    }
+}
+
+// Stores the library in a version 7 database, as the application did at the time: migrations 1-7
+// create the tables, then the songs are added and indexed for the spellfix search. Every album and
+// artist is given an image, and there is a playlist for every 100 songs.
+// Returns a description of what failed (blank if successful)
+static std::string makeVersion7Database(const std::vector<Metadata::Song> & songs) {
+    SQLite db(Path::Common::DatabaseFile);
+    if (!db.openConnection(SQLite::Connection::ReadWrite) || !db.beginTransaction()) {
+        return "Unable to open the database";
+    }
+
+    std::vector< std::function<std::string(SQLite *)> > migrations = {
+        Migration::migrateTo1, Migration::migrateTo2, Migration::migrateTo3, Migration::migrateTo4,
+        Migration::migrateTo5, Migration::migrateTo6, Migration::migrateTo7
+    };
+    for (size_t i = 0; i < migrations.size(); i++) {
+        std::string err = migrations[i](&db);
+        if (!err.empty()) {
+            return "Migration " + std::to_string(i + 1) + ": " + err;
+        }
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < songs.size() && ok; i++) {
+        const Metadata::Song & m = songs[i];
+        ok = db.prepareQuery("INSERT OR IGNORE INTO Artists (name) VALUES (?);");
+        ok = ok && db.bindString(0, m.artist) && db.executeQuery();
+        ok = ok && db.prepareQuery("INSERT OR IGNORE INTO Albums (name) VALUES (?);");
+        ok = ok && db.bindString(0, m.album) && db.executeQuery();
+        ok = ok && db.prepareQuery("INSERT INTO Songs (path, format, modified, artist_id, album_id, title, duration, track, disc) VALUES (?, ?, ?, (SELECT id FROM Artists WHERE name = ?), (SELECT id FROM Albums WHERE name = ?), ?, ?, ?, ?);");
+        ok = ok && db.bindValues(0, m.path, audioFormatToString(m.format), m.modified, m.artist, m.album, m.title, m.duration, m.trackNumber, m.discNumber);
+        ok = ok && db.executeQuery();
+    }
+    if (!ok) {
+        return "Unable to add the songs";
+    }
+
+    int playlists = songs.size() / 100;
+    for (int i = 0; i < playlists && ok; i++) {
+        ok = db.prepareQuery("INSERT INTO Playlists (id, name) VALUES (?, ?);");
+        ok = ok && db.bindValues(0, i + 1, Benchmark::words(3000000 + i, 1 + i % 3)) && db.executeQuery();
+        ok = ok && db.prepareQuery("INSERT INTO PlaylistSongs (playlist_id, song_id) SELECT ?, id FROM Songs WHERE id % ? = ?;");
+        ok = ok && db.bindValues(0, i + 1, playlists, i) && db.executeQuery();
+    }
+    ok = ok && db.prepareQuery("UPDATE Albums SET image_path = ? || id || '.png';");
+    ok = ok && db.bindString(0, Path::App::AlbumImageFolder) && db.executeQuery();
+    ok = ok && db.prepareQuery("UPDATE Artists SET image_path = ? || id || '.png';");
+    ok = ok && db.bindString(0, Path::App::ArtistImageFolder) && db.executeQuery();
+    if (!ok) {
+        return "Unable to add the playlists and images";
+    }
+
+    // These are the queries run by prepareSearch() at the time
+    std::vector<std::string> types = {"Songs", "Artists", "Albums", "Playlists"};
+    for (const std::string & type : types) {
+        std::string select = "SELECT name FROM " + type + ";";
+        if (type == "Songs") {
+            select = "SELECT title, Artists.name, Albums.name FROM Songs JOIN Artists ON artist_id = Artists.id JOIN Albums ON album_id = Albums.id;";
+        } else if (type == "Albums") {
+            select = "SELECT DISTINCT Albums.name, Artists.name FROM Songs JOIN Artists ON artist_id = Artists.id JOIN Albums ON album_id = Albums.id;";
+        }
+        ok = ok && db.prepareAndExecuteQuery("INSERT INTO Fts" + type + " " + select);
+        ok = ok && db.prepareAndExecuteQuery("CREATE VIRTUAL TABLE FtsAux" + type + " USING fts4aux(Fts" + type + ");");
+        ok = ok && db.prepareAndExecuteQuery("INSERT INTO Spellfix" + type + " (word, rank) SELECT term, documents FROM FtsAux" + type + " WHERE col='*';");
+    }
+    ok = ok && db.prepareAndExecuteQuery("UPDATE Variables SET value = 0 WHERE name = 'search_update';");
+    if (!ok) {
+        return "Unable to index the library for searching";
+    }
+
+    if (!db.commitTransaction()) {
+        return "Unable to commit the library";
+    }
+    db.closeConnection();
+    return "";
+}
+
+static void benchmarkLibrary(const size_t count) {
+    std::string songCount = std::to_string(count);
+    Benchmark::progress("Creating a library of " + songCount + " songs...");
+    Benchmark::resetData();
+    std::vector<Metadata::Song> songs = Benchmark::makeLibrary(count);
+
+    Database db;
+    Benchmark::Result result = Benchmark::time([&db]() { return db.migrate(); }, 1);
+    Benchmark::printResult({songCount, "migrate (new database)"}, result);
+    if (!result.ok) {
+        Benchmark::fail("Unable to migrate the database: " + db.error());
+    }
+    bool writable = false;
+    openConnection(db, writable, true);
+
+    // Store the library the way a scan does (all in one transaction)
+    result = Benchmark::time([&db, &songs]() {
+        bool ok = db.beginTransaction();
+        for (size_t i = 0; i < songs.size() && ok; i++) {
+            ok = db.addSong(songs[i]);
+        }
+        return (ok ? db.commitTransaction() : db.rollbackTransaction() && false);
+    }, 1);
+    Benchmark::printResult({songCount, "addSong (whole library)"}, result);
+    if (!result.ok) {
+        Benchmark::fail("Unable to store the library: " + db.error());
+    }
+
+    // Pick a few albums/artists/songs from throughout the library to look up
+    std::vector<Metadata::Song> picked;
+    for (size_t i = 0; i < 10; i++) {
+        Metadata::Song m = songs[i * songs.size() / 10];
+        m.ID = db.getSongIDForPath(m.path);
+        picked.push_back(m);
+    }
+    std::vector<AlbumID> albums;
+    std::vector<ArtistID> artists;
+    for (const Metadata::Song & m : picked) {
+        albums.push_back(db.getAlbumIDForSong(m.ID));
+        artists.push_back(db.getArtistIDForSong(m.ID));
+    }
+    size_t next = 0;
+    auto pick = [&next]() {
+        return (next++) % 10;
+    };
+
+    // Add a playlist with a fifth of the library (songs are numbered from one as the database is new),
+    // and a smart playlist
+    std::vector<SongID> playlistSongs;
+    for (size_t i = 0; i < songs.size(); i += 5) {
+        playlistSongs.push_back(i + 1);
+    }
+    db.addPlaylist(Metadata::Playlist{-1, "Benchmark", "", "", 0});
+    db.addSmartPlaylist(Metadata::Playlist{-1, "Benchmark Smart", "", "", 0}, {SmartPlaylist::Rule{SmartPlaylist::Field::Duration, SmartPlaylist::Comparison::LessThan, "200"}});
+    std::vector<Metadata::Playlist> playlists = db.getAllPlaylistMetadata(Database::SortBy::TitleAsc);
+    PlaylistID playlist = (playlists.empty() ? -1 : playlists[0].ID);
+    Metadata::Playlist playlistMeta = db.getPlaylistMetadataForID(playlist);
+
+    // Add an empty playlist to copy the above into (which is removed at the end), and another with the
+    // picked songs to remove one at a time
+    db.addPlaylist(Metadata::Playlist{-1, "Benchmark Copy", "", "", 0});
+    db.addPlaylist(Metadata::Playlist{-1, "Benchmark Removals", "", "", 0});
+    PlaylistID copyPlaylist = -1;
+    PlaylistID removalsPlaylist = -1;
+    for (const Metadata::Playlist & m : db.getAllPlaylistMetadata(Database::SortBy::TitleAsc)) {
+        if (m.name == "Benchmark Copy") {
+            copyPlaylist = m.ID;
+        } else if (m.name == "Benchmark Removals") {
+            removalsPlaylist = m.ID;
+        }
+    }
+    std::vector<SongID> pickedIDs;
+    for (const Metadata::Song & m : picked) {
+        pickedIDs.push_back(m.ID);
+    }
+    db.addSongsToPlaylist(removalsPlaylist, pickedIDs);
+    std::vector<PlaylistSongID> removals;
+    for (const Metadata::PlaylistSong & m : db.getSongMetadataForPlaylist(removalsPlaylist, Database::SortBy::TitleAsc)) {
+        removals.push_back(m.ID);
+    }
+
+    // The last ten songs are moved and then removed (none of them are picked)
+    std::vector<SongID> spare;
+    for (size_t i = 0; i < 10; i++) {
+        spare.push_back(songs.size() - i);
+    }
+
+    // Metadata of the picked albums/artists to update
+    std::vector<Metadata::Album> albumMeta;
+    std::vector<Metadata::Artist> artistMeta;
+    for (size_t i = 0; i < picked.size(); i++) {
+        albumMeta.push_back(db.getAlbumMetadataForID(albums[i]));
+        artistMeta.push_back(db.getArtistMetadataForID(artists[i]));
+    }
+
+    // An image (and palette) for every album, along with new fingerprints, the directories holding the
+    // songs (as a scan would find them) and every path to add to the scan journal
+    std::vector< std::pair<AlbumID, std::string> > albumImages;
+    std::vector< std::pair<std::string, Metadata::Palette> > palettes;
+    for (const Metadata::Album & m : db.getAllAlbumMetadata(Database::SortBy::AlbumAsc)) {
+        albumImages.push_back(std::make_pair(m.ID, Path::App::AlbumImageFolder + std::to_string(m.ID) + ".png"));
+        palettes.push_back(std::make_pair(albumImages.back().second, Metadata::Palette{true, false, 0x202020FF, 0xFFFFFFFF, 0xBBBBBBFF}));
+    }
+    std::vector< std::pair<std::string, std::string> > fingerprints;
+    std::map<std::string, unsigned int> entries;
+    std::vector<std::string> paths;
+    for (const Metadata::Song & m : songs) {
+        fingerprints.push_back(std::make_pair(m.path, m.fingerprint + "0"));
+        entries[m.path.substr(0, m.path.rfind('/'))]++;
+        paths.push_back(m.path);
+    }
+    std::vector<Metadata::Directory> directories;
+    for (const std::pair<const std::string, unsigned int> & entry : entries) {
+        directories.push_back(Metadata::Directory{entry.first, 1600000000, entry.second});
+    }
+
+    // A play journal with as many plays as there are songs (a fifth of which were skipped)
+    std::vector<PlayJournal::Event> plays;
+    for (size_t i = 0; i < songs.size(); i++) {
+        plays.push_back(PlayJournal::Event{static_cast<int32_t>(1 + (i * 7) % songs.size()), static_cast<uint32_t>(1600000000 + i), 100, (i % 5 == 0 ? uint8_t(1) : uint8_t(0)), 0});
+    }
+    std::FILE * journal = std::fopen(Path::Common::PlayJournalFile.c_str(), "wb");
+    if (journal == nullptr || std::fwrite(plays.data(), sizeof(PlayJournal::Event), plays.size(), journal) != plays.size()) {
+        Benchmark::fail("Unable to write the play journal");
+    }
+    std::fclose(journal);
+
+    // Search queries made up of exact, partial and misspelt names from the library
+    std::vector<std::string> queries;
+    for (const Metadata::Song & m : picked) {
+        queries.push_back(m.title);
+        queries.push_back(m.artist.substr(0, 4));
+        std::string typo = m.album;
+        if (typo.length() > 3) {
+            std::swap(typo[1], typo[2]);
+        }
+        queries.push_back(typo);
+    }
+    auto query = [&queries, &next]() {
+        return queries[(next++) % queries.size()];
+    };
+
+    std::vector<Case> cases = {
+        {"analyze", 1, true, [&db]() { return db.analyze(); }},
+        {"exportPathIndex", 1, true, [&db]() { return db.exportPathIndex(); }},
+        {"addSongsToPlaylist", 1, true, [&db, playlist, &playlistSongs]() { return db.addSongsToPlaylist(playlist, playlistSongs); }},
+        {"addAlbumToPlaylist", 10, true, [&]() { return db.addAlbumToPlaylist(playlist, albums[pick()]); }},
+        {"addArtistToPlaylist", 10, true, [&]() { return db.addArtistToPlaylist(playlist, artists[pick()]); }},
+        {"addSongToPlaylist", 10, true, [&]() { return db.addSongToPlaylist(playlist, picked[pick()].ID); }},
+        {"addPlaylistToPlaylist", 1, true, [&db, copyPlaylist, playlist]() { return db.addPlaylistToPlaylist(copyPlaylist, playlist); }},
+        {"updatePlaylist", 10, true, [&]() { Metadata::Playlist m = playlistMeta; m.description = std::to_string(next++); return db.updatePlaylist(m); }},
+        {"refreshSmartPlaylists", 1, true, [&db]() { return db.refreshSmartPlaylists(); }},
+        {"updateSong", 10, true, [&]() { Metadata::Song m = picked[pick()]; m.plays++; return db.updateSong(m); }},
+        {"setAlbumImages", 1, true, [&db, &albumImages]() { return db.setAlbumImages(albumImages); }},
+        {"getAlbumImagesWithoutPalette", 10, false, [&db]() { return !db.getAlbumImagesWithoutPalette().empty(); }},
+        {"setImagePalettes", 1, true, [&db, &palettes]() { return db.setImagePalettes(palettes); }},
+        // Each replaces the album's image, leaving the previous one unused
+        {"updateAlbum", 10, true, [&]() {
+            size_t i = pick();
+            Metadata::Album m = albumMeta[i];
+            m.tadbID = next;
+            m.imagePath = Path::App::AlbumImageFolder + std::to_string(m.ID) + "-" + std::to_string(next) + ".png";
+            return db.updateAlbum(m);
+        }},
+        {"updateArtist", 10, true, [&]() {
+            size_t i = pick();
+            Metadata::Artist m = artistMeta[i];
+            m.tadbID = next;
+            m.imagePath = Path::App::ArtistImageFolder + std::to_string(m.ID) + "-" + std::to_string(next) + ".png";
+            return db.updateArtist(m);
+        }},
+        {"setSongFingerprints", 1, true, [&db, &fingerprints]() { return db.setSongFingerprints(fingerprints); }},
+        {"importPlayJournal", 1, true, [&db]() { return db.importPlayJournal(); }},
+        {"setAllDirectoryInfo", 1, true, [&db, &directories]() { return db.setAllDirectoryInfo(directories); }},
+        {"addToScanJournal", 1, true, [&db, &paths]() { return db.addToScanJournal(paths); }},
+        {"setScanJournalStored", 1, true, [&db, &paths]() {
+            // As a scan does, within the transaction which stores the songs
+            bool ok = db.beginTransaction() && db.setScanJournalStored(paths);
+            return (ok ? db.commitTransaction() : db.rollbackTransaction() && false);
+        }},
+        {"getStoredScanJournalSongs", 10, false, [&db]() { bool ok; return !db.getStoredScanJournalSongs(ok).empty() && ok; }},
+        {"getAllSongMetadata(TitleAsc)", 10, false, [&db]() { return !db.getAllSongMetadata(Database::SortBy::TitleAsc).empty(); }},
+        {"getAllSongMetadata(ArtistAsc)", 10, false, [&db]() { return !db.getAllSongMetadata(Database::SortBy::ArtistAsc).empty(); }},
+        {"getAllSongMetadata(AlbumAsc)", 10, false, [&db]() { return !db.getAllSongMetadata(Database::SortBy::AlbumAsc).empty(); }},
+        {"getAllSongMetadata(LengthDsc)", 10, false, [&db]() { return !db.getAllSongMetadata(Database::SortBy::LengthDsc).empty(); }},
+        {"getAllAlbumMetadata(AlbumAsc)", 10, false, [&db]() { return !db.getAllAlbumMetadata(Database::SortBy::AlbumAsc).empty(); }},
+        {"getAllAlbumMetadata(SongsDsc)", 10, false, [&db]() { return !db.getAllAlbumMetadata(Database::SortBy::SongsDsc).empty(); }},
+        {"getAllArtistMetadata(ArtistAsc)", 10, false, [&db]() { return !db.getAllArtistMetadata(Database::SortBy::ArtistAsc).empty(); }},
+        {"getAllArtistMetadata(AlbumsDsc)", 10, false, [&db]() { return !db.getAllArtistMetadata(Database::SortBy::AlbumsDsc).empty(); }},
+        {"getAllPlaylistMetadata", 10, false, [&db]() { return !db.getAllPlaylistMetadata(Database::SortBy::TitleAsc).empty(); }},
+        {"getPlaylistMetadataForID", 100, false, [&db, playlist]() { return db.getPlaylistMetadataForID(playlist).ID >= 0; }},
+        {"getSongMetadataForPlaylist", 10, false, [&db, playlist]() { return !db.getSongMetadataForPlaylist(playlist, Database::SortBy::TitleAsc).empty(); }},
+        {"getAlbumMetadataForID", 100, false, [&]() { return db.getAlbumMetadataForID(albums[pick()]).ID >= 0; }},
+        {"getAlbumMetadataForArtist", 100, false, [&]() { return !db.getAlbumMetadataForArtist(artists[pick()], Database::SortBy::AlbumAsc).empty(); }},
+        {"getArtistMetadataForID", 100, false, [&]() { return db.getArtistMetadataForID(artists[pick()]).ID >= 0; }},
+        {"getArtistMetadataForAlbum", 100, false, [&]() { return !db.getArtistMetadataForAlbum(albums[pick()]).empty(); }},
+        {"getSongMetadataForAlbum", 100, false, [&]() { return !db.getSongMetadataForAlbum(albums[pick()]).empty(); }},
+        {"getSongMetadataForArtist", 100, false, [&]() { return !db.getSongMetadataForArtist(artists[pick()]).empty(); }},
+        {"getSongMetadataForID", 100, false, [&]() { return db.getSongMetadataForID(picked[pick()].ID).ID >= 0; }},
+        {"getSongIDForPath", 100, false, [&]() { return db.getSongIDForPath(picked[pick()].path) >= 0; }},
+        {"getAlbumIDForSong", 100, false, [&]() { return db.getAlbumIDForSong(picked[pick()].ID) >= 0; }},
+        {"getArtistIDForSong", 100, false, [&]() { return db.getArtistIDForSong(picked[pick()].ID) >= 0; }},
+        {"getArtistIDForName", 100, false, [&]() { return db.getArtistIDForName(picked[pick()].artist) >= 0; }},
+        {"getSongFingerprintForPath", 100, false, [&]() { return !db.getSongFingerprintForPath(picked[pick()].path).empty(); }},
+        // Every song has a fingerprint, so this only times looking for them
+        {"getSongPathsWithoutFingerprint", 10, false, [&db]() { db.getSongPathsWithoutFingerprint(); return true; }},
+        {"getPaletteForImage", 100, false, [&]() { return db.getPaletteForImage(palettes[pick() * palettes.size() / 10].first).valid; }},
+        {"getAllSongFileInfo", 10, false, [&db]() { bool ok; db.getAllSongFileInfo(ok); return ok; }},
+        {"getAllImagePaths", 10, false, [&db]() { bool ok; db.getAllImagePaths(ok); return ok; }},
+        {"getAllDirectoryInfo", 10, false, [&db]() { bool ok; db.getAllDirectoryInfo(ok); return ok; }},
+        {"searchSongs", 30, false, [&]() { bool ok; db.searchSongs(query(), db.searchToken(), ok); return ok; }},
+        {"searchAlbums", 30, false, [&]() { bool ok; db.searchAlbums(query(), db.searchToken(), ok); return ok; }},
+        {"searchArtists", 30, false, [&]() { bool ok; db.searchArtists(query(), db.searchToken(), ok); return ok; }},
+        {"searchPlaylists", 30, false, [&]() { bool ok; db.searchPlaylists(query(), db.searchToken(), ok); return ok; }},
+
+        // These remove what was added above, so are done last
+        {"removeSongFromPlaylist", 10, true, [&]() { return db.removeSongFromPlaylist(removals[pick()]); }},
+        {"moveSong", 10, true, [&]() {
+            size_t i = pick();
+            return db.moveSong(spare[i], "/moved/" + std::to_string(next) + ".mp3", AudioFormat::MP3, 1600000000);
+        }},
+        {"removeSong", 10, true, [&]() { return db.removeSong(spare[pick()]); }},
+        {"removePlaylist", 1, true, [&db, copyPlaylist]() { return db.removePlaylist(copyPlaylist); }},
+        {"removeUnusedImages", 1, true, [&db]() { return db.removeUnusedImages(); }},
+        {"removeAllDirectoryInfo", 1, true, [&db]() { return db.removeAllDirectoryInfo(); }},
+        {"clearScanJournal", 1, true, [&db]() { return db.clearScanJournal(); }}
+    };
+
+    // Time each method without profiling (which would slow them down)
+    for (const Case & c : cases) {
+        openConnection(db, writable, c.write);
+        result = Benchmark::time(c.func, c.runs);
+        Benchmark::printResult({songCount, c.name}, result);
+        if (!result.ok) {
+            Benchmark::progress(c.name + " failed: " + db.error());
+        }
+    }
+
+    // Now run each once more with profiling enabled, which logs each query's plan
+    // The connection is closed after each so its last query is logged before the next method's name
+    db.close();
+    std::string planFile = "plans-" + songCount + ".log";
+    std::remove(planFile.c_str());
+    Log::openFile(planFile, Log::Level::Info);
+    for (const Case & c : cases) {
+        if (!(c.write ? db.openReadWrite() : db.openReadOnly())) {
+            Benchmark::fail("Unable to open the database: " + db.error());
+        }
+        Log::writeInfo("[BENCH] " + c.name);
+        c.func();
+        db.close();
+    }
+    Log::closeFile();
+    Log::setLogLevel(Log::Level::None);
+    Benchmark::progress("Query plans written to " + planFile);
+
+    // Finally migrate the library from version 7, which reindexes it for the trigram search and
+    // backfills the sort keys, counts and image references
+    Benchmark::progress("Creating a version 7 library of " + songCount + " songs...");
+    Benchmark::resetData();
+    std::string err = makeVersion7Database(songs);
+    if (!err.empty()) {
+        Benchmark::fail("Unable to create the version 7 database: " + err);
+    }
+    Database old;
+    result = Benchmark::time([&old]() { return old.migrate(); }, 1);
+    Benchmark::printResult({songCount, "migrate (from version 7)"}, result);
+    if (!result.ok) {
+        Benchmark::progress("migrate (from version 7) failed: " + old.error());
+    }
+}
+
+int main(int argc, char * argv[]) {
+    std::vector<size_t> counts;
+    for (int i = 1; i < argc; i++) {
+        counts.push_back(std::stoul(argv[i]));
+    }
+    if (counts.empty()) {
+        counts = {1000, 10000, 100000};
+    }
+
+    std::vector<std::string> columns = {"songs", "method"};
+    for (const std::string & column : Benchmark::resultColumns()) {
+        columns.push_back(column);
+    }
+    Benchmark::printHeader(columns);
+    for (size_t count : counts) {
+        benchmarkLibrary(count);
+    }
+    return 0;
+}
\ No newline at end of file
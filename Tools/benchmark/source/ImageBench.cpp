@@ -0,0 +1,111 @@
+// Times resizing album art of typical sizes with Utils::Image.
+// Usage: image [runs] (defaults to 10 runs of each)
+//
+// Covers are generated at 500, 1000, 1500 and 3000px square, with smooth gradients and a little noise
+// so they compress more like photos than random pixels would, and stored as both a JPEG (quality 90)
+// and a PNG. A row is printed for each cover with the time taken by resize() to produce every
+// ArtSize as a PNG (i.e. what writeArt() does before writing the files), and by getPixels() to
+// decode and shrink the cover to the largest size (without encoding).
+#include "Benchmark.hpp"
+#include <cmath>
+#include <cstdio>
+#include <jpeglib.h>
+#include <random>
+#include "utils/Image.hpp"
+
+// Returns a JPEG of a generated cover with the given width/height
+static std::vector<unsigned char> makeCover(const size_t size) {
+    std::mt19937 rng(size);
+    std::vector<unsigned char> pixels(size * size * 3);
+    for (size_t y = 0; y < size; y++) {
+        for (size_t x = 0; x < size; x++) {
+            double u = static_cast<double>(x) / size;
+            double v = static_cast<double>(y) / size;
+            double wave = std::sin(u * 9.0 + std::cos(v * 7.0) * 2.0) * std::cos(v * 5.0 - u * 3.0);
+            double values[3] = {
+                60 + 120 * u + 50 * wave,
+                40 + 150 * v - 40 * wave,
+                90 + 80 * (1 - u) * v + 60 * wave
+            };
+            for (size_t c = 0; c < 3; c++) {
+                int value = static_cast<int>(values[c]) + static_cast<int>(rng() % 17) - 8;
+                pixels[(y * size + x) * 3 + c] = std::clamp(value, 0, 255);
+            }
+        }
+    }
+
+    jpeg_compress_struct jpeg;
+    jpeg_error_mgr err;
+    jpeg.err = jpeg_std_error(&err);
+    jpeg_create_compress(&jpeg);
+    unsigned char * buffer = nullptr;
+    unsigned long length = 0;
+    jpeg_mem_dest(&jpeg, &buffer, &length);
+    jpeg.image_width = size;
+    jpeg.image_height = size;
+    jpeg.input_components = 3;
+    jpeg.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&jpeg);
+    jpeg_set_quality(&jpeg, 90, true);
+    jpeg_start_compress(&jpeg, true);
+    while (jpeg.next_scanline < jpeg.image_height) {
+        unsigned char * row = &pixels[jpeg.next_scanline * size * 3];
+        jpeg_write_scanlines(&jpeg, &row, 1);
+    }
+    jpeg_finish_compress(&jpeg);
+    jpeg_destroy_compress(&jpeg);
+
+    std::vector<unsigned char> data(buffer, buffer + length);
+    std::free(buffer);
+    return data;
+}
+
+int main(int argc, char * argv[]) {
+    unsigned int runs = (argc > 1 ? std::stoul(argv[1]) : 10);
+    std::vector<size_t> sizes = {
+        static_cast<size_t>(Utils::Image::ArtSize::Thumbnail),
+        static_cast<size_t>(Utils::Image::ArtSize::Tile),
+        static_cast<size_t>(Utils::Image::ArtSize::Full)
+    };
+    size_t largest = sizes.back();
+
+    std::vector<std::string> columns = {"format", "cover_px", "source_kb", "method"};
+    for (const std::string & column : Benchmark::resultColumns()) {
+        columns.push_back(column);
+    }
+    Benchmark::printHeader(columns);
+
+    for (size_t size : {500, 1000, 1500, 3000}) {
+        // The PNG is made from the JPEG by "resizing" it to the same size, which only re-encodes it
+        Benchmark::progress("Creating a " + std::to_string(size) + "px cover...");
+        std::vector<unsigned char> jpeg = makeCover(size);
+        std::vector<unsigned char> png = jpeg;
+        if (!Utils::Image::resize(png, size, size)) {
+            Benchmark::fail("Unable to create a PNG cover");
+        }
+
+        for (const std::pair<std::string, std::vector<unsigned char> > & cover : {std::make_pair(std::string("jpeg"), jpeg), std::make_pair(std::string("png"), png)}) {
+            char kb[32];
+            std::snprintf(kb, sizeof(kb), "%.0f", cover.second.size() / 1024.0);
+            std::vector<std::string> values = {cover.first, std::to_string(size), kb};
+
+            Benchmark::Result result = Benchmark::time([&cover, &sizes]() {
+                std::vector<unsigned char> data = cover.second;
+                std::vector< std::vector<unsigned char> > resized;
+                return Utils::Image::resize(data, sizes, resized) && resized.size() == sizes.size();
+            }, runs);
+            values.push_back("resize(110/160/400)");
+            Benchmark::printResult(values, result);
+
+            result = Benchmark::time([&cover, largest]() {
+                std::vector<unsigned char> data = cover.second;
+                std::vector<unsigned char> pixels;
+                size_t width, height;
+                return Utils::Image::getPixels(data, largest, pixels, width, height) && width == largest && height == largest;
+            }, runs);
+            values.back() = "getPixels(400)";
+            Benchmark::printResult(values, result);
+        }
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+// Replaces Common/source/Paths.cpp for the benchmarks, keeping everything the benchmarks
+// write within a 'data' folder in the current directory instead of on the sd card.
+#include "Paths.hpp"
+
+namespace Path {
+    namespace Common {
+        const std::string ConfigFolder = "data/config/";
+        const std::string SwitchFolder = "data/";
+
+        const std::string DatabaseFile = Common::SwitchFolder + "data.sqlite3";
+        const std::string DatabaseBackupFile = Common::SwitchFolder + "data_old.sqlite3";
+        const std::string PathIndexFile = Common::SwitchFolder + "paths.idx";
+        const std::string PlayJournalFile = Common::SwitchFolder + "plays.jnl";
+    };
+
+    namespace App {
+        const std::string ConfigFile = Common::ConfigFolder + "app_config.ini";
+        const std::string LogFile = Common::SwitchFolder + "application.log";
+
+        const std::string UpdateFolder = Common::SwitchFolder + "update/";
+        const std::string UpdateFile = UpdateFolder + "update.zip";
+        const std::string UpdateInfo = UpdateFolder + "meta.json";
+
+        const std::string DefaultArtFile = "";
+        const std::string DefaultArtistFile = "";
+        const std::string DefaultPlaylistFile = "";
+
+        const std::string AlbumImageFolder = Common::SwitchFolder + "images/album/";
+        const std::string ArtistImageFolder = Common::SwitchFolder + "images/artist/";
+        const std::string PlaylistImageFolder = Common::SwitchFolder + "images/playlist/";
+    };
+
+    namespace Sys {
+        const std::string ConfigFile = Common::ConfigFolder + "sys_config.ini";
+        const std::string LogFile = Common::SwitchFolder + "sysmodule.log";
+    };
+};
\ No newline at end of file
@@ -0,0 +1,144 @@
+// Times a scan of a generated library, with the parts of the scanner which need the console
+// stubbed out (see ScannerStubs.cpp and Console.hpp).
+// Usage: scanner-<threads> [files] [read latency (us)] [fs latency (us)]
+// (defaults to 20000 files, 2000us for each song's metadata and 200us for each directory/status)
+//
+// Each scanner-<threads> is built with MAX_METADATA_THREADS and MAX_WALK_THREADS set to <threads>
+// (note that the scanner still uses at most three metadata threads, as that's how many cores
+// applications are given). A row is printed with the total time taken by each stage of the scan,
+// then by processFiles() when scanning again with nothing changed, along with a hash of the order
+// songs were stored in (which shouldn't change with the number of threads).
+#include <algorithm>
+#include <atomic>
+#include "Benchmark.hpp"
+#include <chrono>
+#include "Console.hpp"
+#include <cstdio>
+#include "LibraryScanner.hpp"
+#include "Paths.hpp"
+#include "utils/FS.hpp"
+#include "utils/Utils.hpp"
+
+// Size of each generated file (in bytes)
+#define FILE_SIZE 4096
+
+// Adds the time taken to run the given function to the total, returning the function's result
+static LibraryScanner::Status timeStage(double & total, const std::function<LibraryScanner::Status()> & func) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    LibraryScanner::Status result = func();
+    std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+    total += time.count();
+    return result;
+}
+
+int main(int argc, char * argv[]) {
+    size_t count = (argc > 1 ? std::stoul(argv[1]) : 20000);
+    unsigned int latency = (argc > 2 ? std::stoul(argv[2]) : 2000);
+    unsigned int fsLatency = (argc > 3 ? std::stoul(argv[3]) : 200);
+
+    // Write a file for each song in a synthetic library, in <artist>/<album>/<track> <title>.mp3
+    Benchmark::progress("Writing " + std::to_string(count) + " files...");
+    Benchmark::resetData();
+    std::string musicFolder = Path::Common::SwitchFolder + "music";
+    std::vector<Metadata::Song> songs = Benchmark::makeLibrary(count);
+    for (size_t i = 0; i < songs.size(); i++) {
+        std::string path = musicFolder + songs[i].path.substr(std::string("/music").length());
+        std::vector<unsigned char> data(FILE_SIZE);
+        for (size_t j = 0; j < data.size(); j++) {
+            data[j] = (i * 31 + j * 7) & 0xFF;
+        }
+        Utils::Fs::createPath(Utils::Fs::getParentDirectory(path) + "/");
+        if (!Utils::Fs::writeFile(path, data)) {
+            Benchmark::fail("Unable to write " + path);
+        }
+    }
+
+    // Each call through the SyncDatabase holds its lock until the end of the statement, so they're kept separate
+    SyncDatabase db(new Database());
+    bool ok = db->migrate();
+    ok = (ok && db->openReadOnly());
+    if (!ok) {
+        Benchmark::fail("Unable to open the database: " + db->error());
+    }
+
+    // Scan the library the same way as the splash screen, with the stages timed
+    Benchmark::progress("Scanning...");
+    Console::setReadLatency(latency);
+    Console::setFsLatency(fsLatency);
+    LibraryScanner scanner(db, musicFolder);
+    double filesTime = 0;
+    double metadataTime = 0;
+    double databaseTime = 0;
+    LibraryScanner::Status result = timeStage(filesTime, [&scanner]() {
+        return scanner.processFiles();
+    });
+    if (result == LibraryScanner::Status::Ok) {
+        db->close();
+        db->openReadWrite();
+        result = scanner.startJournal();
+    }
+
+    std::atomic<size_t> currentFile = 0;
+    std::atomic<size_t> totalFiles = 0;
+    std::atomic<size_t> estRemaining = 0;
+    while (result == LibraryScanner::Status::Ok && scanner.filesRemaining() > 0) {
+        db->close();
+        db->openReadOnly();
+        result = timeStage(metadataTime, [&]() {
+            return scanner.processMetadata(currentFile, totalFiles, estRemaining);
+        });
+        if (result == LibraryScanner::Status::Ok) {
+            db->close();
+            db->openReadWrite();
+            result = timeStage(databaseTime, [&scanner]() {
+                return scanner.updateDatabase();
+            });
+        }
+    }
+
+    // The stub doesn't find any art, but this still needs to be done to finish the scan (which clears the journal)
+    if (result == LibraryScanner::Status::Ok) {
+        db->close();
+        db->openReadOnly();
+        result = scanner.processArt(currentFile);
+    }
+    if (result == LibraryScanner::Status::Ok) {
+        db->close();
+        db->openReadWrite();
+        result = scanner.updateArt();
+    }
+    db->close();
+    if (result != LibraryScanner::Status::Ok || !db->openReadOnly()) {
+        Benchmark::fail("The scan failed: " + db->error());
+    }
+
+    // Scan again, which should find nothing has changed
+    Benchmark::progress("Scanning again...");
+    double rescanTime = 0;
+    LibraryScanner rescanner(db, musicFolder);
+    result = timeStage(rescanTime, [&rescanner]() {
+        return rescanner.processFiles();
+    });
+    if (result != LibraryScanner::Status::Done) {
+        Benchmark::fail("The library changed between scans");
+    }
+    Console::setReadLatency(0);
+    Console::setFsLatency(0);
+
+    // Hash the path of each song in the order they were stored (i.e. by ID)
+    std::vector<Metadata::Song> stored = db->getAllSongMetadata(Database::SortBy::TitleAsc);
+    std::sort(stored.begin(), stored.end(), [](const Metadata::Song & lhs, const Metadata::Song & rhs) {
+        return lhs.ID < rhs.ID;
+    });
+    uint64_t hash = Utils::FNV1A_OFFSET_BASIS;
+    for (const Metadata::Song & m : stored) {
+        hash = Utils::fnv1a((const unsigned char *)m.path.data(), m.path.length(), hash);
+    }
+    db->close();
+
+    char buf[128];
+    std::snprintf(buf, sizeof(buf), "%.3f\t%.3f\t%.3f\t%.1f\t%.3f\t%016llx", filesTime, metadataTime, databaseTime, stored.size() / (metadataTime / 1000), rescanTime, (unsigned long long)hash);
+    Benchmark::printHeader({"files", "read_latency_us", "fs_latency_us", "metadata_threads", "walk_threads", "stored", "processFiles_ms", "processMetadata_ms", "updateDatabase_ms", "files_per_s", "rescan_processFiles_ms", "order_hash"});
+    Benchmark::printRow({std::to_string(count), std::to_string(latency), std::to_string(fsLatency), std::to_string(std::min(MAX_METADATA_THREADS, 3)), std::to_string(MAX_WALK_THREADS), std::to_string(stored.size()), buf});
+    return 0;
+}
\ No newline at end of file
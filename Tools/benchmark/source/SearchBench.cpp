@@ -0,0 +1,133 @@
+// Times searches of a synthetic library using different kinds of queries and match percentages.
+// Usage: search [songs] (defaults to a library of 50000 songs)
+//
+// A row is printed for each match percentage, kind of query and type of result, along with the
+// average number of results returned by each search.
+//
+// When built with SPELLFIX_SEARCH (as search-spellfix) the spellfix search which the trigram index
+// replaced is timed instead, with its maximum spellfix score taking the place of the match percentage.
+// Both print the same rows in the same order so their results can be compared side by side.
+#include "Benchmark.hpp"
+#include <cstdio>
+#include "db/Database.hpp"
+
+// Number of different queries of each kind
+#define QUERIES 20
+
+// Returns the first word of the given string
+static std::string firstWord(const std::string & str) {
+    return str.substr(0, str.find(' '));
+}
+
+int main(int argc, char * argv[]) {
+    size_t count = (argc > 1 ? std::stoul(argv[1]) : 50000);
+    std::string songCount = std::to_string(count);
+    Benchmark::progress("Creating a library of " + songCount + " songs...");
+    Benchmark::resetData();
+    std::vector<Metadata::Song> songs = Benchmark::makeLibrary(count);
+
+    Database db;
+    if (!db.migrate() || !db.openReadWrite()) {
+        Benchmark::fail("Unable to open the database: " + db.error());
+    }
+#ifdef SPELLFIX_SEARCH
+    // Each song is added in its own transaction, as the scanner did at the time
+    bool ok = true;
+#else
+    bool ok = db.beginTransaction();
+#endif
+    for (size_t i = 0; i < songs.size() && ok; i++) {
+        ok = db.addSong(songs[i]);
+    }
+    for (size_t i = 0; i < songs.size() / 100 && ok; i++) {
+        ok = db.addPlaylist(Metadata::Playlist{-1, Benchmark::words(3000000 + i, 1 + i % 3), "", "", 0});
+    }
+#ifdef SPELLFIX_SEARCH
+    ok = (ok && (!db.needsSearchUpdate() || db.prepareSearch()));
+#else
+    ok = (ok && db.commitTransaction() && db.analyze());
+#endif
+    db.close();
+    if (!ok || !db.openReadOnly()) {
+        Benchmark::fail("Unable to store the library: " + db.error());
+    }
+
+    // Build each kind of query from songs spread throughout the library
+    std::vector< std::pair<std::string, std::vector<std::string> > > kinds = {
+        {"exact", {}},          // Whole title/album/artist
+        {"prefix", {}},         // Start of a word, as if still typing
+        {"typo", {}},           // Two letters swapped
+        {"words", {}},          // Words from the artist and title
+        {"short", {}}           // Two letters
+    };
+    for (size_t i = 0; i < QUERIES; i++) {
+        const Metadata::Song & m = songs[i * songs.size() / QUERIES];
+        const std::string & name = (i % 3 == 0 ? m.title : (i % 3 == 1 ? m.album : m.artist));
+        std::string typo = name;
+        size_t pos = typo.length() / 2;
+        std::swap(typo[pos - 1], typo[pos]);
+
+        kinds[0].second.push_back(name);
+        kinds[1].second.push_back(name.substr(0, 5));
+        kinds[2].second.push_back(typo);
+        kinds[3].second.push_back(firstWord(m.artist) + " " + firstWord(m.title));
+        kinds[4].second.push_back(name.substr(0, 2));
+    }
+
+#ifdef SPELLFIX_SEARCH
+    // The default score is 130, with 8 phrases
+    std::string search = "spellfix";
+    std::vector<unsigned int> settings = {100, 130, 160};
+    db.setSearchPhraseCount(8);
+#else
+    std::string search = "trigram";
+    std::vector<unsigned int> settings = {25, 50, 75};
+#endif
+
+    std::vector<std::string> columns = {"songs", "search", "setting", "query", "type", "results"};
+    for (const std::string & column : Benchmark::resultColumns()) {
+        columns.push_back(column);
+    }
+    Benchmark::printHeader(columns);
+
+    for (unsigned int setting : settings) {
+#ifdef SPELLFIX_SEARCH
+        db.setSpellfixScore(setting);
+#else
+        db.setSearchMatchPercent(setting);
+#endif
+        for (const std::pair<std::string, std::vector<std::string> > & kind : kinds) {
+            // The spellfix search has no way to report an error, so its results are always taken as ok
+            std::vector< std::pair<std::string, std::function<size_t(const std::string &, bool &)> > > types = {
+#ifdef SPELLFIX_SEARCH
+                {"songs", [&db](const std::string & q, bool & ok) { ok = true; return db.searchSongs(q).size(); }},
+                {"albums", [&db](const std::string & q, bool & ok) { ok = true; return db.searchAlbums(q).size(); }},
+                {"artists", [&db](const std::string & q, bool & ok) { ok = true; return db.searchArtists(q).size(); }},
+                {"playlists", [&db](const std::string & q, bool & ok) { ok = true; return db.searchPlaylists(q).size(); }}
+#else
+                {"songs", [&db](const std::string & q, bool & ok) { return db.searchSongs(q, db.searchToken(), ok).size(); }},
+                {"albums", [&db](const std::string & q, bool & ok) { return db.searchAlbums(q, db.searchToken(), ok).size(); }},
+                {"artists", [&db](const std::string & q, bool & ok) { return db.searchArtists(q, db.searchToken(), ok).size(); }},
+                {"playlists", [&db](const std::string & q, bool & ok) { return db.searchPlaylists(q, db.searchToken(), ok).size(); }}
+#endif
+            };
+
+            for (const std::pair<std::string, std::function<size_t(const std::string &, bool &)> > & type : types) {
+                size_t next = 0;
+                size_t results = 0;
+                Benchmark::Result result = Benchmark::time([&]() {
+                    bool ok;
+                    results += type.second(kind.second[next++], ok);
+                    return ok;
+                }, kind.second.size());
+
+                char avg[32];
+                std::snprintf(avg, sizeof(avg), "%.1f", results / (double)kind.second.size());
+                Benchmark::printResult({songCount, search, std::to_string(setting), kind.first, type.first, avg}, result);
+            }
+        }
+    }
+
+    db.close();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,9 @@
+// Stand-ins for functions the benchmarked code links against but which need the console
+// (or libraries which aren't built for the host). None of them affect what's being measured.
+#include "lang/Lang.hpp"
+
+namespace Utils::Lang {
+    std::string string(const std::string & key) {
+        return key;
+    }
+};
\ No newline at end of file
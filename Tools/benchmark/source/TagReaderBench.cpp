@@ -0,0 +1,344 @@
+// Times reading the tags of a generated library with Metadata::TagReader, and measures how much
+// of each file is actually read.
+// Usage: tagreader [files] [picture size (KB)] [audio size (KB)] [runs]
+// (defaults to 1500 files, each with a 256KB embedded picture and 1024KB of audio, read 5 times)
+//
+// A third of the files are MP3s (alternating between ID3v2.3 with UTF-16 text and ID3v2.4 with UTF-8,
+// plus an ID3v1 tag), a third are FLACs and the rest are PCM WAVs with the LIST INFO and id3 chunks
+// after the audio. The picture comes before the text tags in every file, so they can only be read
+// quickly if it's skipped over. A row is printed for each format with the bytes read per file (taken
+// from /proc/self/io, so it includes everything read by stdio) and how many files had every value read
+// correctly. Files are read from the page cache, so the times show the cost of parsing, not the SD card.
+#include "Benchmark.hpp"
+#include <cstdio>
+#include <fstream>
+#include "meta/TagReader.hpp"
+#include "Paths.hpp"
+#include <random>
+#include "utils/FS.hpp"
+
+// Samples per MPEG-1 Layer III frame, and the size of a 128kbps 44.1kHz frame (in bytes)
+#define MP3_FRAME_SAMPLES 1152
+#define MP3_FRAME_SIZE 417
+
+// A generated file and the values it should be read as
+struct File {
+    std::string path;
+    AudioFormat format;
+    Metadata::Song expected;
+};
+
+// Appends an unsigned integer with the given number of bytes
+static void appendBE(std::vector<unsigned char> & data, uint32_t val, size_t bytes) {
+    for (size_t i = bytes; i > 0; i--) {
+        data.push_back((val >> ((i - 1) * 8)) & 0xFF);
+    }
+}
+
+static void appendLE(std::vector<unsigned char> & data, uint32_t val, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        data.push_back((val >> (i * 8)) & 0xFF);
+    }
+}
+
+static void appendSyncsafe(std::vector<unsigned char> & data, uint32_t val) {
+    for (int shift = 21; shift >= 0; shift -= 7) {
+        data.push_back((val >> shift) & 0x7F);
+    }
+}
+
+static void append(std::vector<unsigned char> & data, const std::string & str) {
+    data.insert(data.end(), str.begin(), str.end());
+}
+
+static void append(std::vector<unsigned char> & data, const std::vector<unsigned char> & other, size_t len) {
+    data.insert(data.end(), other.begin(), other.begin() + len);
+}
+
+// Appends an ID3v2 frame with the given ID and contents
+static void appendID3v2Frame(std::vector<unsigned char> & data, const std::string & id, const std::vector<unsigned char> & frame, unsigned char version) {
+    append(data, id);
+    if (version == 4) {
+        appendSyncsafe(data, frame.size());
+    } else {
+        appendBE(data, frame.size(), 4);
+    }
+    appendBE(data, 0, 2);
+    data.insert(data.end(), frame.begin(), frame.end());
+}
+
+// Returns an ID3v2 tag with the given text frames and a picture before them
+// v2.3 tags store text as UTF-16 (as Windows does), v2.4 tags as UTF-8
+static std::vector<unsigned char> makeID3v2(const std::vector< std::pair<std::string, std::string> > & text, const std::vector<unsigned char> & picture, size_t pictureSize, unsigned char version) {
+    std::vector<unsigned char> frames;
+    std::vector<unsigned char> frame = {0x00};
+    append(frame, "image/jpeg");
+    frame.insert(frame.end(), {0x00, 0x03, 0x00});
+    append(frame, picture, pictureSize);
+    appendID3v2Frame(frames, "APIC", frame, version);
+
+    for (const std::pair<std::string, std::string> & field : text) {
+        if (version == 4) {
+            frame = {0x03};
+            append(frame, field.second);
+        } else {
+            // Generated names are ASCII, so each character is one UTF-16 code unit
+            frame = {0x01, 0xFF, 0xFE};
+            for (char c : field.second) {
+                frame.insert(frame.end(), {(unsigned char)c, 0x00});
+            }
+        }
+        appendID3v2Frame(frames, field.first, frame, version);
+    }
+    frames.resize(frames.size() + 1024, 0);
+
+    std::vector<unsigned char> data;
+    append(data, "ID3");
+    data.insert(data.end(), {version, 0x00, 0x00});
+    appendSyncsafe(data, frames.size());
+    data.insert(data.end(), frames.begin(), frames.end());
+    return data;
+}
+
+static std::vector< std::pair<std::string, std::string> > id3v2Fields(const Metadata::Song & m) {
+    return {{"TIT2", m.title}, {"TPE1", m.artist}, {"TALB", m.album}, {"TRCK", std::to_string(m.trackNumber) + "/20"}, {"TPOS", std::to_string(m.discNumber)}};
+}
+
+static std::vector<unsigned char> makeMP3(const Metadata::Song & m, const std::vector<unsigned char> & random, size_t pictureSize, size_t audioSize, bool v24) {
+    std::vector<unsigned char> data = makeID3v2(id3v2Fields(m), random, pictureSize, v24 ? 4 : 3);
+
+    // The first frame holds a Xing header with enough frames for the song's duration (the audio
+    // that follows is just filler, as it's never read)
+    uint32_t frames = (m.duration * 44100 + MP3_FRAME_SAMPLES - 1) / MP3_FRAME_SAMPLES;
+    size_t start = data.size();
+    data.insert(data.end(), {0xFF, 0xFB, 0x90, 0x00});
+    data.resize(start + 36, 0);
+    append(data, "Xing");
+    appendBE(data, 0x3, 4);
+    appendBE(data, frames, 4);
+    appendBE(data, frames * MP3_FRAME_SIZE, 4);
+    data.resize(start + MP3_FRAME_SIZE, 0);
+    append(data, random, audioSize);
+
+    // ID3v1 only has room for 30 characters, and is only used for values missing from ID3v2
+    std::vector<unsigned char> id3v1;
+    append(id3v1, "TAG");
+    for (const std::string & str : {m.title, m.artist, m.album}) {
+        std::string field = str.substr(0, 30);
+        append(id3v1, field);
+        id3v1.resize(id3v1.size() + 30 - field.length(), 0);
+    }
+    append(id3v1, "2000");
+    id3v1.resize(id3v1.size() + 29, 0);
+    id3v1.push_back(m.trackNumber);
+    id3v1.push_back(0);
+    data.insert(data.end(), id3v1.begin(), id3v1.end());
+    return data;
+}
+
+static std::vector<unsigned char> makeFLAC(const Metadata::Song & m, const std::vector<unsigned char> & random, size_t pictureSize, size_t audioSize) {
+    std::vector<unsigned char> data;
+    append(data, "fLaC");
+
+    // STREAMINFO (only the sample rate and total samples are needed)
+    std::vector<unsigned char> info(18, 0);
+    uint64_t samples = (uint64_t)m.duration * 44100;
+    info[10] = (44100 >> 12) & 0xFF;
+    info[11] = (44100 >> 4) & 0xFF;
+    info[12] = ((44100 & 0xF) << 4) | 0x2;
+    info[13] = 0x70 | ((samples >> 32) & 0xF);
+    for (size_t i = 0; i < 4; i++) {
+        info[14 + i] = (samples >> ((3 - i) * 8)) & 0xFF;
+    }
+    info.resize(34, 0);
+
+    std::vector<unsigned char> comment;
+    std::vector<std::string> fields = {"TITLE=" + m.title, "ARTIST=" + m.artist, "ALBUM=" + m.album, "TRACKNUMBER=" + std::to_string(m.trackNumber), "DISCNUMBER=" + std::to_string(m.discNumber)};
+    appendLE(comment, 9, 4);
+    append(comment, "benchmark");
+    appendLE(comment, fields.size(), 4);
+    for (const std::string & field : fields) {
+        appendLE(comment, field.length(), 4);
+        append(comment, field);
+    }
+
+    std::vector< std::pair<unsigned char, std::vector<unsigned char> > > blocks = {
+        {0, info},
+        {6, std::vector<unsigned char>(random.begin(), random.begin() + pictureSize)},
+        {4, comment},
+        {1, std::vector<unsigned char>(4096, 0)}
+    };
+    for (size_t i = 0; i < blocks.size(); i++) {
+        data.push_back(blocks[i].first | (i + 1 == blocks.size() ? 0x80 : 0));
+        appendBE(data, blocks[i].second.size(), 3);
+        data.insert(data.end(), blocks[i].second.begin(), blocks[i].second.end());
+    }
+    append(data, random, audioSize);
+    return data;
+}
+
+static void appendChunk(std::vector<unsigned char> & data, const std::string & id, const std::vector<unsigned char> & chunk) {
+    append(data, id);
+    appendLE(data, chunk.size(), 4);
+    data.insert(data.end(), chunk.begin(), chunk.end());
+    if (chunk.size() & 1) {
+        data.push_back(0);
+    }
+}
+
+static std::vector<unsigned char> makeWAV(const Metadata::Song & m, const std::vector<unsigned char> & random, size_t pictureSize, size_t audioSize) {
+    // 8-bit mono, with the sample rate chosen so the audio lasts for the song's duration
+    uint32_t sampleRate = audioSize / m.duration;
+    std::vector<unsigned char> format;
+    appendLE(format, 1, 2);
+    appendLE(format, 1, 2);
+    appendLE(format, sampleRate, 4);
+    appendLE(format, sampleRate, 4);
+    appendLE(format, 1, 2);
+    appendLE(format, 8, 2);
+
+    // RIFF INFO doesn't store the disc number, so that's only in the id3 chunk
+    std::vector<unsigned char> info;
+    append(info, "INFO");
+    for (const std::pair<std::string, std::string> & field : std::vector< std::pair<std::string, std::string> >{{"INAM", m.title}, {"IART", m.artist}, {"IPRD", m.album}, {"IPRT", std::to_string(m.trackNumber)}}) {
+        std::vector<unsigned char> value(field.second.begin(), field.second.end());
+        value.push_back(0);
+        appendChunk(info, field.first, value);
+    }
+
+    std::vector<unsigned char> chunks;
+    append(chunks, "WAVE");
+    appendChunk(chunks, "fmt ", format);
+    appendChunk(chunks, "data", std::vector<unsigned char>(random.begin(), random.begin() + sampleRate * m.duration));
+    appendChunk(chunks, "LIST", info);
+    appendChunk(chunks, "id3 ", makeID3v2(id3v2Fields(m), random, pictureSize, 3));
+
+    std::vector<unsigned char> data;
+    append(data, "RIFF");
+    appendLE(data, chunks.size(), 4);
+    data.insert(data.end(), chunks.begin(), chunks.end());
+    return data;
+}
+
+// Returns the total number of bytes read by this process (from any file)
+static uint64_t bytesRead() {
+    std::ifstream file("/proc/self/io");
+    std::string name;
+    uint64_t value;
+    while (file >> name >> value) {
+        if (name == "rchar:") {
+            return value;
+        }
+    }
+    Benchmark::fail("Unable to read /proc/self/io");
+    return 0;
+}
+
+// Returns whether every value was read as expected
+static bool matches(const Metadata::Song & m, const Metadata::Song & expected) {
+    return (m.title == expected.title && m.artist == expected.artist && m.album == expected.album && m.trackNumber == expected.trackNumber
+            && m.discNumber == expected.discNumber && m.duration == expected.duration);
+}
+
+int main(int argc, char * argv[]) {
+    size_t count = (argc > 1 ? std::stoul(argv[1]) : 1500);
+    size_t pictureSize = (argc > 2 ? std::stoul(argv[2]) : 256) * 1024;
+    size_t audioSize = (argc > 3 ? std::stoul(argv[3]) : 1024) * 1024;
+    unsigned int runs = (argc > 4 ? std::stoul(argv[4]) : 5);
+
+    // Pictures and audio are random bytes (the same block is used for every file)
+    std::vector<unsigned char> random(std::max(pictureSize, audioSize));
+    std::mt19937 rng(count);
+    for (unsigned char & c : random) {
+        c = rng() & 0xFF;
+    }
+
+    Benchmark::progress("Writing " + std::to_string(count) + " files...");
+    Benchmark::resetData();
+    std::string musicFolder = Path::Common::SwitchFolder + "music";
+    std::vector<Metadata::Song> songs = Benchmark::makeLibrary(count);
+    std::vector<File> files;
+    std::vector<uint64_t> fileBytes(3, 0);
+    for (size_t i = 0; i < songs.size(); i++) {
+        File file;
+        file.expected = songs[i];
+        std::string path = musicFolder + songs[i].path.substr(std::string("/music").length());
+        path = path.substr(0, path.length() - std::string(".mp3").length());
+
+        std::vector<unsigned char> data;
+        switch (i % 3) {
+            case 0:
+                file.format = AudioFormat::MP3;
+                file.path = path + ".mp3";
+                data = makeMP3(songs[i], random, pictureSize, audioSize, (i / 3) % 2 == 1);
+                break;
+
+            case 1:
+                file.format = AudioFormat::FLAC;
+                file.path = path + ".flac";
+                data = makeFLAC(songs[i], random, pictureSize, audioSize);
+                break;
+
+            default:
+                file.format = AudioFormat::WAV;
+                file.path = path + ".wav";
+                data = makeWAV(songs[i], random, pictureSize, audioSize);
+                break;
+        }
+
+        Utils::Fs::createPath(Utils::Fs::getParentDirectory(file.path) + "/");
+        if (!Utils::Fs::writeFile(file.path, data)) {
+            Benchmark::fail("Unable to write " + file.path);
+        }
+        fileBytes[i % 3] += data.size();
+        files.push_back(file);
+    }
+
+    std::vector<std::string> columns = {"format", "files", "file_kb", "read_bytes_per_file", "files_per_s", "correct"};
+    for (const std::string & column : Benchmark::resultColumns()) {
+        columns.push_back(column);
+    }
+    Benchmark::printHeader(columns);
+
+    std::vector< std::pair<std::string, AudioFormat> > formats = {{"mp3", AudioFormat::MP3}, {"flac", AudioFormat::FLAC}, {"wav", AudioFormat::WAV}};
+    for (size_t f = 0; f < formats.size(); f++) {
+        std::vector<const File *> toRead;
+        for (const File & file : files) {
+            if (file.format == formats[f].second) {
+                toRead.push_back(&file);
+            }
+        }
+        if (toRead.empty()) {
+            continue;
+        }
+
+        // Bytes read and correctness are only checked on the first run (they're the same every time)
+        bool first = true;
+        size_t correct = 0;
+        uint64_t read = 0;
+        Benchmark::Result result = Benchmark::time([&]() {
+            uint64_t before = bytesRead();
+            bool ok = true;
+            for (const File * file : toRead) {
+                Metadata::Song m;
+                m.title = m.artist = m.album = "";
+                m.trackNumber = m.discNumber = -1;
+                m.duration = -1;
+                ok = (Metadata::TagReader::readFromFile(file->path, file->format, m) && ok);
+                if (first && matches(m, file->expected)) {
+                    correct++;
+                }
+            }
+            if (first) {
+                read = bytesRead() - before;
+                first = false;
+            }
+            return ok;
+        }, runs);
+
+        char buf[128];
+        std::snprintf(buf, sizeof(buf), "%.0f\t%.0f\t%.0f\t%zu", fileBytes[f] / 1024.0 / toRead.size(), read / (double)toRead.size(), toRead.size() / (result.median / 1000), correct);
+        Benchmark::printResult({formats[f].first, std::to_string(toRead.size()), buf}, result);
+    }
+    return 0;
+}
\ No newline at end of file